@@ -167,8 +167,15 @@ class ShimDMAAllocator : public DMAAllocator {
 public:
   std::vector<int> dma_columns;
   int shim_dma_channels;
+  // Column allocation policy: "first-fit" fills a shim column's channels
+  // before moving on; "balanced" assigns each new channel to the column with
+  // the least bytes allocated in that direction, preferring the column
+  // closest to the other end of the flow.
+  std::string alloc_policy;
+  std::map<int, uint64_t> mm2s_column_bytes, s2mm_column_bytes;
 
-  ShimDMAAllocator(AIE::DeviceOp device);
+  ShimDMAAllocator(AIE::DeviceOp device,
+                   std::string alloc_policy = "first-fit");
 
   FailureOr<allocation_info_t>
   allocNewDmaChannel(air::MemcpyInterface &memcpyOp, int col, int row,
@@ -180,6 +187,11 @@ public:
                      allocation_info_t existing_alloc,
                      std::vector<Operation *> &dma_ops);
 
+  FailureOr<allocation_info_t>
+  balancedDmaChannelAlloc(air::MemcpyInterface &memcpyOp, int col, int row,
+                          std::vector<Operation *> &dma_ops,
+                          std::string colAllocConstraint);
+
   FailureOr<AIE::ExternalBufferOp> getBuffer(uint64_t &BufferId, int64_t col,
                                              int64_t row,
                                              air::MemcpyInterface &memcpyOp);
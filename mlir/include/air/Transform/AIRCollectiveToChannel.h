@@ -0,0 +1,24 @@
+//===- AIRCollectiveToChannel.h ---------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIR_COLLECTIVE_TO_CHANNEL_H
+#define AIR_COLLECTIVE_TO_CHANNEL_H
+
+#include "air/Transform/PassDetail.h"
+
+#include "mlir/Pass/Pass.h"
+#include <memory>
+
+namespace xilinx {
+namespace air {
+
+std::unique_ptr<mlir::Pass> createAIRCollectiveToChannelPass();
+
+} // namespace air
+} // namespace xilinx
+
+#endif // AIR_COLLECTIVE_TO_CHANNEL_H
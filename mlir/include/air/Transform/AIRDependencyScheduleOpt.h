@@ -33,6 +33,8 @@ std::unique_ptr<mlir::Pass> createAIRHoistOpsNotUsingPingPongPattern();
 
 std::unique_ptr<mlir::Pass> createAIRBroadcastDetection();
 
+std::unique_ptr<mlir::Pass> createAIRChannelBroadcastDetection();
+
 std::unique_ptr<mlir::Pass> createAIRPruneLinalgGenericInputDma();
 
 std::unique_ptr<mlir::Pass> createAIRPingPongTransformationPattern();
@@ -0,0 +1,24 @@
+//===- AIRFuseHerdEpilogue.h ------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIR_FUSE_HERD_EPILOGUE_H
+#define AIR_FUSE_HERD_EPILOGUE_H
+
+#include "air/Transform/PassDetail.h"
+
+#include "mlir/Pass/Pass.h"
+#include <memory>
+
+namespace xilinx {
+namespace air {
+
+std::unique_ptr<mlir::Pass> createAIRFuseHerdEpiloguePass();
+
+} // namespace air
+} // namespace xilinx
+
+#endif // AIR_FUSE_HERD_EPILOGUE_H
@@ -0,0 +1,24 @@
+//===- AIRMemoryFootprint.h -------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIR_MEMORY_FOOTPRINT_H
+#define AIR_MEMORY_FOOTPRINT_H
+
+#include "air/Transform/PassDetail.h"
+
+#include "mlir/Pass/Pass.h"
+#include <memory>
+
+namespace xilinx {
+namespace air {
+
+std::unique_ptr<mlir::Pass> createAIRMemoryFootprintPass();
+
+} // namespace air
+} // namespace xilinx
+
+#endif // AIR_MEMORY_FOOTPRINT_H
@@ -25,7 +25,9 @@ namespace air {
 #define GEN_PASS_DEF_AIRANNOTATEFRONTANDBACKOPSINFORPATTERN
 #define GEN_PASS_DEF_AIRAUTOMATICTILING
 #define GEN_PASS_DEF_AIRBROADCASTDETECTION
+#define GEN_PASS_DEF_AIRCHANNELBROADCASTDETECTION
 #define GEN_PASS_DEF_AIRCOLLAPSEHERDPASS
+#define GEN_PASS_DEF_AIRCOLLECTIVETOCHANNEL
 #define GEN_PASS_DEF_AIRUNROLLOUTERPERFECTLYNESTEDLOOPSPASS
 #define GEN_PASS_DEF_AIRCONSTRUCTPINGPONGDEPENDENCYPATTERN
 #define GEN_PASS_DEF_AIRDEALIASMEMREF
@@ -35,6 +37,8 @@ namespace air {
 #define GEN_PASS_DEF_AIRENFORCELOOPCARRIEDMEMREFDEALLOCPATTERN
 #define GEN_PASS_DEF_AIREXAMPLEPASS
 #define GEN_PASS_DEF_AIRFUSECHANNELS
+#define GEN_PASS_DEF_AIRFUSEHERDEPILOGUE
+#define GEN_PASS_DEF_AIRFUSELAUNCHES
 #define GEN_PASS_DEF_AIRFUSEPARALLELHERDPASS
 #define GEN_PASS_DEF_AIRFUSENESTEDHERDPASS
 #define GEN_PASS_DEF_AIRHERDASSIGN
@@ -56,6 +60,7 @@ namespace air {
 #define GEN_PASS_DEF_AIRLOOPPERMUTATION
 #define GEN_PASS_DEF_AIRLOWERHERDPARALLELPASS
 #define GEN_PASS_DEF_AIRLOWERLINALGTENSORS
+#define GEN_PASS_DEF_AIRMEMORYFOOTPRINT
 #define GEN_PASS_DEF_AIRPINGPONGTRANSFORMATIONPATTERN
 #define GEN_PASS_DEF_AIRPIPELINEREDUCEPASS
 #define GEN_PASS_DEF_AIRPROMOTEUNIFORML1DMA
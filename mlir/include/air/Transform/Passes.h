@@ -10,11 +10,14 @@
 #define AIR_TRANSFORM_PASSES_H
 
 #include "air/Transform/AIRAutomaticTilingPass.h"
+#include "air/Transform/AIRCollectiveToChannel.h"
 #include "air/Transform/AIRDependency.h"
 #include "air/Transform/AIRDependencyCanonicalize.h"
 #include "air/Transform/AIRDependencyParseGraph.h"
 #include "air/Transform/AIRDependencyScheduleOpt.h"
 #include "air/Transform/AIRDmaToChannel.h"
+#include "air/Transform/AIRFuseHerdEpilogue.h"
+#include "air/Transform/AIRFuseLaunches.h"
 #include "air/Transform/AIRHerdAssignPass.h"
 #include "air/Transform/AIRHerdPlacementPass.h"
 #include "air/Transform/AIRHerdVectorize.h"
@@ -24,6 +27,7 @@
 #include "air/Transform/AIRLoopMergingPass.h"
 #include "air/Transform/AIRLoopPermutationPass.h"
 #include "air/Transform/AIRLowerLinalgTensors.h"
+#include "air/Transform/AIRMemoryFootprint.h"
 #include "air/Transform/AIRMiscPasses.h"
 #include "air/Transform/AIRRegularizeLoopPass.h"
 #include "air/Transform/AIRSplitLaunchForPadding.h"
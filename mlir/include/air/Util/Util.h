@@ -62,6 +62,10 @@ SmallVector<int> getTensorShape(const ShapedType ty);
 SmallVector<int> getTensorShape(const Type ty);
 std::string getElementTypeAsString(const mlir::Type ty);
 uint64_t getElementSizeInBytes(const mlir::Type ty);
+// Size in bytes of a statically shaped memref
+uint64_t getMemRefSizeInBytes(MemRefType ty);
+// Total size in bytes of the memref.alloc ops in `space` nested in `op`
+uint64_t getAllocatedBytes(Operation *op, MemorySpace space);
 
 // Get the parent scf.for op of an iter_arg
 scf::ForOp getForRegionIterArgsOwner(Value val);
@@ -120,6 +124,13 @@ std::vector<ChannelPutOp> getTheOtherChannelOpThroughSymbol(ChannelGetOp get);
 std::vector<air::ChannelInterface>
 getTheOtherChannelOpThroughSymbol(air::ChannelInterface op);
 FailureOr<StringRef> getChannelType(air::MemcpyInterface chanIfOp);
+// Get the number of bytes moved by one execution of a channel op. Returns
+// std::nullopt if the access pattern has non-constant sizes.
+std::optional<uint64_t> getStaticChannelTransferBytes(air::ChannelInterface op);
+// Get the product of the static trip counts of all scf.for loops enclosing op,
+// up to (and excluding) scope. Loops with dynamic bounds are counted once.
+uint64_t getStaticEnclosingForLoopTripCount(Operation *op,
+                                            Operation *scope = nullptr);
 // Get integer index to metadataArray, from channel bundle indices.
 std::optional<int>
 getIndexToMetadataArrayFromChannelIndices(air::ChannelInterface op);
@@ -322,6 +333,30 @@ bool isRegionEquivalentTo(Region *lhs, Region *rhs);
 // const value equivalences.
 bool isEquivalentTo(Operation *lhs, Operation *rhs);
 
+// Whether two lists of values are pairwise the same value or the same
+// integer constant, e.g. the sizes of two hierarchy ops.
+bool isEqualConstantIntOrValues(ValueRange a, ValueRange b);
+// Follows a kernel or size argument of hierarchy ops up to the value bound
+// to it outside of them.
+Value getHierarchyArgSource(Value v);
+// Whether `a` computes the same value as `b` for the same ids of the
+// hierarchy ops around them. Once hierarchy arguments are followed, both
+// are the same value or constant, the same dimension of the ids of two
+// hierarchy ops of the same kind and grid, or the same result of the same
+// pure op on equivalent operands.
+bool isEquivalentAcrossHierarchy(Value a, Value b);
+bool isEquivalentAcrossHierarchy(ValueRange a, ValueRange b);
+// Moves the body of a hierarchy op before the terminator of `into`, an op of
+// the same kind and rank, rebinding its ids and sizes to those of `into` and
+// its kernel arguments to `args`. A null entry of `args` leaves the kernel
+// argument as is.
+void spliceHierarchyBody(HierarchyInterface from, HierarchyInterface into,
+                         ArrayRef<Value> args);
+
+// Name of the runtime sequence of a control function specialized for one
+// of its 'air.size_variants', e.g. forward_4_128 for @forward and [4, 128].
+std::string getSizeVariantName(StringRef funcName, ArrayRef<int64_t> sizes);
+
 // Generate composed affine apply op from arith addi op operating on Index
 // values.
 affine::AffineApplyOp
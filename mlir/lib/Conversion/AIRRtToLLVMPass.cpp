@@ -941,6 +941,9 @@ public:
   }
 };
 
+// Widest airrt.wait_all lowered to a call taking one argument per event.
+static constexpr unsigned kMaxWaitAllArity = 3;
+
 class WaitAllOpConversion
     : public OpConversionPattern<xilinx::airrt::WaitAllOp> {
 public:
@@ -953,14 +956,46 @@ public:
     SmallVector<Value, 8> operands{adaptor.getOperands()};
     auto module = op->getParentOfType<ModuleOp>();
     auto ctx = op->getContext();
+    auto loc = op->getLoc();
+    auto ptrTy = LLVM::LLVMPointerType::get(ctx);
 
-    SmallVector<Type, 8> tys(operands.size(), LLVM::LLVMPointerType::get(ctx));
-    SmallVector<Type, 1> retTys(op->getNumResults(),
-                                LLVM::LLVMPointerType::get(ctx));
+    SmallVector<Type, 1> retTys(op->getNumResults(), ptrTy);
 
     std::string fnName = "__airrt_wait_all";
     llvm::raw_string_ostream ss(fnName);
-    ss << "_" << retTys.size() << "_" << operands.size();
+    ss << "_" << retTys.size() << "_";
+
+    // The runtime provides one entry point per arity up to
+    // kMaxWaitAllArity. Wider waits pass their events as an array and a
+    // count to __airrt_wait_all_<results>_n. The array lives on the stack
+    // only for the call, so that waits in loops do not grow the stack.
+    Value stack;
+    if (operands.size() <= kMaxWaitAllArity) {
+      ss << operands.size();
+    } else {
+      auto i32Ty = IntegerType::get(ctx, 32);
+      auto i64Ty = IntegerType::get(ctx, 64);
+      auto one = LLVM::ConstantOp::create(rewriter, loc, i32Ty,
+                                          rewriter.getI32IntegerAttr(1));
+      auto arrayTy = LLVM::LLVMArrayType::get(ptrTy, operands.size());
+      stack = LLVM::StackSaveOp::create(rewriter, loc, ptrTy);
+      Value events =
+          LLVM::AllocaOp::create(rewriter, loc, ptrTy, arrayTy, one, 8);
+      for (auto [i, event] : llvm::enumerate(operands)) {
+        auto slot = LLVM::GEPOp::create(
+            rewriter, loc, ptrTy, arrayTy, events,
+            ArrayRef<LLVM::GEPArg>{0, static_cast<int32_t>(i)});
+        LLVM::StoreOp::create(rewriter, loc, event, slot);
+      }
+      auto count = LLVM::ConstantOp::create(
+          rewriter, loc, i64Ty, rewriter.getI64IntegerAttr(operands.size()));
+      operands = {events, count.getResult()};
+      ss << "n";
+    }
+
+    SmallVector<Type, 8> tys;
+    for (auto o : operands)
+      tys.push_back(o.getType());
 
     auto fn = module.lookupSymbol<func::FuncOp>(fnName);
     if (!fn) {
@@ -970,8 +1005,12 @@ public:
       module.push_back(fn);
     }
 
-    rewriter.replaceOpWithNewOp<func::CallOp>(op, retTys,
-                                              SymbolRefAttr::get(fn), operands);
+    auto call = rewriter.replaceOpWithNewOp<func::CallOp>(
+        op, retTys, SymbolRefAttr::get(fn), operands);
+    if (stack) {
+      rewriter.setInsertionPointAfter(call);
+      LLVM::StackRestoreOp::create(rewriter, loc, stack);
+    }
     return success();
   }
 };
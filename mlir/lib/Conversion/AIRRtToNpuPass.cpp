@@ -23,10 +23,13 @@
 #include "mlir/Dialect/SCF/Transforms/Transforms.h"
 #include "mlir/Dialect/SCF/Utils/Utils.h"
 #include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
@@ -627,10 +630,8 @@ struct HerdLoadToNpuPattern : public OpConversionPattern<airrt::HerdLoadOp> {
             rtp_slot++;
           }
         }
-        // FIXME: this should depend on the metadata to enable and to get the id
-        if (!op.getNumOperands())
-          continue;
-
+        // The core acquires the herd lock before every iteration if the lock
+        // exists, also when the herd has no runtime parameters.
         std::string lock_name = "__air_herd_lock_" + std::to_string(phys_x) +
                                 "_" + std::to_string(phys_y);
 
@@ -1025,6 +1026,9 @@ SmallVector<LaunchRegion> identifyLaunchRegions(func::FuncOp funcOp,
         deviceName = herdLoad.getSymName();
       else
         return;
+      // A launch with several loads is one region
+      if (!regions.empty() && regions.back().boundaryOp == forOp)
+        return;
       AIE::DeviceOp device = getDeviceByName(module, deviceName);
       if (device) {
         regions.push_back({forOp, deviceName, device});
@@ -1035,6 +1039,72 @@ SmallVector<LaunchRegion> identifyLaunchRegions(func::FuncOp funcOp,
   return regions;
 }
 
+// What a launch region touches in L3 memory and on its device. The airrt
+// form no longer carries the async tokens between launches, so the
+// dependencies between them are recovered the way air-dependency derives
+// the tokens: from the buffers their shim DMAs access, plus the shim
+// channels and herds they share.
+struct LaunchFootprint {
+  AIE::DeviceOp device;
+  llvm::SmallDenseSet<Value> reads;
+  llvm::SmallDenseSet<Value> writes;
+  llvm::SmallDenseSet<StringRef> channels;
+  llvm::SmallDenseSet<StringRef> herds;
+  // The region loads a segment without naming its herds
+  bool wholeDevice = false;
+};
+
+LaunchFootprint getLaunchFootprint(Operation *region, AIE::DeviceOp device) {
+  LaunchFootprint fp;
+  fp.device = device;
+  bool hasHerdLoad = false;
+  region->walk([&](Operation *op) {
+    if (auto herdLoad = dyn_cast<airrt::HerdLoadOp>(op)) {
+      fp.herds.insert(herdLoad.getSymName());
+      hasHerdLoad = true;
+      return;
+    }
+    auto dma = dyn_cast<airrt::DmaMemcpyNdOp>(op);
+    if (!dma)
+      return;
+    Value memref = dma.getMemref();
+    while (auto view = memref.getDefiningOp<ViewLikeOpInterface>())
+      memref = view.getViewSource();
+    AIE::ShimDMAAllocationOp alloc;
+    if (auto metadata = dma->getAttrOfType<FlatSymbolRefAttr>("metadata")) {
+      fp.channels.insert(metadata.getValue());
+      alloc =
+          AIE::ShimDMAAllocationOp::getForSymbol(device, metadata.getValue());
+    }
+    // A DMA of unknown direction may write its buffer
+    if (alloc && alloc.getChannelDir() == AIE::DMAChannelDir::MM2S)
+      fp.reads.insert(memref);
+    else
+      fp.writes.insert(memref);
+  });
+  fp.wholeDevice = !hasHerdLoad;
+  return fp;
+}
+
+// Whether two launch regions must run in program order
+bool launchesDependOn(const LaunchFootprint &a, const LaunchFootprint &b) {
+  for (Value v : a.writes)
+    if (b.writes.contains(v) || b.reads.contains(v))
+      return true;
+  for (Value v : b.writes)
+    if (a.reads.contains(v))
+      return true;
+  if (a.device != b.device)
+    return false;
+  if (a.wholeDevice || b.wholeDevice)
+    return true;
+  auto shared = [](const llvm::SmallDenseSet<StringRef> &x,
+                   const llvm::SmallDenseSet<StringRef> &y) {
+    return llvm::any_of(x, [&](StringRef s) { return y.contains(s); });
+  };
+  return shared(a.channels, b.channels) || shared(a.herds, b.herds);
+}
+
 // Collect operations that should be part of the function "prologue" -
 // operations that are used by multiple launch regions and should be
 // cloned to each device's function.
@@ -1386,6 +1456,12 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
 
     ModuleOp module = getOperation();
 
+    // Specialize control functions over their table of runtime sizes
+    if (failed(specializeSizeVariants(module))) {
+      signalPassFailure();
+      return;
+    }
+
     // Move func op to the end of device op's body
     moveFuncOpToEndOfDeviceOp(module);
 
@@ -1398,6 +1474,9 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
     for (auto f : funcOps)
       removeDeadDeviceComputeOps(f);
 
+    // Defer the waits ending each launch to the launches depending on it
+    overlapIndependentLaunches(module);
+
     // Purge all wait all ops
     purgeSCFParContainingOnlyWaitAllOps(module);
 
@@ -1502,6 +1581,9 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
     if (failed(applyPartialConversion(module, target, std::move(patterns))))
       signalPassFailure();
 
+    // Only write the runtime parameters that changed for resident cores
+    elideUnchangedRtpWrites(module);
+
     // Simplify arith ops (from airrt-to-npu)
     RewritePatternSet canoPatterns_2(ctx);
     canoPatterns_2.insert<RelocateAssumeAlignmentOp>(ctx);
@@ -1611,15 +1693,44 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
       SmallVector<Operation *> prologueOps =
           collectPrologueOps(funcOp, regions);
 
+      // Group the regions into device sequences, each run under one
+      // configuration of its device. A region joins the last sequence of
+      // its device unless it depends on a region of a later sequence, which
+      // it would then run ahead of.
+      SmallVector<LaunchFootprint> footprints;
+      for (auto &region : regions)
+        footprints.push_back(
+            getLaunchFootprint(region.boundaryOp, region.device));
+      SmallVector<std::pair<AIE::DeviceOp, SmallVector<unsigned>>> sequences;
+      for (unsigned r = 0; r < regions.size(); r++) {
+        auto last = llvm::find_if(llvm::reverse(sequences), [&](auto &seq) {
+          return seq.first == regions[r].device;
+        });
+        bool append = last != sequences.rend();
+        for (auto it = sequences.rbegin(); append && it != last; ++it)
+          append = llvm::none_of(it->second, [&](unsigned q) {
+            return launchesDependOn(footprints[r], footprints[q]);
+          });
+        if (append)
+          last->second.push_back(r);
+        else
+          sequences.push_back({regions[r].device, {r}});
+      }
+
       OpBuilder builder(module.getContext());
+      SmallVector<std::string> sequenceNames;
+      llvm::DenseMap<AIE::DeviceOp, unsigned> numDeviceSequences;
 
-      // For each device, create a new func with device-specific name
-      for (auto &[device, deviceRegions] : deviceToRegions) {
+      // For each sequence, create a new func with device-specific name
+      for (auto &[device, sequenceRegions] : sequences) {
         builder.setInsertionPoint(device.getBody()->getTerminator());
 
         // Create new function with device-specific name (e.g.,
-        // add_two_sequence)
+        // add_two_sequence, then add_two_sequence_1 for a second sequence)
         std::string newFuncName = device.getSymName().str() + "_sequence";
+        if (unsigned k = numDeviceSequences[device]++)
+          newFuncName += "_" + std::to_string(k);
+        sequenceNames.push_back(newFuncName);
         auto newFuncOp = func::FuncOp::create(
             builder, funcOp.getLoc(), newFuncName, funcOp.getFunctionType());
         newFuncOp.setVisibility(funcOp.getVisibility());
@@ -1639,9 +1750,9 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
           builder.clone(*op, mapper);
         }
 
-        // Clone each launch region for this device
-        for (LaunchRegion *region : deviceRegions) {
-          builder.clone(*region->boundaryOp.getOperation(), mapper);
+        // Clone each launch region of this sequence
+        for (unsigned r : sequenceRegions) {
+          builder.clone(*regions[r].boundaryOp.getOperation(), mapper);
         }
 
         // Add return
@@ -1654,10 +1765,9 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
       pendingMainDevice->loc = funcOp.getLoc();
       pendingMainDevice->deviceType = deviceType;
       pendingMainDevice->mainSeqName = funcOp.getName().str();
-      for (auto &region : regions) {
-        pendingMainDevice->deviceNames.push_back(region.deviceName.str());
-        pendingMainDevice->sequenceNames.push_back(region.deviceName.str() +
-                                                   "_sequence");
+      for (auto [seq, name] : llvm::zip_equal(sequences, sequenceNames)) {
+        pendingMainDevice->deviceNames.push_back(seq.first.getSymName().str());
+        pendingMainDevice->sequenceNames.push_back(name);
       }
 
       // Erase the original function
@@ -1665,6 +1775,87 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
     }
   }
 
+  // The waits ending a launch region serialize it against all the launches
+  // after it. Inline the launch regions of each sequence and sink the
+  // trailing waits of every launch to the first later launch that depends
+  // on it, or to the end of the sequence, so that the shim DMAs of
+  // independent launches are in flight together. The waits never cross
+  // other ops with side effects between the launches.
+  void overlapIndependentLaunches(ModuleOp module) {
+    SmallVector<func::FuncOp> funcOps;
+    module.walk([&](func::FuncOp f) { funcOps.push_back(f); });
+    for (auto f : funcOps) {
+      auto device = f->getParentOfType<AIE::DeviceOp>();
+      if (!device || f.getBody().empty())
+        continue;
+
+      // In ELF mode the launch_end waits of npu2 devices synchronize the
+      // whole device before the next launch
+      if (clOutputElf &&
+          isa<AIE::BaseNPU2TargetModel>(device.getTargetModel()))
+        continue;
+
+      Block &body = f.getBody().front();
+      SmallVector<affine::AffineForOp> launches;
+      for (auto forOp : body.getOps<affine::AffineForOp>())
+        if (isLaunchBoundaryLoop(forOp) && !forOp.getNumResults() &&
+            !forOp.getBody()->without_terminator().empty())
+          launches.push_back(forOp);
+      if (launches.size() < 2)
+        continue;
+
+      SmallVector<LaunchFootprint> footprints;
+      SmallVector<Operation *> firstOps;
+      SmallVector<SmallVector<Operation *>> trailingWaits;
+      for (auto forOp : launches) {
+        footprints.push_back(getLaunchFootprint(forOp, device));
+        firstOps.push_back(&forOp.getBody()->front());
+        SmallVector<Operation *> waits;
+        for (Operation &op :
+             llvm::reverse(forOp.getBody()->without_terminator())) {
+          if (isa<airrt::SegmentLoadOp, airrt::HerdLoadOp>(op))
+            continue;
+          auto waitAll = dyn_cast<airrt::WaitAllOp>(op);
+          if (!waitAll || !waitAll->use_empty())
+            break;
+          waits.push_back(waitAll);
+        }
+        trailingWaits.push_back(std::move(waits));
+      }
+
+      // The op each launch's waits sink to: the start of the first later
+      // launch depending on it, or the first op in between with side
+      // effects
+      SmallVector<Operation *> sinkPoints;
+      for (unsigned a = 0; a < launches.size(); a++) {
+        Operation *sink = body.getTerminator();
+        unsigned b = a + 1;
+        for (Operation *op = launches[a]->getNextNode(); op != sink;
+             op = op->getNextNode()) {
+          if (b < launches.size() && op == launches[b]) {
+            if (launchesDependOn(footprints[a], footprints[b])) {
+              sink = firstOps[b];
+              break;
+            }
+            b++;
+            continue;
+          }
+          if (!isMemoryEffectFree(op)) {
+            sink = op;
+            break;
+          }
+        }
+        sinkPoints.push_back(sink);
+      }
+
+      for (auto forOp : launches)
+        (void)affine::promoteIfSingleIteration(forOp);
+      for (unsigned a = 0; a < launches.size(); a++)
+        for (Operation *wait : llvm::reverse(trailingWaits[a]))
+          wait->moveBefore(sinkPoints[a]);
+    }
+  }
+
   // Wrap existing aie.device ops with a main device when emit-main-device is
   // set but no func.func with segment_load was processed. This handles the
   // XRTRunner path where IR goes directly to AIE dialect with
@@ -1812,6 +2003,193 @@ struct AIRRtToNpuPass : public impl::AIRRtToNpuBase<AIRRtToNpuPass> {
     pendingMainDevice = std::nullopt;
   }
 
+  // A control function whose launch grid and boundary tile sizes are scalar
+  // arguments cannot be lowered to a single instruction sequence, as the NPU
+  // sequences are static. Its 'air.size_variants' attribute lists the sizes
+  // to precompile, one array of values for the integer and index arguments
+  // of the function per variant. Every variant becomes a copy of the
+  // function with those arguments folded away, named after the values, e.g.
+  // @forward_4_128 for [4, 128]. The copies differ only in their shim BDs and
+  // share the aie.device, so the core programs are the same for all sizes
+  // and the host picks the runtime sequence by name.
+  LogicalResult specializeSizeVariants(ModuleOp module) {
+    SmallVector<func::FuncOp> funcs;
+    module.walk([&](func::FuncOp f) {
+      if (f->hasAttr("air.size_variants"))
+        funcs.push_back(f);
+    });
+    for (auto f : funcs) {
+      auto variants = f->getAttrOfType<ArrayAttr>("air.size_variants");
+      if (!variants)
+        return f.emitOpError("expected an array for 'air.size_variants'");
+      if (clOutputElf)
+        return f.emitOpError(
+            "'air.size_variants' is not supported with output-elf");
+
+      llvm::BitVector scalarArgs(f.getNumArguments());
+      for (auto arg : f.getArguments())
+        if (isa<IntegerType, IndexType>(arg.getType()))
+          scalarArgs.set(arg.getArgNumber());
+
+      OpBuilder builder(f);
+      SmallVector<func::FuncOp> specialized;
+      for (Attribute attr : variants) {
+        auto sizes = dyn_cast<DenseI64ArrayAttr>(attr);
+        if (!sizes || sizes.size() != (int64_t)scalarArgs.count())
+          return f.emitOpError("expected ")
+                 << scalarArgs.count() << " values per size variant";
+
+        std::string name =
+            air::getSizeVariantName(f.getName(), sizes.asArrayRef());
+        if (module.lookupSymbol(name))
+          return f.emitOpError("size variant name '")
+                 << name << "' is already in use";
+
+        auto variant = cast<func::FuncOp>(builder.clone(*f));
+        variant.setName(name);
+        variant->removeAttr("air.size_variants");
+        specialized.push_back(variant);
+
+        Block &entry = variant.getBody().front();
+        OpBuilder b = OpBuilder::atBlockBegin(&entry);
+        auto v = sizes.asArrayRef().begin();
+        for (unsigned i : scalarArgs.set_bits()) {
+          BlockArgument arg = entry.getArgument(i);
+          auto c = arith::ConstantOp::create(
+              b, arg.getLoc(), arg.getType(),
+              b.getIntegerAttr(arg.getType(), *v++));
+          arg.replaceAllUsesWith(c);
+        }
+        (void)variant.eraseArguments(scalarArgs);
+
+        // Fold the sizes into the loop bounds and the BD wraps so that the
+        // loops unroll like those of a static launch.
+        RewritePatternSet patterns(module.getContext());
+        affine::AffineForOp::getCanonicalizationPatterns(patterns,
+                                                         module.getContext());
+        affine::AffineApplyOp::getCanonicalizationPatterns(
+            patterns, module.getContext());
+        affine::AffineMinOp::getCanonicalizationPatterns(patterns,
+                                                         module.getContext());
+        arith::IndexCastOp::getCanonicalizationPatterns(patterns,
+                                                        module.getContext());
+        (void)applyPatternsGreedily(variant, std::move(patterns));
+      }
+      if (failed(verifySizeVariantTransfers(specialized)))
+        return failure();
+      f.erase();
+    }
+    return success();
+  }
+
+  // The size variants share the memtile and core BDs at the other end of
+  // each shim channel, which are compiled for the full tile. A variant whose
+  // shim BDs move fewer elements, e.g. the partial last tile of a size that
+  // is not a multiple of the tile size, would leave those BDs waiting for
+  // data that never comes. Check on an unrolled copy of each variant that
+  // every transfer through a shim allocation has the same size in all of
+  // them.
+  LogicalResult verifySizeVariantTransfers(ArrayRef<func::FuncOp> variants) {
+    struct Transfer {
+      func::FuncOp variant;
+      int64_t size;
+    };
+    llvm::MapVector<StringRef, SmallVector<Transfer>> transfers;
+    for (auto variant : variants) {
+      OpBuilder builder(variant);
+      auto scratch = cast<func::FuncOp>(builder.clone(*variant));
+
+      // Unroll outermost first, so that inner bounds become constants.
+      bool unrolled = true;
+      while (unrolled) {
+        affine::AffineForOp afo;
+        scratch.walk<WalkOrder::PreOrder>([&](affine::AffineForOp op) {
+          afo = op;
+          return WalkResult::interrupt();
+        });
+        if (!afo)
+          break;
+        unrolled = succeeded(loopUnrollFull(afo));
+      }
+      if (!unrolled) {
+        scratch.erase();
+        return variant.emitOpError("failed to fully unroll");
+      }
+      RewritePatternSet patterns(variant.getContext());
+      affine::AffineApplyOp::getCanonicalizationPatterns(patterns,
+                                                         variant.getContext());
+      affine::AffineMinOp::getCanonicalizationPatterns(patterns,
+                                                       variant.getContext());
+      arith::IndexCastOp::getCanonicalizationPatterns(patterns,
+                                                      variant.getContext());
+      (void)applyPatternsGreedily(scratch, std::move(patterns));
+
+      WalkResult result = scratch.walk([&](airrt::DmaMemcpyNdOp dma) {
+        auto metadata = dma->getAttrOfType<FlatSymbolRefAttr>("metadata");
+        if (!metadata)
+          return WalkResult::advance();
+        int64_t size = 1;
+        for (Value len : {dma.getLength3(), dma.getLength2(), dma.getLength1(),
+                          dma.getLength0()}) {
+          auto c = getConstantIntValue(len);
+          if (!c) {
+            variant.emitOpError("transfer size through ")
+                << metadata << " does not fold to a constant";
+            return WalkResult::interrupt();
+          }
+          size *= *c;
+        }
+        transfers[metadata.getValue()].push_back({variant, size});
+        return WalkResult::advance();
+      });
+      scratch.erase();
+      if (result.wasInterrupted())
+        return failure();
+    }
+
+    // The largest transfer is the full tile that the device is compiled for.
+    for (auto &[metadata, list] : transfers) {
+      int64_t full = 0;
+      for (auto &t : list)
+        full = std::max(full, t.size);
+      for (auto &t : list)
+        if (t.size != full)
+          return t.variant.emitOpError("transfers ")
+                 << t.size << " elements through @" << metadata
+                 << ", but the device is compiled for " << full
+                 << "; size variants must be multiples of the tile size";
+    }
+    return success();
+  }
+
+  // Cores of a device marked 'air.persistent' by air-to-aie stay resident
+  // across launches and keep their RTP buffers, so a herd load only needs to
+  // write the runtime parameters that differ from the previous launch. The
+  // herd lock is still set for every launch. Tracking stops at anything that
+  // may overwrite the buffers or that is not straight-line code.
+  void elideUnchangedRtpWrites(ModuleOp module) {
+    module.walk([](AIE::DeviceOp device) {
+      if (!device->hasAttr("air.persistent"))
+        return;
+      device.walk([](Block *block) {
+        llvm::DenseMap<std::pair<StringRef, uint32_t>, int32_t> written;
+        for (Operation &o : llvm::make_early_inc_range(*block)) {
+          if (auto rtp = dyn_cast<AIEX::NpuWriteRTPOp>(o)) {
+            auto key = std::make_pair(rtp.getBuffer(), rtp.getIndex());
+            auto it = written.find(key);
+            if (it != written.end() && it->second == rtp.getValue())
+              rtp->erase();
+            else
+              written[key] = rtp.getValue();
+          } else if (o.getNumRegions() ||
+                     isa<AIEX::NpuLoadPdiOp, AIEX::NpuWrite32Op>(o)) {
+            written.clear();
+          }
+        }
+      });
+    });
+  }
+
   // Create a lightweight device clone for between-iteration load_pdi.
   // The clone has the same DMA BDs, locks, and switches but empty core
   // bodies (no ELFs). The between-iteration load_pdi references this
@@ -39,6 +39,7 @@
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
@@ -64,11 +65,13 @@ struct AIRToAIEConversionOptions {
   int64_t row_offset;
   bool emit_while;
   bool emit_herd_lock;
+  bool persistent;
   bool generate_shim_dma;
   bool insert_trace_packet_flow;
   bool use_packet_flow_at_shim_dmas;
   bool use_lock_race_condition_fix;
   AIE::AIEDevice device;
+  std::string shim_dma_alloc_policy = "first-fit";
 };
 
 // Breakpoint stages for debugging with --test-patterns
@@ -111,16 +114,22 @@ struct ShimTileAllocator {
   std::vector<int> shim_columns;
   int shim_dma_channels;
   const AIE::AIETargetModel &aie_target;
+  // "first-fit" fills each shim column before moving to the next one;
+  // "balanced" picks the column with the least bytes allocated so far.
+  std::string policy;
 
   struct shim_allocation_info_t {
     int shim_col;
     int available_channels;
     std::vector<std::string> chan_names;
+    uint64_t bytes = 0;
   };
 
   std::vector<shim_allocation_info_t> mm2s_allocs, s2mm_allocs;
 
-  ShimTileAllocator(const AIE::AIETargetModel &target) : aie_target(target) {
+  ShimTileAllocator(const AIE::AIETargetModel &target,
+                    std::string policy = "first-fit")
+      : aie_target(target), policy(policy) {
     for (int i = 0, e = aie_target.columns(); i < e; i++) {
       if (aie_target.isShimNOCTile(i, 0)) {
         shim_columns.push_back(i);
@@ -130,24 +139,66 @@ struct ShimTileAllocator {
     }
   }
 
+  // In "balanced" mode, ties between equally loaded columns go to the one
+  // nearest target_col, the column of the memtile or core at the other end
+  // of the flow (-1 if unknown).
   AIE::TileOp getShimTile(AIE::DeviceOp aie_device,
                           air::MemorySpace src_memory_space,
                           air::MemorySpace dst_memory_space,
-                          std::string chan_name) {
+                          std::string chan_name, uint64_t bytes = 0,
+                          int target_col = -1) {
     bool isMM2S = (src_memory_space < dst_memory_space);
     auto allocs = isMM2S ? &mm2s_allocs : &s2mm_allocs;
 
+    if (policy == "balanced") {
+      // Every flow costs at least one unit, so that flows of unknown size
+      // are still spread across columns.
+      bytes = std::max(bytes, (uint64_t)1);
+      shim_allocation_info_t *best = nullptr;
+      int bestCol = -1;
+      uint64_t bestLoad = 0;
+      int bestDistance = 0;
+      for (auto col : shim_columns) {
+        auto it = llvm::find_if(*allocs, [&](shim_allocation_info_t &t) {
+          return t.shim_col == col;
+        });
+        if (it != allocs->end() && it->available_channels <= 0)
+          continue;
+        uint64_t load = it != allocs->end() ? it->bytes : 0;
+        int distance = target_col >= 0 ? std::abs(col - target_col) : 0;
+        if (bestCol != -1 && std::make_pair(load, distance) >=
+                                 std::make_pair(bestLoad, bestDistance))
+          continue;
+        best = it != allocs->end() ? &*it : nullptr;
+        bestCol = col;
+        bestLoad = load;
+        bestDistance = distance;
+      }
+      if (bestCol == -1)
+        return nullptr;
+      if (best) {
+        best->available_channels -= 1;
+        best->chan_names.push_back(chan_name);
+        best->bytes += bytes;
+      } else {
+        allocs->push_back(
+            {bestCol, shim_dma_channels - 1, {chan_name}, bytes});
+      }
+      return air::getPhysTileOp(aie_device, bestCol, 0);
+    }
+
     // return first available shim tile with a free channel
     for (auto &t : *allocs) {
       if (t.available_channels > 0) {
         t.available_channels -= 1;
         t.chan_names.push_back(chan_name);
+        t.bytes += bytes;
         return air::getPhysTileOp(aie_device, t.shim_col, 0);
       }
     }
     auto shim_col = shim_columns[allocs->size()];
     auto shim_tile = air::getPhysTileOp(aie_device, shim_col, 0);
-    allocs->push_back({shim_col, shim_dma_channels - 1, {chan_name}});
+    allocs->push_back({shim_col, shim_dma_channels - 1, {chan_name}, bytes});
 
     return shim_tile;
   }
@@ -1973,6 +2024,25 @@ struct LowerAIRChannelsPattern : public OpRewritePattern<air::ChannelOp> {
         bufferToMemtileMap(bufferToMemtileMap),
         linksToComplete(linksToComplete) {}
 
+  // Bytes moved by the device-side ends of a channel, used to weight shim
+  // tile allocation.
+  template <typename OpTy>
+  static uint64_t getTransferBytes(std::vector<OpTy> &ops) {
+    uint64_t bytes = 0;
+    for (auto op : ops)
+      bytes += air::getStaticChannelTransferBytes(
+                   cast<air::ChannelInterface>(op.getOperation()))
+                   .value_or(0) *
+               air::getStaticEnclosingForLoopTripCount(op);
+    return bytes;
+  }
+
+  // Column of a tile value, or -1 if it is not an aie.tile
+  static int getTileCol(Value tile) {
+    auto tileOp = tile ? tile.getDefiningOp<AIE::TileOp>() : nullptr;
+    return tileOp ? tileOp.getCol() : -1;
+  }
+
   LogicalResult matchAndRewrite(air::ChannelOp channel,
                                 PatternRewriter &rewriter) const override {
     auto device = channel->getParentOfType<AIE::DeviceOp>();
@@ -2027,10 +2097,21 @@ struct LowerAIRChannelsPattern : public OpRewritePattern<air::ChannelOp> {
         }
       }
     } else {
-      // put from L3
-      producerTile = shimTileAlloc.getShimTile(device, air::MemorySpace::L3,
-                                               air::MemorySpace::L1,
-                                               channel.getName().str());
+      // put from L3, placed near the first consumer
+      int targetCol = -1;
+      if (!channelGets.empty()) {
+        Value getTile;
+        AIE::AIEObjectFifoType getType;
+        if (failed(findChannelPutGetTile<air::ChannelGetOp>(
+                channelGets.front(), &getTile, &getType)))
+          return failure();
+        targetCol = getTileCol(getTile);
+      }
+      producerTile = shimTileAlloc.getShimTile(
+          device, air::MemorySpace::L3, air::MemorySpace::L1,
+          channel.getName().str(), getTransferBytes(channelGets), targetCol);
+      if (!producerTile)
+        return channel.emitOpError("failed to allocate a shim tile");
     }
 
     // put/get come in pairs, if one is missing then it's L3
@@ -2068,9 +2149,12 @@ struct LowerAIRChannelsPattern : public OpRewritePattern<air::ChannelOp> {
     }
     for (int i = 0; i < expectedGets - (int)channelGets.size(); i++) {
       // get from L3
-      consumerTile = shimTileAlloc.getShimTile(device, air::MemorySpace::L1,
-                                               air::MemorySpace::L3,
-                                               channel.getName().str());
+      consumerTile = shimTileAlloc.getShimTile(
+          device, air::MemorySpace::L1, air::MemorySpace::L3,
+          channel.getName().str(), getTransferBytes(channelPuts),
+          getTileCol(producerTile));
+      if (!consumerTile)
+        return channel.emitOpError("failed to allocate a shim tile");
       consumers.push_back(consumerTile);
     }
 
@@ -2081,7 +2165,7 @@ struct LowerAIRChannelsPattern : public OpRewritePattern<air::ChannelOp> {
     rewriter.setInsertionPoint(*(device.getOps<AIE::CoreOp>().begin()));
     AIE::ObjectFifoCreateOp objFifo = createObjectFifo(
         rewriter, datatype, producerTile, consumers,
-        channel.getBufferResources(), "air_" + channel.getName().str());
+        channel.getDepth(), "air_" + channel.getName().str());
 
     // if this channel's get is linked with another put, register it
     if (linkToComplete)
@@ -2326,6 +2410,8 @@ struct SpecializeChannelBundlePattern
         new_chan->setAttr("broadcast_shape",
                           rewriter.getArrayAttr(ArrayRef(broadcast_shape)));
       }
+      if (channel->hasAttr("depth"))
+        new_chan.setDepth(channel.getDepth());
       std::vector<unsigned> position =
           air::getMDVectorFromIterator(bundle_size_stdvec, iter);
       for (auto put : channelPuts) {
@@ -2494,6 +2580,27 @@ void specializeChannelBundle(
   (void)applyPatternsGreedily(d, std::move(patterns));
 }
 
+// The DMA lowering path takes its buffers and locks from the buffers already
+// allocated in the IR, so it cannot hold more than one transfer per channel
+// buffer. Reject channels deeper than 1 instead of silently running them at
+// depth 1, which deadlocks producers that rely on running ahead.
+static LogicalResult verifyChannelDepthForDmaLowering(AIE::DeviceOp &d) {
+  LogicalResult result = success();
+  llvm::SmallDenseSet<Operation *> seen;
+  d.walk([&](air::ChannelInterface op) {
+    auto channel = air::getChannelDeclarationThroughSymbol(op);
+    if (!channel || channel.getDepth() <= 1 ||
+        !seen.insert(channel.getOperation()).second)
+      return;
+    channel.emitOpError("has depth ")
+        << channel.getDepth()
+        << ", which is only supported when lowering channels to object "
+           "FIFOs; multi-buffer the channel's buffers instead";
+    result = failure();
+  });
+  return result;
+}
+
 // Remove orphaned specialized channels after specializeChannelBundle.
 // An orphaned channel is one that has puts but no gets, or gets but no puts.
 // This happens when cloning L3 ops to all devices, but each device only
@@ -2559,21 +2666,10 @@ struct LowerAIRPingPongPattern : public OpRewritePattern<scf::ForOp> {
     if (!device)
       return failure();
 
-    // Annotate channels with buffer_resource, i.e. object count
-    for_op.walk([&](Operation *op) {
-      if (auto get = dyn_cast_if_present<air::ChannelGetOp>(op)) {
-        auto chan_op = air::getChannelDeclarationThroughSymbol(get);
-        chan_op->setAttr(
-            "buffer_resources",
-            IntegerAttr::get(IntegerType::get(chan_op->getContext(), 32),
-                             unroll_factor));
-      } else if (auto put = dyn_cast_if_present<air::ChannelPutOp>(op)) {
-        auto chan_op = air::getChannelDeclarationThroughSymbol(put);
-        chan_op->setAttr(
-            "buffer_resources",
-            IntegerAttr::get(IntegerType::get(chan_op->getContext(), 32),
-                             unroll_factor));
-      }
+    // Annotate channels with their depth, i.e. object count
+    for_op.walk([&](air::ChannelInterface op) {
+      auto chan_op = air::getChannelDeclarationThroughSymbol(op);
+      chan_op.setDepth(unroll_factor);
     });
 
     for_op->removeAttr("isolated");
@@ -2766,8 +2862,9 @@ public:
     }
 
     // Allocators
-    air::ShimDMAAllocator shimDmaAlloc(device);
-    ShimTileAllocator shimTileAlloc(device.getTargetModel());
+    air::ShimDMAAllocator shimDmaAlloc(device, options.shim_dma_alloc_policy);
+    ShimTileAllocator shimTileAlloc(device.getTargetModel(),
+                                    options.shim_dma_alloc_policy);
     std::map<std::string, std::string> chan_to_chan_map;
     std::map<int, int> chan_renumber_reverse_map;
 
@@ -2819,6 +2916,8 @@ public:
       lowerAIRChannels(device, shimTileAlloc, bufferToMemtileMap);
       allocL1Buffers(device, tileToHerdMap, BufferId);
     } else {
+      if (failed(verifyChannelDepthForDmaLowering(device)))
+        return failure();
       specializeL2MemrefsIntoMemtiles(device);
       allocL1Buffers(device, tileToHerdMap, BufferId);
       allocL2Buffers(device, bufferToMemtileMap, BufferId);
@@ -5767,13 +5866,15 @@ public:
       AIRToAIEConversionOptions options = {
           /*.col_offset = */ clColOffset,
           /*.row_offset = */ clRowOffset,
-          /*.emit_while = */ clEmitWhileLoop,
-          /*.emit_herd_lock = */ clEmitHerdLock,
+          /*.emit_while = */ clEmitWhileLoop || clEmitPersistent,
+          /*.emit_herd_lock = */ clEmitHerdLock || clEmitPersistent,
+          /*.persistent = */ clEmitPersistent,
           /*.generate_shim_dma = */ clGenerateShimDMA,
           /*.insert_trace_packet_flow = */ clInsertTracePacketFlow,
           /*.use_packet_flow_at_shim_dmas = */ clUsePktFlowsAtShimDma,
           /*.use_lock_race_condition_fix = */ clUseLockRaceConditionFix,
-          /*.device = */ *device};
+          /*.device = */ *device,
+          /*.shim_dma_alloc_policy = */ clShimDmaAllocPolicy};
 
       // Pre-pipeline: renumber memcpy ops at module level
       air::renumberMemcpyIfOps(&m.getRegion());
@@ -5824,7 +5925,8 @@ public:
     if (clTestPatterns.find("lower-scf-tokens") != std::string::npos)
       patterns.insert<LowerScfTokenPattern>(ctx);
 
-    ShimTileAllocator shimTileAlloc(AIE::getTargetModel(*device));
+    ShimTileAllocator shimTileAlloc(AIE::getTargetModel(*device),
+                                    clShimDmaAllocPolicy);
     std::map<Operation *, AIE::ObjectFifoCreateOp> linksToComplete;
     if (clTestPatterns.find("lower-air-channels") != std::string::npos) {
       patterns.insert<LowerAIRChannelsPattern>(
@@ -5846,6 +5948,123 @@ public:
       (void)applyPatternsGreedily(m, std::move(patterns));
   }
 
+  // Switch low-bandwidth and time-multiplexed L1/L2 dma_stream channels to
+  // dma_packet, so that they share switchbox ports via packet switching. The
+  // bandwidth of a channel is the number of bytes its puts move per launch;
+  // channels moving a dynamic number of bytes are never taken as low
+  // bandwidth. Two channels are time-multiplexed if, within a herd, all of
+  // their same-direction L1-side operations are ordered by async
+  // dependencies.
+  void assignPacketFlowsToChannels(ModuleOp module) {
+    // The number of packet ids available on a packet-switched route.
+    const unsigned maxPacketIds = 32;
+
+    SmallVector<air::ChannelOp> candidates;
+    llvm::MapVector<air::ChannelOp, std::optional<uint64_t>> channelBytes;
+    DenseMap<air::ChannelOp, SmallVector<air::ChannelInterface>> l1Ops;
+    module.walk([&](air::ChannelOp chan) {
+      if (chan.getChannelType() != "dma_stream")
+        return;
+      auto puts = air::getChannelPutOpThroughSymbol(chan);
+      auto gets = air::getChannelGetOpThroughSymbol(chan);
+      if (puts.empty() || gets.empty())
+        return;
+      SmallVector<air::ChannelInterface> ops;
+      for (auto put : puts)
+        ops.push_back(cast<air::ChannelInterface>(put.getOperation()));
+      for (auto get : gets)
+        ops.push_back(cast<air::ChannelInterface>(get.getOperation()));
+      // Shim packet ids are a device-wide resource shared with control
+      // packets; only consider channels within the AIE array.
+      if (llvm::any_of(ops, [](air::ChannelInterface op) {
+            auto memrefTy = dyn_cast<BaseMemRefType>(op.getMemref().getType());
+            return !memrefTy || air::isL3(memrefTy);
+          }))
+        return;
+      std::optional<uint64_t> bytes = 0;
+      for (auto put : puts) {
+        auto putIf = cast<air::ChannelInterface>(put.getOperation());
+        uint64_t tiles = 1;
+        if (auto herd = put->getParentOfType<air::HerdOp>())
+          tiles = herd.getNumCols() * herd.getNumRows();
+        auto putBytes = air::getStaticChannelTransferBytes(putIf);
+        if (!putBytes) {
+          bytes = std::nullopt;
+          break;
+        }
+        *bytes += *putBytes * air::getStaticEnclosingForLoopTripCount(put) *
+                  tiles;
+      }
+      channelBytes[chan] = bytes;
+      for (auto op : ops)
+        if (op->getParentOfType<air::HerdOp>())
+          l1Ops[chan].push_back(op);
+    });
+    if (channelBytes.empty())
+      return;
+
+    uint64_t maxBytes = 0;
+    for (auto &entry : channelBytes)
+      maxBytes = std::max(maxBytes, entry.second.value_or(0));
+
+    // Low-bandwidth channels
+    llvm::SetVector<air::ChannelOp> selected;
+    for (auto &entry : channelBytes)
+      if (maxBytes && entry.second &&
+          *entry.second * 100 <= maxBytes * clAutoPacketFlowThreshold)
+        selected.insert(entry.first);
+
+    // Time-multiplexed channels: every pair of their L1-side ops in the same
+    // herd, moving data in the same direction, is ordered by async tokens.
+    auto areTimeMultiplexed = [&](air::ChannelOp a, air::ChannelOp b) {
+      bool foundPair = false;
+      for (auto opA : l1Ops[a]) {
+        for (auto opB : l1Ops[b]) {
+          if (opA->getParentOfType<air::HerdOp>() !=
+              opB->getParentOfType<air::HerdOp>())
+            continue;
+          if (isa<air::ChannelPutOp>(opA) != isa<air::ChannelPutOp>(opB))
+            continue;
+          if (!air::areAsyncDependent(opA, opB))
+            return false;
+          foundPair = true;
+        }
+      }
+      return foundPair;
+    };
+    auto channels = llvm::to_vector(llvm::make_first_range(channelBytes));
+    for (unsigned i = 0; i < channels.size(); i++) {
+      for (unsigned j = i + 1; j < channels.size(); j++) {
+        if (!areTimeMultiplexed(channels[i], channels[j]))
+          continue;
+        selected.insert(channels[i]);
+        selected.insert(channels[j]);
+      }
+    }
+
+    // Keep the lightest channels within the packet id budget, those of
+    // unknown volume last.
+    auto packetChannels = selected.takeVector();
+    llvm::stable_sort(packetChannels, [&](air::ChannelOp a, air::ChannelOp b) {
+      return channelBytes[a].value_or(UINT64_MAX) <
+             channelBytes[b].value_or(UINT64_MAX);
+    });
+    if (packetChannels.size() > maxPacketIds)
+      packetChannels.resize(maxPacketIds);
+
+    auto ctx = module.getContext();
+    for (auto chan : packetChannels) {
+      LLVM_DEBUG({
+        llvm::dbgs() << "auto-packet-flow: @" << chan.getSymName() << " (";
+        if (auto bytes = channelBytes[chan])
+          llvm::dbgs() << *bytes << " of " << maxBytes << " bytes)\n";
+        else
+          llvm::dbgs() << "unknown bytes)\n";
+      });
+      chan.setChannelTypeAttr(StringAttr::get(ctx, "dma_packet"));
+    }
+  }
+
   void runOnOperation() override {
 
     if (!clTestPatterns.empty()) {
@@ -5876,17 +6095,27 @@ public:
       signalPassFailure();
       return;
     }
+    if (clShimDmaAllocPolicy != "first-fit" &&
+        clShimDmaAllocPolicy != "balanced") {
+      module.emitOpError("Invalid shim-dma-alloc-policy option");
+      signalPassFailure();
+      return;
+    }
     air::renumberMemcpyIfOps(&module.getRegion());
+    if (clAutoPacketFlow)
+      assignPacketFlowsToChannels(module);
     AIRToAIEConversionOptions options = {
         /* .col_offset = */ clColOffset,
         /* .row_offset = */ clRowOffset,
-        /* .emit_while = */ clEmitWhileLoop,
-        /* .emit_herd_lock = */ clEmitHerdLock,
+        /* .emit_while = */ clEmitWhileLoop || clEmitPersistent,
+        /* .emit_herd_lock = */ clEmitHerdLock || clEmitPersistent,
+        /* .persistent = */ clEmitPersistent,
         /* .generate_shim_dma = */ clGenerateShimDMA,
         /* .insert_trace_packet_flow = */ clInsertTracePacketFlow,
         /* .use_packet_flow_at_shim_dmas = */ clUsePktFlowsAtShimDma,
         /* .use_lock_race_condition_fix = */ clUseLockRaceConditionFix,
-        /* .device = */ *device};
+        /* .device = */ *device,
+        /* .shim_dma_alloc_policy = */ clShimDmaAllocPolicy};
     createAIEModulesAndOutlineCores(module, aie_devices, tileToHerdMap,
                                     options);
 
@@ -5922,9 +6151,11 @@ public:
         return;
       }
 
-      air::ShimDMAAllocator shimDmaAlloc(device);
+      air::ShimDMAAllocator shimDmaAlloc(device,
+                                         device_options.shim_dma_alloc_policy);
       std::map<int, int> chan_renumber_reverse_map;
-      ShimTileAllocator shimTileAlloc(device.getTargetModel());
+      ShimTileAllocator shimTileAlloc(device.getTargetModel(),
+                                      device_options.shim_dma_alloc_policy);
       std::map<std::string, std::string> chan_to_chan_map;
 
       // Get the parent launch for this herd to filter memcpy ops
@@ -5961,6 +6192,10 @@ public:
         if (device->hasAttr("segment_unroll_x") ||
             device->hasAttr("segment_unroll_y"))
           removeOrphanedChannels(device);
+        if (failed(verifyChannelDepthForDmaLowering(device))) {
+          signalPassFailure();
+          return;
+        }
         specializeL2MemrefsIntoMemtiles(device);
         allocL1Buffers(device, tileToHerdMap, BufferId);
         allocL2Buffers(device, bufferToMemtileMap, BufferId);
@@ -6105,6 +6340,22 @@ public:
             labelAIRDmaOpsWithMetadataObjFifo(channel_ops, n, chan_to_chan_map);
       }
 
+      // Resident cores need DMAs that loop over their BDs. DMAs with a
+      // repeat count run out after one launch, so such a device is reloaded
+      // between launches instead of being marked persistent.
+      if (device_options.persistent) {
+        bool bdsLoop = true;
+        device.walk([&](AIE::DMAStartOp start) {
+          if (start.getRepeatCount() > 0)
+            bdsLoop = false;
+        });
+        if (bdsLoop)
+          device->setAttr("air.persistent", UnitAttr::get(ctx));
+        else
+          device.emitWarning("DMAs with a repeat count are reset between "
+                             "launches, cores are not kept resident");
+      }
+
       RewritePatternSet patterns(ctx);
       air::WaitAllOp::getCanonicalizationPatterns(patterns, ctx);
       (void)applyPatternsGreedily(device, std::move(patterns));
@@ -6389,6 +6640,7 @@ FailureOr<ModuleOp> convertAIRToAIE(mlir::RewriterBase &rewriter,
       /* .row_offset = */ 2,
       /* .emit_while = */ false,
       /* .emit_herd_lock = */ false,
+      /* .persistent = */ false,
       /* .generate_shim_dma = */ false,
       /* .trace_size = */ 0,
       /* .ctrl_packet = */ false,
@@ -915,8 +915,10 @@ air::TileDMAAllocator::getBuffer(uint64_t, int64_t col, int64_t row,
 
 // ShimDMAAllocator impl.
 
-air::ShimDMAAllocator::ShimDMAAllocator(AIE::DeviceOp device)
-    : air::DMAAllocator(device, air::MemorySpace::L3) {
+air::ShimDMAAllocator::ShimDMAAllocator(AIE::DeviceOp device,
+                                        std::string alloc_policy)
+    : air::DMAAllocator(device, air::MemorySpace::L3),
+      alloc_policy(alloc_policy) {
   const auto &aie_target = device.getTargetModel();
   shim_dma_channels = 2;
   for (int i = 0, e = aie_target.columns(); i < e; i++) {
@@ -945,7 +947,9 @@ FailureOr<air::allocation_info_t> air::ShimDMAAllocator::allocNewDmaChannel(
       return t;
     }
   }
-  AIE::TileOp tile = nullptr;
+  if (alloc_policy == "balanced")
+    return balancedDmaChannelAlloc(memcpyOp, col, row, dma_ops,
+                                   colAllocConstraint);
   int colIdx = 0;
   if (colAllocConstraint == "same_column") {
     // Attempt to use shim dma channels within the same column.
@@ -973,7 +977,7 @@ FailureOr<air::allocation_info_t> air::ShimDMAAllocator::allocNewDmaChannel(
   if (dma_channel >= shim_dma_channels) {
     return memcpyOp.emitOpError("out of shim dma channels.");
   }
-  tile = getPhysTileOp(device, dma_col, 0);
+  auto tile = getPhysTileOp(device, dma_col, 0);
   if (!tile) {
     return memcpyOp.emitOpError(
         "failed to get shim tile for the newly allocated shim dma channel.");
@@ -991,6 +995,78 @@ FailureOr<air::allocation_info_t> air::ShimDMAAllocator::allocNewDmaChannel(
                                                row, dma_ops_get_id);
 }
 
+// Bandwidth-aware shim dma channel allocation: weight the flow by the bytes
+// it moves per launch, and place it on the shim column that minimizes the
+// resulting maximum per-column load. With the "same_column" constraint, ties
+// go to the column nearest to the memtile or core at the other end of the
+// flow; otherwise they go to the lowest column.
+FailureOr<air::allocation_info_t>
+air::ShimDMAAllocator::balancedDmaChannelAlloc(
+    air::MemcpyInterface &memcpyOp, int col, int row,
+    std::vector<Operation *> &dma_ops, std::string colAllocConstraint) {
+  auto isMM2S = isTileOutbound(memcpyOp, dmaMemorySpace);
+  if (failed(isMM2S))
+    return failure();
+  auto allocs = isMM2S.value() ? &mm2s_allocs : &s2mm_allocs;
+  auto &columnBytes = isMM2S.value() ? mm2s_column_bytes : s2mm_column_bytes;
+  AIE::DMAChannelDir dir =
+      isMM2S.value() ? AIE::DMAChannelDir::MM2S : AIE::DMAChannelDir::S2MM;
+
+  // Every flow costs at least one unit, so that flows of unknown size are
+  // still spread across columns.
+  uint64_t bytes = 1;
+  if (auto chanOp =
+          dyn_cast_if_present<air::ChannelInterface>(memcpyOp.getOperation()))
+    bytes = std::max(
+        bytes, air::getStaticChannelTransferBytes(chanOp).value_or(0) *
+                   air::getStaticEnclosingForLoopTripCount(chanOp));
+
+  int bestCol = -1;
+  int bestChannel = -1;
+  uint64_t bestLoad = 0;
+  int bestDistance = 0;
+  for (int dma_col : dma_columns) {
+    int dma_channel = 0;
+    while (dma_channel < shim_dma_channels &&
+           llvm::any_of(*allocs, [&](air::allocation_info_t &a) {
+             return a.foundAlloc(dma_col, 0,
+                                 AIE::DMAChannel{dir, dma_channel});
+           }))
+      dma_channel++;
+    if (dma_channel >= shim_dma_channels)
+      continue;
+    uint64_t load = columnBytes[dma_col] + bytes;
+    int distance =
+        colAllocConstraint == "same_column" ? std::abs(dma_col - col) : 0;
+    if (bestCol != -1 && std::make_pair(load, distance) >=
+                             std::make_pair(bestLoad, bestDistance))
+      continue;
+    bestCol = dma_col;
+    bestChannel = dma_channel;
+    bestLoad = load;
+    bestDistance = distance;
+  }
+  if (bestCol == -1)
+    return memcpyOp->emitOpError(
+        "failed to map to shim dma channels: out of channels.");
+  columnBytes[bestCol] = bestLoad;
+
+  auto tile = getPhysTileOp(device, bestCol, 0);
+  if (!tile) {
+    return memcpyOp.emitOpError(
+        "failed to get shim tile for the newly allocated shim dma channel.");
+  }
+  std::vector<int> dma_ops_get_id;
+  for (auto op : dma_ops) {
+    if (op->hasAttr("id"))
+      dma_ops_get_id.push_back(op->getAttrOfType<IntegerAttr>("id").getInt());
+    else
+      dma_ops_get_id.push_back(-1);
+  }
+  return air::DMAAllocator::allocNewDmaChannel(memcpyOp, tile, bestChannel, col,
+                                               row, dma_ops_get_id);
+}
+
 FailureOr<air::allocation_info_t>
 air::ShimDMAAllocator::allocNewDmaChannel(air::MemcpyInterface &memcpyOp,
                                           air::allocation_info_t existing_alloc,
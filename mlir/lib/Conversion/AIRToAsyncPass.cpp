@@ -191,6 +191,97 @@ public:
   }
 };
 
+// Run the instances of an air.rank concurrently. The rank is lowered to a
+// pool of async.execute workers, worker w running the rank instances w,
+// w + N, w + 2N, ... in order, where N is the number of rank instances or
+// the capacity of the universe the rank is scheduled on, if that is smaller.
+// Rank instances talk to each other through the channels of the process, so
+// a rank whose instances exchange data must not be given a universe smaller
+// than the number of instances that communicate.
+class AIRRankOpConversion : public OpConversionPattern<air::RankOp> {
+public:
+  using OpConversionPattern<air::RankOp>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(air::RankOp rank, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto loc = rank.getLoc();
+    auto sizes = adaptor.getSizes();
+
+    Value c0 = arith::ConstantIndexOp::create(rewriter, loc, 0);
+    Value c1 = arith::ConstantIndexOp::create(rewriter, loc, 1);
+    Value total = c1;
+    for (auto s : sizes)
+      total = arith::MulIOp::create(rewriter, loc, total, s);
+
+    Value workers = total;
+    if (auto universe = adaptor.getUniverse()) {
+      if (auto alloc = universe.getDefiningOp<air::UniverseAllocOp>()) {
+        auto capacity =
+            arith::MaxUIOp::create(rewriter, loc, alloc.getCapacity(), c1);
+        workers = arith::MinUIOp::create(rewriter, loc, total, capacity);
+      }
+    }
+
+    SmallVector<Value> empty;
+    SmallVector<Type> retTy;
+
+    auto rankExeOp = async::ExecuteOp::create(
+        rewriter, loc, retTy, adaptor.getAsyncDependencies(), empty,
+        [&](OpBuilder &r, Location loc, ValueRange v) {
+          auto group = async::CreateGroupOp::create(r, loc, workers);
+          auto pool = scf::ForOp::create(r, loc, c0, workers, c1);
+          pool->setAttr("air.rank", StringAttr::get(r.getContext(), "pool"));
+          r.setInsertionPointToStart(pool.getBody());
+
+          auto workerExeOp = async::ExecuteOp::create(
+              r, loc, retTy, empty, empty,
+              [&](OpBuilder &b, Location loc, ValueRange v) {
+                auto instances = scf::ForOp::create(
+                    b, loc, pool.getInductionVar(), total, workers);
+                instances->setAttr("air.rank",
+                                   StringAttr::get(b.getContext(), "worker"));
+                b.setInsertionPointToStart(instances.getBody());
+
+                // Recover the rank ids, the last dimension varies fastest
+                IRMapping mapper;
+                Value linear = instances.getInductionVar();
+                for (int d = rank.getNumDims() - 1; d >= 0; d--) {
+                  auto id = arith::RemUIOp::create(b, loc, linear, sizes[d]);
+                  linear = arith::DivUIOp::create(b, loc, linear, sizes[d]);
+                  mapper.map(rank.getIds()[d], id);
+                  mapper.map(rank.getSize()[d], sizes[d]);
+                }
+                for (unsigned i = 0; i < rank.getNumKernelOperands(); i++)
+                  mapper.map(rank.getKernelArgument(i),
+                             adaptor.getRankOperands()[i]);
+
+                for (auto &o : rank.getBody().front().getOperations()) {
+                  if (!isa<air::RankTerminatorOp>(o))
+                    b.clone(o, mapper);
+                }
+
+                b.setInsertionPointAfter(instances);
+                async::YieldOp::create(b, loc, empty);
+              });
+          async::AddToGroupOp::create(r, loc, workerExeOp.getResult(0), group);
+
+          r.setInsertionPointAfter(pool);
+          async::AwaitAllOp::create(r, loc, group);
+          async::YieldOp::create(r, loc, empty);
+        });
+
+    rewriter.setInsertionPointAfter(rankExeOp);
+    if (auto t = rank.getAsyncToken())
+      t.replaceAllUsesWith(rankExeOp.getResult(0));
+    else
+      async::AwaitOp::create(rewriter, loc, rankExeOp.getResult(0));
+    rewriter.eraseOp(rank);
+
+    return success();
+  }
+};
+
 static func::CallOp convertOpToFunction(Operation *op, ArrayRef<Value> operands,
                                         ConversionPatternRewriter &rewriter,
                                         StringRef fnName) {
@@ -681,6 +772,10 @@ struct ChannelOpConversion : public OpConversionPattern<air::ChannelOp> {
     if (op->getAttr("broadcast_shape")) {
       globalOp->setAttr("broadcast_shape", op->getAttr("broadcast_shape"));
     }
+    // the runtime allocates depth slots per channel
+    if (op->getAttr("depth")) {
+      globalOp->setAttr("depth", op->getAttr("depth"));
+    }
     return success();
   }
 };
@@ -746,12 +841,16 @@ public:
             rewriter, op->getLoc(), llvm::cast<IntegerAttr>(i).getInt()));
       }
     } else {
-      // if channel is not broadcast, add 1
-      operands.push_back(
-          arith::ConstantIndexOp::create(rewriter, op->getLoc(), 1));
-      operands.push_back(
-          arith::ConstantIndexOp::create(rewriter, op->getLoc(), 1));
+      // if channel is not broadcast, the broadcast shape is its own shape
+      operands.push_back(operands[1]);
+      operands.push_back(operands[2]);
     }
+    // number of transfers the channel holds
+    int64_t depth = 1;
+    if (auto attr = channelOp->getAttrOfType<IntegerAttr>("depth"))
+      depth = attr.getInt();
+    operands.push_back(
+        arith::ConstantIndexOp::create(rewriter, op->getLoc(), depth));
     operands.append(adaptor.getOperands().begin(), adaptor.getOperands().end());
     auto call = convertOpToFunction(op, operands, rewriter, "air_channel_put");
     if (call)
@@ -818,6 +917,22 @@ public:
       signalPassFailure();
     }
 
+    // Lower air.rank ahead of the hierarchy below it, the launches, segments
+    // and herds cloned into the rank workers are lowered by the next phases.
+    target.addIllegalOp<air::RankOp>();
+    RewritePatternSet air_rank_patterns(context);
+    air_rank_patterns.add<AIRRankOpConversion>(context);
+    if (failed(applyPartialConversion(module, target,
+                                      std::move(air_rank_patterns)))) {
+      emitError(UnknownLoc::get(context), "error lowering air.rank\n");
+      signalPassFailure();
+    }
+    // The universes only sized the worker pools
+    module.walk([](air::UniverseAllocOp op) {
+      if (op->use_empty())
+        op->erase();
+    });
+
     // Create a type converter for herd phase that converts air::AsyncTokenType
     TypeConverter herdConverter;
     herdConverter.addConversion([&](Type type) -> std::optional<Type> {
@@ -1181,6 +1181,66 @@ LogicalResult air::RankOp::verify() {
   return success();
 }
 
+//
+// Collective ops
+//
+
+// Checks the world, chunking and reduction of a collective. The number of
+// elements of src times srcScale must match that of dst times dstScale, where
+// a scale of 0 stands for the number of rank instances.
+static LogicalResult verifyCollective(Operation *op, Value src, Value dst,
+                                      int64_t chunks,
+                                      std::optional<StringRef> reduction,
+                                      int64_t srcScale, int64_t dstScale) {
+  auto rank = dyn_cast_if_present<air::RankOp>(
+      op->getParentWithTrait<OpTrait::IsIsolatedFromAbove>());
+  if (!rank)
+    return op->emitOpError("must be nested in the body of an air.rank");
+
+  if (chunks < 1)
+    return op->emitOpError("expects at least one chunk, got ") << chunks;
+  if (reduction && !llvm::is_contained(
+                       ArrayRef<StringRef>{"add", "mul", "max", "min"},
+                       *reduction))
+    return op->emitOpError("unknown reduction '") << *reduction << "'";
+
+  auto srcTy = llvm::cast<MemRefType>(src.getType());
+  auto dstTy = llvm::cast<MemRefType>(dst.getType());
+  if (srcTy.getElementType() != dstTy.getElementType())
+    return op->emitOpError("expects src and dst of the same element type");
+
+  int64_t world = 1;
+  for (auto s : rank.getSizeOperands()) {
+    auto size = getConstantIntValue(s);
+    if (!size)
+      return success();
+    world *= *size;
+  }
+  if (!srcScale)
+    srcScale = world;
+  if (!dstScale)
+    dstScale = world;
+  if (srcTy.getNumElements() * srcScale != dstTy.getNumElements() * dstScale)
+    return op->emitOpError("src and dst sizes do not match a world of ")
+           << world << " rank instances";
+  return success();
+}
+
+LogicalResult air::CollectiveAllReduceOp::verify() {
+  return verifyCollective(*this, getSrc(), getDst(), getChunks(),
+                          getReduction(), 1, 1);
+}
+
+LogicalResult air::CollectiveAllGatherOp::verify() {
+  return verifyCollective(*this, getSrc(), getDst(), getChunks(), std::nullopt,
+                          0, 1);
+}
+
+LogicalResult air::CollectiveReduceScatterOp::verify() {
+  return verifyCollective(*this, getSrc(), getDst(), getChunks(),
+                          getReduction(), 1, 0);
+}
+
 //
 // SegmentOp
 //
@@ -3062,6 +3122,15 @@ void air::ChannelGetOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
 //
 
 LogicalResult air::ChannelOp::verify() {
+  if (auto depth = getOperation()->getAttr("depth")) {
+    auto depthAttr = dyn_cast<IntegerAttr>(depth);
+    if (!depthAttr)
+      return emitOpError() << "expected integer attribute for depth, but found "
+                           << depth;
+    if (depthAttr.getInt() < 1)
+      return emitOpError() << "depth (" << depthAttr.getInt()
+                           << ") must be at least 1";
+  }
   if (isBroadcast()) {
     auto bundle_size = getSize();
     auto broadcast_shape = getBroadcastShape();
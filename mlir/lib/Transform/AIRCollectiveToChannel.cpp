@@ -0,0 +1,329 @@
+//===- AIRCollectiveToChannel.cpp -------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include "air/Transform/AIRCollectiveToChannel.h"
+#include "air/Dialect/AIR/AIRDialect.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "air-collective-to-channel"
+
+using namespace mlir;
+
+namespace xilinx {
+namespace air {
+
+namespace {
+
+// Channel bundle of one collective, one channel per rank instance. It goes
+// after the channels already declared at the top of the module.
+static air::ChannelOp createRingChannel(ModuleOp module, Location loc,
+                                        int64_t world) {
+  std::string name = "collective_0";
+  for (int i = 1; SymbolTable::lookupSymbolIn(module, name); i++)
+    name = "collective_" + std::to_string(i);
+
+  Operation *o = &module.getBody()->front();
+  while (dyn_cast_or_null<air::ChannelOp>(o))
+    o = o->getNextNode();
+  OpBuilder builder(o);
+  return air::ChannelOp::create(builder, loc, name,
+                                builder.getI64ArrayAttr({world, 1}),
+                                builder.getStringAttr("dma_stream"));
+}
+
+static Value flatten(OpBuilder &b, Location loc, Value memref) {
+  auto ty = llvm::cast<MemRefType>(memref.getType());
+  if (ty.getRank() == 1)
+    return memref;
+  SmallVector<ReassociationIndices> reassociation(1);
+  for (int64_t i = 0; i < ty.getRank(); i++)
+    reassociation[0].push_back(i);
+  return memref::CollapseShapeOp::create(b, loc, memref, reassociation);
+}
+
+static Value createReduction(OpBuilder &b, Location loc, StringRef kind,
+                             Value lhs, Value rhs) {
+  if (llvm::isa<FloatType>(lhs.getType())) {
+    if (kind == "mul")
+      return arith::MulFOp::create(b, loc, lhs, rhs);
+    if (kind == "max")
+      return arith::MaximumFOp::create(b, loc, lhs, rhs);
+    if (kind == "min")
+      return arith::MinimumFOp::create(b, loc, lhs, rhs);
+    return arith::AddFOp::create(b, loc, lhs, rhs);
+  }
+  if (kind == "mul")
+    return arith::MulIOp::create(b, loc, lhs, rhs);
+  if (kind == "max")
+    return arith::MaxSIOp::create(b, loc, lhs, rhs);
+  if (kind == "min")
+    return arith::MinSIOp::create(b, loc, lhs, rhs);
+  return arith::AddIOp::create(b, loc, lhs, rhs);
+}
+
+// Ring schedule of one collective over a flat buffer of world blocks. The
+// steps are emitted at the insertion point of the builder.
+class RingSchedule {
+public:
+  RingSchedule(OpBuilder &b, Location loc, air::RankOp rank,
+               air::ChannelOp channel, int64_t world, int64_t blockSize,
+               int64_t chunks)
+      : b(b), loc(loc), channel(channel), world(world), blockSize(blockSize),
+        chunks(chunks), chunkSize(blockSize / chunks) {
+    // Linearized rank id, the last dimension varies fastest
+    rankId = cst(0);
+    for (unsigned d = 0; d < rank.getNumDims(); d++) {
+      rankId = arith::MulIOp::create(b, loc, rankId, rank.getSize()[d]);
+      rankId = arith::AddIOp::create(b, loc, rankId, rank.getIds()[d]);
+    }
+    nextId = arith::RemUIOp::create(
+        b, loc, arith::AddIOp::create(b, loc, rankId, cst(1)), cst(world));
+  }
+
+  // Subview of the block of this rank instance
+  Value ownBlock(Value buf) {
+    SmallVector<OpFoldResult> offsets{
+        arith::MulIOp::create(b, loc, rankId, cst(blockSize)).getResult()};
+    SmallVector<OpFoldResult> sizes{b.getIndexAttr(blockSize)};
+    SmallVector<OpFoldResult> strides{b.getIndexAttr(1)};
+    return memref::SubViewOp::create(b, loc, buf, offsets, sizes, strides);
+  }
+
+  // world - 1 steps that leave every instance with the block of its rank id
+  // reduced over all instances
+  void reduceScatter(Value buf, StringRef reduction) {
+    auto elemTy = llvm::cast<MemRefType>(buf.getType()).getElementType();
+    auto tmp = memref::AllocOp::create(
+        b, loc, MemRefType::get({chunkSize}, elemTy));
+    emitSteps(buf, /*shift=*/1, [&](Value recvOffset) {
+      getChunk(tmp, {});
+      auto loop = scf::ForOp::create(b, loc, cst(0), cst(chunkSize), cst(1));
+      OpBuilder::InsertionGuard guard(b);
+      b.setInsertionPointToStart(loop.getBody());
+      Value i = loop.getInductionVar();
+      Value j = arith::AddIOp::create(b, loc, recvOffset, i);
+      Value acc = memref::LoadOp::create(b, loc, buf, j);
+      Value in = memref::LoadOp::create(b, loc, tmp, i);
+      Value r = createReduction(b, loc, reduction, acc, in);
+      memref::StoreOp::create(b, loc, r, buf, j);
+    });
+    memref::DeallocOp::create(b, loc, tmp);
+  }
+
+  // world - 1 steps that circulate the block every instance owns
+  void allGather(Value buf) {
+    emitSteps(buf, /*shift=*/0,
+              [&](Value recvOffset) { getChunk(buf, recvOffset); });
+  }
+
+private:
+  Value cst(int64_t v) { return arith::ConstantIndexOp::create(b, loc, v); }
+
+  // (rank - step - shift) mod world, for 0 <= step < world - 1 and
+  // shift <= 2
+  Value blockIndex(Value step, int64_t shift) {
+    Value v = arith::AddIOp::create(b, loc, rankId, cst(2 * world - shift));
+    v = arith::SubIOp::create(b, loc, v, step);
+    return arith::RemUIOp::create(b, loc, v, cst(world));
+  }
+
+  Value chunkOffset(Value block, Value chunk) {
+    Value v = arith::MulIOp::create(b, loc, block, cst(blockSize));
+    Value c = arith::MulIOp::create(b, loc, chunk, cst(chunkSize));
+    return arith::AddIOp::create(b, loc, v, c);
+  }
+
+  void putChunk(Value buf, Value offset) {
+    air::ChannelPutOp::create(
+        b, loc, TypeRange{}, ValueRange{},
+        FlatSymbolRefAttr::get(channel.getSymNameAttr()),
+        ValueRange{nextId, cst(0)}, buf, ValueRange{offset},
+        ValueRange{cst(chunkSize)}, ValueRange{cst(1)},
+        /*pad_before=*/nullptr, /*pad_after=*/nullptr);
+  }
+
+  // Gets a chunk into buf at offset, or into all of buf without an offset
+  void getChunk(Value buf, Value offset) {
+    SmallVector<Value> offsets, sizes, strides;
+    if (offset) {
+      offsets.push_back(offset);
+      sizes.push_back(cst(chunkSize));
+      strides.push_back(cst(1));
+    }
+    air::ChannelGetOp::create(b, loc, TypeRange{}, ValueRange{},
+                              FlatSymbolRefAttr::get(channel.getSymNameAttr()),
+                              ValueRange{rankId, cst(0)}, buf, offsets, sizes,
+                              strides, /*pad_before=*/nullptr,
+                              /*pad_after=*/nullptr);
+  }
+
+  // Every step sends block (rank - step - shift) to the next instance chunk
+  // by chunk, and receives block (rank - step - shift - 1) from the previous
+  // one, which recv handles one chunk at a time.
+  void emitSteps(Value buf, int64_t shift,
+                 llvm::function_ref<void(Value)> recv) {
+    if (world == 1)
+      return;
+    auto steps = scf::ForOp::create(b, loc, cst(0), cst(world - 1), cst(1));
+    OpBuilder::InsertionGuard guard(b);
+    b.setInsertionPointToStart(steps.getBody());
+    Value sendBlock = blockIndex(steps.getInductionVar(), shift);
+    Value recvBlock = blockIndex(steps.getInductionVar(), shift + 1);
+    auto chunkLoop = scf::ForOp::create(b, loc, cst(0), cst(chunks), cst(1));
+    b.setInsertionPointToStart(chunkLoop.getBody());
+    putChunk(buf, chunkOffset(sendBlock, chunkLoop.getInductionVar()));
+    recv(chunkOffset(recvBlock, chunkLoop.getInductionVar()));
+  }
+
+  OpBuilder &b;
+  Location loc;
+  air::ChannelOp channel;
+  int64_t world;
+  int64_t blockSize;
+  int64_t chunks;
+  int64_t chunkSize;
+  Value rankId;
+  Value nextId;
+};
+
+static LogicalResult lowerCollective(ModuleOp module, Operation *op) {
+  auto loc = op->getLoc();
+  auto rank = llvm::cast<air::RankOp>(
+      op->getParentWithTrait<OpTrait::IsIsolatedFromAbove>());
+
+  int64_t world = 1;
+  for (auto s : rank.getSizeOperands()) {
+    auto size = getConstantIntValue(s);
+    if (!size)
+      return op->emitOpError("expects an air.rank of constant sizes");
+    world *= *size;
+  }
+
+  Value src, dst;
+  int64_t chunks = 1;
+  StringRef reduction;
+  if (auto allReduce = dyn_cast<air::CollectiveAllReduceOp>(op)) {
+    src = allReduce.getSrc();
+    dst = allReduce.getDst();
+    chunks = allReduce.getChunks();
+    reduction = allReduce.getReduction();
+  } else if (auto allGather = dyn_cast<air::CollectiveAllGatherOp>(op)) {
+    src = allGather.getSrc();
+    dst = allGather.getDst();
+    chunks = allGather.getChunks();
+  } else {
+    auto reduceScatter = cast<air::CollectiveReduceScatterOp>(op);
+    src = reduceScatter.getSrc();
+    dst = reduceScatter.getDst();
+    chunks = reduceScatter.getChunks();
+    reduction = reduceScatter.getReduction();
+  }
+  auto srcTy = llvm::cast<MemRefType>(src.getType());
+  auto dstTy = llvm::cast<MemRefType>(dst.getType());
+  for (auto ty : {srcTy, dstTy})
+    if (!ty.getRank() || !ty.getLayout().isIdentity())
+      return op->emitOpError("expects memrefs of identity layout");
+  auto elemTy = srcTy.getElementType();
+  if (!elemTy.isIntOrFloat())
+    return op->emitOpError("expects integer or float elements");
+
+  int64_t blockSize = isa<air::CollectiveAllGatherOp>(op)
+                          ? srcTy.getNumElements()
+                          : dstTy.getNumElements();
+  if (isa<air::CollectiveAllReduceOp>(op)) {
+    if (blockSize % world)
+      return op->emitOpError("expects a number of elements divisible by the ")
+             << world << " rank instances";
+    blockSize /= world;
+  }
+  if (blockSize % chunks)
+    return op->emitOpError("expects blocks of ")
+           << blockSize << " elements to split into " << chunks << " chunks";
+
+  OpBuilder b(op);
+  auto asyncOp = llvm::cast<air::AsyncOpInterface>(op);
+  if (!asyncOp.getAsyncDependencies().empty())
+    air::WaitAllOp::create(b, loc, Type{}, asyncOp.getAsyncDependencies());
+
+  auto channel = createRingChannel(module, loc, world);
+  RingSchedule ring(b, loc, rank, channel, world, blockSize, chunks);
+
+  if (isa<air::CollectiveAllReduceOp>(op)) {
+    if (src != dst)
+      memref::CopyOp::create(b, loc, src, dst);
+    Value buf = flatten(b, loc, dst);
+    ring.reduceScatter(buf, reduction);
+    ring.allGather(buf);
+  } else if (isa<air::CollectiveAllGatherOp>(op)) {
+    Value buf = flatten(b, loc, dst);
+    memref::CopyOp::create(b, loc, flatten(b, loc, src), ring.ownBlock(buf));
+    ring.allGather(buf);
+  } else {
+    // Reduce in a scratch copy of src, which may be read elsewhere
+    auto scratch = memref::AllocOp::create(
+        b, loc, MemRefType::get({srcTy.getNumElements()}, elemTy));
+    memref::CopyOp::create(b, loc, flatten(b, loc, src), scratch);
+    ring.reduceScatter(scratch, reduction);
+    memref::CopyOp::create(b, loc, ring.ownBlock(scratch),
+                           flatten(b, loc, dst));
+    memref::DeallocOp::create(b, loc, scratch);
+  }
+
+  if (auto token = asyncOp.getAsyncToken()) {
+    auto waitAll = air::WaitAllOp::create(
+        b, loc, air::AsyncTokenType::get(b.getContext()), ValueRange{});
+    token.replaceAllUsesWith(waitAll.getAsyncToken());
+  }
+  op->erase();
+  return success();
+}
+
+struct AIRCollectiveToChannelPass
+    : public air::impl::AIRCollectiveToChannelBase<AIRCollectiveToChannelPass> {
+
+  AIRCollectiveToChannelPass() = default;
+  AIRCollectiveToChannelPass(const AIRCollectiveToChannelPass &pass) {}
+
+  void getDependentDialects(::mlir::DialectRegistry &registry) const override {
+    registry.insert<air::airDialect>();
+    registry.insert<arith::ArithDialect>();
+    registry.insert<memref::MemRefDialect>();
+    registry.insert<scf::SCFDialect>();
+  }
+
+  void runOnOperation() override {
+    auto module = getOperation();
+
+    SmallVector<Operation *> collectives;
+    module.walk([&](Operation *op) {
+      if (isa<air::CollectiveAllReduceOp, air::CollectiveAllGatherOp,
+              air::CollectiveReduceScatterOp>(op))
+        collectives.push_back(op);
+    });
+    for (auto op : collectives)
+      if (failed(lowerCollective(module, op)))
+        return signalPassFailure();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> createAIRCollectiveToChannelPass() {
+  return std::make_unique<AIRCollectiveToChannelPass>();
+}
+
+} // namespace air
+} // namespace xilinx
@@ -2969,6 +2969,237 @@ public:
 private:
 };
 
+// Infer broadcast channels from unicast L2-to-L1 channels whose puts send
+// identical data to every herd tile along a channel dimension.
+class AIRChannelBroadcastDetection
+    : public xilinx::air::impl::AIRChannelBroadcastDetectionBase<
+          AIRChannelBroadcastDetection> {
+
+public:
+  AIRChannelBroadcastDetection() = default;
+  AIRChannelBroadcastDetection(const AIRChannelBroadcastDetection &pass){};
+
+  // Returns true if the value is computed from the herd's tile ids.
+  bool dependsOnHerdIds(Value v, air::HerdOp herd) {
+    SmallVector<Value> worklist{v};
+    llvm::SmallPtrSet<Operation *, 8> visited;
+    while (!worklist.empty()) {
+      Value val = worklist.pop_back_val();
+      if (llvm::is_contained(herd.getIds(), val))
+        return true;
+      Operation *defOp = val.getDefiningOp();
+      if (!defOp || !herd->isProperAncestor(defOp) ||
+          !visited.insert(defOp).second)
+        continue;
+      for (auto oper : defOp->getOperands())
+        worklist.push_back(oper);
+    }
+    return false;
+  }
+
+  bool isEqualIndexValue(Value a, Value b) {
+    return isEqualConstantIntOrValue(getAsOpFoldResult(a),
+                                     getAsOpFoldResult(b));
+  }
+
+  // Two puts send identical data if they read the same memref through the
+  // same access pattern.
+  bool haveIdenticalAccessPattern(air::ChannelInterface a,
+                                  air::ChannelInterface b) {
+    if (a.getMemref() != b.getMemref())
+      return false;
+    if (a->getBlock() != b->getBlock())
+      return false;
+    auto equalRange = [&](OperandRange x, OperandRange y) {
+      return x.size() == y.size() &&
+             llvm::all_of(llvm::zip_equal(x, y), [&](auto pair) {
+               return isEqualIndexValue(std::get<0>(pair), std::get<1>(pair));
+             });
+    };
+    return equalRange(a.getOffsets(), b.getOffsets()) &&
+           equalRange(a.getSizes(), b.getSizes()) &&
+           equalRange(a.getStrides(), b.getStrides());
+  }
+
+  // Returns true if the merged puts could send different data: some op
+  // placed between the first and the last put may write their memref, or a
+  // writer placed before them is waited on by a later put but not by the
+  // first one. Expects the puts in block order.
+  bool mayReadDifferentData(ArrayRef<air::ChannelPutOp> group) {
+    Value memref = group.front().getMemref();
+    auto writesMemref = [&](Operation *op) {
+      return op
+          ->walk([&](Operation *nested) {
+            auto writes = air::getAllWriteAccessedMemrefOperandsFromOp(nested);
+            if (failed(writes) || llvm::any_of(*writes, [&](auto &entry) {
+                  return entry.first == memref;
+                }))
+              return WalkResult::interrupt();
+            return WalkResult::advance();
+          })
+          .wasInterrupted();
+    };
+    Operation *first = group.front();
+    for (Operation &op : *first->getBlock()) {
+      if (&op == group.back().getOperation())
+        break;
+      if (!writesMemref(&op))
+        continue;
+      if (first->isBeforeInBlock(&op))
+        return true;
+      for (auto put : llvm::drop_begin(group))
+        if (air::isAsyncDependent(&op, put) &&
+            !air::isAsyncDependent(&op, first))
+          return true;
+    }
+    return false;
+  }
+
+  // Check that every get is a herd-local L1 write indexed by the herd's tile
+  // id along dimension 'dim', and writes the same local access pattern on
+  // every tile.
+  bool getsSpanDimension(ArrayRef<air::ChannelGetOp> gets, unsigned dim) {
+    for (auto get : gets) {
+      auto herd = get->getParentOfType<air::HerdOp>();
+      if (!herd)
+        return false;
+      auto memrefTy = dyn_cast<BaseMemRefType>(get.getMemref().getType());
+      if (!memrefTy || !air::isL1(memrefTy))
+        return false;
+      if (get.getIndices().size() <= dim ||
+          !llvm::is_contained(herd.getIds(), get.getIndices()[dim]))
+        return false;
+      SmallVector<Value> wraps;
+      llvm::append_range(wraps, get.getOffsets());
+      llvm::append_range(wraps, get.getSizes());
+      llvm::append_range(wraps, get.getStrides());
+      if (llvm::any_of(wraps,
+                       [&](Value v) { return dependsOnHerdIds(v, herd); }))
+        return false;
+    }
+    return true;
+  }
+
+  // Group the puts along 'dim' by their remaining indices. Returns failure
+  // unless every group covers the full dimension with identical data.
+  FailureOr<SmallVector<SmallVector<air::ChannelPutOp>>>
+  getBroadcastGroups(ArrayRef<air::ChannelPutOp> puts,
+                     ArrayRef<int64_t> channelSizes, unsigned dim) {
+    std::map<SmallVector<int64_t>, SmallVector<air::ChannelPutOp>> groups;
+    for (auto put : puts) {
+      if (put.getIndices().size() != channelSizes.size())
+        return failure();
+      auto memrefTy = dyn_cast<BaseMemRefType>(put.getMemref().getType());
+      if (!memrefTy || air::isL1(memrefTy))
+        return failure();
+      SmallVector<int64_t> key;
+      for (auto idx : put.getIndices()) {
+        auto cst = getConstantIntValue(idx);
+        if (!cst)
+          return failure();
+        key.push_back(*cst);
+      }
+      key[dim] = 0;
+      groups[key].push_back(put);
+    }
+    SmallVector<SmallVector<air::ChannelPutOp>> result;
+    for (auto &[key, group] : groups) {
+      if ((int64_t)group.size() != channelSizes[dim])
+        return failure();
+      llvm::SmallSet<int64_t, 4> positions;
+      for (auto put : group)
+        positions.insert(*getConstantIntValue(put.getIndices()[dim]));
+      if ((int64_t)positions.size() != channelSizes[dim])
+        return failure();
+      auto first = cast<air::ChannelInterface>(group.front().getOperation());
+      for (auto put : group)
+        if (!haveIdenticalAccessPattern(
+                first, cast<air::ChannelInterface>(put.getOperation())))
+          return failure();
+      // Keep the first put in the block, so that its token dominates the
+      // wait_alls replacing the others.
+      llvm::stable_sort(group, [](air::ChannelPutOp a, air::ChannelPutOp b) {
+        return a->isBeforeInBlock(b);
+      });
+      if (mayReadDifferentData(group))
+        return failure();
+      result.push_back(group);
+    }
+    return result;
+  }
+
+  void runOnChannel(air::ChannelOp chan) {
+    if (chan.isBroadcast() || chan.getChannelType() == "cascade")
+      return;
+    auto puts = air::getChannelPutOpThroughSymbol(chan);
+    auto gets = air::getChannelGetOpThroughSymbol(chan);
+    if (puts.empty() || gets.empty())
+      return;
+
+    SmallVector<int64_t> bcastShape = extractFromIntegerArrayAttr<int64_t>(
+        chan.getSize());
+    SmallVector<int64_t> channelSizes = bcastShape;
+    OpBuilder builder(chan);
+    uint64_t savedBytes = 0;
+    unsigned mergedPuts = 0;
+    unsigned numPuts = puts.size();
+    for (unsigned dim = 0; dim < channelSizes.size(); dim++) {
+      if (channelSizes[dim] <= 1 || !getsSpanDimension(gets, dim))
+        continue;
+      auto groups = getBroadcastGroups(puts, channelSizes, dim);
+      if (failed(groups))
+        continue;
+      for (auto &group : *groups) {
+        // The kept put sends on position 0 of the collapsed dimension.
+        air::ChannelPutOp kept = group.front();
+        if (getConstantIntValue(kept.getIndices()[dim]) != 0) {
+          builder.setInsertionPoint(kept);
+          kept.getIndicesMutable()[dim].set(
+              arith::ConstantIndexOp::create(builder, kept.getLoc(), 0));
+        }
+        for (auto put : llvm::drop_begin(group)) {
+          auto putIf = cast<air::ChannelInterface>(put.getOperation());
+          savedBytes += air::getStaticChannelTransferBytes(putIf).value_or(0) *
+                        air::getStaticEnclosingForLoopTripCount(put);
+          mergedPuts++;
+          if (air::isAsyncOp(put)) {
+            // Users of the removed put now wait for the data to be sent by
+            // the kept one.
+            IRMapping remap;
+            builder.setInsertionPoint(put);
+            auto waitAll = air::replaceAsyncOpWithWaitAll(builder, remap, put);
+            if (Value token = kept.getAsyncToken())
+              waitAll.addAsyncDependency(token);
+            put.getAsyncToken().replaceAllUsesWith(waitAll.getAsyncToken());
+          }
+          put->erase();
+        }
+      }
+      channelSizes[dim] = 1;
+      puts = air::getChannelPutOpThroughSymbol(chan);
+    }
+    if (!mergedPuts)
+      return;
+
+    chan.setSizeAttr(builder.getI64ArrayAttr(channelSizes));
+    chan->setAttr("broadcast_shape", builder.getI64ArrayAttr(bcastShape));
+    chan.emitRemark("inferred broadcast_shape [")
+        << ArrayRef<int64_t>(bcastShape)
+        << "]: merged " << mergedPuts << " of " << numPuts
+        << " puts, saving " << savedBytes << " bytes of DMA traffic";
+  }
+
+  void runOnOperation() override {
+    auto module = getOperation();
+    SmallVector<air::ChannelOp> channels;
+    module.walk([&](air::ChannelOp chan) { channels.push_back(chan); });
+    for (auto chan : channels)
+      runOnChannel(chan);
+  }
+
+private:
+};
+
 class AIRPruneLinalgGenericInputDma
     : public xilinx::air::impl::AIRPruneLinalgGenericInputDmaBase<
           AIRPruneLinalgGenericInputDma> {
@@ -6923,6 +7154,10 @@ std::unique_ptr<Pass> createAIRBroadcastDetection() {
   return std::make_unique<AIRBroadcastDetection>();
 }
 
+std::unique_ptr<Pass> createAIRChannelBroadcastDetection() {
+  return std::make_unique<AIRChannelBroadcastDetection>();
+}
+
 std::unique_ptr<Pass> createAIRPruneLinalgGenericInputDma() {
   return std::make_unique<AIRPruneLinalgGenericInputDma>();
 }
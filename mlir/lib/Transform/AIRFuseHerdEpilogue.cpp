@@ -0,0 +1,325 @@
+//===- AIRFuseHerdEpilogue.cpp ----------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include "air/Transform/AIRFuseHerdEpilogue.h"
+#include "air/Dialect/AIR/AIRDialect.h"
+#include "air/Util/Util.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "air-fuse-herd-epilogue"
+
+using namespace mlir;
+
+namespace xilinx {
+namespace air {
+
+namespace {
+
+// A linalg op over parallel loops only, with a body of arith and math ops
+static bool isElementwiseLinalg(linalg::LinalgOp op) {
+  if (op.getNumLoops() != op.getNumParallelLoops())
+    return false;
+  return llvm::all_of(op.getBlock()->getOperations(), [](Operation &o) {
+    StringRef dialect = o.getDialect()->getNamespace();
+    return isa<linalg::YieldOp>(o) ||
+           (isPure(&o) && (dialect == "arith" || dialect == "math"));
+  });
+}
+
+// A herd that only moves tiles through L1 buffers and applies elementwise
+// linalg ops to them, e.g. a bias add or an activation
+static bool isElementwiseEpilogue(air::HerdOp herd) {
+  for (Operation &op : herd.getBody().front().without_terminator()) {
+    if (auto alloc = dyn_cast<memref::AllocOp>(op)) {
+      if (!air::isL1(alloc.getType()))
+        return false;
+      continue;
+    }
+    if (isa<memref::DeallocOp, air::DmaMemcpyNdOp>(op) || isPure(&op))
+      continue;
+    auto linalgOp = dyn_cast<linalg::LinalgOp>(op);
+    if (!linalgOp || !isElementwiseLinalg(linalgOp))
+      return false;
+  }
+  return true;
+}
+
+static bool isWholeDst(air::DmaMemcpyNdOp dma) {
+  return dma.getDstOffsets().empty() && dma.getDstSizes().empty() &&
+         dma.getDstStrides().empty();
+}
+
+static bool isWholeSrc(air::DmaMemcpyNdOp dma) {
+  return dma.getSrcOffsets().empty() && dma.getSrcSizes().empty() &&
+         dma.getSrcStrides().empty();
+}
+
+// A herd argument that is only copied from
+static bool isOnlyRead(Value arg) {
+  return llvm::all_of(arg.getUsers(), [&](Operation *user) {
+    auto dma = dyn_cast<air::DmaMemcpyNdOp>(user);
+    return dma && dma.getDstMemref() != arg;
+  });
+}
+
+// The store of a producer's accumulator tile and the load of the same tile
+// by a consumer herd
+struct EpilogueMatch {
+  air::DmaMemcpyNdOp store;
+  air::DmaMemcpyNdOp load;
+};
+
+struct AIRFuseHerdEpiloguePass
+    : public air::impl::AIRFuseHerdEpilogueBase<AIRFuseHerdEpiloguePass> {
+
+  AIRFuseHerdEpiloguePass() = default;
+  AIRFuseHerdEpiloguePass(const AIRFuseHerdEpiloguePass &pass) {}
+
+  void getDependentDialects(::mlir::DialectRegistry &registry) const override {
+    registry.insert<air::airDialect>();
+    registry.insert<memref::MemRefDialect>();
+  }
+
+  // The store in `producer` of an accumulator that a reduction leaves in
+  // L1, after its last iteration
+  air::DmaMemcpyNdOp getAccumulatorStore(Value arg) {
+    air::DmaMemcpyNdOp store;
+    for (Operation *user : arg.getUsers()) {
+      auto dma = dyn_cast<air::DmaMemcpyNdOp>(user);
+      if (!dma)
+        return nullptr;
+      if (dma.getDstMemref() != arg)
+        continue;
+      if (store)
+        return nullptr;
+      store = dma;
+    }
+    if (!store || store->getBlock() != arg.getParentBlock() ||
+        !isWholeSrc(store))
+      return nullptr;
+    // The tile is not read back after it is stored
+    Block *body = store->getBlock();
+    for (Operation *user : arg.getUsers())
+      if (user != store &&
+          !body->findAncestorOpInBlock(*user)->isBeforeInBlock(store))
+        return nullptr;
+
+    Value acc = store.getSrcMemref();
+    auto alloc = acc.getDefiningOp<memref::AllocOp>();
+    if (!alloc || alloc->getBlock() != body || !air::isL1(alloc.getType()))
+      return nullptr;
+    bool reduced = false;
+    for (Operation *user : acc.getUsers()) {
+      Operation *op = body->findAncestorOpInBlock(*user);
+      if (store->isBeforeInBlock(op) && !isa<memref::DeallocOp>(op))
+        return nullptr;
+      auto linalgOp = dyn_cast<linalg::LinalgOp>(user);
+      if (linalgOp && linalgOp.getNumReductionLoops() &&
+          llvm::is_contained(linalgOp.getDpsInits(), acc))
+        reduced = true;
+    }
+    return reduced ? store : nullptr;
+  }
+
+  std::optional<EpilogueMatch> match(air::HerdOp producer,
+                                     air::HerdOp consumer) {
+    if (producer.getAsyncToken() || consumer.getAsyncToken() ||
+        !producer.getAsyncDependencies().empty() ||
+        !consumer.getAsyncDependencies().empty())
+      return std::nullopt;
+    if (!air::isEqualConstantIntOrValues(producer.getSizeOperands(),
+                                         consumer.getSizeOperands()) ||
+        !isElementwiseEpilogue(consumer))
+      return std::nullopt;
+
+    // The consumer's arguments bound to the same operands as the producer's
+    IRMapping map;
+    SmallVector<Value> producerOperands(producer.getKernelOperands());
+    for (unsigned i = 0, e = consumer.getNumKernelOperands(); i < e; i++) {
+      auto it = llvm::find(producerOperands, consumer.getKernelOperand(i));
+      if (it != producerOperands.end())
+        map.map(consumer.getKernelArgument(i),
+                producer.getKernelArgument(it - producerOperands.begin()));
+    }
+
+    Block &body = consumer.getBody().front();
+    for (unsigned i = 0, e = consumer.getNumKernelOperands(); i < e; i++) {
+      Value arg = consumer.getKernelArgument(i);
+      if (!map.contains(arg) || !arg.hasOneUse())
+        continue;
+      auto load = dyn_cast<air::DmaMemcpyNdOp>(*arg.getUsers().begin());
+      if (!load || load.getSrcMemref() != arg || load->getBlock() != &body ||
+          !isWholeDst(load))
+        continue;
+      auto in = load.getDstMemref().getDefiningOp<memref::AllocOp>();
+      if (!in || in->getBlock() != &body)
+        continue;
+      auto store = getAccumulatorStore(map.lookup(arg));
+      if (!store || store.getSrcMemref().getType() != in.getType())
+        continue;
+      if (!air::isEquivalentAcrossHierarchy(load.getSrcOffsets(),
+                                            store.getDstOffsets()) ||
+          !air::isEquivalentAcrossHierarchy(load.getSrcSizes(),
+                                            store.getDstSizes()) ||
+          !air::isEquivalentAcrossHierarchy(load.getSrcStrides(),
+                                            store.getDstStrides())) {
+        LLVM_DEBUG(llvm::dbgs() << "tile mismatch " << load << "\n");
+        continue;
+      }
+      // The tiles of the fused herd no longer wait for each other between
+      // the two, so any other buffer they share must only be read
+      for (unsigned j = 0; j < e; j++) {
+        Value other = consumer.getKernelArgument(j);
+        if (j != i && map.contains(other) &&
+            (!isOnlyRead(other) || !isOnlyRead(map.lookup(other))))
+          return std::nullopt;
+      }
+      return EpilogueMatch{store, load};
+    }
+    return std::nullopt;
+  }
+
+  // Whether the consumer can move up to the producer. The ops in between
+  // must not touch memory, except for allocations, and those defining the
+  // consumer's operands move above the producer with it.
+  bool canHoist(air::HerdOp producer, air::HerdOp consumer) {
+    auto isBetween = [&](Operation *op) {
+      return op && op->getBlock() == producer->getBlock() &&
+             producer->isBeforeInBlock(op);
+    };
+    for (Operation *op = producer->getNextNode(); op != consumer;
+         op = op->getNextNode())
+      if (!isMemoryEffectFree(op) && !isa<memref::AllocOp>(op))
+        return false;
+    for (Value v : consumer->getOperands()) {
+      Operation *def = v.getDefiningOp();
+      if (isBetween(def) && llvm::any_of(def->getOperands(), [&](Value o) {
+            return isBetween(o.getDefiningOp());
+          }))
+        return false;
+    }
+    return true;
+  }
+
+  // Whether the tile stored by the producer may be read by anything but
+  // the epilogue. Any other use of the buffer, such as a view of it that a
+  // later op reads, counts as a read.
+  bool isLiveAfter(Value memref, air::HerdOp producer, air::HerdOp consumer) {
+    if (!memref.getDefiningOp<memref::AllocOp>())
+      return true;
+    return llvm::any_of(memref.getUsers(), [&](Operation *user) {
+      return user != producer && user != consumer &&
+             !isa<memref::DeallocOp>(user);
+    });
+  }
+
+  void fuse(air::HerdOp producer, air::HerdOp consumer, EpilogueMatch m) {
+    Block *block = producer->getBlock();
+    for (Value v : consumer->getOperands()) {
+      Operation *def = v.getDefiningOp();
+      if (def && def->getBlock() == block && producer->isBeforeInBlock(def))
+        def->moveBefore(producer);
+    }
+    Value tile = producer.getTiedKernelOperand(
+        cast<BlockArgument>(m.store.getDstMemref()));
+    bool keepStore = isLiveAfter(tile, producer, consumer);
+
+    // The epilogue reads the accumulator in place of its copy of the tile
+    Value acc = m.store.getSrcMemref();
+    Value in = m.load.getDstMemref();
+    m.load->erase();
+    for (Operation *user : llvm::make_early_inc_range(in.getUsers()))
+      if (isa<memref::DeallocOp>(user))
+        user->erase();
+    in.replaceAllUsesWith(acc);
+    in.getDefiningOp()->erase();
+    if (!keepStore)
+      m.store->erase();
+
+    SmallVector<Value> operands(producer.getKernelOperands());
+    for (Value v : consumer.getKernelOperands())
+      if (!llvm::is_contained(operands, v))
+        operands.push_back(v);
+    OpBuilder b(producer);
+    Location loc = FusedLoc::get(producer.getContext(),
+                                 {producer.getLoc(), consumer.getLoc()});
+    auto herd =
+        air::HerdOp::create(b, loc, ValueRange{}, producer.getSizeOperands(),
+                            operands, false, producer->getAttrs());
+    for (auto from : {producer, consumer}) {
+      SmallVector<Value> args;
+      for (Value v : from.getKernelOperands())
+        args.push_back(herd.getKernelArgument(llvm::find(operands, v) -
+                                              operands.begin()));
+      air::spliceHierarchyBody(from, herd, args);
+    }
+
+    // The accumulator now lives until the end of the epilogue
+    Operation *terminator = herd.getBody().front().getTerminator();
+    for (Operation *user : llvm::make_early_inc_range(acc.getUsers()))
+      if (isa<memref::DeallocOp>(user))
+        user->moveBefore(terminator);
+
+    producer->erase();
+    consumer->erase();
+  }
+
+  // Fuses the first elementwise epilogue found into its producer
+  bool fuseOne(func::FuncOp func) {
+    SmallVector<air::HerdOp> herds;
+    func.walk([&](air::HerdOp herd) { herds.push_back(herd); });
+    for (auto consumer : herds) {
+      for (auto producer : herds) {
+        if (producer == consumer ||
+            producer->getBlock() != consumer->getBlock() ||
+            !producer->isBeforeInBlock(consumer))
+          continue;
+        auto m = match(producer, consumer);
+        if (!m || !canHoist(producer, consumer))
+          continue;
+        uint64_t bytes =
+            air::getAllocatedBytes(producer, air::MemorySpace::L1) +
+            air::getAllocatedBytes(consumer, air::MemorySpace::L1) -
+            air::getMemRefSizeInBytes(
+                cast<MemRefType>(m->load.getDstMemref().getType()));
+        if (bytes > clL1Size) {
+          LLVM_DEBUG(llvm::dbgs() << "not fusing, " << bytes
+                                  << " bytes of L1 needed\n");
+          continue;
+        }
+        fuse(producer, consumer, *m);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void runOnOperation() override {
+    auto func = getOperation();
+    while (fuseOne(func))
+      ;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> createAIRFuseHerdEpiloguePass() {
+  return std::make_unique<AIRFuseHerdEpiloguePass>();
+}
+
+} // namespace air
+} // namespace xilinx
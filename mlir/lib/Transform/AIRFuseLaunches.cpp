@@ -0,0 +1,383 @@
+//===- AIRFuseLaunches.cpp --------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include "air/Transform/AIRFuseLaunches.h"
+#include "air/Dialect/AIR/AIRDialect.h"
+#include "air/Util/Util.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "air-fuse-launches"
+
+using namespace mlir;
+
+namespace xilinx {
+namespace air {
+
+namespace {
+
+// How a launch accesses a memref it gets as a kernel operand
+struct MemrefAccess {
+  bool read = false;
+  bool write = false;
+  // Only moved by air.dma_memcpy_nd ops in herds, which work the same on an
+  // L2 copy of the memref
+  bool herdDmaOnly = true;
+};
+
+// Follows a memref through the hierarchy ops it is passed to
+static void collectAccess(Value memref, bool inHerd, MemrefAccess &access) {
+  for (OpOperand &use : memref.getUses()) {
+    Operation *user = use.getOwner();
+    if (auto hier = dyn_cast<air::HierarchyInterface>(user)) {
+      unsigned first = hier.getKernelOperands().getBeginOperandIndex();
+      if (use.getOperandNumber() >= first) {
+        if (inHerd)
+          access.herdDmaOnly = false;
+        collectAccess(hier.getKernelArgument(use.getOperandNumber() - first),
+                      inHerd || isa<air::HerdOp>(user), access);
+        continue;
+      }
+    }
+    if (auto memcpy = dyn_cast<air::MemcpyInterface>(user)) {
+      if (memcpy.getSrcMemref() == memref)
+        access.read = true;
+      if (memcpy.getDstMemref() == memref)
+        access.write = true;
+      if (!inHerd || !isa<air::DmaMemcpyNdOp>(user))
+        access.herdDmaOnly = false;
+      continue;
+    }
+    // Views, kernel calls and anything else may do both
+    access.read = access.write = true;
+    access.herdDmaOnly = false;
+  }
+}
+
+static llvm::MapVector<Value, MemrefAccess>
+getLaunchAccesses(air::LaunchOp launch) {
+  llvm::MapVector<Value, MemrefAccess> accesses;
+  for (unsigned i = 0, e = launch.getNumKernelOperands(); i < e; i++) {
+    Value oper = launch.getKernelOperand(i);
+    if (isa<BaseMemRefType>(oper.getType()))
+      collectAccess(launch.getKernelArgument(i), false, accesses[oper]);
+  }
+  return accesses;
+}
+
+static bool conflict(const llvm::MapVector<Value, MemrefAccess> &a,
+                     const llvm::MapVector<Value, MemrefAccess> &b) {
+  for (auto &[memref, access] : a) {
+    auto it = b.find(memref);
+    if (it != b.end() && (access.write || it->second.write))
+      return true;
+  }
+  return false;
+}
+
+static bool isOneInstance(OperandRange sizes) {
+  return llvm::all_of(sizes, [](Value v) {
+    auto c = getConstantIntValue(v);
+    return c && *c == 1;
+  });
+}
+
+// Whether every tile of `memref` that the consumer reads is written by the
+// producer in the same launch and segment instance
+static bool readsOwnTiles(Value memref, air::LaunchOp producer,
+                          air::LaunchOp consumer) {
+  SmallVector<air::DmaMemcpyNdOp> writes;
+  producer.walk([&](air::DmaMemcpyNdOp dma) {
+    if (air::getHierarchyArgSource(dma.getDstMemref()) == memref)
+      writes.push_back(dma);
+  });
+  WalkResult result = consumer.walk([&](air::DmaMemcpyNdOp read) {
+    if (air::getHierarchyArgSource(read.getSrcMemref()) != memref)
+      return WalkResult::advance();
+    bool written = llvm::any_of(writes, [&](air::DmaMemcpyNdOp write) {
+      return air::isEquivalentAcrossHierarchy(read.getSrcOffsets(),
+                                              write.getDstOffsets()) &&
+             air::isEquivalentAcrossHierarchy(read.getSrcSizes(),
+                                              write.getDstSizes()) &&
+             air::isEquivalentAcrossHierarchy(read.getSrcStrides(),
+                                              write.getDstStrides());
+    });
+    if (written)
+      return WalkResult::advance();
+    LLVM_DEBUG(llvm::dbgs() << "tile not written by the producer " << read
+                            << "\n");
+    return WalkResult::interrupt();
+  });
+  return !result.wasInterrupted();
+}
+
+// The only segment of a launch whose other ops have no side effects
+static air::SegmentOp getOnlySegment(air::LaunchOp launch) {
+  air::SegmentOp segment;
+  for (Operation &op : launch.getBody().front().without_terminator()) {
+    if (auto s = dyn_cast<air::SegmentOp>(op)) {
+      if (segment)
+        return nullptr;
+      segment = s;
+    } else if (!isMemoryEffectFree(&op)) {
+      return nullptr;
+    }
+  }
+  return segment;
+}
+
+// A function-level L3 buffer that can be replaced by an L2 one in the fused
+// launch: besides the two launches it is only deallocated
+static bool isLocalIntermediate(Value memref, air::LaunchOp producer,
+                                air::LaunchOp consumer) {
+  auto alloc = memref.getDefiningOp<memref::AllocOp>();
+  if (!alloc || !air::isL3(alloc.getType()) ||
+      !alloc.getType().hasStaticShape() ||
+      !alloc.getType().getLayout().isIdentity())
+    return false;
+  return llvm::all_of(memref.getUsers(), [&](Operation *user) {
+    return user == producer || user == consumer ||
+           (isa<memref::DeallocOp>(user) && consumer->isBeforeInBlock(user));
+  });
+}
+
+struct AIRFuseLaunchesPass
+    : public air::impl::AIRFuseLaunchesBase<AIRFuseLaunchesPass> {
+
+  AIRFuseLaunchesPass() = default;
+  AIRFuseLaunchesPass(const AIRFuseLaunchesPass &pass) {}
+
+  void getDependentDialects(::mlir::DialectRegistry &registry) const override {
+    registry.insert<air::airDialect>();
+    registry.insert<memref::MemRefDialect>();
+  }
+
+  // The intermediates through which `consumer` can be fused into `producer`,
+  // empty if the pair cannot be fused
+  SmallVector<Value> getFusibleIntermediates(air::LaunchOp producer,
+                                             air::LaunchOp consumer) {
+    SmallVector<Value> intermediates;
+    if (producer.getAsyncToken() || consumer.getAsyncToken() ||
+        !producer.getAsyncDependencies().empty() ||
+        !consumer.getAsyncDependencies().empty())
+      return {};
+    if (!air::isEqualConstantIntOrValues(producer.getSizeOperands(),
+                                         consumer.getSizeOperands()))
+      return {};
+    air::SegmentOp ps = getOnlySegment(producer);
+    air::SegmentOp cs = getOnlySegment(consumer);
+    if (!ps || !cs ||
+        !air::isEqualConstantIntOrValues(ps.getSizeOperands(),
+                                         cs.getSizeOperands()))
+      return {};
+
+    auto producerAccesses = getLaunchAccesses(producer);
+    auto consumerAccesses = getLaunchAccesses(consumer);
+    for (auto &[memref, access] : producerAccesses) {
+      auto it = consumerAccesses.find(memref);
+      if (it == consumerAccesses.end())
+        continue;
+      const MemrefAccess &use = it->second;
+      if (access.write && !access.read && access.herdDmaOnly && use.read &&
+          !use.write && use.herdDmaOnly &&
+          isLocalIntermediate(memref, producer, consumer))
+        intermediates.push_back(memref);
+    }
+
+    if (intermediates.empty())
+      return {};
+
+    // Every launch and segment instance of the fused launch stages its own
+    // copy of the intermediates, holding only what its producer herds wrote.
+    // A consumer instance may also run before the producer instances of
+    // other ids are done, so the two may share no other buffer that either
+    // of them writes.
+    if (!isOneInstance(producer.getSizeOperands()) ||
+        !isOneInstance(ps.getSizeOperands())) {
+      if (!llvm::all_of(intermediates, [&](Value memref) {
+            return readsOwnTiles(memref, producer, consumer);
+          }))
+        return {};
+      llvm::MapVector<Value, MemrefAccess> shared;
+      for (auto &[memref, access] : producerAccesses)
+        if (!llvm::is_contained(intermediates, memref))
+          shared[memref] = access;
+      if (conflict(shared, consumerAccesses)) {
+        LLVM_DEBUG(llvm::dbgs() << "not fusing, a buffer shared by the "
+                                   "launches is written\n");
+        return {};
+      }
+    }
+
+    // The producer moves down to the consumer, past the ops in between
+    for (Operation *op = producer->getNextNode(); op != consumer;
+         op = op->getNextNode()) {
+      if (isMemoryEffectFree(op))
+        continue;
+      auto launch = dyn_cast<air::LaunchOp>(op);
+      if (!launch || conflict(producerAccesses, getLaunchAccesses(launch))) {
+        LLVM_DEBUG(llvm::dbgs() << "not fusing across " << *op << "\n");
+        return {};
+      }
+    }
+
+    uint64_t bytes = air::getAllocatedBytes(producer, air::MemorySpace::L2) +
+                     air::getAllocatedBytes(consumer, air::MemorySpace::L2);
+    for (Value memref : intermediates) {
+      auto ty = cast<MemRefType>(memref.getType());
+      bytes += air::getTensorVolume(ty) *
+               air::getElementSizeInBytes(ty.getElementType());
+    }
+    if (bytes > clL2Size) {
+      LLVM_DEBUG(llvm::dbgs() << "not fusing, " << bytes
+                              << " bytes of L2 needed\n");
+      return {};
+    }
+    return intermediates;
+  }
+
+  void fuse(air::LaunchOp producer, air::LaunchOp consumer,
+            ArrayRef<Value> intermediates) {
+    MLIRContext *ctx = producer.getContext();
+    Location loc = FusedLoc::get(ctx, {producer.getLoc(), consumer.getLoc()});
+    air::SegmentOp ps = getOnlySegment(producer);
+    air::SegmentOp cs = getOnlySegment(consumer);
+
+    // Kernel operands of the fused launch, without the intermediates
+    SmallVector<Value> operands;
+    for (auto launch : {producer, consumer})
+      for (Value v : launch.getKernelOperands())
+        if (!llvm::is_contained(intermediates, v) &&
+            !llvm::is_contained(operands, v))
+          operands.push_back(v);
+
+    OpBuilder b(consumer);
+    auto launch =
+        air::LaunchOp::create(b, loc, ValueRange{}, producer.getSizeOperands(),
+                              operands, false, producer->getAttrs());
+    for (auto from : {producer, consumer}) {
+      SmallVector<Value> args;
+      for (Value v : from.getKernelOperands()) {
+        auto it = llvm::find(operands, v);
+        args.push_back(it == operands.end()
+                           ? Value()
+                           : launch.getKernelArgument(it - operands.begin()));
+      }
+      air::spliceHierarchyBody(from, launch, args);
+    }
+
+    // The segment operands, the intermediates left as arguments of the
+    // original launches
+    auto intermediateOf = [&](Value v) -> Value {
+      auto arg = dyn_cast<BlockArgument>(v);
+      if (!arg)
+        return nullptr;
+      for (auto from : {producer, consumer})
+        if (arg.getOwner() == &from.getBody().front())
+          return from.getTiedKernelOperand(arg);
+      return nullptr;
+    };
+    SmallVector<Value> segOperands;
+    for (auto from : {ps, cs})
+      for (Value v : from.getKernelOperands())
+        if (!intermediateOf(v) && !llvm::is_contained(segOperands, v))
+          segOperands.push_back(v);
+
+    b.setInsertionPoint(launch.getBody().front().getTerminator());
+    auto segment =
+        air::SegmentOp::create(b, loc, ValueRange{}, ps.getSizeOperands(),
+                               segOperands, false, ps->getAttrs());
+    b.setInsertionPointToStart(&segment.getBody().front());
+    DenseMap<Value, Value> staged;
+    for (Value memref : intermediates) {
+      auto ty = cast<MemRefType>(memref.getType());
+      auto l2Ty = MemRefType::get(
+          ty.getShape(), ty.getElementType(), nullptr,
+          air::MemorySpaceAttr::get(ctx, air::MemorySpace::L2));
+      staged[memref] = memref::AllocOp::create(b, memref.getLoc(), l2Ty);
+    }
+    for (auto from : {ps, cs}) {
+      SmallVector<Value> args;
+      for (auto [v, arg] : llvm::zip_equal(from.getKernelOperands(),
+                                           from.getKernelArguments())) {
+        if (Value memref = intermediateOf(v)) {
+          // The herds now get the L2 buffer
+          Value buf = staged[memref];
+          for (OpOperand &use : arg.getUses()) {
+            auto herd = cast<air::HerdOp>(use.getOwner());
+            unsigned first = herd.getKernelOperands().getBeginOperandIndex();
+            herd.getKernelArgument(use.getOperandNumber() - first)
+                .setType(buf.getType());
+          }
+          args.push_back(buf);
+          continue;
+        }
+        auto it = llvm::find(segOperands, v);
+        args.push_back(segment.getKernelArgument(it - segOperands.begin()));
+      }
+      air::spliceHierarchyBody(from, segment, args);
+    }
+    b.setInsertionPoint(segment.getBody().front().getTerminator());
+    for (Value memref : intermediates)
+      memref::DeallocOp::create(b, memref.getLoc(), staged[memref]);
+
+    ps->erase();
+    cs->erase();
+    producer->erase();
+    consumer->erase();
+    for (Value memref : intermediates) {
+      for (Operation *user : llvm::make_early_inc_range(memref.getUsers()))
+        user->erase();
+      memref.getDefiningOp()->erase();
+    }
+  }
+
+  // Fuses the first fusible pair of launches in the function
+  bool fuseOnePair(func::FuncOp func) {
+    SmallVector<air::LaunchOp> launches;
+    func.walk([&](air::LaunchOp launch) { launches.push_back(launch); });
+    for (auto consumer : launches) {
+      for (auto producer : launches) {
+        if (producer == consumer ||
+            producer->getBlock() != consumer->getBlock() ||
+            !producer->isBeforeInBlock(consumer))
+          continue;
+        SmallVector<Value> intermediates =
+            getFusibleIntermediates(producer, consumer);
+        if (intermediates.empty())
+          continue;
+        fuse(producer, consumer, intermediates);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void runOnOperation() override {
+    auto func = getOperation();
+    while (fuseOnePair(func))
+      ;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> createAIRFuseLaunchesPass() {
+  return std::make_unique<AIRFuseLaunchesPass>();
+}
+
+} // namespace air
+} // namespace xilinx
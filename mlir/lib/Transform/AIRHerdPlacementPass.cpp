@@ -25,10 +25,12 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <numeric>
+#include <random>
 #include <set>
 #include <string>
 #include <vector>
@@ -54,6 +56,16 @@ struct SharedL1Connection {
   Value sharedMemref;
 };
 
+// Represents data moved over air.channel between two herds, or between a herd
+// and an L2/L3 buffer outside of any herd. Herds are referred to by number;
+// -1 marks the buffer end of the transfer.
+struct HerdTraffic {
+  int32_t producer;
+  int32_t consumer;
+  Value buffer;
+  uint64_t bytes;
+};
+
 class Herd {
 
 public:
@@ -152,6 +164,14 @@ public:
     }
   }
 
+  // Free all tiles occupied by the herd
+  void removeHerd(std::unique_ptr<Herd> &herd) {
+    for (auto &row : grid)
+      for (auto &tile : row)
+        if (tile == (int)herd->getNumber())
+          tile = -1;
+  }
+
   void printSegment() const {
     for (uint32_t i = 0; i < grid.size(); i++) {
       for (uint32_t j = 0; j < grid[i].size(); j++) {
@@ -192,6 +212,13 @@ public:
       return;
     }
 
+    if (clPlacementMode != "greedy" && clPlacementMode != "annealing") {
+      getOperation().emitError("Unknown placement mode '")
+          << clPlacementMode << "'. Supported modes: greedy, annealing.";
+      signalPassFailure();
+      return;
+    }
+
     auto module = getOperation();
 
     // Place herds in segments
@@ -228,6 +255,11 @@ public:
       // Analyze shared L1 memref connections
       analyzeSharedL1Connections(part, sharedL1Connections);
 
+      // Analyze channel traffic volumes, used by annealing placement
+      std::vector<HerdTraffic> traffic;
+      if (clPlacementMode == "annealing")
+        analyzeChannelTraffic(part, segmentHerds, traffic);
+
       // If the size and offset attributes of the segment op are set then use
       // them. Otherwise use the values from the command line.
       auto num_rows_op = part.getNumRows();
@@ -243,7 +275,7 @@ public:
           std::make_unique<Segment>(num_rows, num_cols, row_offset, col_offset);
 
       placeHerdsInSegment(segmentHerds, segment, cascadeConnections,
-                          sharedL1Connections);
+                          sharedL1Connections, traffic, part);
 
       auto intTy = IntegerType::get(part->getContext(), 64);
       part->setAttr(part.getRowOffsetAttrName(),
@@ -428,6 +460,80 @@ private:
     }
   }
 
+  // Analyze the bytes moved by air.channel ops within a segment, between pairs
+  // of herds and between herds and L2/L3 buffers. Cascade channels are not
+  // routed through switchboxes and are therefore excluded.
+  void analyzeChannelTraffic(air::SegmentOp segment,
+                             std::vector<std::unique_ptr<Herd>> &herds,
+                             std::vector<HerdTraffic> &traffic) {
+    DenseMap<Operation *, int32_t> herdOpToNumber;
+    for (auto &herd : herds)
+      for (auto herdOp : herd->getHerdOps())
+        herdOpToNumber[herdOp] = herd->getNumber();
+
+    // Get the number of the placed herd containing op, or -1
+    auto getHerdNumber = [&](Operation *op) -> int32_t {
+      auto herdOp = op->getParentOfType<air::HerdOp>();
+      if (!herdOp || !herdOpToNumber.count(herdOp))
+        return -1;
+      return herdOpToNumber[herdOp];
+    };
+
+    // Get the bytes moved by all tiles of the herd over the op's lifetime
+    auto getHerdTransferBytes = [](air::ChannelInterface op) -> uint64_t {
+      auto herdOp = op->getParentOfType<air::HerdOp>();
+      uint64_t bytes = getStaticChannelTransferBytes(op).value_or(
+          getTensorVolume(op.getMemref().getType()) *
+          getElementSizeInBytes(op.getMemref().getType()));
+      return bytes * getStaticEnclosingForLoopTripCount(op, herdOp) *
+             herdOp.getNumCols() * herdOp.getNumRows();
+    };
+
+    auto isCascade = [](air::ChannelInterface op) {
+      auto chanOp = getChannelDeclarationThroughSymbol(op);
+      return chanOp && chanOp.getChannelType() == "cascade";
+    };
+
+    // Herd-to-herd and herd-to-buffer traffic, seen from the producer herd
+    segment.walk([&](air::ChannelPutOp put) {
+      int32_t producer = getHerdNumber(put);
+      auto putIf = cast<air::ChannelInterface>(put.getOperation());
+      if (producer < 0 || isCascade(putIf))
+        return;
+      uint64_t bytes = getHerdTransferBytes(putIf);
+      bool hasBufferEnd = false;
+      for (auto get : getTheOtherChannelOpThroughSymbol(put)) {
+        int32_t consumer = getHerdNumber(get);
+        if (consumer == producer)
+          continue;
+        if (consumer >= 0) {
+          traffic.push_back({producer, consumer, Value(), bytes});
+        } else if (!hasBufferEnd && !get->getParentOfType<air::HerdOp>()) {
+          traffic.push_back({producer, -1, get.getMemref(), bytes});
+          hasBufferEnd = true;
+        }
+      }
+    });
+
+    // Buffer-to-herd traffic, seen from the consumer herd
+    segment.walk([&](air::ChannelGetOp get) {
+      int32_t consumer = getHerdNumber(get);
+      auto getIf = cast<air::ChannelInterface>(get.getOperation());
+      if (consumer < 0 || isCascade(getIf))
+        return;
+      for (auto put : getTheOtherChannelOpThroughSymbol(get)) {
+        if (put->getParentOfType<air::HerdOp>())
+          continue;
+        traffic.push_back(
+            {-1, consumer, put.getMemref(), getHerdTransferBytes(getIf)});
+        break;
+      }
+    });
+
+    LLVM_DEBUG(llvm::dbgs() << "Found " << traffic.size()
+                            << " channel traffic edges\n");
+  }
+
   // Find herd index by name in the herds vector
   int findHerdIdxByName(std::vector<std::unique_ptr<Herd>> &herds,
                         const std::string &name) {
@@ -464,7 +570,9 @@ private:
       std::vector<std::unique_ptr<Herd>> &unplacedHerds,
       std::unique_ptr<Segment> &segment,
       std::vector<CascadeConnection> &cascadeConnections,
-      std::vector<SharedL1Connection> sharedL1Connections = {}) {
+      std::vector<SharedL1Connection> sharedL1Connections = {},
+      std::vector<HerdTraffic> traffic = {},
+      Operation *segmentOp = nullptr) {
 
     std::vector<std::unique_ptr<Herd>> placedHerds;
 
@@ -493,6 +601,11 @@ private:
       return;
     }
 
+    // Refine the greedy placement against the estimated routing cost
+    if (clPlacementMode == "annealing" && segmentOp)
+      annealPlacement(segment, placedHerds, traffic, cascadeConnections,
+                      sharedL1Connections, segmentOp);
+
     auto xLocName = xilinx::air::HerdOp::getColOffsetAttrName();
     auto yLocName = xilinx::air::HerdOp::getRowOffsetAttrName();
 
@@ -1275,6 +1388,234 @@ private:
     return false;
   }
 
+  // Distance between two 1-D spans [lo1, lo1 + size1) and [lo2, lo2 + size2)
+  static int32_t getSpanDistance(int32_t lo1, int32_t size1, int32_t lo2,
+                                 int32_t size2) {
+    return std::max({0, lo2 - (lo1 + size1 - 1), lo1 - (lo2 + size2 - 1)});
+  }
+
+  // Estimate the routing cost of the current placement. Each traffic edge
+  // costs its bytes times the Manhattan hops travelled. An L2/L3 buffer is
+  // modelled as a single memtile/shim port, located one/two rows below the
+  // segment, at the traffic-weighted median column of the herds accessing it.
+  // Stream demand per column beyond the available switchbox ports is
+  // penalized quadratically, weighted by the heaviest traffic edge.
+  uint64_t getRoutingCost(std::unique_ptr<Segment> &segment,
+                          DenseMap<int32_t, Herd *> &herds,
+                          ArrayRef<HerdTraffic> traffic) {
+    // Switchbox ports per column available to north- and south-bound streams
+    const int64_t northPorts = 6;
+    const int64_t southPorts = 4;
+
+    auto getCenterCol = [](Herd *h) {
+      return h->getLocX() + (h->getNumCols() - 1) / 2;
+    };
+
+    // Place each buffer port at the weighted median column of its herds
+    DenseMap<Value, int32_t> bufferCol;
+    {
+      DenseMap<Value, std::vector<std::pair<int32_t, uint64_t>>> bufferUsers;
+      for (auto &t : traffic) {
+        if (!t.buffer)
+          continue;
+        Herd *h = herds[t.producer >= 0 ? t.producer : t.consumer];
+        bufferUsers[t.buffer].push_back({getCenterCol(h), t.bytes});
+      }
+      for (auto &entry : bufferUsers) {
+        auto &users = entry.second;
+        llvm::sort(users);
+        uint64_t total = 0;
+        for (auto &u : users)
+          total += u.second;
+        uint64_t acc = 0;
+        for (auto &u : users) {
+          acc += u.second;
+          if (2 * acc >= total) {
+            bufferCol[entry.first] = u.first;
+            break;
+          }
+        }
+      }
+    }
+
+    uint64_t cost = 0;
+    uint64_t maxBytes = 0;
+    std::vector<int64_t> northDemand(segment->getNumCols(), 0);
+    std::vector<int64_t> southDemand(segment->getNumCols(), 0);
+    for (auto &t : traffic) {
+      maxBytes = std::max(maxBytes, t.bytes);
+      if (t.producer >= 0 && t.consumer >= 0) {
+        Herd *p = herds[t.producer];
+        Herd *c = herds[t.consumer];
+        int64_t hops = getSpanDistance(p->getLocX(), p->getNumCols(),
+                                       c->getLocX(), c->getNumCols()) +
+                       getSpanDistance(p->getLocY(), p->getNumRows(),
+                                       c->getLocY(), c->getNumRows());
+        cost += t.bytes * hops;
+        continue;
+      }
+      bool toHerd = t.producer < 0;
+      Herd *h = herds[toHerd ? t.consumer : t.producer];
+      auto memrefTy = dyn_cast<BaseMemRefType>(t.buffer.getType());
+      int64_t rowsBelow = (memrefTy && air::isL3(memrefTy)) ? 2 : 1;
+      int64_t hops =
+          getSpanDistance(h->getLocX(), h->getNumCols(), bufferCol[t.buffer],
+                          1) +
+          h->getLocY() + rowsBelow;
+      cost += t.bytes * hops;
+      // Every tile of the herd holds one stream through its column
+      for (int32_t col = h->getLocX();
+           col < h->getLocX() + h->getNumCols() && col < segment->getNumCols();
+           col++) {
+        if (toHerd)
+          northDemand[col] += h->getNumRows();
+        else
+          southDemand[col] += h->getNumRows();
+      }
+    }
+
+    for (int32_t col = 0; col < segment->getNumCols(); col++) {
+      int64_t northOverflow =
+          std::max((int64_t)0, northDemand[col] - northPorts);
+      int64_t southOverflow =
+          std::max((int64_t)0, southDemand[col] - southPorts);
+      cost += maxBytes * (northOverflow * northOverflow +
+                          southOverflow * southOverflow);
+    }
+    return cost;
+  }
+
+  // Refine a complete placement by simulated annealing over the estimated
+  // routing cost. Moves either relocate one herd to a random free location,
+  // or swap two herds of the same shape. Cascade and shared L1 neighbors which
+  // are adjacent in the initial placement must stay adjacent. The best
+  // placement seen is kept, and only if it improves on the initial one.
+  void annealPlacement(std::unique_ptr<Segment> &segment,
+                       std::vector<std::unique_ptr<Herd>> &placedHerds,
+                       ArrayRef<HerdTraffic> traffic,
+                       std::vector<CascadeConnection> &cascadeConnections,
+                       std::vector<SharedL1Connection> &sharedL1Connections,
+                       Operation *segmentOp) {
+    DenseMap<int32_t, Herd *> herdByNumber;
+    for (auto &herd : placedHerds)
+      herdByNumber[herd->getNumber()] = herd.get();
+
+    // Neighbor relations satisfied by the initial placement
+    SmallVector<std::pair<Herd *, Herd *>> cascadePairs, l1Pairs;
+    for (auto &conn : cascadeConnections) {
+      Herd *p = findPlacedHerd(placedHerds, conn.producerHerdName);
+      Herd *c = findPlacedHerd(placedHerds, conn.consumerHerdName);
+      if (p && c && areCascadeNeighbors(p, c))
+        cascadePairs.push_back({p, c});
+    }
+    for (auto &conn : sharedL1Connections) {
+      Herd *h1 = findPlacedHerd(placedHerds, conn.herd1Name);
+      Herd *h2 = findPlacedHerd(placedHerds, conn.herd2Name);
+      if (h1 && h2 && areNeighbors(h1, h2))
+        l1Pairs.push_back({h1, h2});
+    }
+    auto neighborsPreserved = [&]() {
+      for (auto &pair : cascadePairs)
+        if (!areCascadeNeighbors(pair.first, pair.second))
+          return false;
+      for (auto &pair : l1Pairs)
+        if (!areNeighbors(pair.first, pair.second))
+          return false;
+      return true;
+    };
+
+    using Locations = std::vector<std::pair<int32_t, int32_t>>;
+    auto getLocations = [&]() {
+      Locations locs;
+      for (auto &herd : placedHerds)
+        locs.push_back({herd->getLocX(), herd->getLocY()});
+      return locs;
+    };
+    auto setLocations = [&](const Locations &locs) {
+      for (auto &herd : placedHerds)
+        segment->removeHerd(herd);
+      for (unsigned i = 0; i < placedHerds.size(); i++) {
+        placedHerds[i]->setLocX(locs[i].first);
+        placedHerds[i]->setLocY(locs[i].second);
+        segment->placeHerd(placedHerds[i], locs[i].second, locs[i].first);
+      }
+    };
+
+    std::mt19937 rng(clAnnealingSeed);
+    auto randomIndex = [&](size_t n) { return (size_t)(rng() % n); };
+
+    // Move one herd to a random legal location
+    auto relocate = [&]() {
+      auto &herd = placedHerds[randomIndex(placedHerds.size())];
+      segment->removeHerd(herd);
+      std::vector<std::pair<int32_t, int32_t>> candidates;
+      for (int32_t y = 0; y < segment->getNumRows(); y++)
+        for (int32_t x = 0; x < segment->getNumCols(); x++)
+          if (segment->isLegalPlacement(herd, y, x))
+            candidates.push_back({x, y});
+      auto loc = candidates[randomIndex(candidates.size())];
+      herd->setLocX(loc.first);
+      herd->setLocY(loc.second);
+      segment->placeHerd(herd, loc.second, loc.first);
+      return true;
+    };
+
+    // Exchange the locations of two herds with the same shape
+    auto swap = [&]() {
+      unsigned i = randomIndex(placedHerds.size());
+      SmallVector<unsigned> sameShape;
+      for (unsigned j = 0; j < placedHerds.size(); j++)
+        if (j != i &&
+            placedHerds[j]->getNumRows() == placedHerds[i]->getNumRows() &&
+            placedHerds[j]->getNumCols() == placedHerds[i]->getNumCols())
+          sameShape.push_back(j);
+      if (sameShape.empty())
+        return false;
+      unsigned j = sameShape[randomIndex(sameShape.size())];
+      auto locs = getLocations();
+      std::swap(locs[i], locs[j]);
+      setLocations(locs);
+      return true;
+    };
+
+    uint64_t initialCost = getRoutingCost(segment, herdByNumber, traffic);
+    uint64_t currentCost = initialCost;
+    uint64_t bestCost = initialCost;
+    Locations initialLocs = getLocations();
+    Locations bestLocs = initialLocs;
+
+    int iterations = std::max(clAnnealingIterations.getValue(), 1);
+    double temperature = std::max(1.0, 0.1 * (double)initialCost);
+    double cooling = std::pow(1e-3, 1.0 / iterations);
+    for (int iter = 0; iter < clAnnealingIterations && !traffic.empty();
+         iter++, temperature *= cooling) {
+      Locations savedLocs = getLocations();
+      bool moved = (rng() % 2) ? swap() : relocate();
+      if (!moved)
+        continue;
+      if (!neighborsPreserved()) {
+        setLocations(savedLocs);
+        continue;
+      }
+      uint64_t newCost = getRoutingCost(segment, herdByNumber, traffic);
+      double delta = (double)newCost - (double)currentCost;
+      double threshold = (double)rng() / (double)std::mt19937::max();
+      if (delta <= 0 || threshold < std::exp(-delta / temperature)) {
+        currentCost = newCost;
+        if (newCost < bestCost) {
+          bestCost = newCost;
+          bestLocs = getLocations();
+        }
+      } else {
+        setLocations(savedLocs);
+      }
+    }
+
+    setLocations(bestCost < initialCost ? bestLocs : initialLocs);
+    segmentOp->emitRemark("estimated routing cost: ")
+        << initialCost << " -> " << std::min(bestCost, initialCost);
+  }
+
   // Performs placement, trying to place the first herd on the anchor point
   // first, moving from left -> right, up a row, then left -> right again. Will
   // try to place each remaining unplaced herd in each open segment tile.
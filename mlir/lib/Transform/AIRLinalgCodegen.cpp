@@ -1042,10 +1042,13 @@ static std::string createChannelName(ModuleOp module) {
 
 // Split a linalg reduction into 'pipeline_depth' consecutive
 // stages, each one feeding partial reductions to the next stage.
-// Stages are mapped to Nx1 or Nx1 herd.
+// Stages are mapped to Nx1 or Nx1 herd. With channel_type "cascade" the
+// partial sums are held in L1 and forwarded over the core-to-core cascade
+// stream, so no DMA or lock is needed between stages.
 FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
     RewriterBase &b, linalg::LinalgOp op, ArrayRef<int64_t> static_tile_sizes,
-    unsigned int pipeline_depth, std::string pipeline_direction, bool promote) {
+    unsigned int pipeline_depth, std::string pipeline_direction, bool promote,
+    std::string channel_type = "dma_stream") {
 
   OpBuilder::InsertionGuard g(b);
   b.setInsertionPoint(op);
@@ -1055,6 +1058,10 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
   if (!(pipeline_direction == "vert" || pipeline_direction == "horiz"))
     return failure();
 
+  if (!(channel_type == "dma_stream" || channel_type == "cascade"))
+    return failure();
+  bool isCascade = channel_type == "cascade";
+
   auto iteratorTypes = op.getIteratorTypesArray();
   if (linalg::isParallelIterator(iteratorTypes.back()))
     return failure();
@@ -1119,14 +1126,23 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
     }
 
   Value firstOutputOperand = tiledOperands[resultIdx];
+  auto outputTy = llvm::cast<MemRefType>(firstOutputOperand.getType());
+  if (isCascade && !outputTy.hasStaticShape())
+    return failure();
+
   SmallVector<air::ChannelOp> channels(pipeline_depth, nullptr);
   for (unsigned int i = 0; i < pipeline_depth; i++) {
     OpBuilder::InsertionGuard pipeline_guard(b);
     bool last_stage = i == pipeline_depth - 1;
     bool first_stage = i == 0;
 
+    // Cascade streams only run west to east and north to south, so a
+    // vertical cascade pipeline starts from the top row.
+    unsigned int stage_pos =
+        (isCascade && !isHoriz) ? pipeline_depth - 1 - i : i;
     SmallVector<AffineExpr, 2> constraints{
-        getAffineDimExpr(isHoriz ? 0 : 1, ctx) - getAffineConstantExpr(i, ctx),
+        getAffineDimExpr(isHoriz ? 0 : 1, ctx) -
+            getAffineConstantExpr(stage_pos, ctx),
         getAffineDimExpr(isHoriz ? 1 : 0, ctx)};
     SmallVector<bool, 2> eqflags{true, false};
     auto int_set = IntegerSet::get(2, 0, constraints, eqflags);
@@ -1137,6 +1153,7 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
     Block *stageBlock = aif.getBody();
     b.setInsertionPointToStart(stageBlock);
 
+    Value cascadeAcc;
     if (i) {
       auto ty = llvm::cast<MemRefType>(tiledOperands[resultIdx].getType());
       auto alloc = memref::AllocOp::create(
@@ -1155,6 +1172,17 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
                                 channel_idx, tiledOperands[resultIdx],
                                 src_offsets, src_sizes, src_strides,
                                 /*pad_before=*/nullptr, /*pad_after=*/nullptr);
+    } else if (isCascade) {
+      // The cascade stream reads from core-local memory, so the first stage
+      // accumulates into an L1 copy of the output tile.
+      auto alloc = memref::AllocOp::create(
+          b, loc,
+          MemRefType::get(
+              outputTy.getShape(), outputTy.getElementType(), AffineMap(),
+              air::MemorySpaceAttr::get(b.getContext(), air::MemorySpace::L1)));
+      memref::CopyOp::create(b, loc, tiledOperands[resultIdx], alloc);
+      tiledOperands[resultIdx] = alloc.getResult();
+      cascadeAcc = alloc.getResult();
     }
 
     linalg::LinalgOp linalgOp = clone(b, op, {}, tiledOperands);
@@ -1168,7 +1196,7 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
     if (promote) {
       SmallVector<int64_t, 3> opers_to_promote(linalgOp->getNumOperands() - 1);
       std::iota(opers_to_promote.begin(), opers_to_promote.end(), 0);
-      if (first_stage /* || last_stage*/)
+      if (first_stage && !isCascade /* || last_stage*/)
         opers_to_promote.push_back(linalgOp->getNumOperands() - 1);
 
       auto emptyCopyCallBack = [](OpBuilder &bldr, Value src,
@@ -1180,7 +1208,7 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
                          .setOperandsToPromote(opers_to_promote)
                          .setAllocationDeallocationFns(allocBufferCallBack,
                                                        deallocBufferCallBack);
-      if (first_stage)
+      if (first_stage && !isCascade)
         options.setCopyInOutFns(defaultCopyCallBack, emptyCopyCallBack);
       auto res = linalg::promoteSubViews(b, linalgOp, options);
       if (failed(res))
@@ -1194,7 +1222,7 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
       b.setInsertionPoint(stageBlock->getTerminator());
     } else {
       auto mref = tiledOperands[resultIdx];
-      if (promote && first_stage) {
+      if (promote && first_stage && !isCascade) {
         memref::SubViewOp sv = dyn_cast_if_present<memref::SubViewOp>(
             linalgOp.getDpsInitOperand(0)->get().getDefiningOp());
         mref = sv.getSource();
@@ -1205,7 +1233,7 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
       auto cname = createChannelName(module);
       b.setInsertionPointToStart(module.getBody());
       auto channel_op = air::ChannelOp::create(
-          b, loc, cname, b.getI64ArrayAttr({1}), b.getStringAttr("dma_stream"));
+          b, loc, cname, b.getI64ArrayAttr({1}), b.getStringAttr(channel_type));
       b.setInsertionPoint(stageBlock->getTerminator());
       SmallVector<Value> src_offsets;
       SmallVector<Value> src_sizes;
@@ -1219,6 +1247,8 @@ FailureOr<linalg::TiledLinalgOp> static pipelineReduceLinalgOp(
                                 /*pad_before=*/nullptr, /*pad_after=*/nullptr);
       channels[i] = channel_op;
     }
+    if (cascadeAcc)
+      memref::DeallocOp::create(b, loc, cascadeAcc);
     // if (erased) erased.erase();
   }
 
@@ -1234,11 +1264,13 @@ struct PipelineReducePattern : public RewritePattern {
       MLIRContext *context, linalg::LinalgTilingOptions options,
       ArrayRef<int64_t> tile_size, int pipeline_depth,
       std::string &pipeline_direction, bool promote,
+      std::string &channel_type,
       LinalgTransformationFilter filter = LinalgTransformationFilter(),
       PatternBenefit benefit = 1)
       : RewritePattern(MatchAnyOpTypeTag(), benefit, context), filter(filter),
         options(options), tile_size(tile_size), pipeline_depth(pipeline_depth),
-        pipeline_direction(pipeline_direction), promote(promote) {}
+        pipeline_direction(pipeline_direction), promote(promote),
+        channel_type(channel_type) {}
 
   LogicalResult matchAndRewrite(Operation *op,
                                 PatternRewriter &rewriter) const override {
@@ -1254,7 +1286,7 @@ struct PipelineReducePattern : public RewritePattern {
 
     auto result =
         pipelineReduceLinalgOp(rewriter, linalgOp, tile_size, pipeline_depth,
-                               pipeline_direction, promote);
+                               pipeline_direction, promote, channel_type);
 
     if (failed(result))
       return failure();
@@ -1272,6 +1304,7 @@ private:
   unsigned int pipeline_depth;
   std::string pipeline_direction;
   bool promote;
+  std::string channel_type;
 };
 
 class AIRPipelineReducePass
@@ -1298,9 +1331,16 @@ void AIRPipelineReducePass::runOnOperation() {
   for (auto &s : clTileSize)
     sizes.push_back(s);
 
+  if (clChannelType != "dma_stream" && clChannelType != "cascade") {
+    func.emitOpError("unsupported channel-type '")
+        << clChannelType << "', expected 'dma_stream' or 'cascade'";
+    signalPassFailure();
+    return;
+  }
+
   patterns.add<PipelineReducePattern>(ctx, linalg::LinalgTilingOptions(), sizes,
                                       clPipelineDepth, clPipelineDirection,
-                                      clPromoteSubViews);
+                                      clPromoteSubViews, clChannelType);
 
   (void)applyPatternsGreedily(func, std::move(patterns));
 }
@@ -1949,7 +1989,8 @@ DiagnosedSilenceableFailure transform::PipelineReduceOp::applyToOne(
     transform::TransformState &state) {
   auto result = xilinx::air::pipelineReduceLinalgOp(
       rewriter, target, extractFromIntegerArrayAttr<int64_t>(getTileSize()),
-      getPipelineDepth(), getDirection().str(), getPromote());
+      getPipelineDepth(), getDirection().str(), getPromote(),
+      getChannelType().str());
   if (failed(result))
     return emitDefiniteFailure() << "Failed";
   results.push_back(result->op);
@@ -0,0 +1,332 @@
+//===- AIRMemoryFootprint.cpp -----------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include "air/Transform/AIRMemoryFootprint.h"
+#include "air/Dialect/AIR/AIRDialect.h"
+#include "air/Util/Dependency.h"
+#include "air/Util/Util.h"
+
+#if AIR_ENABLE_AIE
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#endif
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "air-memory-footprint"
+
+using namespace mlir;
+
+namespace xilinx {
+namespace air {
+
+namespace {
+
+// The buffers live together at the peak of a region, each with the number
+// of copies of it, e.g. one per iteration of an scf.parallel
+struct Footprint {
+  uint64_t bytes = 0;
+  SmallVector<std::pair<memref::AllocOp, uint64_t>> allocs;
+};
+
+// A buffer, or the peak of the buffers local to an op, live from the start
+// of `start` to the end of `end` among the ops of a block. A null `end` is
+// not freed in the block.
+struct LiveRange {
+  Operation *start;
+  Operation *end;
+  Footprint footprint;
+};
+
+// The memref an alloc gives to the rest of the IR, the result of its
+// air.execute if it has one
+static Value getAllocatedMemref(memref::AllocOp alloc) {
+  auto exec = dyn_cast<air::ExecuteOp>(alloc->getParentOp());
+  if (!exec)
+    return alloc.getMemref();
+  Operation *terminator = exec.getBody().getTerminator();
+  for (OpOperand &use : terminator->getOpOperands())
+    if (use.get() == alloc.getMemref())
+      return exec->getResult(use.getOperandNumber() + 1);
+  return alloc.getMemref();
+}
+
+// Number of iterations of an scf.parallel that may run at once, 1 if not
+// constant
+static uint64_t getParallelFactor(Operation *op) {
+  auto par = dyn_cast<scf::ParallelOp>(op);
+  if (!par)
+    return 1;
+  uint64_t factor = 1;
+  for (auto [lb, ub, step] : llvm::zip_equal(
+           par.getLowerBound(), par.getUpperBound(), par.getStep())) {
+    auto l = getConstantIntValue(lb);
+    auto u = getConstantIntValue(ub);
+    auto s = getConstantIntValue(step);
+    if (!l || !u || !s || *s <= 0)
+      return 1;
+    factor *= llvm::divideCeil(*u - *l, *s);
+  }
+  return factor;
+}
+
+// Whether the ops after a synchronous op in its block wait for it. Ops with
+// no memory effects, such as constants and views, do not order anything.
+static bool isBarrier(Operation *op) {
+  if (air::isAsyncOp(op))
+    return false;
+  // Synchronous hierarchy ops, DMAs and waits
+  if (isa_and_nonnull<air::airDialect>(op->getDialect()))
+    return true;
+  return !isMemoryEffectFree(op);
+}
+
+// Peak memory of the allocations in one memory space made directly by a
+// hierarchy op, i.e. not by the hierarchy ops nested in it
+class FootprintAnalysis {
+public:
+  FootprintAnalysis(Operation *owner, air::MemorySpace space)
+      : owner(owner) {
+    owner->walk([&](memref::AllocOp alloc) {
+      auto ty = alloc.getType();
+      bool inSpace = space == air::MemorySpace::L1 ? air::isL1(ty)
+                                                    : air::isL2(ty);
+      if (!inSpace || !ty.hasStaticShape() ||
+          alloc->getParentOfType<air::HierarchyInterface>() != owner)
+        return;
+      Value memref = getAllocatedMemref(alloc);
+      for (Operation *user : memref.getUsers())
+        if (isa<memref::DeallocOp>(user))
+          deallocs[alloc].push_back(user);
+      scopes[getScope(alloc)].push_back(alloc);
+      largest = std::max(largest, air::getMemRefSizeInBytes(ty));
+    });
+  }
+
+  Footprint getPeak() {
+    return getPeak(owner->getRegion(0).front());
+  }
+
+  // The largest single buffer
+  uint64_t largest = 0;
+
+private:
+  // The innermost block holding an alloc and all of its deallocs
+  Block *getScope(memref::AllocOp alloc) {
+    Block *block = alloc->getBlock();
+    while (block->getParentOp() != owner &&
+           llvm::any_of(deallocs[alloc], [&](Operation *d) {
+             return !block->findAncestorOpInBlock(*d);
+           }))
+      block = block->getParentOp()->getBlock();
+    return block;
+  }
+
+  Footprint getPeak(Block &block) {
+    SmallVector<LiveRange> ranges;
+    for (memref::AllocOp alloc : scopes.lookup(&block)) {
+      Operation *end = nullptr;
+      for (Operation *d : deallocs[alloc]) {
+        Operation *op = block.findAncestorOpInBlock(*d);
+        if (!end || end->isBeforeInBlock(op))
+          end = op;
+      }
+      Footprint f;
+      f.bytes = air::getMemRefSizeInBytes(alloc.getType());
+      f.allocs.push_back({alloc, 1});
+      ranges.push_back({block.findAncestorOpInBlock(*alloc), end, f});
+    }
+    // Buffers local to an op count as live while the op runs
+    for (Operation &op : block) {
+      if (isa<air::HierarchyInterface>(op))
+        continue;
+      Footprint inner;
+      for (Region &region : op.getRegions())
+        for (Block &b : region) {
+          Footprint f = getPeak(b);
+          if (f.bytes > inner.bytes)
+            inner = f;
+        }
+      uint64_t factor = getParallelFactor(&op);
+      inner.bytes *= factor;
+      for (auto &entry : inner.allocs)
+        entry.second *= factor;
+      if (inner.bytes)
+        ranges.push_back({&op, &op, inner});
+    }
+    if (ranges.empty())
+      return {};
+
+    // An op runs after another if it waits on its token, directly or not,
+    // or if the other one is a synchronous barrier and comes first
+    DenseMap<Operation *, unsigned> index;
+    SmallVector<llvm::BitVector> after;
+    int lastSync = -1;
+    for (Operation &op : block) {
+      unsigned i = index.size();
+      index[&op] = i;
+      llvm::BitVector preds(block.getOperations().size());
+      if (lastSync >= 0) {
+        preds |= after[lastSync];
+        preds.set(lastSync);
+      }
+      for (Value v : op.getOperands()) {
+        Operation *def = v.getDefiningOp();
+        if (!isa<air::AsyncTokenType>(v.getType()) || !def ||
+            def->getBlock() != &block)
+          continue;
+        preds |= after[index[def]];
+        preds.set(index[def]);
+      }
+      after.push_back(std::move(preds));
+      if (isBarrier(&op))
+        lastSync = i;
+    }
+    auto happensBefore = [&](Operation *a, Operation *b) {
+      return after[index[b]].test(index[a]);
+    };
+
+    // At its peak, a schedule has just allocated some buffer X. The other
+    // live buffers were not allocated after X and not freed before it.
+    Footprint peak;
+    for (LiveRange &x : ranges) {
+      Footprint f;
+      for (LiveRange &y : ranges) {
+        if ((y.end && happensBefore(y.end, x.start)) ||
+            happensBefore(x.start, y.start))
+          continue;
+        f.bytes += y.footprint.bytes;
+        f.allocs.append(y.footprint.allocs);
+      }
+      if (f.bytes > peak.bytes)
+        peak = f;
+    }
+    return peak;
+  }
+
+  Operation *owner;
+  DenseMap<memref::AllocOp, SmallVector<Operation *>> deallocs;
+  DenseMap<Block *, SmallVector<memref::AllocOp>> scopes;
+};
+
+struct AIRMemoryFootprintPass
+    : public air::impl::AIRMemoryFootprintBase<AIRMemoryFootprintPass> {
+
+  AIRMemoryFootprintPass() = default;
+  AIRMemoryFootprintPass(const AIRMemoryFootprintPass &pass) {}
+
+  llvm::json::Object report(Operation *op, FootprintAnalysis &analysis,
+                            uint64_t capacity) {
+    Footprint peak = analysis.getPeak();
+    llvm::json::Object entry;
+    if (auto name =
+            op->getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName()))
+      entry["name"] = name.getValue();
+    entry["capacity"] = capacity;
+    entry["peak"] = peak.bytes;
+    entry["slack"] = (int64_t)capacity - (int64_t)peak.bytes;
+    llvm::json::Array allocs;
+    for (auto [alloc, count] : peak.allocs) {
+      std::string ty;
+      llvm::raw_string_ostream os(ty);
+      os << alloc.getType();
+      uint64_t bytes = count * air::getMemRefSizeInBytes(alloc.getType());
+      allocs.push_back(llvm::json::Object{
+          {"type", ty}, {"count", count}, {"bytes", bytes}});
+    }
+    entry["allocations"] = std::move(allocs);
+    if (peak.bytes > capacity)
+      op->emitWarning() << "peak of " << peak.bytes << " bytes exceeds "
+                        << capacity << " bytes";
+    return entry;
+  }
+
+  void runOnOperation() override {
+    auto module = getOperation();
+
+    uint64_t l1Size = clL1Size;
+    uint64_t memtileSize = clL2Size;
+    if (!clDevice.empty()) {
+#if AIR_ENABLE_AIE
+      auto device = AIE::symbolizeAIEDevice(clDevice);
+      if (!device) {
+        module.emitOpError("Invalid aie.device option");
+        signalPassFailure();
+        return;
+      }
+      const AIE::AIETargetModel &model = AIE::getTargetModel(*device);
+      l1Size = model.getLocalMemorySize();
+      if (model.getNumMemTileRows())
+        memtileSize = model.getMemTileSize();
+#else
+      module.emitWarning("device option ignored, built without AIE support");
+#endif
+    }
+
+    llvm::json::Object top;
+    module.walk([&](func::FuncOp func) {
+      llvm::json::Array segments;
+      func.walk([&](air::SegmentOp segment) {
+        FootprintAnalysis analysis(segment, air::MemorySpace::L2);
+        uint64_t memtiles = segment.getNumCols().value_or(1);
+        auto entry = report(segment, analysis, memtiles * memtileSize);
+        entry["memtiles"] = memtiles;
+        entry["largest_buffer"] = analysis.largest;
+        segments.push_back(std::move(entry));
+      });
+      llvm::json::Array herds;
+      func.walk([&](air::HerdOp herd) {
+        FootprintAnalysis analysis(herd, air::MemorySpace::L1);
+        auto entry = report(herd, analysis, l1Size);
+        entry["num_cols"] = herd.getNumCols();
+        entry["num_rows"] = herd.getNumRows();
+        if (auto x = herd.getColOffset())
+          entry["x_loc"] = *x;
+        if (auto y = herd.getRowOffset())
+          entry["y_loc"] = *y;
+        herds.push_back(std::move(entry));
+      });
+      if (segments.empty() && herds.empty())
+        return;
+      top[func.getSymName()] = llvm::json::Object{
+          {"segments", std::move(segments)}, {"herds", std::move(herds)}};
+    });
+
+    llvm::json::Value json(std::move(top));
+    if (clOutputFile != "-") {
+      std::error_code EC;
+      llvm::raw_fd_ostream os(clOutputFile, EC);
+      if (EC) {
+        module.emitOpError("cannot open ") << clOutputFile;
+        signalPassFailure();
+        return;
+      }
+      os << llvm::formatv("{0:2}", json) << "\n";
+    } else {
+      llvm::outs() << llvm::formatv("{0:2}", json) << "\n";
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> createAIRMemoryFootprintPass() {
+  return std::make_unique<AIRMemoryFootprintPass>();
+}
+
+} // namespace air
+} // namespace xilinx
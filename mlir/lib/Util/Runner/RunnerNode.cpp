@@ -930,6 +930,16 @@ private:
       return 1;
   }
 
+  // Get depth, i.e. the number of transfers each channel holds, from channel
+  // declaration
+  unsigned getDepthFromChannelDeclaration(Operation *op) {
+    auto chan_op = dyn_cast_if_present<air::ChannelInterface>(op);
+    if (!chan_op)
+      return 1;
+    auto chan_declr = getChannelDeclarationThroughSymbol(chan_op);
+    return chan_declr.getDepth();
+  }
+
   // Get the number of dispatches already executed in a dynamically dispatched
   // event
   unsigned getAlreadyDispatchedForDynamicDispatch(std::string chan_name,
@@ -962,9 +972,15 @@ private:
     unsigned already_dispatched = this->getAlreadyDispatchedForDynamicDispatch(
         putOp.getChanName().str(), "put");
 
-    // Check how many remaining evnets need to be dispatched in this op
-    unsigned remaining = total - already_dispatched;
-    return remaining;
+    // Check how many remaining evnets need to be dispatched in this op. Puts
+    // may run up to depth transfers ahead of the gets draining the channel,
+    // one transfer per execution of the op.
+    unsigned depth =
+        this->getDepthFromChannelDeclaration(putOp.getOperation());
+    int remaining = std::min((int)(total - already_dispatched % total),
+                             (int)(depth * total) - (int)already_dispatched);
+    remaining = std::max(remaining, 0);
+    return (unsigned)remaining;
   }
   unsigned getRemainingDispatchesForDynamicDispatch(air::ChannelGetOp getOp) {
     // Only launch runner node holds channel_ops_in_progress cache
@@ -982,7 +998,14 @@ private:
     // Channel broadcast
     unsigned bcast_factor =
         this->getBCastSizeFromChannelDeclaration(getOp.getOperation());
-    int remaining = put_dispatched * bcast_factor - get_dispatched;
+    // One transfer per execution of the op, even if the puts are further
+    // ahead in a channel of depth > 1
+    unsigned total =
+        this->tokenSpatialFactorForResource<air::HierarchyInterface>(
+            getOp.getOperation(), {});
+    int remaining =
+        std::min((int)(put_dispatched * bcast_factor) - (int)get_dispatched,
+                 (int)(total - get_dispatched % total));
     remaining = std::max(remaining, 0);
     return (unsigned)remaining;
   }
@@ -1136,8 +1159,10 @@ private:
     unsigned total_count =
         this->tokenSpatialFactorForResource<air::HierarchyInterface>(op, {});
     if (launch_runner->channel_ops_in_progress.count(key)) {
+      // Complete once a whole transfer is dispatched. In a channel of depth
+      // > 1, earlier transfers may still wait for their gets.
       unsigned processed = launch_runner->channel_ops_in_progress[key].first;
-      if (processed == total_count) {
+      if (processed && processed % total_count == 0) {
         this->processed_vertices.push_back(it);
       }
     } else
@@ -1212,14 +1237,23 @@ private:
       }
     }
 
-    // If data movement is complete, clear put and get progresses
-    if ((put_processed * bcast_factor == total_count) &&
-        (get_processed == total_count)) {
+    // If data movement is complete, retire the transfer from put and get
+    // progresses. Puts of later transfers remain in a channel of depth > 1.
+    if ((put_processed * bcast_factor >= total_count) &&
+        (get_processed >= total_count)) {
       this->processed_vertices.push_back(it);
-      launch_runner->channel_ops_in_progress[get_key].first = 0;
-      launch_runner->channel_ops_in_progress[get_key].second.clear();
-      launch_runner->channel_ops_in_progress[put_key].first = 0;
-      launch_runner->channel_ops_in_progress[put_key].second.clear();
+      auto &get_progress = launch_runner->channel_ops_in_progress[get_key];
+      auto &put_progress = launch_runner->channel_ops_in_progress[put_key];
+      get_progress.first -= total_count;
+      put_progress.first -= total_count / bcast_factor;
+      if (!get_progress.first && !put_progress.first) {
+        get_progress.second.clear();
+        put_progress.second.clear();
+      } else {
+        auto released = [](resource *r) { return !r->isReserved; };
+        llvm::erase_if(get_progress.second, released);
+        llvm::erase_if(put_progress.second, released);
+      }
     }
     // Else if a previous executeOp has already cleared the progresses
     else if (!launch_runner->channel_ops_in_progress[get_key].first &&
@@ -17,6 +17,7 @@
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/IntegerSet.h"
 #include "mlir/IR/Iterators.h"
@@ -238,6 +239,19 @@ uint64_t air::getElementSizeInBytes(const mlir::Type ty) {
     return 0;
 }
 
+uint64_t air::getMemRefSizeInBytes(MemRefType ty) {
+  return getTensorVolume(ty) * getElementSizeInBytes(ty);
+}
+
+uint64_t air::getAllocatedBytes(Operation *op, MemorySpace space) {
+  uint64_t bytes = 0;
+  op->walk([&](memref::AllocOp alloc) {
+    if (getMemorySpace(alloc.getType()) == space)
+      bytes += getMemRefSizeInBytes(alloc.getType());
+  });
+  return bytes;
+}
+
 // Get the parent scf.for op of an iter_arg
 scf::ForOp air::getForRegionIterArgsOwner(Value val) {
   auto ivArg = llvm::dyn_cast_if_present<BlockArgument>(val);
@@ -530,6 +544,44 @@ FailureOr<StringRef> air::getChannelType(air::MemcpyInterface memcpyIfOp) {
   return failure();
 }
 
+// Get the number of bytes moved by one execution of a channel op.
+std::optional<uint64_t>
+air::getStaticChannelTransferBytes(air::ChannelInterface op) {
+  auto memref = op.getMemref();
+  if (!memref)
+    return std::nullopt;
+  auto memrefTy = llvm::dyn_cast<BaseMemRefType>(memref.getType());
+  if (!memrefTy)
+    return std::nullopt;
+  uint64_t elemBytes = getElementSizeInBytes(memrefTy);
+  // Empty sizes list means default data access pattern spanning the entire
+  // memref.
+  if (op.getSizes().empty())
+    return getTensorVolume(memrefTy) * elemBytes;
+  uint64_t volume = 1;
+  for (auto size : op.getSizes()) {
+    auto constSize = getConstantIntValue(size);
+    if (!constSize)
+      return std::nullopt;
+    volume *= *constSize;
+  }
+  return volume * elemBytes;
+}
+
+// Get the product of the static trip counts of all scf.for loops enclosing op.
+uint64_t air::getStaticEnclosingForLoopTripCount(Operation *op,
+                                                 Operation *scope) {
+  uint64_t tripCount = 1;
+  Operation *parent = op->getParentOp();
+  while (parent && parent != scope) {
+    if (auto forOp = dyn_cast<scf::ForOp>(parent))
+      if (auto tc = getStaticScfForTripCountAsInt(forOp))
+        tripCount *= std::max(*tc, (int64_t)1);
+    parent = parent->getParentOp();
+  }
+  return tripCount;
+}
+
 // Get the other channel op through channel symbol
 std::vector<air::ChannelPutOp>
 air::getTheOtherChannelOpThroughSymbol(air::ChannelGetOp get) {
@@ -2275,6 +2327,104 @@ void air::getTopLevelTileableBands(
   }
 }
 
+bool air::isEqualConstantIntOrValues(ValueRange a, ValueRange b) {
+  if (a.size() != b.size())
+    return false;
+  return llvm::all_of(llvm::zip_equal(a, b), [](std::tuple<Value, Value> p) {
+    return isEqualConstantIntOrValue(std::get<0>(p), std::get<1>(p));
+  });
+}
+
+Value air::getHierarchyArgSource(Value v) {
+  while (auto arg = dyn_cast<BlockArgument>(v)) {
+    auto hier =
+        dyn_cast<air::HierarchyInterface>(arg.getOwner()->getParentOp());
+    if (!hier)
+      break;
+    auto sizes = hier.getSize();
+    if (llvm::is_contained(hier.getKernelArguments(), arg))
+      v = hier.getTiedKernelOperand(arg);
+    else if (auto it = llvm::find(sizes, arg); it != sizes.end())
+      v = hier.getSizeOperands()[it - sizes.begin()];
+    else
+      break;
+  }
+  return v;
+}
+
+// Whether `a`, an id of a hierarchy op, is the same dimension of an op of
+// the same kind and grid as `b`
+static bool isSameHierarchyId(BlockArgument a, BlockArgument b) {
+  auto ha = dyn_cast<air::HierarchyInterface>(a.getOwner()->getParentOp());
+  auto hb = dyn_cast<air::HierarchyInterface>(b.getOwner()->getParentOp());
+  if (!ha || !hb || ha->getName() != hb->getName() ||
+      !air::isEqualConstantIntOrValues(ha.getSizeOperands(),
+                                       hb.getSizeOperands()))
+    return false;
+  auto ia = llvm::find(ha.getIds(), a);
+  auto ib = llvm::find(hb.getIds(), b);
+  return ia != ha.getIds().end() && ib != hb.getIds().end() &&
+         ia - ha.getIds().begin() == ib - hb.getIds().begin();
+}
+
+bool air::isEquivalentAcrossHierarchy(Value a, Value b) {
+  a = getHierarchyArgSource(a);
+  b = getHierarchyArgSource(b);
+  if (a == b)
+    return true;
+  auto ca = getConstantIntValue(a);
+  auto cb = getConstantIntValue(b);
+  if (ca || cb)
+    return ca && cb && *ca == *cb;
+  auto aa = dyn_cast<BlockArgument>(a);
+  auto ab = dyn_cast<BlockArgument>(b);
+  if (aa || ab)
+    return aa && ab && isSameHierarchyId(aa, ab);
+  auto ra = cast<OpResult>(a);
+  auto rb = cast<OpResult>(b);
+  if (ra.getResultNumber() != rb.getResultNumber())
+    return false;
+  Operation *opA = ra.getOwner();
+  Operation *opB = rb.getOwner();
+  if (opA->getName() != opB->getName() || !air::isPure(opA) ||
+      opA->getNumRegions() ||
+      opA->getAttrDictionary() != opB->getAttrDictionary())
+    return false;
+  return isEquivalentAcrossHierarchy(opA->getOperands(), opB->getOperands());
+}
+
+bool air::isEquivalentAcrossHierarchy(ValueRange a, ValueRange b) {
+  if (a.size() != b.size())
+    return false;
+  return llvm::all_of(llvm::zip_equal(a, b), [](std::tuple<Value, Value> p) {
+    return isEquivalentAcrossHierarchy(std::get<0>(p), std::get<1>(p));
+  });
+}
+
+void air::spliceHierarchyBody(HierarchyInterface from, HierarchyInterface into,
+                              ArrayRef<Value> args) {
+  for (auto [a, b] : llvm::zip_equal(from.getIds(), into.getIds()))
+    a.replaceAllUsesWith(b);
+  for (auto [a, b] : llvm::zip_equal(from.getSize(), into.getSize()))
+    a.replaceAllUsesWith(b);
+  for (auto [arg, v] : llvm::zip_equal(from.getKernelArguments(), args))
+    if (v)
+      arg.replaceAllUsesWith(v);
+  Block &src = from.getBody().front();
+  Block &dst = into.getBody().front();
+  dst.getOperations().splice(dst.getTerminator()->getIterator(),
+                             src.getOperations(), src.begin(),
+                             src.getTerminator()->getIterator());
+}
+
+std::string air::getSizeVariantName(StringRef funcName,
+                                    ArrayRef<int64_t> sizes) {
+  std::string name = funcName.str();
+  for (int64_t v : sizes)
+    name += "_" + std::to_string(v);
+  return name;
+}
+
 Operation *air::cloneOpAndOperands(RewriterBase &rewriter, IRMapping &remap,
                                    Operation *op,
                                    function_ref<bool(Operation *)> canClone) {
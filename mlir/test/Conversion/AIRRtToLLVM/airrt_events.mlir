@@ -86,3 +86,23 @@ func.func @scf_par() {
   airrt.wait_all %1
   return
 }
+
+// Waits on more than 3 events pass them as an array and a count. The array
+// is freed after the call, so a wait in a loop does not grow the stack.
+
+// CHECK-LABEL: func.func @wide
+// CHECK: %[[STACK:.*]] = llvm.intr.stacksave : !llvm.ptr
+// CHECK: %[[ARRAY:.*]] = llvm.alloca %{{.*}} x !llvm.array<5 x ptr>
+// CHECK-COUNT-5: llvm.store %{{.*}}, %{{.*}} : !llvm.ptr, !llvm.ptr
+// CHECK: %[[N:.*]] = llvm.mlir.constant(5 : i64) : i64
+// CHECK: call @__airrt_wait_all_1_n(%[[ARRAY]], %[[N]]) : (!llvm.ptr, i64) -> !llvm.ptr
+// CHECK-NEXT: llvm.intr.stackrestore %[[STACK]] : !llvm.ptr
+func.func @wide() {
+  %0 = airrt.wait_all : !airrt.event
+  %1 = airrt.wait_all : !airrt.event
+  %2 = airrt.wait_all : !airrt.event
+  %3 = airrt.wait_all : !airrt.event
+  %4 = airrt.wait_all : !airrt.event
+  %5 = airrt.wait_all %0, %1, %2, %3, %4 : !airrt.event
+  return
+}
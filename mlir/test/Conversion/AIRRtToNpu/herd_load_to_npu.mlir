@@ -61,3 +61,36 @@ module {
     return
   }
 }
+
+// -----
+
+// A core built with a herd lock waits for it before every iteration, so the
+// lock is set also for a herd without runtime parameters. A herd without a
+// lock gets no set_lock.
+
+// CHECK-LABEL: module
+// CHECK: aie.device(npu1) @segment_0
+// CHECK: aie.runtime_sequence @func3
+// CHECK-NOT:  aiex.npu.rtp_write
+// CHECK:      aiex.set_lock(%__air_herd_lock_0_2, 1)
+// CHECK-NOT:  aiex.set_lock
+
+module {
+  aie.device(npu1) @segment_0 {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_1_2 = aie.tile(1, 2)
+    %__air_herd_lock_0_2 = aie.lock(%tile_0_2, 0) {init = 0 : i32, sym_name = "__air_herd_lock_0_2"}
+  }
+  airrt.module_metadata {
+    airrt.segment_metadata attributes {sym_name = "segment_0"} {
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 0 : i64, loc_y = 2 : i64, sym_name = "herd_0"}
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 1 : i64, loc_y = 2 : i64, sym_name = "herd_1"}
+    }
+  }
+  func.func @func3() {
+    %p = airrt.segment_load "segment_0" : i64
+    %h0 = airrt.herd_load "herd_0" () {segment_name = "segment_0"} : () -> i64
+    %h1 = airrt.herd_load "herd_1" () {segment_name = "segment_0"} : () -> i64
+    return
+  }
+}
@@ -0,0 +1,135 @@
+//===- overlapped_launches.mlir --------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt -airrt-to-npu -split-input-file %s | FileCheck %s
+
+// Three launches on one device. @b runs on its own herd, channels and
+// buffers, so its DMAs are issued before the waits of @a and waited on only
+// at the end. @c reads the output of @a and waits for it first.
+
+// CHECK-LABEL: aie.device(npu1_1col) @segment_0
+// CHECK: aie.runtime_sequence @overlap
+// CHECK:      %[[A_IN:.*]] = aiex.dma_configure_task_for @a_in
+// CHECK:      aiex.dma_start_task(%[[A_IN]])
+// CHECK:      %[[A_OUT:.*]] = aiex.dma_configure_task_for @a_out
+// CHECK:      aiex.dma_start_task(%[[A_OUT]])
+// CHECK:      %[[B_IN:.*]] = aiex.dma_configure_task_for @b_in
+// CHECK:      aiex.dma_start_task(%[[B_IN]])
+// CHECK:      %[[B_OUT:.*]] = aiex.dma_configure_task_for @b_out
+// CHECK:      aiex.dma_start_task(%[[B_OUT]])
+// CHECK-NEXT: aiex.dma_free_task(%[[A_IN]])
+// CHECK-NEXT: aiex.dma_await_task(%[[A_OUT]])
+// CHECK:      %[[C_IN:.*]] = aiex.dma_configure_task_for @a_in
+// CHECK:      aiex.dma_start_task(%[[C_IN]])
+// CHECK:      %[[C_OUT:.*]] = aiex.dma_configure_task_for @a_out
+// CHECK:      aiex.dma_start_task(%[[C_OUT]])
+// CHECK-NEXT: aiex.dma_free_task(%[[B_IN]])
+// CHECK-NEXT: aiex.dma_await_task(%[[B_OUT]])
+// CHECK-NEXT: aiex.dma_free_task(%[[C_IN]])
+// CHECK-NEXT: aiex.dma_await_task(%[[C_OUT]])
+
+module {
+  aie.device(npu1_1col) @segment_0 {
+    %tile_0_0 = aie.tile(0, 0)
+    aie.shim_dma_allocation @a_in(%tile_0_0, MM2S, 0)
+    aie.shim_dma_allocation @a_out(%tile_0_0, S2MM, 0)
+    aie.shim_dma_allocation @b_in(%tile_0_0, MM2S, 1)
+    aie.shim_dma_allocation @b_out(%tile_0_0, S2MM, 1)
+  }
+  airrt.module_metadata {
+    airrt.segment_metadata attributes {sym_name = "segment_0"} {
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 0 : i64, loc_y = 2 : i64, sym_name = "herd_0"}
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 0 : i64, loc_y = 3 : i64, sym_name = "herd_1"}
+    }
+  }
+  func.func @overlap(%arg0: memref<512xi32>, %arg1: memref<512xi32>, %arg2: memref<512xi32>, %arg3: memref<512xi32>, %arg4: memref<512xi32>) {
+    %c0_i64 = arith.constant 0 : i64
+    %c1_i64 = arith.constant 1 : i64
+    %c512_i64 = arith.constant 512 : i64
+    %c1_i32 = arith.constant 1 : i32
+    %c2_i32 = arith.constant 2 : i32
+
+    // @a: %arg0 -> %arg1 on herd_0
+    affine.for %arg5 = 0 to 1 {
+      %p = airrt.segment_load "segment_0" : i64
+      %h = airrt.herd_load "herd_0" () {segment_name = "segment_0"} : () -> i64
+      %0 = airrt.dma_memcpy_nd(%c1_i32, %c0_i64, %c0_i64, %arg0[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @a_in} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      %1 = airrt.dma_memcpy_nd(%c2_i32, %c0_i64, %c0_i64, %arg1[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @a_out} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %0, %1 {"air.launch_end"}
+    } {affine_opt_label = "tiling"}
+
+    // @b: %arg2 -> %arg3 on herd_1
+    affine.for %arg5 = 0 to 1 {
+      %p = airrt.segment_load "segment_0" : i64
+      %h = airrt.herd_load "herd_1" () {segment_name = "segment_0"} : () -> i64
+      %0 = airrt.dma_memcpy_nd(%c1_i32, %c0_i64, %c0_i64, %arg2[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @b_in} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      %1 = airrt.dma_memcpy_nd(%c2_i32, %c0_i64, %c0_i64, %arg3[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @b_out} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %0, %1 {"air.launch_end"}
+    } {affine_opt_label = "tiling"}
+
+    // @c: %arg1 -> %arg4 on herd_0
+    affine.for %arg5 = 0 to 1 {
+      %p = airrt.segment_load "segment_0" : i64
+      %h = airrt.herd_load "herd_0" () {segment_name = "segment_0"} : () -> i64
+      %0 = airrt.dma_memcpy_nd(%c1_i32, %c0_i64, %c0_i64, %arg1[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @a_in} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      %1 = airrt.dma_memcpy_nd(%c2_i32, %c0_i64, %c0_i64, %arg4[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @a_out} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %0, %1 {"air.launch_end"}
+    } {affine_opt_label = "tiling"}
+    return
+  }
+}
+
+// -----
+
+// Launches on two devices, @add_two, @add_three and @add_two again. The
+// last launch is independent of the second, so both launches of @add_two
+// run in one sequence under a single configuration of the device.
+
+// CHECK: aie.runtime_sequence @add_two_sequence
+// CHECK-COUNT-2: aiex.dma_configure_task_for @air_channel_in_add_two
+// CHECK: aie.runtime_sequence @add_three_sequence
+// CHECK: aie.runtime_sequence @independent
+// CHECK:      aiex.configure @add_two
+// CHECK-NEXT:   aiex.run @add_two_sequence
+// CHECK:      aiex.configure @add_three
+// CHECK-NEXT:   aiex.run @add_three_sequence
+// CHECK-NOT:  aiex.configure
+
+module {
+  aie.device(npu1_1col) @add_two {
+    %tile_0_0 = aie.tile(0, 0)
+    aie.shim_dma_allocation @air_channel_in_add_two(%tile_0_0, MM2S, 0)
+  }
+  aie.device(npu1_1col) @add_three {
+    %tile_0_0 = aie.tile(0, 0)
+    aie.shim_dma_allocation @air_channel_in_add_three(%tile_0_0, MM2S, 0)
+  }
+  airrt.module_metadata {
+  }
+  func.func @independent(%arg0: memref<512xi32>) {
+    %c0_i64 = arith.constant 0 : i64
+    %c1_i64 = arith.constant 1 : i64
+    %c512_i64 = arith.constant 512 : i64
+    %c1_i32 = arith.constant 1 : i32
+    affine.for %arg1 = 0 to 1 {
+      %0 = airrt.dma_memcpy_nd(%c1_i32, %c0_i64, %c0_i64, %arg0[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @air_channel_in_add_two} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %0
+      %p = airrt.segment_load "add_two" : i64
+    } {affine_opt_label = "tiling"}
+    affine.for %arg1 = 0 to 1 {
+      %0 = airrt.dma_memcpy_nd(%c1_i32, %c0_i64, %c0_i64, %arg0[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @air_channel_in_add_three} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %0
+      %p = airrt.segment_load "add_three" : i64
+    } {affine_opt_label = "tiling"}
+    affine.for %arg1 = 0 to 1 {
+      %0 = airrt.dma_memcpy_nd(%c1_i32, %c0_i64, %c0_i64, %arg0[%c0_i64, %c0_i64, %c0_i64, %c0_i64], [%c1_i64, %c1_i64, %c1_i64, %c512_i64], [%c0_i64, %c0_i64, %c0_i64, %c0_i64]) {metadata = @air_channel_in_add_two} : (i32, i64, i64, memref<512xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %0
+      %p = airrt.segment_load "add_two" : i64
+    } {affine_opt_label = "tiling"}
+    return
+  }
+}
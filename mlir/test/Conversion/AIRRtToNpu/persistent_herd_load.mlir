@@ -0,0 +1,87 @@
+//===- persistent_herd_load.mlir -------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt -airrt-to-npu -split-input-file %s | FileCheck %s
+
+// The cores of an air.persistent device keep their RTP buffers across
+// launches. Each launch writes only the runtime parameters that changed and
+// then sets the herd lock, also for herds without runtime parameters.
+
+// CHECK-LABEL: aie.device(npu1) @segment_0
+// CHECK: aie.runtime_sequence @persistent
+// CHECK:      aiex.npu.rtp_write(@__air_herd_rtp_0_2, 0, 5)
+// CHECK-NEXT: aiex.npu.rtp_write(@__air_herd_rtp_0_2, 1, 7)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_0_2, 1)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_1_2, 1)
+// CHECK-NEXT: aiex.npu.rtp_write(@__air_herd_rtp_0_2, 1, 8)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_0_2, 1)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_1_2, 1)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_0_2, 1)
+// CHECK-NOT:  aiex.npu.rtp_write
+// CHECK-NOT:  aiex.npu.load_pdi
+
+module {
+  aie.device(npu1) @segment_0 {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_1_2 = aie.tile(1, 2)
+    %__air_herd_lock_0_2 = aie.lock(%tile_0_2, 0) {init = 0 : i32, sym_name = "__air_herd_lock_0_2"}
+    %__air_herd_rtp_0_2 = aie.buffer(%tile_0_2) {sym_name = "__air_herd_rtp_0_2"} : memref<2xi32>
+    %__air_herd_lock_1_2 = aie.lock(%tile_1_2, 0) {init = 0 : i32, sym_name = "__air_herd_lock_1_2"}
+  } {air.persistent}
+  airrt.module_metadata {
+    airrt.segment_metadata attributes {sym_name = "segment_0"} {
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 0 : i64, loc_y = 2 : i64, sym_name = "herd_0"}
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 1 : i64, loc_y = 2 : i64, sym_name = "herd_1"}
+    }
+  }
+  func.func @persistent() {
+    %c5_i32 = arith.constant 5 : i32
+    %c7_i32 = arith.constant 7 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %p0 = airrt.segment_load "segment_0" : i64
+    %h0 = airrt.herd_load "herd_0" (%c5_i32, %c7_i32) {segment_name = "segment_0"} : (i32, i32) -> i64
+    %h1 = airrt.herd_load "herd_1" () {segment_name = "segment_0"} : () -> i64
+    %p1 = airrt.segment_load "segment_0" : i64
+    %h2 = airrt.herd_load "herd_0" (%c5_i32, %c8_i32) {segment_name = "segment_0"} : (i32, i32) -> i64
+    %h3 = airrt.herd_load "herd_1" () {segment_name = "segment_0"} : () -> i64
+    %p2 = airrt.segment_load "segment_0" : i64
+    %h4 = airrt.herd_load "herd_0" (%c5_i32, %c8_i32) {segment_name = "segment_0"} : (i32, i32) -> i64
+    return
+  }
+}
+
+// -----
+
+// Without air.persistent the parameters are written for every launch.
+
+// CHECK-LABEL: aie.device(npu1) @segment_0
+// CHECK: aie.runtime_sequence @reloaded
+// CHECK:      aiex.npu.rtp_write(@__air_herd_rtp_0_2, 0, 5)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_0_2, 1)
+// CHECK-NEXT: aiex.npu.rtp_write(@__air_herd_rtp_0_2, 0, 5)
+// CHECK-NEXT: aiex.set_lock(%__air_herd_lock_0_2, 1)
+
+module {
+  aie.device(npu1) @segment_0 {
+    %tile_0_2 = aie.tile(0, 2)
+    %__air_herd_lock_0_2 = aie.lock(%tile_0_2, 0) {init = 0 : i32, sym_name = "__air_herd_lock_0_2"}
+    %__air_herd_rtp_0_2 = aie.buffer(%tile_0_2) {sym_name = "__air_herd_rtp_0_2"} : memref<1xi32>
+  }
+  airrt.module_metadata {
+    airrt.segment_metadata attributes {sym_name = "segment_0"} {
+      airrt.herd_metadata {size_x = 1 : i64, size_y = 1 : i64, loc_x = 0 : i64, loc_y = 2 : i64, sym_name = "herd_0"}
+    }
+  }
+  func.func @reloaded() {
+    %c5_i32 = arith.constant 5 : i32
+    %p0 = airrt.segment_load "segment_0" : i64
+    %h0 = airrt.herd_load "herd_0" (%c5_i32) {segment_name = "segment_0"} : (i32) -> i64
+    %p1 = airrt.segment_load "segment_0" : i64
+    %h1 = airrt.herd_load "herd_0" (%c5_i32) {segment_name = "segment_0"} : (i32) -> i64
+    return
+  }
+}
@@ -0,0 +1,98 @@
+//===- size_variants.mlir --------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt -airrt-to-npu -split-input-file -verify-diagnostics %s | FileCheck %s
+
+// The number of row tiles and the row count are runtime arguments. Each
+// size variant gets its own runtime sequence in the same device, with one
+// shim BD per row tile.
+
+// CHECK-LABEL: aie.device(npu1_1col) @segment_0
+// CHECK:  aie.runtime_sequence @dyn_1_8(%[[ARG0:.*]]: memref<16x8xi32>)
+// CHECK:    aiex.dma_configure_task_for @airMemcpyId5 {
+// CHECK:      aie.dma_bd(%[[ARG0]] : memref<16x8xi32>, 0, 64
+// CHECK-NOT:  aiex.dma_configure_task_for
+// CHECK:  aie.runtime_sequence @dyn_2_16(%[[ARG1:.*]]: memref<16x8xi32>)
+// CHECK:    aiex.dma_configure_task_for @airMemcpyId5 {
+// CHECK:      aie.dma_bd(%[[ARG1]] : memref<16x8xi32>, 0, 64
+// CHECK:    aiex.dma_configure_task_for @airMemcpyId5 {
+// CHECK:      aie.dma_bd(%[[ARG1]] : memref<16x8xi32>, 64, 64
+// CHECK-NOT:  aie.runtime_sequence @dyn(
+
+#map = affine_map<(d0) -> (d0 * 8)>
+#min = affine_map<(d0)[s0] -> (8, s0 - d0 * 8)>
+module {
+  aie.device(npu1_1col) {
+    %shim_noc_tile_0_0 = aie.tile(0, 0)
+    aie.shim_dma_allocation @airMemcpyId5(%shim_noc_tile_0_0, MM2S, 0)
+  } {sym_name = "segment_0"}
+  airrt.module_metadata{
+  }
+  func.func @dyn(%arg0: memref<16x8xi32>, %arg1: index, %arg2: index) attributes {air.size_variants = [array<i64: 1, 8>, array<i64: 2, 16>]} {
+    %c8_i64 = arith.constant 8 : i64
+    %c5_i32 = arith.constant 5 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c0_i64 = arith.constant 0 : i64
+    affine.for %arg3 = 0 to %arg1 {
+      %0 = affine.apply #map(%arg3)
+      %1 = affine.min #min(%arg3)[%arg2]
+      %2 = arith.index_cast %0 : index to i64
+      %3 = arith.index_cast %1 : index to i64
+      %4 = airrt.dma_memcpy_nd(%c5_i32, %c0_i64, %c0_i64, %arg0[%c0_i64, %c0_i64, %2, %c0_i64], [%c1_i64, %c1_i64, %3, %c8_i64], [%c0_i64, %c0_i64, %c8_i64, %c1_i64]) {metadata = @airMemcpyId5} : (i32, i64, i64, memref<16x8xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %4
+      %p = airrt.segment_load "segment_0" : i64
+    }
+    return
+  }
+}
+
+// -----
+
+// The last row tile of 13 rows is cut to 5 rows, which the memtile and core
+// BDs compiled for full tiles would wait on forever.
+
+#map = affine_map<(d0) -> (d0 * 8)>
+#min = affine_map<(d0)[s0] -> (8, s0 - d0 * 8)>
+module {
+  aie.device(npu1_1col) {
+    %shim_noc_tile_0_0 = aie.tile(0, 0)
+    aie.shim_dma_allocation @airMemcpyId5(%shim_noc_tile_0_0, MM2S, 0)
+  } {sym_name = "segment_0"}
+  airrt.module_metadata{
+  }
+  // expected-error@+1 {{transfers 40 elements through @airMemcpyId5, but the device is compiled for 64; size variants must be multiples of the tile size}}
+  func.func @dyn(%arg0: memref<16x8xi32>, %arg1: index, %arg2: index) attributes {air.size_variants = [array<i64: 1, 8>, array<i64: 2, 13>]} {
+    %c8_i64 = arith.constant 8 : i64
+    %c5_i32 = arith.constant 5 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c0_i64 = arith.constant 0 : i64
+    affine.for %arg3 = 0 to %arg1 {
+      %0 = affine.apply #map(%arg3)
+      %1 = affine.min #min(%arg3)[%arg2]
+      %2 = arith.index_cast %0 : index to i64
+      %3 = arith.index_cast %1 : index to i64
+      %4 = airrt.dma_memcpy_nd(%c5_i32, %c0_i64, %c0_i64, %arg0[%c0_i64, %c0_i64, %2, %c0_i64], [%c1_i64, %c1_i64, %3, %c8_i64], [%c0_i64, %c0_i64, %c8_i64, %c1_i64]) {metadata = @airMemcpyId5} : (i32, i64, i64, memref<16x8xi32>, [i64, i64, i64, i64], [i64, i64, i64, i64], [i64, i64, i64, i64]) : !airrt.event
+      airrt.wait_all %4
+      %p = airrt.segment_load "segment_0" : i64
+    }
+    return
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_1col) {
+    %shim_noc_tile_0_0 = aie.tile(0, 0)
+  } {sym_name = "segment_0"}
+  airrt.module_metadata{
+  }
+  // expected-error@+1 {{expected 2 values per size variant}}
+  func.func @bad(%arg0: memref<16x8xi32>, %arg1: index, %arg2: i32) attributes {air.size_variants = [array<i64: 1>]} {
+    return
+  }
+}
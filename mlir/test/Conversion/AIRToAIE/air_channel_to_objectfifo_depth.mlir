@@ -1,4 +1,4 @@
-//===- air_channel_to_objectfifo_buffer_resources.mlir --------------------*- MLIR -*-===//
+//===- air_channel_to_objectfifo_depth.mlir --------------------*- MLIR -*-===//
 //
 // Copyright (C) 2022, Advanced Micro Devices, Inc.
 // SPDX-License-Identifier: MIT
@@ -36,7 +36,7 @@ aie.device(xcvc1902) {
   %0 = aie.tile(1, 1)
   %1 = aie.tile(1, 2)
   air.channel @channel_0 [1, 1]
-  air.channel @channel_1 [1, 1] {buffer_resources = 2}
+  air.channel @channel_1 [1, 1] {depth = 2}
   %2 = aie.core(%1) {
     %c32 = arith.constant 32 : index
     %c0 = arith.constant 0 : index
@@ -90,7 +90,7 @@ aie.device(xcvc1902) {
   %0 = aie.tile(1, 1)
   %1 = aie.tile(1, 2)
   air.channel @channel_0 [1, 1]
-  air.channel @channel_1 [1, 1] {buffer_resources = 2}
+  air.channel @channel_1 [1, 1] {depth = 2}
   %2 = aie.core(%1) {
     %c32 = arith.constant 32 : index
     %c0 = arith.constant 0 : index
@@ -0,0 +1,178 @@
+//===- auto_packet_flow.mlir -----------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-to-aie='row-offset=2 col-offset=0 device=npu2 auto-packet-flow=true' -split-input-file | FileCheck %s
+// RUN: air-opt %s -air-to-aie='row-offset=2 col-offset=0 device=npu2' -split-input-file | FileCheck %s --check-prefix=DEFAULT
+
+// @chan_heavy moves 8 x 128 bytes per launch and keeps its circuit-switched
+// flow. @chan_light moves 128 bytes, below 25% of the heaviest channel, and is
+// merged onto a packet-switched route.
+
+// CHECK-LABEL: aie.device(npu2) @segment_0
+// CHECK-DAG:   aie.flow(%{{.*}}, DMA : {{[0-9]+}}, %{{.*}}, DMA : {{[0-9]+}})
+// CHECK-DAG:   aie.packet_flow(0)
+// CHECK-NOT:   aie.packet_flow(1)
+
+// DEFAULT-LABEL: aie.device(npu2) @segment_0
+// DEFAULT-NOT:   aie.packet_flow
+
+module {
+  air.channel @chan_heavy [1, 1]
+  air.channel @chan_light [1, 1]
+
+  func.func @auto_packet_flow(%arg0: memref<128xbf16>) {
+    %0 = air.launch async () in () args(%input=%arg0) : memref<128xbf16> attributes {id = 1 : i32} {
+      %segment = air.segment @segment_0 async attributes {id = 2 : i32, x_loc = 0 : i64, x_size = 4 : i64, y_loc = 2 : i64, y_size = 4 : i64} {
+        %c0_seg = arith.constant 0 : index
+        %c1_seg = arith.constant 1 : index
+        %c8_seg = arith.constant 8 : index
+        %l2_buf_a = memref.alloc() : memref<64xbf16, 1>
+        %l2_buf_b = memref.alloc() : memref<64xbf16, 1>
+
+        scf.for %i = %c0_seg to %c8_seg step %c1_seg {
+          air.channel.put @chan_heavy[] (%l2_buf_a[] [] []) {id = 1 : i32} : (memref<64xbf16, 1>)
+        }
+        %put_b = air.channel.put async @chan_light[] (%l2_buf_b[] [] []) {id = 2 : i32} : (memref<64xbf16, 1>)
+
+        %herd = air.herd @herd_0 async [%put_b] tile (%tx, %ty) in (%htx=%c1_seg, %hty=%c1_seg) attributes {id = 3 : i32} {
+          %c0 = arith.constant 0 : index
+          %c1 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %async_token_a, %l1_buf_a = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          %async_token_b, %l1_buf_b = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          scf.for %i = %c0 to %c8 step %c1 {
+            air.channel.get @chan_heavy[] (%l1_buf_a[] [] []) {id = 3 : i32} : (memref<64xbf16, 2>)
+          }
+          %get_b = air.channel.get async [%async_token_b] @chan_light[] (%l1_buf_b[] [] []) {id = 4 : i32} : (memref<64xbf16, 2>)
+          %dealloc_a = air.execute [%async_token_a] {
+            memref.dealloc %l1_buf_a : memref<64xbf16, 2>
+          }
+          %dealloc_b = air.execute [%get_b] {
+            memref.dealloc %l1_buf_b : memref<64xbf16, 2>
+          }
+        }
+
+        memref.dealloc %l2_buf_a : memref<64xbf16, 1>
+        memref.dealloc %l2_buf_b : memref<64xbf16, 1>
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// @chan_a and @chan_b move the same number of bytes, so neither is
+// low-bandwidth. The get of @chan_b waits on the get of @chan_a, so the two
+// channels never stream at the same time and are merged onto packet-switched
+// routes with distinct packet ids.
+
+// CHECK-LABEL: aie.device(npu2) @segment_tm
+// CHECK-DAG:   aie.packet_flow(0)
+// CHECK-DAG:   aie.packet_flow(1)
+// CHECK-NOT:   aie.flow(
+
+// DEFAULT-LABEL: aie.device(npu2) @segment_tm
+// DEFAULT-NOT:   aie.packet_flow
+
+module {
+  air.channel @chan_a [1, 1]
+  air.channel @chan_b [1, 1]
+
+  func.func @time_multiplexed(%arg0: memref<64xbf16>) {
+    %0 = air.launch async () in () args(%input=%arg0) : memref<64xbf16> attributes {id = 1 : i32} {
+      %segment = air.segment @segment_tm async attributes {id = 2 : i32, x_loc = 0 : i64, x_size = 4 : i64, y_loc = 2 : i64, y_size = 4 : i64} {
+        %c1_seg = arith.constant 1 : index
+        %l2_buf_a = memref.alloc() : memref<64xbf16, 1>
+        %l2_buf_b = memref.alloc() : memref<64xbf16, 1>
+        %put_a = air.channel.put async @chan_a[] (%l2_buf_a[] [] []) {id = 1 : i32} : (memref<64xbf16, 1>)
+        %put_b = air.channel.put async @chan_b[] (%l2_buf_b[] [] []) {id = 2 : i32} : (memref<64xbf16, 1>)
+
+        %herd = air.herd @herd_0 async [%put_a, %put_b] tile (%tx, %ty) in (%htx=%c1_seg, %hty=%c1_seg) attributes {id = 3 : i32} {
+          %async_token_a, %l1_buf_a = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          %async_token_b, %l1_buf_b = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          %get_a = air.channel.get async [%async_token_a] @chan_a[] (%l1_buf_a[] [] []) {id = 3 : i32} : (memref<64xbf16, 2>)
+          %get_b = air.channel.get async [%async_token_b, %get_a] @chan_b[] (%l1_buf_b[] [] []) {id = 4 : i32} : (memref<64xbf16, 2>)
+          %dealloc_a = air.execute [%get_a] {
+            memref.dealloc %l1_buf_a : memref<64xbf16, 2>
+          }
+          %dealloc_b = air.execute [%get_b] {
+            memref.dealloc %l1_buf_b : memref<64xbf16, 2>
+          }
+        }
+
+        memref.dealloc %l2_buf_a : memref<64xbf16, 1>
+        memref.dealloc %l2_buf_b : memref<64xbf16, 1>
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// Same channels, but the two gets only wait on their own buffers and may
+// stream at the same time. Both keep their circuit-switched flows.
+
+// CHECK-LABEL: aie.device(npu2) @segment_overlap
+// CHECK-COUNT-2: aie.flow(%{{.*}}, DMA : {{[0-9]+}}, %{{.*}}, DMA : {{[0-9]+}})
+// CHECK-NOT:   aie.packet_flow
+
+// DEFAULT-LABEL: aie.device(npu2) @segment_overlap
+// DEFAULT-NOT:   aie.packet_flow
+
+module {
+  air.channel @chan_a [1, 1]
+  air.channel @chan_b [1, 1]
+
+  func.func @overlapping(%arg0: memref<64xbf16>) {
+    %0 = air.launch async () in () args(%input=%arg0) : memref<64xbf16> attributes {id = 1 : i32} {
+      %segment = air.segment @segment_overlap async attributes {id = 2 : i32, x_loc = 0 : i64, x_size = 4 : i64, y_loc = 2 : i64, y_size = 4 : i64} {
+        %c1_seg = arith.constant 1 : index
+        %l2_buf_a = memref.alloc() : memref<64xbf16, 1>
+        %l2_buf_b = memref.alloc() : memref<64xbf16, 1>
+        %put_a = air.channel.put async @chan_a[] (%l2_buf_a[] [] []) {id = 1 : i32} : (memref<64xbf16, 1>)
+        %put_b = air.channel.put async @chan_b[] (%l2_buf_b[] [] []) {id = 2 : i32} : (memref<64xbf16, 1>)
+
+        %herd = air.herd @herd_0 async [%put_a, %put_b] tile (%tx, %ty) in (%htx=%c1_seg, %hty=%c1_seg) attributes {id = 3 : i32} {
+          %async_token_a, %l1_buf_a = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          %async_token_b, %l1_buf_b = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          %get_a = air.channel.get async [%async_token_a] @chan_a[] (%l1_buf_a[] [] []) {id = 3 : i32} : (memref<64xbf16, 2>)
+          %get_b = air.channel.get async [%async_token_b] @chan_b[] (%l1_buf_b[] [] []) {id = 4 : i32} : (memref<64xbf16, 2>)
+          %dealloc_a = air.execute [%get_a] {
+            memref.dealloc %l1_buf_a : memref<64xbf16, 2>
+          }
+          %dealloc_b = air.execute [%get_b] {
+            memref.dealloc %l1_buf_b : memref<64xbf16, 2>
+          }
+        }
+
+        memref.dealloc %l2_buf_a : memref<64xbf16, 1>
+        memref.dealloc %l2_buf_b : memref<64xbf16, 1>
+      }
+    }
+    return
+  }
+}
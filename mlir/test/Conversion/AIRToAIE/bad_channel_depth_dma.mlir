@@ -0,0 +1,40 @@
+//===- bad_channel_depth_dma.mlir ------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-to-aie='row-offset=2 col-offset=0 device=npu2' -verify-diagnostics
+
+// The DMA lowering path cannot hold more than one transfer per channel buffer,
+// so a deeper channel is rejected rather than run at depth 1.
+
+module {
+  // expected-error@+1 {{'air.channel' op has depth 2, which is only supported when lowering channels to object FIFOs}}
+  air.channel @chan_a [1, 1] {depth = 2}
+
+  func.func @deep_channel(%arg0: memref<64xbf16>) {
+    %0 = air.launch async () in () args(%input=%arg0) : memref<64xbf16> attributes {id = 1 : i32} {
+      %segment = air.segment @segment_0 async attributes {id = 2 : i32, x_loc = 0 : i64, x_size = 4 : i64, y_loc = 2 : i64, y_size = 4 : i64} {
+        %c1_seg = arith.constant 1 : index
+        %l2_buf = memref.alloc() : memref<64xbf16, 1>
+        %put = air.channel.put async @chan_a[] (%l2_buf[] [] []) {id = 1 : i32} : (memref<64xbf16, 1>)
+
+        %herd = air.herd @herd_0 async [%put] tile (%tx, %ty) in (%htx=%c1_seg, %hty=%c1_seg) attributes {id = 3 : i32} {
+          %async_token, %l1_buf = air.execute -> (memref<64xbf16, 2>) {
+            %alloc = memref.alloc() : memref<64xbf16, 2>
+            air.execute_terminator %alloc : memref<64xbf16, 2>
+          }
+          %get = air.channel.get async [%async_token] @chan_a[] (%l1_buf[] [] []) {id = 2 : i32} : (memref<64xbf16, 2>)
+          %dealloc = air.execute [%get] {
+            memref.dealloc %l1_buf : memref<64xbf16, 2>
+          }
+        }
+
+        memref.dealloc %l2_buf : memref<64xbf16, 1>
+      }
+    }
+    return
+  }
+}
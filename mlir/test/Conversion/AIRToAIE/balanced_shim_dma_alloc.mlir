@@ -0,0 +1,75 @@
+//===- balanced_shim_dma_alloc.mlir ----------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-to-aie="row-offset=2 col-offset=0 device=npu1" | FileCheck %s --check-prefix=FIRSTFIT
+// RUN: air-opt %s -air-to-aie="row-offset=2 col-offset=0 device=npu1 shim-dma-alloc-policy=balanced" | FileCheck %s --check-prefix=BALANCED
+
+// Four L1 to L3 flows from a 2x2 herd. First-fit packs them into the shim
+// channels of columns 0 and 1. The balanced policy puts each flow on the
+// least loaded shim column, preferring the column closest to its source, and
+// spreads them over columns 0, 1 and 2.
+
+// FIRSTFIT: aie.device(npu1)
+// FIRSTFIT-DAG: %[[tile_0_0:.*]] = aie.tile(0, 0)
+// FIRSTFIT-DAG: %[[tile_1_0:.*]] = aie.tile(1, 0)
+// FIRSTFIT:  aie.shim_dma_allocation @air_channel_0_0(%[[tile_0_0]], S2MM, 0)
+// FIRSTFIT:  aie.shim_dma_allocation @air_channel_0_1(%[[tile_0_0]], S2MM, 1)
+// FIRSTFIT:  aie.shim_dma_allocation @air_channel_0_2(%[[tile_1_0]], S2MM, 0)
+// FIRSTFIT:  aie.shim_dma_allocation @air_channel_0_3(%[[tile_1_0]], S2MM, 1)
+
+// BALANCED: aie.device(npu1)
+// BALANCED-DAG: %[[tile_0_0:.*]] = aie.tile(0, 0)
+// BALANCED-DAG: %[[tile_1_0:.*]] = aie.tile(1, 0)
+// BALANCED-DAG: %[[tile_2_0:.*]] = aie.tile(2, 0)
+// BALANCED:  aie.shim_dma_allocation @air_channel_0_0(%[[tile_0_0]], S2MM, 0)
+// BALANCED:  aie.shim_dma_allocation @air_channel_0_1(%[[tile_1_0]], S2MM, 0)
+// BALANCED:  aie.shim_dma_allocation @air_channel_0_2(%[[tile_0_0]], S2MM, 1)
+// BALANCED:  aie.shim_dma_allocation @air_channel_0_3(%[[tile_2_0]], S2MM, 0)
+
+#map1 = affine_map<()[s0] -> (s0 * 4)>
+air.channel @channel_0 [2, 2]
+func.func @func0(%arg5 : memref<8x8xi32>) {
+  %c1 = arith.constant 1 : index
+  %0 = air.launch async (%arg0, %arg1) in (%arg2=%c1, %arg3=%c1) args(%arg4=%arg5) : memref<8x8xi32> attributes {id = 1 : i32} {
+    %c0_8 = arith.constant 0 : index
+    %c2 = arith.constant 2 : index
+    %c1_7 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    %c8 = arith.constant 8 : index
+    %3 = air.wait_all async 
+    %4 = scf.parallel (%arg6, %arg7) = (%c0_8, %c0_8) to (%c2, %c2) step (%c1_7, %c1_7) init (%3) -> !air.async.token {
+      %async_token_17, %results_18 = air.execute -> (index) {
+        %7 = affine.apply #map1()[%arg6]
+        air.execute_terminator %7 : index
+      }
+      %async_token_19, %results_20 = air.execute -> (index) {
+        %7 = affine.apply #map1()[%arg7]
+        air.execute_terminator %7 : index
+      }
+      %6 = air.channel.get async [%async_token_19, %async_token_17]  @channel_0[%arg6, %arg7] (%arg4[%results_18, %results_20] [%c4, %c4] [%c8, %c1_7]) {id = 3 : i32} : (memref<8x8xi32>)
+      scf.reduce(%6 : !air.async.token) {
+      ^bb0(%arg8: !air.async.token, %arg9: !air.async.token):
+        %7 = air.wait_all async [%arg8, %arg9] 
+        scf.reduce.return %7 : !air.async.token
+      }
+    }
+    %5 = air.segment @segment_0 async  attributes {id = 2 : i32, x_loc = 0 : i64, x_size = 2 : i64, y_loc = 3 : i64, y_size = 2 : i64} {
+      %c2_22 = arith.constant 2 : index
+      %25 = air.herd @herd_0 async tile (%arg6, %arg7) in (%arg8=%c2_22, %arg9=%c2_22) attributes {id = 3 : i32, x_loc = 0 : i64, y_loc = 3 : i64} {
+        %async_token_34, %results_35 = air.execute -> (memref<4x4xi32, 2>) {
+          %alloc = memref.alloc() : memref<4x4xi32, 2>
+          air.execute_terminator %alloc : memref<4x4xi32, 2>
+        }
+        %27 = air.channel.put async [%async_token_34]  @channel_0[%arg6, %arg7] (%results_35[] [] []) {id = 14 : i32} : (memref<4x4xi32, 2>)
+        %async_token_45 = air.execute [%27] {
+          memref.dealloc %results_35 : memref<4x4xi32, 2>
+        }
+      }
+    }
+  }
+  return
+}
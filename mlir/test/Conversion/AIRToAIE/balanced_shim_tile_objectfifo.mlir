@@ -0,0 +1,48 @@
+//===- balanced_shim_tile_objectfifo.mlir ----------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s --air-to-aie='test-patterns=lower-air-channels' | FileCheck %s --check-prefix=FIRSTFIT
+// RUN: air-opt %s --air-to-aie='test-patterns=lower-air-channels shim-dma-alloc-policy=balanced' | FileCheck %s --check-prefix=BALANCED
+
+// Objectfifo lowering of an L3 round trip to a core in column 7. First-fit
+// takes the first shim column. With the balanced policy all shim columns are
+// equally loaded, and the tie goes to the shim tile below the core.
+
+// FIRSTFIT-LABEL: aie.device(xcvc1902)
+// FIRSTFIT-DAG:   %[[CORE:.*]] = aie.tile(7, 1)
+// FIRSTFIT-DAG:   %[[SHIM:.*]] = aie.tile(2, 0)
+// FIRSTFIT-DAG:   aie.objectfifo @{{.*}}(%[[CORE]], {%[[SHIM]]}, 1 : i32)
+// FIRSTFIT-DAG:   aie.objectfifo @{{.*}}(%[[SHIM]], {%[[CORE]]}, 1 : i32)
+
+// BALANCED-LABEL: aie.device(xcvc1902)
+// BALANCED-DAG:   %[[CORE:.*]] = aie.tile(7, 1)
+// BALANCED-DAG:   %[[SHIM:.*]] = aie.tile(7, 0)
+// BALANCED-DAG:   aie.objectfifo @{{.*}}(%[[CORE]], {%[[SHIM]]}, 1 : i32)
+// BALANCED-DAG:   aie.objectfifo @{{.*}}(%[[SHIM]], {%[[CORE]]}, 1 : i32)
+
+aie.device(xcvc1902) {
+  %0 = aie.tile(7, 1)
+  air.channel @channel_0 [1, 1]
+  air.channel @channel_1 [1, 1]
+  %1 = aie.core(%0) {
+    %c32 = arith.constant 32 : index
+    %c0 = arith.constant 0 : index
+    %alloc = memref.alloc() {sym_name = "scratch"} : memref<32xi32, 2>
+    %alloc_0 = memref.alloc() {sym_name = "scratch_copy"} : memref<32xi32, 2>
+    affine.for %arg0 = 0 to 4096 step 32 {
+      %3 = air.channel.get async @channel_0[] (%alloc[%c0] [%c32] [%c0]) : (memref<32xi32, 2>)
+      affine.for %arg1 = 0 to 32 {
+        %2 = affine.load %alloc[%arg1] : memref<32xi32, 2>
+        affine.store %2, %alloc_0[%arg1] : memref<32xi32, 2>
+      }
+      air.channel.put  @channel_1[] (%alloc_0[%c0] [%c32] [%c0]) : (memref<32xi32, 2>)
+    }
+    memref.dealloc %alloc_0 : memref<32xi32, 2>
+    memref.dealloc %alloc : memref<32xi32, 2>
+    aie.end
+  }
+}
@@ -0,0 +1,66 @@
+//===- emit_persistent.mlir ------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-to-aie='emit-persistent=true device=npu1 row-offset=2' -split-input-file | FileCheck %s
+
+// Resident cores wait on the herd lock at the top of every iteration, then
+// read the runtime parameters of the launch from the RTP buffer.
+
+// CHECK-LABEL: aie.device(npu1)
+// CHECK:  %[[TILE:.*]] = aie.tile(1, 2)
+// CHECK:  %[[RTP:.*]] = aie.buffer(%[[TILE]]) {{{.*}}sym_name = "__air_herd_rtp_1_2"{{.*}}} : memref<1xi32>
+// CHECK:  %[[LOCK:.*]] = aie.lock(%[[TILE]], 0) {init = 0 : i32, sym_name = "__air_herd_lock_1_2"}
+// CHECK:  aie.core(%[[TILE]]) {
+// CHECK:    cf.br ^bb1
+// CHECK:  ^bb1:
+// CHECK:    aie.use_lock(%[[LOCK]], AcquireGreaterEqual, 1)
+// CHECK:    memref.load %[[RTP]]
+// CHECK:    cf.br ^bb2
+// CHECK:  ^bb2:
+// CHECK:    memref.store
+// CHECK:    cf.br ^bb1
+// CHECK:  air.persistent
+
+module {
+  func.func @rtp(%arg0: i32) {
+    %c1 = arith.constant 1 : index
+    air.herd @herd_0 tile(%tx, %ty) in (%size_x = %c1, %size_y = %c1) args(%a = %arg0) : i32 {
+      %c0 = arith.constant 0 : index
+      %buf = memref.alloc() : memref<1xi32, 2>
+      memref.store %a, %buf[%c0] : memref<1xi32, 2>
+      air.herd_terminator
+    }
+    return
+  }
+}
+
+// -----
+
+// Herds without runtime parameters are gated by the herd lock as well.
+
+// CHECK-LABEL: aie.device(npu1)
+// CHECK:  %[[TILE:.*]] = aie.tile(1, 2)
+// CHECK-NOT: __air_herd_rtp
+// CHECK:  %[[LOCK:.*]] = aie.lock(%[[TILE]], 0) {init = 0 : i32, sym_name = "__air_herd_lock_1_2"}
+// CHECK:  aie.core(%[[TILE]]) {
+// CHECK:    cf.br ^bb1
+// CHECK:  ^bb1:
+// CHECK:    aie.use_lock(%[[LOCK]], AcquireGreaterEqual, 1)
+// CHECK:    cf.br ^bb2
+// CHECK:  ^bb2:
+// CHECK:    cf.br ^bb1
+// CHECK:  air.persistent
+
+module {
+  func.func @no_rtp() {
+    %c1 = arith.constant 1 : index
+    air.herd @herd_0 tile(%tx, %ty) in (%size_x = %c1, %size_y = %c1) {
+      air.herd_terminator
+    }
+    return
+  }
+}
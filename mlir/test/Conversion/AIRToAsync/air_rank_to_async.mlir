@@ -0,0 +1,90 @@
+//===- air_rank_to_async.mlir ----------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-to-async | FileCheck %s
+
+// One worker per rank instance.
+// CHECK-LABEL: func.func @rank_1d
+// CHECK-NOT: air.rank
+// CHECK: %[[TOTAL:.*]] = arith.muli %{{.*}}, %[[C4:.*]] : index
+// CHECK: %[[RANK:.*]] = async.execute {
+// CHECK:   %[[GROUP:.*]] = async.create_group %[[TOTAL]] : !async.group
+// CHECK:   scf.for %[[W:.*]] = %{{.*}} to %[[TOTAL]] step %{{.*}} {
+// CHECK:     %[[WORKER:.*]] = async.execute {
+// CHECK:       scf.for %[[I:.*]] = %[[W]] to %[[TOTAL]] step %[[TOTAL]] {
+// CHECK:         arith.remui %[[I]], %[[C4]] : index
+// CHECK:       } {air.rank = "worker"}
+// CHECK:       async.yield
+// CHECK:     async.add_to_group %[[WORKER]], %[[GROUP]] : !async.token
+// CHECK:   } {air.rank = "pool"}
+// CHECK:   async.await_all %[[GROUP]]
+// CHECK: async.await %[[RANK]] : !async.token
+func.func @rank_1d(%arg0 : memref<16xf32>) {
+  %c4 = arith.constant 4 : index
+  air.rank (%rx) in (%sx = %c4) args(%a=%arg0) : memref<16xf32> {
+    %c1 = arith.constant 1 : index
+    air.launch (%lx) in (%ls = %c1) args(%la=%a) : memref<16xf32> {
+    }
+  }
+  return
+}
+
+// The universe bounds the number of workers, each worker strides over the
+// rank instances by the number of workers.
+// CHECK-LABEL: func.func @rank_universe
+// CHECK-NOT: air.universe.alloc
+// CHECK: %[[TOTAL:.*]] = arith.muli
+// CHECK: %[[CAP:.*]] = arith.maxui %{{.*}}, %{{.*}} : index
+// CHECK: %[[WORKERS:.*]] = arith.minui %[[TOTAL]], %[[CAP]] : index
+// CHECK: async.execute {
+// CHECK:   async.create_group %[[WORKERS]] : !async.group
+// CHECK:   scf.for %[[W:.*]] = %{{.*}} to %[[WORKERS]] step %{{.*}} {
+// CHECK:     async.execute {
+// CHECK:       scf.for %{{.*}} = %[[W]] to %[[TOTAL]] step %[[WORKERS]] {
+func.func @rank_universe(%arg0 : memref<16xf32>) {
+  %c2 = arith.constant 2 : index
+  %c8 = arith.constant 8 : index
+  %u = air.universe.alloc(%c2)
+  air.rank universe(%u) (%rx) in (%sx = %c8) args(%a=%arg0) : memref<16xf32> {
+  }
+  return
+}
+
+// Rank ids of a 2D rank are recovered from the linear instance index, the
+// last dimension varies fastest.
+// CHECK-LABEL: func.func @rank_2d
+// CHECK: scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+// CHECK:   %[[RY:.*]] = arith.remui %[[I]], %[[C4:.*]] : index
+// CHECK:   %[[Q:.*]] = arith.divui %[[I]], %[[C4]] : index
+// CHECK:   %[[RX:.*]] = arith.remui %[[Q]], %[[C2:.*]] : index
+// CHECK:   func.call @use(%[[RX]], %[[RY]])
+func.func private @use(index, index)
+func.func @rank_2d() {
+  %c2 = arith.constant 2 : index
+  %c4 = arith.constant 4 : index
+  air.rank (%rx, %ry) in (%sx = %c2, %sy = %c4) {
+    func.call @use(%rx, %ry) : (index, index) -> ()
+  }
+  return
+}
+
+// An async rank does not block its caller, its token completes when every
+// rank instance has.
+// CHECK-LABEL: func.func @rank_async
+// CHECK: %[[DEP:.*]] = async.execute {
+// CHECK: %[[RANK:.*]] = async.execute [%[[DEP]]] {
+// CHECK:   async.await_all
+// CHECK: async.await %[[RANK]] : !async.token
+// CHECK-NEXT: return
+func.func @rank_async() {
+  %c2 = arith.constant 2 : index
+  %dep = air.wait_all async
+  %t = air.rank async [%dep] (%rx) in (%sx = %c2) {
+  }
+  air.wait_all [%t]
+  return
+}
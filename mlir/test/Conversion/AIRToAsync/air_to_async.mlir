@@ -128,7 +128,7 @@ func.func @herd_1(%arg0: i32, %arg1: i32) -> () {
 // CHECK-NEXT: call @air_channel_get_M0D2I64_M0D2F32
 // CHECK-NEXT: async.yield
 // CHECK: async.await %[[T0]] : !async.token
-// CHECK: call @air_channel_put_M0D2I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64(
+// CHECK: call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64(
 air.channel @channel_0 [1]
 func.func @channel_get_put_0(%arg0 : memref<16x16xf32>, %arg1 : memref<16x16xf32>) -> () {
   %alloc = memref.alloc() : memref<8x8xf32>
@@ -145,7 +145,7 @@ func.func @channel_get_put_0(%arg0 : memref<16x16xf32>, %arg1 : memref<16x16xf32
 // CHECK-LABEL: channel_get_put_3_3
 // CHECK: memref.get_global @channel_1 : memref<3x3xi64>
 // CHECK: call @air_channel_get_M0D2I64_I64_I64_M0D2F32
-// CHECK: call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64
+// CHECK: call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64
 air.channel @channel_1 [3,3]
 func.func @channel_get_put_3_3(%arg0 : memref<9x9xf32>) -> () {
   %c3 = arith.constant 1 : index
@@ -160,6 +160,37 @@ func.func @channel_get_put_3_3(%arg0 : memref<9x9xf32>) -> () {
   return
 }
 
+// CHECK: memref.global "private" @channel_2 : memref<1x1xi64> = dense<0> {depth = 2 : i64}
+// CHECK-LABEL: channel_put_depth
+// CHECK: %[[DEPTH:.*]] = arith.constant 2 : index
+// CHECK: call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64(%{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %[[DEPTH]], %{{.*}})
+air.channel @channel_2 [1, 1] {depth = 2}
+func.func @channel_put_depth(%arg0 : memref<16x16xf32>) -> () {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %c16 = arith.constant 16 : index
+  air.channel.put @channel_2[] (%arg0[%c0, %c0] [%c8, %c8] [%c16, %c1]) : (memref<16x16xf32>)
+  return
+}
+
+// A non-broadcast channel broadcasts to its own shape, so the put passes the
+// channel sizes again as the broadcast sizes.
+// CHECK: memref.global "private" @channel_3 : memref<4x1xi64> = dense<0>
+// CHECK-LABEL: channel_put_bundle
+// CHECK: %[[N:.*]] = arith.constant 4 : index
+// CHECK: %[[M:.*]] = arith.constant 1 : index
+// CHECK: call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64(%{{.*}}, %[[N]], %[[M]], %[[N]], %[[M]],
+air.channel @channel_3 [4, 1]
+func.func @channel_put_bundle(%arg0 : memref<16x16xf32>) -> () {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c3 = arith.constant 3 : index
+  %c16 = arith.constant 16 : index
+  air.channel.put @channel_3[%c3, %c0] (%arg0[%c0, %c0] [%c3, %c16] [%c16, %c1]) : (memref<16x16xf32>)
+  return
+}
+
 // CHECK-LABEL: @scf_par
 // CHECK: %[[C0:.*]] = arith.constant 0 : index
 // CHECK: %[[C32:.*]] = arith.constant 32 : index
@@ -137,3 +137,6 @@ func.func @cascade_func() {
   }
   return
 }
+
+// CHECK: air.channel @channel_depth [1, 1] {depth = 2 : i64}
+air.channel @channel_depth [1, 1] {depth = 2}
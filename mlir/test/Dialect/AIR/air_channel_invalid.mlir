@@ -81,3 +81,15 @@ func.func @channel_get_temporal_for_iv(%m: memref<64xi32>) {
   }
   return
 }
+
+// -----
+
+// Test: channel depth must hold at least one transfer.
+// expected-error @+1 {{'air.channel' op depth (0) must be at least 1}}
+air.channel @zero_depth [1, 1] {depth = 0}
+
+// -----
+
+// Test: channel depth must be an integer.
+// expected-error @+1 {{'air.channel' op expected integer attribute for depth, but found "2"}}
+air.channel @string_depth [1, 1] {depth = "2"}
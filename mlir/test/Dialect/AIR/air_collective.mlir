@@ -0,0 +1,34 @@
+//===- air_collective.mlir -------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s | FileCheck %s
+
+// CHECK-LABEL: func.func @test_collectives
+// CHECK: air.collective.all_reduce (%{{.*}}, %{{.*}}) : (memref<64xf32>, memref<64xf32>)
+// CHECK: %[[T0:.*]] = air.collective.all_reduce async (%{{.*}}, %{{.*}}) {chunks = 4 : i64, reduction = "max"} : (memref<8x8xf32>, memref<64xf32>)
+// CHECK: %[[T1:.*]] = air.collective.all_gather async [%[[T0]]] (%{{.*}}, %{{.*}}) : (memref<16xi32>, memref<4x16xi32>)
+// CHECK: air.collective.reduce_scatter [%[[T1]]] (%{{.*}}, %{{.*}}) {reduction = "min"} : (memref<4x16xi32>, memref<16xi32>)
+func.func @test_collectives(%arg0 : memref<64xf32>, %arg1 : memref<8x8xf32>,
+                            %arg2 : memref<16xi32>, %arg3 : memref<4x16xi32>) {
+  %c4 = arith.constant 4 : index
+  air.rank (%r) in (%n = %c4) args(%a=%arg0, %b=%arg1, %c=%arg2, %d=%arg3) : memref<64xf32>, memref<8x8xf32>, memref<16xi32>, memref<4x16xi32> {
+    air.collective.all_reduce (%a, %a) : (memref<64xf32>, memref<64xf32>)
+    %t0 = air.collective.all_reduce async (%b, %a) {chunks = 4 : i64, reduction = "max"} : (memref<8x8xf32>, memref<64xf32>)
+    %t1 = air.collective.all_gather async [%t0] (%c, %d) : (memref<16xi32>, memref<4x16xi32>)
+    air.collective.reduce_scatter [%t1] (%d, %c) {reduction = "min"} : (memref<4x16xi32>, memref<16xi32>)
+  }
+  return
+}
+
+// CHECK-LABEL: func.func @test_collective_dynamic_world
+// CHECK: air.collective.all_gather
+func.func @test_collective_dynamic_world(%arg0 : memref<16xi32>, %arg1 : memref<64xi32>, %n : index) {
+  air.rank (%r) in (%s = %n) args(%a=%arg0, %b=%arg1) : memref<16xi32>, memref<64xi32> {
+    air.collective.all_gather (%a, %b) : (memref<16xi32>, memref<64xi32>)
+  }
+  return
+}
@@ -0,0 +1,84 @@
+//===- air_collective_invalid.mlir -----------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -split-input-file -verify-diagnostics
+
+func.func @collective_outside_rank(%arg0 : memref<64xf32>) {
+  // expected-error @below {{must be nested in the body of an air.rank}}
+  air.collective.all_reduce (%arg0, %arg0) : (memref<64xf32>, memref<64xf32>)
+  return
+}
+
+// -----
+
+func.func @collective_in_launch(%arg0 : memref<64xf32>) {
+  %c2 = arith.constant 2 : index
+  air.rank (%r) in (%n = %c2) args(%a=%arg0) : memref<64xf32> {
+    %c1 = arith.constant 1 : index
+    air.launch (%l) in (%ls = %c1) args(%la=%a) : memref<64xf32> {
+      // expected-error @below {{must be nested in the body of an air.rank}}
+      air.collective.all_reduce (%la, %la) : (memref<64xf32>, memref<64xf32>)
+    }
+  }
+  return
+}
+
+// -----
+
+func.func @collective_bad_reduction(%arg0 : memref<64xf32>) {
+  %c2 = arith.constant 2 : index
+  air.rank (%r) in (%n = %c2) args(%a=%arg0) : memref<64xf32> {
+    // expected-error @below {{unknown reduction 'avg'}}
+    air.collective.all_reduce (%a, %a) {reduction = "avg"} : (memref<64xf32>, memref<64xf32>)
+  }
+  return
+}
+
+// -----
+
+func.func @collective_bad_chunks(%arg0 : memref<64xf32>) {
+  %c2 = arith.constant 2 : index
+  air.rank (%r) in (%n = %c2) args(%a=%arg0) : memref<64xf32> {
+    // expected-error @below {{expects at least one chunk, got 0}}
+    air.collective.all_reduce (%a, %a) {chunks = 0 : i64} : (memref<64xf32>, memref<64xf32>)
+  }
+  return
+}
+
+// -----
+
+func.func @collective_element_type(%arg0 : memref<64xf32>, %arg1 : memref<64xi32>) {
+  %c2 = arith.constant 2 : index
+  air.rank (%r) in (%n = %c2) args(%a=%arg0, %b=%arg1) : memref<64xf32>, memref<64xi32> {
+    // expected-error @below {{expects src and dst of the same element type}}
+    air.collective.all_reduce (%a, %b) : (memref<64xf32>, memref<64xi32>)
+  }
+  return
+}
+
+// -----
+
+func.func @all_gather_size(%arg0 : memref<16xf32>, %arg1 : memref<64xf32>) {
+  %c2 = arith.constant 2 : index
+  air.rank (%r) in (%n = %c2) args(%a=%arg0, %b=%arg1) : memref<16xf32>, memref<64xf32> {
+    // expected-error @below {{src and dst sizes do not match a world of 2 rank instances}}
+    air.collective.all_gather (%a, %b) : (memref<16xf32>, memref<64xf32>)
+  }
+  return
+}
+
+// -----
+
+func.func @reduce_scatter_size(%arg0 : memref<64xf32>, %arg1 : memref<16xf32>) {
+  %c2 = arith.constant 2 : index
+  %c3 = arith.constant 3 : index
+  air.rank (%rx, %ry) in (%nx = %c2, %ny = %c3) args(%a=%arg0, %b=%arg1) : memref<64xf32>, memref<16xf32> {
+    // expected-error @below {{src and dst sizes do not match a world of 6 rank instances}}
+    air.collective.reduce_scatter (%a, %b) : (memref<64xf32>, memref<16xf32>)
+  }
+  return
+}
@@ -0,0 +1,99 @@
+//===- collective_to_channel.mlir ------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-collective-to-channel -split-input-file | FileCheck %s
+
+// All-reduce: a reduce-scatter ring and an all-gather ring over one channel
+// per rank instance, each block forwarded in two chunks.
+// CHECK: air.channel @collective_0 [4, 1]
+// CHECK-LABEL: func.func @all_reduce
+// CHECK: air.rank
+// CHECK-NOT: air.collective
+// CHECK: %[[TMP:.*]] = memref.alloc() : memref<128xf32>
+// CHECK: scf.for %{{.*}} = %{{.*}} to %{{.*}} step
+// CHECK:   scf.for %{{.*}} = %{{.*}} to %{{.*}} step
+// CHECK:     air.channel.put @collective_0[%[[NEXT:[a-z0-9_]+]], %{{.*}}] (%{{.*}}[%{{.*}}] [%{{.*}}] [%{{.*}}]) : (memref<1024xf32>)
+// CHECK:     air.channel.get @collective_0[%[[RANK:[a-z0-9_]+]], %{{.*}}] (%[[TMP]][] [] []) : (memref<128xf32>)
+// CHECK:     scf.for
+// CHECK:       memref.load
+// CHECK:       memref.load %[[TMP]]
+// CHECK:       arith.addf
+// CHECK:       memref.store
+// CHECK: memref.dealloc %[[TMP]] : memref<128xf32>
+// CHECK: scf.for
+// CHECK:   scf.for
+// CHECK:     air.channel.put @collective_0[%[[NEXT]], %{{.*}}]
+// CHECK:     air.channel.get @collective_0[%[[RANK]], %{{.*}}] (%{{.*}}[%{{.*}}] [%{{.*}}] [%{{.*}}]) : (memref<1024xf32>)
+func.func @all_reduce(%arg0 : memref<1024xf32>) {
+  %c4 = arith.constant 4 : index
+  air.rank (%r) in (%n = %c4) args(%a=%arg0) : memref<1024xf32> {
+    air.collective.all_reduce (%a, %a) {chunks = 2 : i64} : (memref<1024xf32>, memref<1024xf32>)
+  }
+  return
+}
+
+// -----
+
+// All-gather of a 2D rank: the linearized rank id selects the block, and
+// async dependencies and tokens turn into air.wait_all.
+// CHECK-LABEL: func.func @all_gather
+// CHECK: air.rank (%[[RX:[a-z0-9_]+]], %[[RY:[a-z0-9_]+]]) in (%[[NX:[a-z0-9_]+]]=%{{.*}}, %[[NY:[a-z0-9_]+]]=%{{.*}})
+// CHECK: air.wait_all [%{{.*}}]
+// CHECK: %[[M:.*]] = arith.muli %{{.*}}, %[[NX]] : index
+// CHECK: %[[A:.*]] = arith.addi %[[M]], %[[RX]] : index
+// CHECK: %[[M2:.*]] = arith.muli %[[A]], %[[NY]] : index
+// CHECK: %[[ID:.*]] = arith.addi %[[M2]], %[[RY]] : index
+// CHECK: %[[FLAT:.*]] = memref.collapse_shape %{{.*}} {{\[}}[0, 1]] : memref<4x16xi32> into memref<64xi32>
+// CHECK: %[[OFF:.*]] = arith.muli %[[ID]], %{{.*}} : index
+// CHECK: %[[OWN:.*]] = memref.subview %[[FLAT]][%[[OFF]]] [16] [1]
+// CHECK: memref.copy %{{.*}}, %[[OWN]]
+// CHECK: air.channel.get @collective_0[%[[ID]], %{{.*}}] (%[[FLAT]]
+// CHECK: %[[T:.*]] = air.wait_all async
+// CHECK: air.wait_all [%[[T]]]
+func.func @all_gather(%arg0 : memref<16xi32>, %arg1 : memref<4x16xi32>) {
+  %c2 = arith.constant 2 : index
+  air.rank (%rx, %ry) in (%nx = %c2, %ny = %c2) args(%a=%arg0, %b=%arg1) : memref<16xi32>, memref<4x16xi32> {
+    %t0 = air.wait_all async
+    %t1 = air.collective.all_gather async [%t0] (%a, %b) : (memref<16xi32>, memref<4x16xi32>)
+    air.wait_all [%t1]
+  }
+  return
+}
+
+// -----
+
+// Reduce-scatter reduces in a scratch copy of src and returns the block of
+// the rank instance.
+// CHECK-LABEL: func.func @reduce_scatter
+// CHECK: %[[SCRATCH:.*]] = memref.alloc() : memref<64xi32>
+// CHECK: memref.copy %{{.*}}, %[[SCRATCH]]
+// CHECK: arith.maxsi
+// CHECK: %[[OWN:.*]] = memref.subview %[[SCRATCH]]
+// CHECK: memref.copy %[[OWN]], %{{.*}}
+// CHECK: memref.dealloc %[[SCRATCH]]
+func.func @reduce_scatter(%arg0 : memref<64xi32>, %arg1 : memref<16xi32>) {
+  %c4 = arith.constant 4 : index
+  air.rank (%r) in (%n = %c4) args(%a=%arg0, %b=%arg1) : memref<64xi32>, memref<16xi32> {
+    air.collective.reduce_scatter (%a, %b) {reduction = "max"} : (memref<64xi32>, memref<16xi32>)
+  }
+  return
+}
+
+// -----
+
+// A world of one instance needs no channel traffic.
+// CHECK-LABEL: func.func @single_rank
+// CHECK-NOT: air.channel.put
+// CHECK: memref.copy
+// CHECK-NOT: air.channel.put
+func.func @single_rank(%arg0 : memref<64xf32>, %arg1 : memref<64xf32>) {
+  %c1 = arith.constant 1 : index
+  air.rank (%r) in (%n = %c1) args(%a=%arg0, %b=%arg1) : memref<64xf32>, memref<64xf32> {
+    air.collective.all_reduce (%a, %b) : (memref<64xf32>, memref<64xf32>)
+  }
+  return
+}
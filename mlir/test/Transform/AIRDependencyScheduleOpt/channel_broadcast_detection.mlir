@@ -0,0 +1,152 @@
+//===- channel_broadcast_detection.mlir ------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-channel-broadcast-detection --split-input-file -verify-diagnostics | FileCheck %s
+
+// Each row of a 2x2 herd reads the same L2 tile. The column dimension of the
+// channel is collapsed into a broadcast and the duplicate puts are removed.
+
+// CHECK-LABEL: module
+// CHECK: air.channel @L2ToL1 [2, 1] {broadcast_shape = [2, 2]}
+// CHECK-LABEL: func.func @row_broadcast
+// CHECK: %[[PUT_A:.*]] = air.channel.put async [%{{.*}}]{{ *}}@L2ToL1[%c0{{.*}}, %c0{{.*}}] (%[[BUF_A:.*]][] [] [])
+// CHECK: air.wait_all async [%{{.*}}, %[[PUT_A]]]
+// CHECK: %[[PUT_B:.*]] = air.channel.put async [%{{.*}}]{{ *}}@L2ToL1[%c1{{.*}}, %c0{{.*}}] (%[[BUF_B:.*]][] [] [])
+// CHECK: air.wait_all async [%{{.*}}, %[[PUT_B]]]
+// CHECK-NOT: air.channel.put
+// CHECK: air.herd
+// CHECK: air.channel.get async {{.*}}@L2ToL1[%{{.*}}, %{{.*}}]
+
+module {
+  // expected-remark @below {{inferred broadcast_shape [2, 2]: merged 2 of 4 puts, saving 8192 bytes of DMA traffic}}
+  air.channel @L2ToL1 [2, 2]
+  func.func @row_broadcast() {
+    %c1 = arith.constant 1 : index
+    %0 = air.launch async (%arg0, %arg1) in (%arg2=%c1, %arg3=%c1) {
+      %1 = air.segment @seg async {
+        %c0 = arith.constant 0 : index
+        %c1_0 = arith.constant 1 : index
+        %c2 = arith.constant 2 : index
+        %t0, %buf_a = air.execute -> (memref<32x64xbf16, 1 : i32>) {
+          %alloc = memref.alloc() : memref<32x64xbf16, 1 : i32>
+          air.execute_terminator %alloc : memref<32x64xbf16, 1 : i32>
+        }
+        %t1, %buf_b = air.execute -> (memref<32x64xbf16, 1 : i32>) {
+          %alloc = memref.alloc() : memref<32x64xbf16, 1 : i32>
+          air.execute_terminator %alloc : memref<32x64xbf16, 1 : i32>
+        }
+        %2 = air.channel.put async [%t0] @L2ToL1[%c0, %c0] (%buf_a[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %3 = air.channel.put async [%t0] @L2ToL1[%c0, %c1_0] (%buf_a[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %4 = air.channel.put async [%t1] @L2ToL1[%c1_0, %c0] (%buf_b[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %5 = air.channel.put async [%t1] @L2ToL1[%c1_0, %c1_0] (%buf_b[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %6 = air.herd @herd_0 async tile (%tx, %ty) in (%sx=%c2, %sy=%c2) {
+          %t2, %l1 = air.execute -> (memref<32x64xbf16, 2 : i32>) {
+            %alloc = memref.alloc() : memref<32x64xbf16, 2 : i32>
+            air.execute_terminator %alloc : memref<32x64xbf16, 2 : i32>
+          }
+          %7 = air.channel.get async [%t2] @L2ToL1[%tx, %ty] (%l1[] [] []) : (memref<32x64xbf16, 2 : i32>)
+          %8 = air.execute [%7] {
+            memref.dealloc %l1 : memref<32x64xbf16, 2 : i32>
+          }
+        }
+        %9 = air.wait_all async [%2, %3, %4, %5, %6]
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The puts read different offsets of the same L2 buffer, so no broadcast is
+// inferred.
+
+// CHECK-LABEL: module
+// CHECK: air.channel @L2ToL1 [1, 2]
+// CHECK-NOT: broadcast_shape
+// CHECK-LABEL: func.func @no_broadcast
+// CHECK-COUNT-2: air.channel.put
+
+module {
+  air.channel @L2ToL1 [1, 2]
+  func.func @no_broadcast() {
+    %c1 = arith.constant 1 : index
+    %0 = air.launch async (%arg0, %arg1) in (%arg2=%c1, %arg3=%c1) {
+      %1 = air.segment @seg async {
+        %c0 = arith.constant 0 : index
+        %c1_0 = arith.constant 1 : index
+        %c2 = arith.constant 2 : index
+        %c32 = arith.constant 32 : index
+        %c64 = arith.constant 64 : index
+        %t0, %buf = air.execute -> (memref<64x64xbf16, 1 : i32>) {
+          %alloc = memref.alloc() : memref<64x64xbf16, 1 : i32>
+          air.execute_terminator %alloc : memref<64x64xbf16, 1 : i32>
+        }
+        %2 = air.channel.put async [%t0] @L2ToL1[%c0, %c0] (%buf[%c0, %c0] [%c32, %c64] [%c64, %c1_0]) : (memref<64x64xbf16, 1 : i32>)
+        %3 = air.channel.put async [%t0] @L2ToL1[%c0, %c1_0] (%buf[%c32, %c0] [%c32, %c64] [%c64, %c1_0]) : (memref<64x64xbf16, 1 : i32>)
+        %4 = air.herd @herd_0 async tile (%tx, %ty) in (%sx=%c1_0, %sy=%c2) {
+          %t2, %l1 = air.execute -> (memref<32x64xbf16, 2 : i32>) {
+            %alloc = memref.alloc() : memref<32x64xbf16, 2 : i32>
+            air.execute_terminator %alloc : memref<32x64xbf16, 2 : i32>
+          }
+          %5 = air.channel.get async [%t2] @L2ToL1[%tx, %ty] (%l1[] [] []) : (memref<32x64xbf16, 2 : i32>)
+          %6 = air.execute [%5] {
+            memref.dealloc %l1 : memref<32x64xbf16, 2 : i32>
+          }
+        }
+        %7 = air.wait_all async [%2, %3, %4]
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The L2 buffer is overwritten between the two puts, so the two herd tiles
+// receive different data and no broadcast is inferred.
+
+// CHECK-LABEL: module
+// CHECK: air.channel @L2ToL1 [1, 2]
+// CHECK-NOT: broadcast_shape
+// CHECK-LABEL: func.func @written_between_puts
+// CHECK-COUNT-2: air.channel.put{{.*}}@L2ToL1
+
+module {
+  air.channel @L3ToL2 [1, 1]
+  air.channel @L2ToL1 [1, 2]
+  func.func @written_between_puts(%arg0: memref<32x64xbf16>) {
+    %c1 = arith.constant 1 : index
+    %put = air.channel.put async @L3ToL2[] (%arg0[] [] []) : (memref<32x64xbf16>)
+    %0 = air.launch async (%arg1, %arg2) in (%arg3=%c1, %arg4=%c1) args(%arg5=%arg0) : memref<32x64xbf16> {
+      %1 = air.segment @seg async args(%arg6=%arg5) : memref<32x64xbf16> {
+        %c0 = arith.constant 0 : index
+        %c1_0 = arith.constant 1 : index
+        %c2 = arith.constant 2 : index
+        %t0, %buf = air.execute -> (memref<32x64xbf16, 1 : i32>) {
+          %alloc = memref.alloc() : memref<32x64xbf16, 1 : i32>
+          air.execute_terminator %alloc : memref<32x64xbf16, 1 : i32>
+        }
+        %2 = air.channel.put async [%t0] @L2ToL1[%c0, %c0] (%buf[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %3 = air.channel.get async [%2] @L3ToL2[] (%buf[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %4 = air.channel.put async [%3] @L2ToL1[%c0, %c1_0] (%buf[] [] []) : (memref<32x64xbf16, 1 : i32>)
+        %5 = air.herd @herd_0 async tile (%tx, %ty) in (%sx=%c1_0, %sy=%c2) {
+          %t2, %l1 = air.execute -> (memref<32x64xbf16, 2 : i32>) {
+            %alloc = memref.alloc() : memref<32x64xbf16, 2 : i32>
+            air.execute_terminator %alloc : memref<32x64xbf16, 2 : i32>
+          }
+          %6 = air.channel.get async [%t2] @L2ToL1[%tx, %ty] (%l1[] [] []) : (memref<32x64xbf16, 2 : i32>)
+          %7 = air.execute [%6] {
+            memref.dealloc %l1 : memref<32x64xbf16, 2 : i32>
+          }
+        }
+        %8 = air.wait_all async [%4, %5]
+      }
+    }
+    return
+  }
+}
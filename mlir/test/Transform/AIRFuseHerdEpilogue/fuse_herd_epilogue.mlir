@@ -0,0 +1,271 @@
+//===- fuse_herd_epilogue.mlir ---------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-fuse-herd-epilogue -split-input-file | FileCheck %s
+// RUN: air-opt %s -air-fuse-herd-epilogue="l1-size=16384" -split-input-file | FileCheck %s --check-prefix=SMALL
+
+// A matmul followed by a bias add over the same 2x2 grid of 32x32 tiles.
+// The bias add runs on the accumulator in the matmul herd, and the store
+// of the accumulator to %c goes away since nothing reads %c afterwards.
+// The fused herd needs 16512 bytes of L1, more than the second run allows.
+
+// CHECK-LABEL: func.func @matmul_bias
+// CHECK:       air.herd @matmul
+// CHECK:         %[[ACC:.*]] = memref.alloc() : memref<32x32xf32, 2 : i32>
+// CHECK:         scf.for
+// CHECK:           linalg.matmul
+// CHECK:         }
+// CHECK-NOT:     air.dma_memcpy_nd ({{.*}}, %[[ACC]][] [] [])
+// CHECK:         %[[BIAS:.*]] = memref.alloc() : memref<32xf32, 2 : i32>
+// CHECK:         %[[OUT:.*]] = memref.alloc() : memref<32x32xf32, 2 : i32>
+// CHECK:         air.dma_memcpy_nd (%[[BIAS]][] [] [], %{{.*}}[%{{.*}}] [%{{.*}}] [%{{.*}}])
+// CHECK:         linalg.generic {{.*}} ins(%[[ACC]], %[[BIAS]] : memref<32x32xf32, 2 : i32>, memref<32xf32, 2 : i32>) outs(%[[OUT]] : memref<32x32xf32, 2 : i32>)
+// CHECK:         air.dma_memcpy_nd (%{{.*}}[%{{.*}}, %{{.*}}] [%{{.*}}, %{{.*}}] [%{{.*}}, %{{.*}}], %[[OUT]][] [] [])
+// CHECK:         memref.dealloc %[[ACC]] : memref<32x32xf32, 2 : i32>
+// CHECK-NEXT:    }
+// CHECK-NOT:   air.herd
+
+// SMALL-LABEL: func.func @matmul_bias
+// SMALL-COUNT-2: air.herd @
+
+#map = affine_map<()[s0] -> (s0 * 32)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+#map2 = affine_map<(d0, d1) -> (d1)>
+module {
+  func.func @matmul_bias(%a: memref<64x64xf32, 1 : i32>, %b: memref<64x64xf32, 1 : i32>, %bias: memref<64xf32, 1 : i32>, %d: memref<64x64xf32, 1 : i32>) {
+    %c2 = arith.constant 2 : index
+    %c = memref.alloc() : memref<64x64xf32, 1 : i32>
+    air.herd @matmul tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%ha=%a, %hb=%b, %hc=%c) : memref<64x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %cst = arith.constant 0.000000e+00 : f32
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %acc = memref.alloc() : memref<32x32xf32, 2 : i32>
+      linalg.fill ins(%cst : f32) outs(%acc : memref<32x32xf32, 2 : i32>)
+      scf.for %k = %c0 to %c64 step %c32 {
+        %la = memref.alloc() : memref<32x32xf32, 2 : i32>
+        %lb = memref.alloc() : memref<32x32xf32, 2 : i32>
+        air.dma_memcpy_nd (%la[] [] [], %ha[%x, %k] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x64xf32, 1 : i32>)
+        air.dma_memcpy_nd (%lb[] [] [], %hb[%k, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x64xf32, 1 : i32>)
+        linalg.matmul ins(%la, %lb : memref<32x32xf32, 2 : i32>, memref<32x32xf32, 2 : i32>) outs(%acc : memref<32x32xf32, 2 : i32>)
+        memref.dealloc %la : memref<32x32xf32, 2 : i32>
+        memref.dealloc %lb : memref<32x32xf32, 2 : i32>
+      }
+      air.dma_memcpy_nd (%hc[%x, %y] [%c32, %c32] [%c64, %c1], %acc[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %acc : memref<32x32xf32, 2 : i32>
+    }
+    air.herd @bias tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%hc=%c, %hbias=%bias, %hd=%d) : memref<64x64xf32, 1 : i32>, memref<64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %in = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %lbias = memref.alloc() : memref<32xf32, 2 : i32>
+      %out = memref.alloc() : memref<32x32xf32, 2 : i32>
+      air.dma_memcpy_nd (%in[] [] [], %hc[%x, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x64xf32, 1 : i32>)
+      air.dma_memcpy_nd (%lbias[] [] [], %hbias[%y] [%c32] [%c1]) : (memref<32xf32, 2 : i32>, memref<64xf32, 1 : i32>)
+      linalg.generic {indexing_maps = [#map1, #map2, #map1], iterator_types = ["parallel", "parallel"]} ins(%in, %lbias : memref<32x32xf32, 2 : i32>, memref<32xf32, 2 : i32>) outs(%out : memref<32x32xf32, 2 : i32>) {
+      ^bb0(%i: f32, %bv: f32, %o: f32):
+        %s = arith.addf %i, %bv : f32
+        linalg.yield %s : f32
+      }
+      air.dma_memcpy_nd (%hd[%x, %y] [%c32, %c32] [%c64, %c1], %out[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %in : memref<32x32xf32, 2 : i32>
+      memref.dealloc %lbias : memref<32xf32, 2 : i32>
+      memref.dealloc %out : memref<32x32xf32, 2 : i32>
+    }
+    memref.dealloc %c : memref<64x64xf32, 1 : i32>
+    return
+  }
+}
+
+// -----
+
+// A matmul followed by a ReLU, whose input is also a function argument the
+// caller reads: the ReLU is fused and the matmul result is still stored.
+
+// CHECK-LABEL: func.func @matmul_relu
+// CHECK:       air.herd @matmul
+// CHECK:         %[[ACC:.*]] = memref.alloc() : memref<32x32xf32, 2 : i32>
+// CHECK:         linalg.matmul
+// CHECK:         air.dma_memcpy_nd ({{.*}}, %[[ACC]][] [] [])
+// CHECK:         linalg.generic {{.*}} ins(%[[ACC]] : memref<32x32xf32, 2 : i32>)
+// CHECK:         memref.dealloc %[[ACC]] : memref<32x32xf32, 2 : i32>
+// CHECK-NEXT:    }
+// CHECK-NOT:   air.herd
+
+#map = affine_map<()[s0] -> (s0 * 32)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+module {
+  func.func @matmul_relu(%a: memref<64x32xf32, 1 : i32>, %b: memref<32x64xf32, 1 : i32>, %c: memref<64x64xf32, 1 : i32>, %d: memref<64x64xf32, 1 : i32>) {
+    %c2 = arith.constant 2 : index
+    air.herd @matmul tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%ha=%a, %hb=%b, %hc=%c) : memref<64x32xf32, 1 : i32>, memref<32x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %cst = arith.constant 0.000000e+00 : f32
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %acc = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %la = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %lb = memref.alloc() : memref<32x32xf32, 2 : i32>
+      linalg.fill ins(%cst : f32) outs(%acc : memref<32x32xf32, 2 : i32>)
+      air.dma_memcpy_nd (%la[] [] [], %ha[%x, %c1] [%c32, %c32] [%c32, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x32xf32, 1 : i32>)
+      air.dma_memcpy_nd (%lb[] [] [], %hb[%c1, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<32x64xf32, 1 : i32>)
+      linalg.matmul ins(%la, %lb : memref<32x32xf32, 2 : i32>, memref<32x32xf32, 2 : i32>) outs(%acc : memref<32x32xf32, 2 : i32>)
+      air.dma_memcpy_nd (%hc[%x, %y] [%c32, %c32] [%c64, %c1], %acc[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %la : memref<32x32xf32, 2 : i32>
+      memref.dealloc %lb : memref<32x32xf32, 2 : i32>
+      memref.dealloc %acc : memref<32x32xf32, 2 : i32>
+    }
+    air.herd @relu tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%hc=%c, %hd=%d) : memref<64x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %in = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %out = memref.alloc() : memref<32x32xf32, 2 : i32>
+      air.dma_memcpy_nd (%in[] [] [], %hc[%x, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x64xf32, 1 : i32>)
+      linalg.generic {indexing_maps = [#map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%in : memref<32x32xf32, 2 : i32>) outs(%out : memref<32x32xf32, 2 : i32>) {
+      ^bb0(%i: f32, %o: f32):
+        %zero = arith.constant 0.000000e+00 : f32
+        %r = arith.maximumf %i, %zero : f32
+        linalg.yield %r : f32
+      }
+      air.dma_memcpy_nd (%hd[%x, %y] [%c32, %c32] [%c64, %c1], %out[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %in : memref<32x32xf32, 2 : i32>
+      memref.dealloc %out : memref<32x32xf32, 2 : i32>
+    }
+    return
+  }
+}
+
+// -----
+
+// The matmul result goes to a local buffer, but a view of it taken up front
+// is copied out after the ReLU: the matmul result is still stored.
+
+// CHECK-LABEL: func.func @matmul_relu_view
+// CHECK:       air.herd @matmul
+// CHECK:         %[[ACC:.*]] = memref.alloc() : memref<32x32xf32, 2 : i32>
+// CHECK:         linalg.matmul
+// CHECK:         air.dma_memcpy_nd ({{.*}}, %[[ACC]][] [] [])
+// CHECK:         linalg.generic {{.*}} ins(%[[ACC]] : memref<32x32xf32, 2 : i32>)
+// CHECK-NOT:   air.herd
+// CHECK:       memref.copy
+
+#map = affine_map<()[s0] -> (s0 * 32)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+module {
+  func.func @matmul_relu_view(%a: memref<64x32xf32, 1 : i32>, %b: memref<32x64xf32, 1 : i32>, %d: memref<64x64xf32, 1 : i32>, %e: memref<32x64xf32, 1 : i32>) {
+    %c2 = arith.constant 2 : index
+    %c = memref.alloc() : memref<64x64xf32, 1 : i32>
+    %top = memref.subview %c[0, 0] [32, 64] [1, 1] : memref<64x64xf32, 1 : i32> to memref<32x64xf32, strided<[64, 1]>, 1 : i32>
+    air.herd @matmul tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%ha=%a, %hb=%b, %hc=%c) : memref<64x32xf32, 1 : i32>, memref<32x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %cst = arith.constant 0.000000e+00 : f32
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %acc = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %la = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %lb = memref.alloc() : memref<32x32xf32, 2 : i32>
+      linalg.fill ins(%cst : f32) outs(%acc : memref<32x32xf32, 2 : i32>)
+      air.dma_memcpy_nd (%la[] [] [], %ha[%x, %c1] [%c32, %c32] [%c32, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x32xf32, 1 : i32>)
+      air.dma_memcpy_nd (%lb[] [] [], %hb[%c1, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<32x64xf32, 1 : i32>)
+      linalg.matmul ins(%la, %lb : memref<32x32xf32, 2 : i32>, memref<32x32xf32, 2 : i32>) outs(%acc : memref<32x32xf32, 2 : i32>)
+      air.dma_memcpy_nd (%hc[%x, %y] [%c32, %c32] [%c64, %c1], %acc[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %la : memref<32x32xf32, 2 : i32>
+      memref.dealloc %lb : memref<32x32xf32, 2 : i32>
+      memref.dealloc %acc : memref<32x32xf32, 2 : i32>
+    }
+    air.herd @relu tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%hc=%c, %hd=%d) : memref<64x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %in = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %out = memref.alloc() : memref<32x32xf32, 2 : i32>
+      air.dma_memcpy_nd (%in[] [] [], %hc[%x, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x64xf32, 1 : i32>)
+      linalg.generic {indexing_maps = [#map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%in : memref<32x32xf32, 2 : i32>) outs(%out : memref<32x32xf32, 2 : i32>) {
+      ^bb0(%i: f32, %o: f32):
+        %zero = arith.constant 0.000000e+00 : f32
+        %r = arith.maximumf %i, %zero : f32
+        linalg.yield %r : f32
+      }
+      air.dma_memcpy_nd (%hd[%x, %y] [%c32, %c32] [%c64, %c1], %out[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %in : memref<32x32xf32, 2 : i32>
+      memref.dealloc %out : memref<32x32xf32, 2 : i32>
+    }
+    memref.copy %top, %e : memref<32x64xf32, strided<[64, 1]>, 1 : i32> to memref<32x64xf32, 1 : i32>
+    memref.dealloc %c : memref<64x64xf32, 1 : i32>
+    return
+  }
+}
+
+
+// -----
+
+// The second herd reads the transposed tile, which another tile of the
+// matmul herd writes: nothing is fused.
+
+// CHECK-LABEL: func.func @transposed_tile
+// CHECK-COUNT-2: air.herd @
+
+#map = affine_map<()[s0] -> (s0 * 32)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+module {
+  func.func @transposed_tile(%a: memref<64x32xf32, 1 : i32>, %b: memref<32x64xf32, 1 : i32>, %d: memref<64x64xf32, 1 : i32>) {
+    %c2 = arith.constant 2 : index
+    %c = memref.alloc() : memref<64x64xf32, 1 : i32>
+    air.herd @matmul tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%ha=%a, %hb=%b, %hc=%c) : memref<64x32xf32, 1 : i32>, memref<32x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %acc = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %la = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %lb = memref.alloc() : memref<32x32xf32, 2 : i32>
+      air.dma_memcpy_nd (%la[] [] [], %ha[%x, %c1] [%c32, %c32] [%c32, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x32xf32, 1 : i32>)
+      air.dma_memcpy_nd (%lb[] [] [], %hb[%c1, %y] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<32x64xf32, 1 : i32>)
+      linalg.matmul ins(%la, %lb : memref<32x32xf32, 2 : i32>, memref<32x32xf32, 2 : i32>) outs(%acc : memref<32x32xf32, 2 : i32>)
+      air.dma_memcpy_nd (%hc[%x, %y] [%c32, %c32] [%c64, %c1], %acc[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %la : memref<32x32xf32, 2 : i32>
+      memref.dealloc %lb : memref<32x32xf32, 2 : i32>
+      memref.dealloc %acc : memref<32x32xf32, 2 : i32>
+    }
+    air.herd @relu tile (%tx, %ty) in (%sx=%c2, %sy=%c2) args(%hc=%c, %hd=%d) : memref<64x64xf32, 1 : i32>, memref<64x64xf32, 1 : i32> {
+      %c1 = arith.constant 1 : index
+      %c32 = arith.constant 32 : index
+      %c64 = arith.constant 64 : index
+      %x = affine.apply #map()[%tx]
+      %y = affine.apply #map()[%ty]
+      %in = memref.alloc() : memref<32x32xf32, 2 : i32>
+      %out = memref.alloc() : memref<32x32xf32, 2 : i32>
+      air.dma_memcpy_nd (%in[] [] [], %hc[%y, %x] [%c32, %c32] [%c64, %c1]) : (memref<32x32xf32, 2 : i32>, memref<64x64xf32, 1 : i32>)
+      linalg.generic {indexing_maps = [#map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%in : memref<32x32xf32, 2 : i32>) outs(%out : memref<32x32xf32, 2 : i32>) {
+      ^bb0(%i: f32, %o: f32):
+        %zero = arith.constant 0.000000e+00 : f32
+        %r = arith.maximumf %i, %zero : f32
+        linalg.yield %r : f32
+      }
+      air.dma_memcpy_nd (%hd[%x, %y] [%c32, %c32] [%c64, %c1], %out[] [] []) : (memref<64x64xf32, 1 : i32>, memref<32x32xf32, 2 : i32>)
+      memref.dealloc %in : memref<32x32xf32, 2 : i32>
+      memref.dealloc %out : memref<32x32xf32, 2 : i32>
+    }
+    memref.dealloc %c : memref<64x64xf32, 1 : i32>
+    return
+  }
+}
@@ -0,0 +1,292 @@
+//===- fuse_launches.mlir --------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-fuse-launches -split-input-file | FileCheck %s
+
+// Two layers over a [1, 4] herd grid. The intermediate %t moves to an L2
+// buffer of the fused segment, and the launch in between, which only
+// touches other buffers, stays in front of it.
+
+// CHECK-LABEL: func.func @two_layers
+// CHECK-NOT:   memref.alloc() : memref<256xi32>
+// CHECK:       air.launch @other
+// CHECK:       air.launch @layer0 ({{.*}}) in ({{.*}}) args(%[[A:.*]]=%arg0, %[[B:.*]]=%arg1) : memref<256xi32>, memref<256xi32>
+// CHECK:         air.segment @seg0 args(%[[SA:.*]]=%[[A]], %[[SB:.*]]=%[[B]]) : memref<256xi32>, memref<256xi32>
+// CHECK:           %[[L2:.*]] = memref.alloc() : memref<256xi32, 1 : i32>
+// CHECK:           air.herd @herd0 {{.*}} args(%{{.*}}=%[[SA]], %[[H0T:.*]]=%[[L2]]) : memref<256xi32>, memref<256xi32, 1 : i32>
+// CHECK:             air.dma_memcpy_nd (%[[H0T]][%{{.*}}] [%{{.*}}] [%{{.*}}], %{{.*}}[] [] []) : (memref<256xi32, 1 : i32>, memref<64xi32, 2 : i32>)
+// CHECK:           air.herd @herd1 {{.*}} args(%[[H1T:.*]]=%[[L2]], %{{.*}}=%[[SB]]) : memref<256xi32, 1 : i32>, memref<256xi32>
+// CHECK:             air.dma_memcpy_nd (%{{.*}}[] [] [], %[[H1T]][%{{.*}}] [%{{.*}}] [%{{.*}}]) : (memref<64xi32, 2 : i32>, memref<256xi32, 1 : i32>)
+// CHECK:           memref.dealloc %[[L2]] : memref<256xi32, 1 : i32>
+// CHECK-NOT:   air.launch
+// CHECK-NOT:   memref.dealloc
+
+module {
+  func.func @two_layers(%arg0: memref<256xi32>, %arg1: memref<256xi32>, %arg2: memref<16xi32>) {
+    %c1 = arith.constant 1 : index
+    %t = memref.alloc() : memref<256xi32>
+    air.launch @layer0 (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%la=%arg0, %lt=%t) : memref<256xi32>, memref<256xi32> {
+      air.segment @seg0 args(%sa=%la, %st=%lt) : memref<256xi32>, memref<256xi32> {
+        %c1_0 = arith.constant 1 : index
+        %c4 = arith.constant 4 : index
+        air.herd @herd0 tile (%tx, %ty) in (%sx=%c1_0, %sy=%c4) args(%ha=%sa, %ht=%st) : memref<256xi32>, memref<256xi32> {
+          %c1_1 = arith.constant 1 : index
+          %c64 = arith.constant 64 : index
+          %off = arith.muli %ty, %c64 : index
+          %l1 = memref.alloc() : memref<64xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ha[%off] [%c64] [%c1_1]) : (memref<64xi32, 2 : i32>, memref<256xi32>)
+          air.dma_memcpy_nd (%ht[%off] [%c64] [%c1_1], %l1[] [] []) : (memref<256xi32>, memref<64xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<64xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch @other (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%lc=%arg2) : memref<16xi32> {
+      air.segment @seg_other args(%sc=%lc) : memref<16xi32> {
+        %c1_0 = arith.constant 1 : index
+        air.herd @herd_other tile (%tx, %ty) in (%sx=%c1_0, %sy=%c1_0) args(%hc=%sc) : memref<16xi32> {
+          %l1 = memref.alloc() : memref<16xi32, 2 : i32>
+          air.dma_memcpy_nd (%hc[] [] [], %l1[] [] []) : (memref<16xi32>, memref<16xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<16xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch @layer1 (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%lt=%t, %lb=%arg1) : memref<256xi32>, memref<256xi32> {
+      air.segment @seg1 args(%st=%lt, %sb=%lb) : memref<256xi32>, memref<256xi32> {
+        %c1_0 = arith.constant 1 : index
+        %c4 = arith.constant 4 : index
+        air.herd @herd1 tile (%tx, %ty) in (%sx=%c1_0, %sy=%c4) args(%ht=%st, %hb=%sb) : memref<256xi32>, memref<256xi32> {
+          %c1_1 = arith.constant 1 : index
+          %c64 = arith.constant 64 : index
+          %off = arith.muli %ty, %c64 : index
+          %l1 = memref.alloc() : memref<64xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ht[%off] [%c64] [%c1_1]) : (memref<64xi32, 2 : i32>, memref<256xi32>)
+          air.dma_memcpy_nd (%hb[%off] [%c64] [%c1_1], %l1[] [] []) : (memref<256xi32>, memref<64xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<64xi32, 2 : i32>
+        }
+      }
+    }
+    memref.dealloc %t : memref<256xi32>
+    return
+  }
+}
+
+// -----
+
+// The intermediate does not fit in L2, or is a function argument that the
+// caller may read: the launches stay apart.
+
+// CHECK-LABEL: func.func @no_fusion
+// CHECK:       memref.alloc() : memref<262144xi32>
+// CHECK-COUNT-4: air.launch
+
+module {
+  func.func @no_fusion(%arg0: memref<262144xi32>, %arg1: memref<262144xi32>, %arg2: memref<256xi32>) {
+    %c1 = arith.constant 1 : index
+    %t = memref.alloc() : memref<262144xi32>
+    air.launch (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%la=%arg0, %lt=%t) : memref<262144xi32>, memref<262144xi32> {
+      air.segment @big0 args(%sa=%la, %st=%lt) : memref<262144xi32>, memref<262144xi32> {
+        %c1_0 = arith.constant 1 : index
+        air.herd @h0 tile (%tx, %ty) in (%sx=%c1_0, %sy=%c1_0) args(%ha=%sa, %ht=%st) : memref<262144xi32>, memref<262144xi32> {
+          %l1 = memref.alloc() : memref<64xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ha[] [] []) : (memref<64xi32, 2 : i32>, memref<262144xi32>)
+          air.dma_memcpy_nd (%ht[] [] [], %l1[] [] []) : (memref<262144xi32>, memref<64xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<64xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%lt=%t, %lb=%arg1) : memref<262144xi32>, memref<262144xi32> {
+      air.segment @big1 args(%st=%lt, %sb=%lb) : memref<262144xi32>, memref<262144xi32> {
+        %c1_0 = arith.constant 1 : index
+        air.herd @h1 tile (%tx, %ty) in (%sx=%c1_0, %sy=%c1_0) args(%ht=%st, %hb=%sb) : memref<262144xi32>, memref<262144xi32> {
+          %l1 = memref.alloc() : memref<64xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ht[] [] []) : (memref<64xi32, 2 : i32>, memref<262144xi32>)
+          air.dma_memcpy_nd (%hb[] [] [], %l1[] [] []) : (memref<262144xi32>, memref<64xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<64xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%la=%arg0, %lt=%arg2) : memref<262144xi32>, memref<256xi32> {
+      air.segment @seg2 args(%sa=%la, %st=%lt) : memref<262144xi32>, memref<256xi32> {
+        %c1_0 = arith.constant 1 : index
+        air.herd @h2 tile (%tx, %ty) in (%sx=%c1_0, %sy=%c1_0) args(%ha=%sa, %ht=%st) : memref<262144xi32>, memref<256xi32> {
+          %l1 = memref.alloc() : memref<64xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ha[] [] []) : (memref<64xi32, 2 : i32>, memref<262144xi32>)
+          air.dma_memcpy_nd (%ht[] [] [], %l1[] [] []) : (memref<256xi32>, memref<64xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<64xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch (%lx, %ly) in (%lsx=%c1, %lsy=%c1) args(%lt=%arg2, %lb=%arg1) : memref<256xi32>, memref<262144xi32> {
+      air.segment @seg3 args(%st=%lt, %sb=%lb) : memref<256xi32>, memref<262144xi32> {
+        %c1_0 = arith.constant 1 : index
+        air.herd @h3 tile (%tx, %ty) in (%sx=%c1_0, %sy=%c1_0) args(%ht=%st, %hb=%sb) : memref<256xi32>, memref<262144xi32> {
+          %l1 = memref.alloc() : memref<64xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ht[] [] []) : (memref<64xi32, 2 : i32>, memref<256xi32>)
+          air.dma_memcpy_nd (%hb[] [] [], %l1[] [] []) : (memref<262144xi32>, memref<64xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<64xi32, 2 : i32>
+        }
+      }
+    }
+    memref.dealloc %t : memref<262144xi32>
+    return
+  }
+}
+
+// -----
+
+// A [2, 2] launch grid, where each launch instance reads back the tile of
+// the intermediate it wrote: every instance stages its own copy of it in L2.
+
+// CHECK-LABEL: func.func @same_tiles
+// CHECK-NOT:   memref.alloc() : memref<16x16xi32>
+// CHECK:       air.launch
+// CHECK:         air.segment @same_tiles0
+// CHECK:           memref.alloc() : memref<16x16xi32, 1 : i32>
+// CHECK-NOT:   air.launch
+
+module {
+  func.func @same_tiles(%arg0: memref<16x16xi32>, %arg1: memref<16x16xi32>) {
+    %c2 = arith.constant 2 : index
+    %t = memref.alloc() : memref<16x16xi32>
+    air.launch (%lx, %ly) in (%lsx=%c2, %lsy=%c2) args(%la=%arg0, %lt=%t) : memref<16x16xi32>, memref<16x16xi32> {
+      air.segment @same_tiles0 args(%sx=%lx, %sy=%ly, %sa=%la, %st=%lt) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+        %c1 = arith.constant 1 : index
+        air.herd @same_tiles_h0 tile (%tx, %ty) in (%hsx=%c1, %hsy=%c1) args(%hx=%sx, %hy=%sy, %ha=%sa, %ht=%st) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+          %c1_0 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %c16 = arith.constant 16 : index
+          %row = arith.muli %hx, %c8 : index
+          %col = arith.muli %hy, %c8 : index
+          %l1 = memref.alloc() : memref<8x8xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ha[%row, %col] [%c8, %c8] [%c16, %c1_0]) : (memref<8x8xi32, 2 : i32>, memref<16x16xi32>)
+          air.dma_memcpy_nd (%ht[%row, %col] [%c8, %c8] [%c16, %c1_0], %l1[] [] []) : (memref<16x16xi32>, memref<8x8xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<8x8xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch (%lx, %ly) in (%lsx=%c2, %lsy=%c2) args(%lt=%t, %lb=%arg1) : memref<16x16xi32>, memref<16x16xi32> {
+      air.segment @same_tiles1 args(%sx=%lx, %sy=%ly, %st=%lt, %sb=%lb) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+        %c1 = arith.constant 1 : index
+        air.herd @same_tiles_h1 tile (%tx, %ty) in (%hsx=%c1, %hsy=%c1) args(%hx=%sx, %hy=%sy, %ht=%st, %hb=%sb) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+          %c1_0 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %c16 = arith.constant 16 : index
+          %row = arith.muli %hx, %c8 : index
+          %col = arith.muli %hy, %c8 : index
+          %l1 = memref.alloc() : memref<8x8xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ht[%row, %col] [%c8, %c8] [%c16, %c1_0]) : (memref<8x8xi32, 2 : i32>, memref<16x16xi32>)
+          air.dma_memcpy_nd (%hb[%row, %col] [%c8, %c8] [%c16, %c1_0], %l1[] [] []) : (memref<16x16xi32>, memref<8x8xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<8x8xi32, 2 : i32>
+        }
+      }
+    }
+    memref.dealloc %t : memref<16x16xi32>
+    return
+  }
+}
+
+// -----
+
+// The consumer reads the transposed tile, written by another launch
+// instance: the launches stay apart.
+
+// CHECK-LABEL: func.func @transposed_tiles
+// CHECK:       memref.alloc() : memref<16x16xi32>
+// CHECK-COUNT-2: air.launch
+
+module {
+  func.func @transposed_tiles(%arg0: memref<16x16xi32>, %arg1: memref<16x16xi32>) {
+    %c2 = arith.constant 2 : index
+    %t = memref.alloc() : memref<16x16xi32>
+    air.launch (%lx, %ly) in (%lsx=%c2, %lsy=%c2) args(%la=%arg0, %lt=%t) : memref<16x16xi32>, memref<16x16xi32> {
+      air.segment @transposed_tiles0 args(%sx=%lx, %sy=%ly, %sa=%la, %st=%lt) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+        %c1 = arith.constant 1 : index
+        air.herd @transposed_tiles_h0 tile (%tx, %ty) in (%hsx=%c1, %hsy=%c1) args(%hx=%sx, %hy=%sy, %ha=%sa, %ht=%st) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+          %c1_0 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %c16 = arith.constant 16 : index
+          %row = arith.muli %hx, %c8 : index
+          %col = arith.muli %hy, %c8 : index
+          %l1 = memref.alloc() : memref<8x8xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ha[%row, %col] [%c8, %c8] [%c16, %c1_0]) : (memref<8x8xi32, 2 : i32>, memref<16x16xi32>)
+          air.dma_memcpy_nd (%ht[%row, %col] [%c8, %c8] [%c16, %c1_0], %l1[] [] []) : (memref<16x16xi32>, memref<8x8xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<8x8xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch (%lx, %ly) in (%lsx=%c2, %lsy=%c2) args(%lt=%t, %lb=%arg1) : memref<16x16xi32>, memref<16x16xi32> {
+      air.segment @transposed_tiles1 args(%sx=%lx, %sy=%ly, %st=%lt, %sb=%lb) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+        %c1 = arith.constant 1 : index
+        air.herd @transposed_tiles_h1 tile (%tx, %ty) in (%hsx=%c1, %hsy=%c1) args(%hx=%sx, %hy=%sy, %ht=%st, %hb=%sb) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+          %c1_0 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %c16 = arith.constant 16 : index
+          %row = arith.muli %hx, %c8 : index
+          %col = arith.muli %hy, %c8 : index
+          %l1 = memref.alloc() : memref<8x8xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ht[%col, %row] [%c8, %c8] [%c16, %c1_0]) : (memref<8x8xi32, 2 : i32>, memref<16x16xi32>)
+          air.dma_memcpy_nd (%hb[%row, %col] [%c8, %c8] [%c16, %c1_0], %l1[] [] []) : (memref<16x16xi32>, memref<8x8xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<8x8xi32, 2 : i32>
+        }
+      }
+    }
+    memref.dealloc %t : memref<16x16xi32>
+    return
+  }
+}
+
+// -----
+
+// Each consumer instance reads back its own tile of the intermediate, but
+// writes %arg0 in place, which the producer reads: a consumer instance could
+// overwrite a tile that another producer instance has yet to read, so the
+// launches stay apart.
+
+// CHECK-LABEL: func.func @shared_written
+// CHECK:       memref.alloc() : memref<16x16xi32>
+// CHECK-COUNT-2: air.launch
+
+module {
+  func.func @shared_written(%arg0: memref<16x16xi32>, %arg1: memref<16x16xi32>) {
+    %c2 = arith.constant 2 : index
+    %t = memref.alloc() : memref<16x16xi32>
+    air.launch (%lx, %ly) in (%lsx=%c2, %lsy=%c2) args(%la=%arg0, %lt=%t) : memref<16x16xi32>, memref<16x16xi32> {
+      air.segment @shared_written0 args(%sx=%lx, %sy=%ly, %sa=%la, %st=%lt) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+        %c1 = arith.constant 1 : index
+        air.herd @shared_written_h0 tile (%tx, %ty) in (%hsx=%c1, %hsy=%c1) args(%hx=%sx, %hy=%sy, %ha=%sa, %ht=%st) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+          %c1_0 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %c16 = arith.constant 16 : index
+          %row = arith.muli %hx, %c8 : index
+          %col = arith.muli %hy, %c8 : index
+          %l1 = memref.alloc() : memref<8x8xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ha[%row, %col] [%c8, %c8] [%c16, %c1_0]) : (memref<8x8xi32, 2 : i32>, memref<16x16xi32>)
+          air.dma_memcpy_nd (%ht[%row, %col] [%c8, %c8] [%c16, %c1_0], %l1[] [] []) : (memref<16x16xi32>, memref<8x8xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<8x8xi32, 2 : i32>
+        }
+      }
+    }
+    air.launch (%lx, %ly) in (%lsx=%c2, %lsy=%c2) args(%lt=%t, %lb=%arg0) : memref<16x16xi32>, memref<16x16xi32> {
+      air.segment @shared_written1 args(%sx=%lx, %sy=%ly, %st=%lt, %sb=%lb) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+        %c1 = arith.constant 1 : index
+        air.herd @shared_written_h1 tile (%tx, %ty) in (%hsx=%c1, %hsy=%c1) args(%hx=%sx, %hy=%sy, %ht=%st, %hb=%sb) : index, index, memref<16x16xi32>, memref<16x16xi32> {
+          %c1_0 = arith.constant 1 : index
+          %c8 = arith.constant 8 : index
+          %c16 = arith.constant 16 : index
+          %row = arith.muli %hx, %c8 : index
+          %col = arith.muli %hy, %c8 : index
+          %l1 = memref.alloc() : memref<8x8xi32, 2 : i32>
+          air.dma_memcpy_nd (%l1[] [] [], %ht[%row, %col] [%c8, %c8] [%c16, %c1_0]) : (memref<8x8xi32, 2 : i32>, memref<16x16xi32>)
+          air.dma_memcpy_nd (%hb[%row, %col] [%c8, %c8] [%c16, %c1_0], %l1[] [] []) : (memref<16x16xi32>, memref<8x8xi32, 2 : i32>)
+          memref.dealloc %l1 : memref<8x8xi32, 2 : i32>
+        }
+      }
+    }
+    memref.dealloc %t : memref<16x16xi32>
+    return
+  }
+}
@@ -0,0 +1,81 @@
+//===- annealing_placement.mlir ---------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-place-herds='num-rows=2 num-cols=2 row-anchor=2 col-anchor=0 placement-mode=annealing annealing-seed=7' --split-input-file -verify-diagnostics | FileCheck %s
+
+// Greedy placement puts @herd_a at (0, 0), @herd_b at (1, 0) and @herd_c at
+// (0, 1), so the 4096 bytes sent from @herd_b to @herd_c travel 2 hops.
+// Annealing moves the two communicating herds next to each other, with
+// @herd_b stacked directly above @herd_c.
+
+// CHECK-LABEL: @herd_to_herd
+// CHECK: air.herd @herd_a {{.*}} attributes {{{.*}}x_loc = 1 : i64, y_loc = 2 : i64}
+// CHECK: air.herd @herd_b {{.*}} attributes {{{.*}}x_loc = 0 : i64, y_loc = 3 : i64}
+// CHECK: air.herd @herd_c {{.*}} attributes {{{.*}}x_loc = 0 : i64, y_loc = 2 : i64}
+
+module {
+  air.channel @BToC [1, 1]
+  func.func @herd_to_herd() {
+    %c1 = arith.constant 1 : index
+    air.launch (%arg0, %arg1) in (%arg2=%c1, %arg3=%c1) {
+      // expected-remark @below {{estimated routing cost: 8192 -> 4096}}
+      air.segment @segment_0 {
+        %c1_0 = arith.constant 1 : index
+        air.herd @herd_a tile (%arg4, %arg5) in (%arg6=%c1_0, %arg7=%c1_0) {
+          %alloc = memref.alloc() : memref<32x32xi32, 2 : i32>
+          memref.dealloc %alloc : memref<32x32xi32, 2 : i32>
+        }
+        air.herd @herd_b tile (%arg4, %arg5) in (%arg6=%c1_0, %arg7=%c1_0) {
+          %alloc = memref.alloc() : memref<32x32xi32, 2 : i32>
+          air.channel.put @BToC[] (%alloc[] [] []) : (memref<32x32xi32, 2 : i32>)
+          memref.dealloc %alloc : memref<32x32xi32, 2 : i32>
+        }
+        air.herd @herd_c tile (%arg4, %arg5) in (%arg6=%c1_0, %arg7=%c1_0) {
+          %alloc = memref.alloc() : memref<32x32xi32, 2 : i32>
+          air.channel.get @BToC[] (%alloc[] [] []) : (memref<32x32xi32, 2 : i32>)
+          memref.dealloc %alloc : memref<32x32xi32, 2 : i32>
+        }
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// A single herd reading from L2 sits right above the memtile row already, and
+// is left in place.
+
+// CHECK-LABEL: @herd_from_l2
+// CHECK: air.herd @herd_0 {{.*}} attributes {{{.*}}x_loc = 0 : i64, y_loc = 2 : i64}
+
+module {
+  air.channel @L2ToL1 [1, 1]
+  func.func @herd_from_l2() {
+    %c1 = arith.constant 1 : index
+    air.launch (%arg0, %arg1) in (%arg2=%c1, %arg3=%c1) {
+      // expected-remark @below {{estimated routing cost: 16384 -> 16384}}
+      air.segment @segment_0 {
+        %c1_0 = arith.constant 1 : index
+        %alloc_l2 = memref.alloc() : memref<32x32xi32, 1 : i32>
+        air.channel.put @L2ToL1[] (%alloc_l2[] [] []) : (memref<32x32xi32, 1 : i32>)
+        air.herd @herd_0 tile (%arg4, %arg5) in (%arg6=%c1_0, %arg7=%c1_0) {
+          %c0_1 = arith.constant 0 : index
+          %c1_1 = arith.constant 1 : index
+          %c4_1 = arith.constant 4 : index
+          %alloc = memref.alloc() : memref<32x32xi32, 2 : i32>
+          scf.for %arg8 = %c0_1 to %c4_1 step %c1_1 {
+            air.channel.get @L2ToL1[] (%alloc[] [] []) : (memref<32x32xi32, 2 : i32>)
+          }
+          memref.dealloc %alloc : memref<32x32xi32, 2 : i32>
+        }
+        memref.dealloc %alloc_l2 : memref<32x32xi32, 1 : i32>
+      }
+    }
+    return
+  }
+}
@@ -0,0 +1,52 @@
+//===- air_pipeline_reduce_cascade.mlir ------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-pipeline-reduce='pipeline-depth=4 tile-size=0,0,16 channel-type=cascade' | FileCheck %s
+// RUN: air-opt %s -air-pipeline-reduce='pipeline-depth=4 tile-size=0,0,16 pipeline-direction=vert channel-type=cascade' | FileCheck %s --check-prefix=VERT
+
+// K-split matmul pipeline forwarding partial sums over cascade channels. The
+// first stage accumulates into an L1 copy of the output tile.
+
+// CHECK-DAG: #[[SET0:.*]] = affine_set<()[s0, s1] : (s0 == 0, s1 >= 0)>
+// CHECK-DAG: #[[SET3:.*]] = affine_set<()[s0, s1] : (s0 - 3 == 0, s1 >= 0)>
+// CHECK-DAG: air.channel @channel_0 [1] {channel_type = "cascade"}
+// CHECK-DAG: air.channel @channel_1 [1] {channel_type = "cascade"}
+// CHECK-DAG: air.channel @channel_2 [1] {channel_type = "cascade"}
+// CHECK-NOT: air.channel @channel_3
+// CHECK: func.func @matmul_k_split
+// CHECK: air.herd
+// CHECK: affine.if #[[SET0]]
+// CHECK:   %[[ACC:.*]] = memref.alloc() : memref<32x32xi32, 2 : i32>
+// CHECK:   memref.copy %{{.*}}, %[[ACC]]
+// CHECK:   linalg.matmul {{.*}} outs(%[[ACC]] : memref<32x32xi32, 2 : i32>)
+// CHECK:   air.channel.put  @channel_0[] (%[[ACC]][] [] [])
+// CHECK:   memref.dealloc %[[ACC]] : memref<32x32xi32, 2 : i32>
+// CHECK: affine.if
+// CHECK:   air.channel.get  @channel_0[]
+// CHECK:   air.channel.put  @channel_1[]
+// CHECK: affine.if
+// CHECK:   air.channel.get  @channel_1[]
+// CHECK:   air.channel.put  @channel_2[]
+// CHECK: affine.if #[[SET3]]
+// CHECK:   %[[LAST:.*]] = memref.alloc() : memref<32x32xi32, 2 : i32>
+// CHECK:   air.channel.get  @channel_2[] (%[[LAST]][] [] [])
+// CHECK:   linalg.matmul {{.*}} outs(%[[LAST]] : memref<32x32xi32, 2 : i32>)
+// CHECK:   memref.copy %[[LAST]]
+
+// A vertical cascade flows north to south, so the first stage is the top row.
+
+// VERT-DAG: #[[SET0:.*]] = affine_set<()[s0, s1] : (s1 - 3 == 0, s0 >= 0)>
+// VERT-DAG: #[[SET3:.*]] = affine_set<()[s0, s1] : (s1 == 0, s0 >= 0)>
+// VERT: affine.if #[[SET0]]
+// VERT:   air.channel.put  @channel_0[]
+// VERT: affine.if #[[SET3]]
+// VERT:   air.channel.get  @channel_2[]
+
+func.func @matmul_k_split(%arg0: memref<32x64xi32>, %arg1: memref<64x32xi32>, %arg2: memref<32x32xi32>) {
+  linalg.matmul ins(%arg0, %arg1 : memref<32x64xi32>, memref<64x32xi32>) outs(%arg2 : memref<32x32xi32>)
+  return
+}
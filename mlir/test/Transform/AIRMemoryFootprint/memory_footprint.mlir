@@ -0,0 +1,141 @@
+//===- memory_footprint.mlir -----------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt %s -air-memory-footprint -split-input-file | FileCheck %s
+
+// L2 buffers of an async segment over two columns. %late waits for %other
+// to be freed, but not for the ping and pong buffers, which stay live
+// together with it: the peak is 16 KiB + 2 * 4 KiB.
+
+// CHECK:      "ping_pong": {
+// CHECK-NEXT:   "herds": [],
+// CHECK-NEXT:   "segments": [
+// CHECK-NEXT:     {
+// CHECK-NEXT:       "allocations": [
+// CHECK-NEXT:         {
+// CHECK-NEXT:           "bytes": 4096,
+// CHECK-NEXT:           "count": 1,
+// CHECK-NEXT:           "type": "memref<1024xi32, 1 : i32>"
+// CHECK-NEXT:         },
+// CHECK-NEXT:         {
+// CHECK-NEXT:           "bytes": 4096,
+// CHECK-NEXT:           "count": 1,
+// CHECK-NEXT:           "type": "memref<1024xi32, 1 : i32>"
+// CHECK-NEXT:         },
+// CHECK-NEXT:         {
+// CHECK-NEXT:           "bytes": 16384,
+// CHECK-NEXT:           "count": 1,
+// CHECK-NEXT:           "type": "memref<4096xi32, 1 : i32>"
+// CHECK-NEXT:         }
+// CHECK-NEXT:       ],
+// CHECK-NEXT:       "capacity": 1048576,
+// CHECK-NEXT:       "largest_buffer": 16384,
+// CHECK-NEXT:       "memtiles": 2,
+// CHECK-NEXT:       "name": "seg",
+// CHECK-NEXT:       "peak": 24576,
+// CHECK-NEXT:       "slack": 1024000
+
+module {
+  func.func @ping_pong() {
+    %c1 = arith.constant 1 : index
+    %0 = air.launch async (%x, %y) in (%sx=%c1, %sy=%c1) {
+      %1 = air.segment @seg async attributes {x_loc = 0 : i64, x_size = 2 : i64, y_loc = 1 : i64, y_size = 1 : i64} {
+        %t0, %ping = air.execute -> (memref<1024xi32, 1 : i32>) {
+          %a = memref.alloc() : memref<1024xi32, 1 : i32>
+          air.execute_terminator %a : memref<1024xi32, 1 : i32>
+        }
+        %t1, %pong = air.execute -> (memref<1024xi32, 1 : i32>) {
+          %a = memref.alloc() : memref<1024xi32, 1 : i32>
+          air.execute_terminator %a : memref<1024xi32, 1 : i32>
+        }
+        %t2, %other = air.execute -> (memref<2048xi32, 1 : i32>) {
+          %a = memref.alloc() : memref<2048xi32, 1 : i32>
+          air.execute_terminator %a : memref<2048xi32, 1 : i32>
+        }
+        %t3 = air.execute [%t2] {
+          memref.dealloc %other : memref<2048xi32, 1 : i32>
+        }
+        %t4, %late = air.execute [%t3] -> (memref<4096xi32, 1 : i32>) {
+          %a = memref.alloc() : memref<4096xi32, 1 : i32>
+          air.execute_terminator %a : memref<4096xi32, 1 : i32>
+        }
+        %t5 = air.execute [%t4] {
+          memref.dealloc %late : memref<4096xi32, 1 : i32>
+        }
+        %t6 = air.execute [%t0, %t1] {
+          memref.dealloc %ping : memref<1024xi32, 1 : i32>
+        }
+        %t7 = air.execute [%t0, %t1] {
+          memref.dealloc %pong : memref<1024xi32, 1 : i32>
+        }
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// L1 buffers of a synchronous herd. %a is freed before %d is allocated,
+// and the four iterations of the scf.parallel may each hold their buffer
+// at once: the peak is %a, %b and 4 copies of %p.
+
+// CHECK:      "sequential": {
+// CHECK-NEXT:   "herds": [
+// CHECK-NEXT:     {
+// CHECK-NEXT:       "allocations": [
+// CHECK-NEXT:         {
+// CHECK-NEXT:           "bytes": 4096,
+// CHECK-NEXT:           "count": 1,
+// CHECK-NEXT:           "type": "memref<1024xi32, 2 : i32>"
+// CHECK-NEXT:         },
+// CHECK-NEXT:         {
+// CHECK-NEXT:           "bytes": 4096,
+// CHECK-NEXT:           "count": 1,
+// CHECK-NEXT:           "type": "memref<1024xi32, 2 : i32>"
+// CHECK-NEXT:         },
+// CHECK-NEXT:         {
+// CHECK-NEXT:           "bytes": 16384,
+// CHECK-NEXT:           "count": 4,
+// CHECK-NEXT:           "type": "memref<1024xi32, 2 : i32>"
+// CHECK-NEXT:         }
+// CHECK-NEXT:       ],
+// CHECK-NEXT:       "capacity": 65536,
+// CHECK-NEXT:       "name": "herd_0",
+// CHECK-NEXT:       "num_cols": 2,
+// CHECK-NEXT:       "num_rows": 2,
+// CHECK-NEXT:       "peak": 24576,
+// CHECK-NEXT:       "slack": 40960
+// CHECK-NEXT:     }
+// CHECK-NEXT:   ],
+// CHECK-NEXT:   "segments": []
+
+module {
+  func.func @sequential() {
+    %c2 = arith.constant 2 : index
+    air.herd @herd_0 tile (%tx, %ty) in (%sx=%c2, %sy=%c2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c4 = arith.constant 4 : index
+      %a = memref.alloc() : memref<1024xi32, 2 : i32>
+      %b = memref.alloc() : memref<1024xi32, 2 : i32>
+      scf.for %i = %c0 to %c4 step %c1 {
+        %c = memref.alloc() : memref<512xi32, 2 : i32>
+        memref.dealloc %c : memref<512xi32, 2 : i32>
+      }
+      scf.parallel (%i) = (%c0) to (%c4) step (%c1) {
+        %p = memref.alloc() : memref<1024xi32, 2 : i32>
+        memref.dealloc %p : memref<1024xi32, 2 : i32>
+      }
+      memref.dealloc %a : memref<1024xi32, 2 : i32>
+      %d = memref.alloc() : memref<4096xi32, 2 : i32>
+      memref.dealloc %d : memref<4096xi32, 2 : i32>
+      memref.dealloc %b : memref<1024xi32, 2 : i32>
+    }
+    return
+  }
+}
@@ -30,7 +30,7 @@ module {
         %0 = memref.get_global @channel_0 : memref<1x1xi64>
         %1 = builtin.unrealized_conversion_cast %0 : memref<1x1xi64> to memref<1x1xi64>
         %2 = builtin.unrealized_conversion_cast %alloc : memref<32x32xi32> to memref<?x?xi32>
-        func.call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(%1, %c1, %c1, %c1, %c1, %c0, %c0, %2, %c0, %c0, %c32, %c32, %c1, %c32) : (memref<1x1xi64>, index, index, index, index, index, index, memref<?x?xi32>, index, index, index, index, index, index) -> ()
+        func.call @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(%1, %c1, %c1, %c1, %c1, %c1, %c0, %c0, %2, %c0, %c0, %c32, %c32, %c1, %c32) : (memref<1x1xi64>, index, index, index, index, index, index, index, memref<?x?xi32>, index, index, index, index, index, index) -> ()
         memref.dealloc %alloc : memref<32x32xi32>
         scf.yield
       }
@@ -66,7 +66,7 @@ module {
     
     return
   }
-  func.func private @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(memref<1x1xi64>, index, index, index, index, index, index, memref<?x?xi32>, index, index, index, index, index, index) attributes {llvm.emit_c_interface}
+  func.func private @air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(memref<1x1xi64>, index, index, index, index, index, index, index, memref<?x?xi32>, index, index, index, index, index, index) attributes {llvm.emit_c_interface}
   func.func private @air_channel_get_M0D2I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(memref<1x1xi64>, index, index, memref<?x?xi32>, index, index, index, index, index, index) attributes {llvm.emit_c_interface}
 }
 
@@ -0,0 +1,40 @@
+//===- bundle.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+
+// RUN: air-opt -o %T/bundle.llvm.mlir %s -buffer-results-to-out-params -air-to-async -async-to-async-runtime -async-runtime-ref-counting -async-runtime-ref-counting-opt -convert-linalg-to-affine-loops -expand-strided-metadata -lower-affine -convert-scf-to-cf -convert-async-to-llvm -convert-arith-to-llvm -finalize-memref-to-llvm -convert-cf-to-llvm -convert-func-to-llvm -reconcile-unrealized-casts -canonicalize -cse
+// RUN: air-translate --mlir-to-llvmir %T/bundle.llvm.mlir -o %T/bundle.ll
+// RUN: %OPT -O3 -o %T/bundle.opt.bc < %T/bundle.ll
+// RUN: %LLC %T/bundle.opt.bc --relocation-model=pic -filetype=obj -o %T/bundle.o
+// RUN: %CLANG %S/main.cpp -O2 -std=c++17 %airhost_inc -c -o %T/main.o
+// RUN: %CLANG %aircpu_lib %mlir_async_lib -o %T/test.exe %T/main.o %T/bundle.o
+// RUN: %ld_lib_path %T/test.exe
+
+// Each channel of a [4, 1] bundle carries one quarter of the rows of the
+// matrix. The gets read the channels in reverse, reversing the order of the
+// quarters. The bundle is not square, so a put that linearizes its index with
+// the wrong dimension lands on the wrong channel.
+air.channel @channel_0 [4, 1]
+func.func @forward(%arg0 : memref<16x16xi32>, %arg1 : memref<16x16xi32>) -> () {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c3 = arith.constant 3 : index
+  %c4 = arith.constant 4 : index
+  %c8 = arith.constant 8 : index
+  %c12 = arith.constant 12 : index
+  %c16 = arith.constant 16 : index
+  air.channel.put @channel_0[%c0, %c0] (%arg0[%c0, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.put @channel_0[%c1, %c0] (%arg0[%c4, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.put @channel_0[%c2, %c0] (%arg0[%c8, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.put @channel_0[%c3, %c0] (%arg0[%c12, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.get @channel_0[%c3, %c0] (%arg1[%c0, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.get @channel_0[%c2, %c0] (%arg1[%c4, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.get @channel_0[%c1, %c0] (%arg1[%c8, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.get @channel_0[%c0, %c0] (%arg1[%c12, %c0] [%c4, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  return
+}
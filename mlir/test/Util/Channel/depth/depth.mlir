@@ -0,0 +1,31 @@
+//===- depth.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+
+// RUN: air-opt -o %T/depth.llvm.mlir %s -buffer-results-to-out-params -air-to-async -async-to-async-runtime -async-runtime-ref-counting -async-runtime-ref-counting-opt -convert-linalg-to-affine-loops -expand-strided-metadata -lower-affine -convert-scf-to-cf -convert-async-to-llvm -convert-arith-to-llvm -finalize-memref-to-llvm -convert-cf-to-llvm -convert-func-to-llvm -reconcile-unrealized-casts -canonicalize -cse
+// RUN: air-translate --mlir-to-llvmir %T/depth.llvm.mlir -o %T/depth.ll
+// RUN: %OPT -O3 -o %T/depth.opt.bc < %T/depth.ll
+// RUN: %LLC %T/depth.opt.bc --relocation-model=pic -filetype=obj -o %T/depth.o
+// RUN: %CLANG %S/main.cpp -O2 -std=c++17 %airhost_inc -c -o %T/main.o
+// RUN: %CLANG %aircpu_lib %mlir_async_lib -o %T/test.exe %T/main.o %T/depth.o
+// RUN: %ld_lib_path %T/test.exe
+
+// Both puts complete before the first get, which a channel of depth 1 would
+// deadlock on. The gets receive the transfers in order, swapping the halves
+// of the matrix.
+air.channel @channel_0 [1, 1] {depth = 2}
+func.func @forward(%arg0 : memref<16x16xi32>, %arg1 : memref<16x16xi32>) -> () {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %c16 = arith.constant 16 : index
+  air.channel.put @channel_0[%c0, %c0] (%arg0[%c0, %c0] [%c8, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.put @channel_0[%c0, %c0] (%arg0[%c8, %c0] [%c8, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.get @channel_0[%c0, %c0] (%arg1[%c8, %c0] [%c8, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  air.channel.get @channel_0[%c0, %c0] (%arg1[%c0, %c0] [%c8, %c16] [%c16, %c1]) : (memref<16x16xi32>)
+  return
+}
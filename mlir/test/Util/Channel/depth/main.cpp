@@ -0,0 +1,63 @@
+//===- main.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "air_tensor.h"
+
+extern "C" {
+void _mlir_ciface_forward(void *, void *);
+}
+
+#define M_SIZE 16
+
+int main(int argc, char *argv[]) {
+
+  tensor_t<int32_t, 2> input;
+  tensor_t<int32_t, 2> output;
+
+  input.shape[0] = input.shape[1] = M_SIZE;
+  input.alloc = input.data =
+      (int32_t *)malloc(sizeof(int32_t) * input.shape[0] * input.shape[1]);
+
+  output.shape[0] = output.shape[1] = M_SIZE;
+  output.alloc = output.data =
+      (int32_t *)malloc(sizeof(int32_t) * output.shape[0] * output.shape[1]);
+
+  for (unsigned int i = 0; i < input.shape[0] * input.shape[1]; i++) {
+    input.data[i] = ((int32_t)i) % 1024;
+    output.data[i] = 0;
+  }
+
+  _mlir_ciface_forward((void *)&input, (void *)&output);
+
+  // the top and bottom halves are swapped
+  int errors = 0;
+  for (unsigned int i = 0; i < M_SIZE; i++) {
+    for (unsigned int j = 0; j < M_SIZE; j++) {
+      auto d = output.data[i * M_SIZE + j];
+      auto ref = input.data[((i + M_SIZE / 2) % M_SIZE) * M_SIZE + j];
+      if (d != ref) {
+        errors++;
+        if (errors < 10)
+          printf("%u,%u: mismatch %d != %d\n", i, j, d, ref);
+      }
+    }
+  }
+  if (!errors) {
+    printf("PASS!\n");
+  } else {
+    printf("fail %d/%d.\n", M_SIZE * M_SIZE - errors, M_SIZE * M_SIZE);
+  }
+
+  free(input.alloc);
+  free(output.alloc);
+
+  return errors ? 1 : 0;
+}
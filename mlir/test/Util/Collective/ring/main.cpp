@@ -0,0 +1,137 @@
+//===- main.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Checks the ring all-reduce lowered from ring.mlir and the reference
+// collectives of aircpu, then measures the bandwidth of the reference
+// collectives across rank counts.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "air_collective.h"
+#include "air_tensor.h"
+
+extern "C" {
+void _mlir_ciface_forward(void *);
+}
+
+// Runs f(rank) on one thread per rank
+static void run_ranks(uint32_t world, std::function<void(uint32_t)> f) {
+  std::vector<std::thread> threads;
+  for (uint32_t r = 0; r < world; r++)
+    threads.emplace_back(f, r);
+  for (auto &t : threads)
+    t.join();
+}
+
+static int check_forward() {
+  tensor_t<float, 2> output;
+  output.shape[0] = 4;
+  output.shape[1] = 256;
+  output.alloc = output.data = (float *)malloc(sizeof(float) * 4 * 256);
+  for (int i = 0; i < 4 * 256; i++)
+    output.data[i] = 0;
+
+  _mlir_ciface_forward((void *)&output);
+
+  // rank r contributes r + 1
+  int errors = 0;
+  for (int i = 0; i < 4 * 256; i++) {
+    if (output.data[i] != 10.0f) {
+      if (errors++ < 10)
+        printf("%04X: mismatch %f != 10.0\n", i, output.data[i]);
+    }
+  }
+  free(output.alloc);
+  return errors;
+}
+
+// value of element i of rank r
+static int32_t input(uint32_t r, size_t i) { return (r + 1) * (i % 7 + 1); }
+
+static int check_reference(uint32_t world, size_t count, uint64_t chunk_bytes) {
+  auto comm = air_collective_comm_create(world, chunk_bytes, 2);
+  std::vector<std::vector<int32_t>> in(world), out(world), gathered(world),
+      scattered(world);
+  for (uint32_t r = 0; r < world; r++) {
+    for (size_t i = 0; i < count * world; i++)
+      in[r].push_back(input(r, i));
+    out[r].resize(count);
+    gathered[r].resize(count * world);
+    scattered[r].resize(count);
+  }
+
+  run_ranks(world, [&](uint32_t r) {
+    air_collective_all_reduce_i32(comm, r, in[r].data(), out[r].data(), count,
+                                  AIR_COLLECTIVE_ADD);
+    air_collective_all_gather_i32(comm, r, in[r].data(), gathered[r].data(),
+                                  count);
+    air_collective_reduce_scatter_i32(comm, r, in[r].data(),
+                                      scattered[r].data(), count,
+                                      AIR_COLLECTIVE_MAX);
+  });
+  air_collective_comm_destroy(comm);
+
+  int errors = 0;
+  int32_t sum = world * (world + 1) / 2;
+  for (uint32_t r = 0; r < world; r++) {
+    for (size_t i = 0; i < count; i++) {
+      errors += out[r][i] != sum * input(0, i);
+      errors += scattered[r][i] != input(world - 1, r * count + i);
+    }
+    for (size_t i = 0; i < count * world; i++)
+      errors += gathered[r][i] != input(i / count, i % count);
+  }
+  if (errors)
+    printf("reference world=%u count=%zu chunk=%lu: %d errors\n", world, count,
+           (unsigned long)chunk_bytes, errors);
+  return errors;
+}
+
+int main(int argc, char *argv[]) {
+  int errors = check_forward();
+  printf("forward: %s\n", errors ? "FAIL" : "PASS");
+
+  // uneven blocks, chunks larger and smaller than the blocks
+  int ref_errors = 0;
+  for (uint32_t world : {1, 2, 3, 4, 8})
+    for (size_t count : {1, 5, 1000})
+      for (uint64_t chunk_bytes : {4, 64, 1 << 20})
+        ref_errors += check_reference(world, count, chunk_bytes);
+  printf("reference: %s\n", ref_errors ? "FAIL" : "PASS");
+  errors += ref_errors;
+
+  // Bus bandwidth counts the 2 (N - 1) / N of the data every rank moves
+  // in an all-reduce, so that it is comparable across rank counts.
+  const size_t count = 4 << 20;
+  const int iterations = 5;
+  for (uint32_t world : {2, 4, 8}) {
+    auto comm = air_collective_comm_create(world, 256 << 10, 4);
+    std::vector<std::vector<float>> bufs(world, std::vector<float>(count, 1));
+    auto start = std::chrono::steady_clock::now();
+    run_ranks(world, [&](uint32_t r) {
+      for (int i = 0; i < iterations; i++)
+        air_collective_all_reduce_f32(comm, r, bufs[r].data(), bufs[r].data(),
+                                      count, AIR_COLLECTIVE_ADD);
+    });
+    auto end = std::chrono::steady_clock::now();
+    air_collective_comm_destroy(comm);
+
+    double s = std::chrono::duration<double>(end - start).count() / iterations;
+    double bytes = count * sizeof(float);
+    printf("all_reduce ranks=%u bytes=%.0f algbw=%.2f GB/s busbw=%.2f GB/s\n",
+           world, bytes, bytes / s / 1e9,
+           bytes / s / 1e9 * 2 * (world - 1) / world);
+  }
+
+  return errors;
+}
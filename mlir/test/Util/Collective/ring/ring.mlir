@@ -0,0 +1,46 @@
+//===- ring.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-opt -o %T/ring.async.mlir %s -air-collective-to-channel -air-to-async
+// RUN: air-opt -o %T/ring.async.llvm.mlir %T/ring.async.mlir -async-to-async-runtime -async-runtime-ref-counting -async-runtime-ref-counting-opt -convert-linalg-to-affine-loops -expand-strided-metadata -lower-affine -convert-scf-to-cf -convert-async-to-llvm -convert-arith-to-llvm -finalize-memref-to-llvm -convert-cf-to-llvm -convert-func-to-llvm -reconcile-unrealized-casts -canonicalize -cse
+// RUN: air-translate --mlir-to-llvmir %T/ring.async.llvm.mlir -o %T/ring.async.ll
+// RUN: %OPT -O3 -o %T/ring.async.opt.bc < %T/ring.async.ll
+// RUN: %LLC %T/ring.async.opt.bc --relocation-model=pic -filetype=obj -o %T/ring.async.o
+// RUN: %CLANG %S/main.cpp -O2 -std=c++17 %airhost_inc -c -o %T/main.o
+// RUN: %CLANG %aircpu_lib %mlir_async_lib -lstdc++ -lpthread -o %T/test.exe %T/main.o %T/ring.async.o
+// RUN: %ld_lib_path %T/test.exe | FileCheck %s
+
+// CHECK: forward: PASS
+// CHECK: reference: PASS
+// CHECK: all_reduce ranks=2
+// CHECK: all_reduce ranks=4
+// CHECK: all_reduce ranks=8
+
+// Four rank instances, instance r contributes r + 1 to an all-reduce and
+// instance 0 returns the result.
+module {
+  func.func @forward(%out : memref<4x256xf32>) {
+    %c4 = arith.constant 4 : index
+    air.rank (%r) in (%n = %c4) args(%o = %out) : memref<4x256xf32> {
+      %c0 = arith.constant 0 : index
+      %one = arith.constant 1.0 : f32
+      %buf = memref.alloc() : memref<4x256xf32>
+      %ri = arith.index_cast %r : index to i32
+      %rf = arith.sitofp %ri : i32 to f32
+      %v = arith.addf %rf, %one : f32
+      linalg.fill ins(%v : f32) outs(%buf : memref<4x256xf32>)
+      air.collective.all_reduce (%buf, %buf) {chunks = 4 : i64}
+          : (memref<4x256xf32>, memref<4x256xf32>)
+      %first = arith.cmpi eq, %r, %c0 : index
+      scf.if %first {
+        memref.copy %buf, %o : memref<4x256xf32> to memref<4x256xf32>
+      }
+      memref.dealloc %buf : memref<4x256xf32>
+    }
+    return
+  }
+}
@@ -0,0 +1,65 @@
+//===- channel_depth.mlir --------------------------------------*- MLIR -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: air-runner %s -f test -m %S/arch.json | FileCheck %s
+
+// Air channel ops on a channel holding two transfers. The segment only starts
+// once the second put is done, which needs the puts to run two transfers ahead
+// of the gets. The third put then waits until a get has drained a transfer,
+// and all four transfers are received.
+
+// CHECK-NOT: "name": "ChannelGetOp@channel_0(L2<--L3)",
+// CHECK: "name": "ChannelPutOp@channel_0(L3-->L2)",{{[[:space:]]+}}"cat": "layer",{{[[:space:]]+}}"ph": "E",
+// CHECK-NOT: "name": "ChannelGetOp@channel_0(L2<--L3)",
+// CHECK: "name": "ChannelPutOp@channel_0(L3-->L2)",{{[[:space:]]+}}"cat": "layer",{{[[:space:]]+}}"ph": "E",
+// CHECK-NOT: "name": "ChannelPutOp@channel_0(L3-->L2)",
+// CHECK: "name": "ChannelGetOp@channel_0(L2<--L3)",{{[[:space:]]+}}"cat": "layer",{{[[:space:]]+}}"ph": "E",
+// CHECK: "name": "ChannelPutOp@channel_0(L3-->L2)",{{[[:space:]]+}}"cat": "layer",{{[[:space:]]+}}"ph": "B",
+
+// CHECK-COUNT-3: "name": "ChannelGetOp@channel_0(L2<--L3)",{{[[:space:]]+}}"cat": "layer",{{[[:space:]]+}}"ph": "E",
+
+// CHECK: "name": "LaunchTerminator",
+// CHECK: "ph": "B",
+
+// CHECK: "name": "LaunchTerminator",
+// CHECK: "ph": "E",
+
+module {
+  air.channel @channel_0 [1, 1] {depth = 2}
+  func.func @test(%arg0: memref<256x128xbf16>) {
+    %c1 = arith.constant 1 : index
+    %0 = air.launch async (%arg1, %arg2) in (%arg3=%c1, %arg4=%c1) args(%arg5=%arg0) : memref<256x128xbf16> {
+      %c0 = arith.constant 0 : index
+      %c1_0 = arith.constant 1 : index
+      %c64 = arith.constant 64 : index
+      %c128 = arith.constant 128 : index
+      %c192 = arith.constant 192 : index
+      %1 = air.channel.put async @channel_0[] (%arg5[%c0, %c0] [%c64, %c128] [%c128, %c1_0]) : (memref<256x128xbf16>)
+      %2 = air.channel.put async [%1] @channel_0[] (%arg5[%c64, %c0] [%c64, %c128] [%c128, %c1_0]) : (memref<256x128xbf16>)
+      %3 = air.channel.put async [%2] @channel_0[] (%arg5[%c128, %c0] [%c64, %c128] [%c128, %c1_0]) : (memref<256x128xbf16>)
+      %4 = air.channel.put async [%3] @channel_0[] (%arg5[%c192, %c0] [%c64, %c128] [%c128, %c1_0]) : (memref<256x128xbf16>)
+      %5 = air.segment async [%2] attributes {x_loc = 0 : i64, x_size = 4 : i64, y_loc = 0 : i64, y_size = 4 : i64} {
+        %c0_1 = arith.constant 0 : index
+        %c64_2 = arith.constant 64 : index
+        %c256_3 = arith.constant 256 : index
+        %6 = air.wait_all async
+        %7 = scf.for %arg6 = %c0_1 to %c256_3 step %c64_2 iter_args(%arg7 = %6) -> (!air.async.token) {
+          %async_token, %results = air.execute [%arg7] -> (memref<64x128xbf16, 1>) {
+            %alloc = memref.alloc() : memref<64x128xbf16, 1>
+            air.execute_terminator %alloc : memref<64x128xbf16, 1>
+          }
+          %8 = air.channel.get async [%async_token]  @channel_0[] (%results[] [] []) : (memref<64x128xbf16, 1>)
+          %async_token_4 = air.execute [%8] {
+            memref.dealloc %results : memref<64x128xbf16, 1>
+          }
+          scf.yield %async_token_4 : !air.async.token
+        }
+      }
+    }
+    return
+  }
+}
@@ -9,41 +9,38 @@ import torch_mlir.passmanager
 from air.compiler.aircc.configure import install_path
 import air.ir
 import air.passmanager
+from air.ir import AffineMap, FunctionType, MemRefType, UnitAttr
 
-import os
 import sys
+import hashlib
+import threading
 
-# override the default library paths for the mlir extras refbackend
-if sys.platform != "win32":
-    os.environ["ASYNC_RUNTIME_LIB_PATH"] = (
-        f"{install_path()}/python/air/_mlir_libs/libmlir_async_runtime.so"
-    )
-    os.environ["C_RUNNER_UTILS_LIB_PATH"] = (
-        f"{install_path()}/python/air/_mlir_libs/libmlir_c_runner_utils.so"
-    )
-    os.environ["RUNNER_UTILS_LIB_PATH"] = (
-        f"{install_path()}/python/air/_mlir_libs/libmlir_runner_utils.so"
-    )
-from aie.extras.runtime.refbackend import LLVMJITBackend
-import aie.ir as aieir
+import numpy as np
+from ml_dtypes import bfloat16
 
-from .abc import AirBackend
+from air.execution_engine import ExecutionEngine
+from air.runtime import get_ranked_memref_descriptor
+
+from .abc import AirBackend, AirBackendError
 
 import air.compiler.util
 
 import ctypes
 
+# Runtime libraries the JIT'd code calls into
 if sys.platform != "win32":
-    ctypes.CDLL(
+    SHARED_LIBS = [
         f"{install_path()}/runtime_lib/x86_64/aircpu/libaircpu.so",
-        mode=ctypes.RTLD_GLOBAL,
-    )
-    ctypes.CDLL(
         f"{install_path()}/python/air/_mlir_libs/libmlir_async_runtime.so",
-        mode=ctypes.RTLD_GLOBAL,
-    )
+        f"{install_path()}/python/air/_mlir_libs/libmlir_c_runner_utils.so",
+        f"{install_path()}/python/air/_mlir_libs/libmlir_runner_utils.so",
+    ]
+    for lib in SHARED_LIBS[:2]:
+        ctypes.CDLL(lib, mode=ctypes.RTLD_GLOBAL)
+else:
+    SHARED_LIBS = []
 
-__all__ = ["AirCpuBackend", "DEFAULT_PIPELINE"]
+__all__ = ["AirCpuBackend", "AirCpuArtifact", "DEFAULT_PIPELINE", "clear_jit_cache"]
 
 DEFAULT_PIPELINE = (
     "builtin.module(" + ",".join(["air-to-async", "canonicalize", "cse"]) + ")"
@@ -91,18 +88,70 @@ REF_BACKEND_LOWERING_PIPELINE = (
 )
 
 
+class AirCpuArtifact:
+    """An AIR module lowered to the LLVM dialect, ready for the JIT.
+
+    Attributes:
+        key: hash of the async module the artifact was lowered from
+        llvm_module: the lowered module as text
+        strided_args: for each argument of the kernel, whether it takes a
+            memref with a strided layout, which a strided numpy view can be
+            passed to without a copy
+    """
+
+    def __init__(self, key, llvm_module, strided_args):
+        self.key = key
+        self.llvm_module = llvm_module
+        self.strided_args = strided_args
+
+
+# Lowered artifacts and JIT'd engines, keyed by module hash, shared by all
+# backends of the process
+_artifact_cache = {}
+_engine_cache = {}
+_cache_lock = threading.Lock()
+
+
+def clear_jit_cache():
+    """Drop all cached artifacts and execution engines."""
+    with _cache_lock:
+        _artifact_cache.clear()
+        _engine_cache.clear()
+
+
+def _memref_arg(arg, strided):
+    """A pointer to a memref descriptor over arg's buffer, and the contiguous
+    copy the kernel works on instead when arg's layout can't be passed."""
+    if hasattr(arg, "numpy"):
+        arg = arg.numpy()
+    if not isinstance(arg, np.ndarray):
+        raise AirBackendError(f"Unsupported argument type {type(arg)}")
+    staged = None
+    if not strided and not arg.flags.c_contiguous:
+        staged = np.ascontiguousarray(arg)
+    buffer = arg if staged is None else staged
+    # The C types of the descriptor have no 16-bit floats, pass their bits
+    if buffer.dtype in (bfloat16, np.float16):
+        buffer = buffer.view(np.int16)
+    descriptor = get_ranked_memref_descriptor(buffer)
+    return ctypes.pointer(ctypes.pointer(descriptor)), staged
+
+
 class AirCpuBackend(AirBackend):
     """Main entry-point for the AIR CPU backend.
 
-    This currently uses the torch-mlir linalg-on-tensors RefBackend
-    for JIT execution.
+    Modules are lowered to LLVM and JIT'd with the MLIR ExecutionEngine. The
+    lowered module and its engine are cached for the process, keyed by the
+    hash of the async module, so compiling and loading the same kernel again
+    costs only the AIR pipeline.
 
+    Arguments are passed to the kernel as memref descriptors over the numpy
+    buffers, outputs are written in place into the arrays passed for them.
     """
 
     def __init__(self):
         super().__init__()
         self.handle = None
-        self.backend = LLVMJITBackend()
 
     def __del__(self):
         self.unload()
@@ -152,19 +201,48 @@ class AirCpuBackend(AirBackend):
                 print("Async Module:")
                 print(air_module)
 
+            key = hashlib.sha256(str(air_module).encode()).hexdigest()
+            with _cache_lock:
+                artifact = _artifact_cache.get(key)
+            if artifact is not None:
+                if verbose:
+                    print("Using cached LLVM module", key)
+                return artifact
+
+            kernel = None
+            for op in air_module.body.operations:
+                if op.operation.name == "func.func" and (
+                    op.attributes["sym_name"].value == "forward"
+                ):
+                    kernel = op
+            if kernel is None:
+                raise AirBackendError("Module has no 'forward' function")
+            function_type = FunctionType(kernel.attributes["function_type"].value)
+            if len(function_type.results):
+                raise AirBackendError(
+                    "'forward' must return its results through out parameters"
+                )
+            strided_args = [
+                MemRefType.isinstance(t)
+                and MemRefType(t).affine_map
+                != AffineMap.get_identity(MemRefType(t).rank)
+                for t in function_type.inputs
+            ]
+            kernel.attributes["llvm.emit_c_interface"] = UnitAttr.get()
+
             pm = air.passmanager.PassManager.parse(ASYNC_TO_LLVM_PIPELINE)
             pm.run(air_module.operation)
+            pm = air.passmanager.PassManager.parse(REF_BACKEND_LOWERING_PIPELINE)
+            pm.run(air_module.operation)
 
             if verbose:
                 print("LLVM Module:")
                 print(air_module)
-        with aieir.Context(), aieir.Location.unknown():
-            compiled_module = self.backend.compile(
-                aieir.Module.parse(str(air_module)),
-                pipeline=REF_BACKEND_LOWERING_PIPELINE,
-                kernel_name="forward",
-            )
-        return compiled_module
+
+            artifact = AirCpuArtifact(key, str(air_module), strided_args)
+        with _cache_lock:
+            _artifact_cache[key] = artifact
+        return artifact
 
     def compile_from_torch_mlir(
         self,
@@ -201,24 +279,49 @@ class AirCpuBackend(AirBackend):
             linalg_module, pipeline, verbose, segment_offset, segment_size
         )
 
-    def load(self, module):
-        """Load a compiled artifact."""
+    def load(self, artifact: AirCpuArtifact):
+        """Load a compiled artifact.
+
+        Returns: A callable taking the arguments of the kernel as numpy arrays
+            or tensors with a numpy view. Arrays with a layout the kernel
+            parameter accepts are passed without a copy, other arrays are
+            staged through a contiguous copy and written back afterwards.
+        """
+        with _cache_lock:
+            engine = _engine_cache.get(artifact.key)
+        if engine is None:
+            with air.ir.Context():
+                engine = ExecutionEngine(
+                    air.ir.Module.parse(artifact.llvm_module),
+                    opt_level=3,
+                    shared_libs=SHARED_LIBS,
+                )
+            with _cache_lock:
+                engine = _engine_cache.setdefault(artifact.key, engine)
+
+        strided_args = artifact.strided_args
 
         def wrapped_function(*args):
             """Wrap the function"""
-            try:
-                with aieir.Context(), aieir.Location.unknown():
-                    loaded = self.backend.load(module)
-                    f = getattr(loaded, "forward")
-                    return f(*args)
-            except Exception as e:
-                print(f"Error in wrapped function: {e}")
-                pass
-            return None
+            if len(args) != len(strided_args):
+                raise AirBackendError(
+                    f"Expected {len(strided_args)} arguments, got {len(args)}"
+                )
+            ffi_args = []
+            staged = []
+            for arg, strided in zip(args, strided_args):
+                ffi_arg, copy = _memref_arg(arg, strided)
+                ffi_args.append(ffi_arg)
+                if copy is not None:
+                    staged.append((arg, copy))
+            engine.invoke("forward", *ffi_args)
+            for arg, copy in staged:
+                np.copyto(arg.numpy() if hasattr(arg, "numpy") else arg, copy)
 
         return wrapped_function
 
     def unload(self):
-        """Unload any loaded module and release resources."""
-        # self.backend = None
+        """Unload any loaded module and release resources.
+
+        Engines stay in the process-wide cache, see clear_jit_cache."""
         pass
@@ -15,9 +15,14 @@ import air.compiler.util
 from air.dialects import air as _air_dialect  # noqa: F401
 
 import numpy as np
+import contextlib
+import hashlib
+import json
 import os
 import shutil
 import subprocess
+import threading
+from collections import OrderedDict, deque
 
 from ml_dtypes import bfloat16
 
@@ -37,6 +42,7 @@ class XRTCompileArtifact:
         output_binary,
         kernel,
         insts,
+        variants=None,
     ):
         """
         Constructor for an XRTCompileArtifact
@@ -45,10 +51,217 @@ class XRTCompileArtifact:
             output_binary: output binary file name/path (.xclbin, .elf, or .txn)
             kernel: kernel name
             insts: instruction file name/path
+            variants: for a control function with air.size_variants, a dict
+                from the tuple of sizes of each variant to its instruction
+                file name/path. None if the function has no size variants.
         """
         self.output_binary = output_binary
         self.kernel = kernel
         self.insts = insts
+        self.variants = variants
+
+
+def size_variants_manifest(insts):
+    """Path of the manifest aircc writes next to the insts file when the
+    control function has size variants."""
+    if insts.endswith(".insts.bin"):
+        insts = insts[: -len(".insts.bin")]
+    return insts + ".variants.json"
+
+
+def load_size_variants(manifest):
+    """Read an aircc size variant manifest into a dict from the tuple of sizes
+    of each variant to its instruction file."""
+    with open(manifest) as f:
+        entries = json.load(f)
+    variants = {}
+    for entry in entries:
+        sizes = tuple(entry["sizes"])
+        if sizes in variants:
+            raise AirBackendError(
+                f"Size variant {list(sizes)} is listed twice in {manifest}"
+            )
+        variants[sizes] = entry["insts"]
+    return variants
+
+
+def artifact_hash(artifact: XRTCompileArtifact):
+    """Hash of everything that ends up on the device when loading an artifact."""
+    h = hashlib.sha256()
+    h.update(artifact.kernel.encode())
+    paths = [artifact.output_binary]
+    if not artifact.output_binary.endswith(".elf"):
+        paths.append(artifact.insts)
+        for sizes, insts in sorted((artifact.variants or {}).items()):
+            h.update(repr(sizes).encode())
+            paths.append(insts)
+    for path in paths:
+        h.update(b"\0")
+        with open(path, "rb") as f:
+            for chunk in iter(lambda: f.read(1 << 20), b""):
+                h.update(chunk)
+    return h.hexdigest()
+
+
+class XRTLoadedArtifact:
+    """Device state of a loaded artifact: its hw context, kernel, instruction
+    buffers, and the argument buffers of earlier invocations keyed by their
+    sizes."""
+
+    def __init__(
+        self,
+        xrt,
+        device,
+        context,
+        kernel,
+        xclbin=None,
+        elf=None,
+        bo_instr=None,
+        instr_v=None,
+        variants=None,
+    ):
+        self.xrt = xrt
+        self.device = device
+        self.context = context
+        self.kernel = kernel
+        self.xclbin = xclbin
+        self.elf = elf
+        self.bo_instr = bo_instr
+        self.instr_v = instr_v
+        # (bo_instr, instr_v) of each size variant, keyed by its sizes
+        self.variants = variants or {}
+        self.bos = {}
+        # Invocations of the same artifact share the argument buffers
+        self.lock = threading.RLock()
+
+    def get_bos(self, sizes_in_bytes, slot=0):
+        """Argument buffers for the given sizes. Buffer sets with different
+        slots can be in flight at the same time, slot 0 is used by
+        synchronous invocations."""
+        key = (tuple(sizes_in_bytes), slot)
+        bos = self.bos.get(key)
+        if bos is None:
+            xrt = self.xrt
+            if self.elf is not None:
+                # Use xrt.ext.bo for ELF mode (simpler, no group_id needed)
+                bos = [xrt.ext.bo(self.device, s) for s in sizes_in_bytes]
+            else:
+                bos = [
+                    xrt.bo(
+                        self.device, s, xrt.bo.host_only, self.kernel.group_id(i + 3)
+                    )
+                    for i, s in enumerate(sizes_in_bytes)
+                ]
+            self.bos[key] = bos
+        return bos
+
+    def write(self, bos, args):
+        for i, a in enumerate(args):
+            if a.dtype == bfloat16:
+                # store bfloat16 in binary as int16
+                a = a.view(np.int16)
+            bos[i].write(a, 0)
+
+    def instructions(self, sizes=None):
+        """The instruction buffer and words of the size variant for sizes, or
+        of the default sequence when sizes is None."""
+        if sizes is None:
+            return self.bo_instr, self.instr_v
+        variant = self.variants.get(tuple(sizes))
+        if variant is None:
+            raise AirBackendError(
+                f"No size variant for sizes {list(sizes)}, compiled variants: "
+                f"{[list(k) for k in self.variants]}"
+            )
+        return variant
+
+    def sync_to_device(self, bos, sizes=None):
+        to_device = self.xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE
+        bo_instr, _ = self.instructions(sizes)
+        if bo_instr is not None:
+            bo_instr.sync(to_device)
+        for bo in bos:
+            bo.sync(to_device)
+
+    def start(self, bos, sizes=None):
+        """Start the kernel on bos, with the runtime sequence of the size
+        variant for sizes, and return a function waiting for it."""
+        if self.elf is not None:
+            if sizes is not None:
+                raise AirBackendError("Size variants are not supported with ELF")
+            # Use xrt.run for ELF mode
+            run = self.xrt.run(self.kernel)
+            for i, bo in enumerate(bos):
+                run.set_arg(i, bo)
+            run.start()
+            return run.wait2
+        bo_instr, instr_v = self.instructions(sizes)
+        h = self.kernel(3, bo_instr, len(instr_v), *bos)
+        return h.wait
+
+    def sync_from_device(self, bos):
+        for bo in bos:
+            bo.sync(self.xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_FROM_DEVICE)
+
+    def read(self, bos, args):
+        return tuple(
+            [
+                bos[i].read(a.size * a.itemsize, 0).view(a.dtype)
+                for i, a in enumerate(args)
+            ]
+        )
+
+
+class XRTLoadCache:
+    """Process-level cache of loaded artifacts, keyed by artifact_hash.
+
+    Registering an xclbin and creating a hw context dominate the load time, so
+    artifacts stay loaded after XRTBackend.unload and are reused by any later
+    load of the same binary. Every entry holds a hw context, which the driver
+    has few of, so by default only the most recently loaded artifact is kept.
+    The least recently used artifact is released once more than `capacity`
+    are loaded, and a capacity of 0 keeps nothing after unload.
+    """
+
+    def __init__(self, capacity: int = 1):
+        self.capacity = capacity
+        self.entries = OrderedDict()
+        self.hits = 0
+        self.misses = 0
+        self.device = None
+        self.lock = threading.Lock()
+
+    def get_device(self, xrt):
+        with self.lock:
+            if self.device is None:
+                self.device = xrt.device(0)
+            return self.device
+
+    def lookup(self, key):
+        with self.lock:
+            entry = self.entries.get(key)
+            if entry is None:
+                self.misses += 1
+                return None
+            self.hits += 1
+            self.entries.move_to_end(key)
+            return entry
+
+    def insert(self, key, entry):
+        with self.lock:
+            self.entries[key] = entry
+            self.entries.move_to_end(key)
+            while len(self.entries) > max(self.capacity, 0):
+                self.entries.popitem(last=False)
+
+    def clear(self):
+        """Release all cached hw contexts and buffers, and the device."""
+        with self.lock:
+            self.entries.clear()
+            self.device = None
+
+
+xrt_load_cache = XRTLoadCache(int(os.environ.get("AIR_XRT_LOAD_CACHE_SIZE", "1")))
 
 
 class XRTBackend(AirBackend):
@@ -76,6 +289,8 @@ class XRTBackend(AirBackend):
         num_device_cols: int = 0,
         debug_ir: bool = False,
         bf16_emulation: bool = False,
+        use_load_cache: bool = True,
+        device_lock=None,
     ):
         """Constructor for XRTBackend
 
@@ -103,6 +318,8 @@ class XRTBackend(AirBackend):
             debug_ir: enable debug mode to emit IR after each individual pass for fine-grained inspection.
                 IRs are saved to <tmpdir>/debug_ir/ with sequence numbers.
             bf16_emulation: emulate f32 vector arithmetic using bf16 operations.
+            use_load_cache: reuse hw contexts, kernels and argument buffers of artifacts loaded earlier in this process (see XRTLoadCache).
+            device_lock: context manager held while an artifact is loaded onto the device and around each device submission, e.g. a filelock shared between processes. None for no locking.
         """
         super().__init__()
         self.verbose = verbose
@@ -130,6 +347,8 @@ class XRTBackend(AirBackend):
         self.num_device_cols = num_device_cols
         self.debug_ir = debug_ir
         self.bf16_emulation = bf16_emulation
+        self.use_load_cache = use_load_cache
+        self.device_lock = device_lock
 
     def __del__(self):
         self.unload()
@@ -346,6 +565,11 @@ class XRTBackend(AirBackend):
             with open("air.mlir", "w") as f:
                 f.write(str(air_module))
 
+            # aircc only writes a manifest for functions with size variants
+            manifest = size_variants_manifest(insts)
+            if os.path.exists(manifest):
+                os.remove(manifest)
+
             # Invoke the C++ aircc binary
             aircc_exe = shutil.which("aircc")
             if not aircc_exe:
@@ -369,7 +593,11 @@ class XRTBackend(AirBackend):
         else:
             elf_kernel = kernel
 
-        return XRTCompileArtifact(output_binary, elf_kernel, insts)
+        variants = None
+        if os.path.isfile(manifest):
+            variants = load_size_variants(manifest)
+
+        return XRTCompileArtifact(output_binary, elf_kernel, insts, variants)
 
     def compile_from_torch_mlir(
         self,
@@ -444,7 +672,9 @@ class XRTBackend(AirBackend):
         Returns: A callable that can be used to invoke the loaded module.
             The callable takes a list of numpy arrays. Each numpy array is
             assumed to be an input/output tensor. The callable also returns a
-            list of numpy arrays, one for each tensor.
+            list of numpy arrays, one for each tensor. For an artifact with
+            size variants, the sizes keyword argument picks the variant to
+            run, as listed in the air.size_variants of the function.
         """
         # Try to import pyxrt - it's only needed for load(), not compile()
         try:
@@ -471,121 +701,201 @@ class XRTBackend(AirBackend):
         # Determine the loading mode based on file extension
         is_elf = artifact.output_binary.endswith(".elf")
 
-        # create the device
-        self.device = xrt.device(0)
-
-        if is_elf:
-            # ELF loading path - uses experimental APIs
-            # No instruction file needed for ELF (instructions embedded in ELF)
-            try:
-                self.elf = xrt.elf(artifact.output_binary)
-                self.context = xrt.hw_context(self.device, self.elf)
-                self.kernel = xrt.ext.kernel(self.context, artifact.kernel)
-            except Exception as e:
-                raise AirBackendError(
-                    f"Failed to load ELF kernel for XRT from '{artifact.output_binary}' "
-                    f"with kernel name '{artifact.kernel}'. "
-                    "Ensure this file is a valid ELF binary compiled for the target device "
-                    "and that it contains a kernel symbol matching the provided name."
-                ) from e
-            self.bo_instr = None  # Not needed for ELF
-            self.instr_v = None
-
-            def invoker(*args):
-                sizes_in_bytes = [a.size * a.itemsize for a in args]
-                # Use xrt.ext.bo for ELF mode (simpler, no group_id needed)
-                bos = [xrt.ext.bo(self.device, s) for s in sizes_in_bytes]
-
-                for i, a in enumerate(args):
-                    if a.dtype == bfloat16:
-                        a = a.view(np.int16)
-                    bos[i].write(a, 0)
-                    bos[i].sync(xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE)
-
-                # Use xrt.run for ELF mode
-                run = xrt.run(self.kernel)
-                for i, bo in enumerate(bos):
-                    run.set_arg(i, bo)
-                run.start()
-                run.wait2()
-
-                for i, a in enumerate(args):
-                    bos[i].sync(xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_FROM_DEVICE)
-                return tuple(
-                    [
-                        bos[i].read(s, 0).view(args[i].dtype)
-                        for i, s in enumerate(sizes_in_bytes)
-                    ]
-                )
+        if not is_elf:
+            for insts in [artifact.insts, *(artifact.variants or {}).values()]:
+                if not os.path.isfile(insts):
+                    raise AirBackendError(
+                        f"Cannot load XRTCompileArtifact because {insts} insts file does not exist"
+                    )
 
+        key = artifact_hash(artifact) if self.use_load_cache else None
+        loaded = xrt_load_cache.lookup(key) if key else None
+        if self.use_load_cache:
+            self.device = xrt_load_cache.get_device(xrt)
         else:
-            # xclbin loading path - original implementation
-            if not os.path.isfile(artifact.insts):
-                raise AirBackendError(
-                    f"Cannot load XRTCompileArtifact because {artifact.insts} insts file does not exist"
-                )
+            # create the device
+            self.device = xrt.device(0)
+
+        device_lock = self.device_lock or contextlib.nullcontext()
+        if loaded is None:
+            # Registering the xclbin and creating the hw context touch the
+            # device like a run does
+            with device_lock:
+                if is_elf:
+                    loaded = self._load_elf(xrt, artifact)
+                else:
+                    loaded = self._load_xclbin(xrt, artifact)
+            if key:
+                xrt_load_cache.insert(key, loaded)
+
+        self.loaded = loaded
+        self.context = loaded.context
+        self.kernel = loaded.kernel
+        self.xclbin = loaded.xclbin
+        self.elf = loaded.elf
+        self.bo_instr = loaded.bo_instr
+        self.instr_v = loaded.instr_v
+
+        is_xclbin = not is_elf
+
+        def invoker(*args, sizes=None):
+            # limit arg length to 5
+            if is_xclbin and len(args) > 5:
+                raise ValueError("Too many arguments")
+            loaded.instructions(sizes)
+            sizes_in_bytes = [a.size * a.itemsize for a in args]
+            with loaded.lock:
+                bos = loaded.get_bos(sizes_in_bytes)
+                loaded.write(bos, args)
+                with device_lock:
+                    loaded.sync_to_device(bos, sizes)
+                    loaded.start(bos, sizes)()
+                    loaded.sync_from_device(bos)
+                return loaded.read(bos, args)
+
+        invoker.stream = self.stream
+        self.currently_loaded = True
+        return invoker
 
-            self.xclbin = xrt.xclbin(artifact.output_binary)
-            self.device.register_xclbin(self.xclbin)
-            self.context = xrt.hw_context(self.device, self.xclbin.get_uuid())
+    def stream(self, batches, num_buffers: int = 2, sizes=None):
+        """Invoke the loaded module on a sequence of batches, overlapping host
+        staging with device execution.
+
+        Args:
+            batches: an iterable of argument lists, each one as passed to the
+                callable returned by load.
+            num_buffers: number of buffer sets in rotation. Up to this many
+                batches are on the device while the next one is staged.
+            sizes: the size variant to run every batch with, as for the
+                callable returned by load.
+
+        Returns: A generator yielding the outputs of each batch, in order, as
+            the callable returned by load would return them.
+
+        The device lock is held while the stream stages, submits and
+        retires batches, but not while the consumer works on an output, so
+        other processes can use the device in between. Runs submitted before
+        a yield keep running meanwhile.
+        """
+        if not self.currently_loaded:
+            raise AirBackendError("Cannot stream before an artifact is loaded.")
+        if num_buffers < 1:
+            raise AirBackendError("stream needs at least one buffer set.")
+        loaded = self.loaded
+        loaded.instructions(sizes)
+        is_xclbin = self.elf is None
+        device_lock = self.device_lock or contextlib.nullcontext()
+
+        def finish(inflight):
+            bos, args, wait = inflight
+            wait()
+            loaded.sync_from_device(bos)
+            return loaded.read(bos, args)
+
+        with loaded.lock, contextlib.ExitStack() as held:
+            pending = deque()
+            locked = False
+
+            def lock():
+                nonlocal locked
+                if not locked:
+                    held.enter_context(device_lock)
+                    locked = True
+
+            def retire():
+                # The device lock is dropped for the consumer's turn, and
+                # taken again on the next submission or retirement
+                nonlocal locked
+                lock()
+                outputs = finish(pending.popleft())
+                held.close()
+                locked = False
+                return outputs
 
-            # find and load the kernel
-            kernels = self.xclbin.get_kernels()
             try:
-                xkernel = [k for k in kernels if artifact.kernel in k.get_name()][0]
-            except:
-                raise AirBackendError(
-                    f"Kernel '{artifact.kernel}' not found in '{artifact.output_binary}'"
-                )
-            self.kernel = xrt.kernel(self.context, xkernel.get_name())
+                for index, args in enumerate(batches):
+                    if is_xclbin and len(args) > 5:
+                        raise ValueError("Too many arguments")
+                    if len(pending) == num_buffers:
+                        yield retire()
+
+                    # The slot of the batch just retired is free again
+                    sizes_in_bytes = [a.size * a.itemsize for a in args]
+                    bos = loaded.get_bos(sizes_in_bytes, 1 + index % num_buffers)
+                    loaded.write(bos, args)
+                    lock()
+                    loaded.sync_to_device(bos, sizes)
+                    pending.append((bos, args, loaded.start(bos, sizes)))
+
+                while pending:
+                    yield retire()
+            finally:
+                # Drain runs a consumer abandoned, their buffers get reused.
+                # Closing the stream or an error releases the device lock.
+                while pending:
+                    pending.popleft()[2]()
+
+    def _load_elf(self, xrt, artifact):
+        # ELF loading path - uses experimental APIs
+        # No instruction file needed for ELF (instructions embedded in ELF)
+        try:
+            elf = xrt.elf(artifact.output_binary)
+            context = xrt.hw_context(self.device, elf)
+            kernel = xrt.ext.kernel(context, artifact.kernel)
+        except Exception as e:
+            raise AirBackendError(
+                f"Failed to load ELF kernel for XRT from '{artifact.output_binary}' "
+                f"with kernel name '{artifact.kernel}'. "
+                "Ensure this file is a valid ELF binary compiled for the target device "
+                "and that it contains a kernel symbol matching the provided name."
+            ) from e
+        return XRTLoadedArtifact(xrt, self.device, context, kernel, elf=elf)
+
+    def _load_xclbin(self, xrt, artifact):
+        xclbin = xrt.xclbin(artifact.output_binary)
+        self.device.register_xclbin(xclbin)
+        context = xrt.hw_context(self.device, xclbin.get_uuid())
+
+        # find and load the kernel
+        kernels = xclbin.get_kernels()
+        try:
+            xkernel = [k for k in kernels if artifact.kernel in k.get_name()][0]
+        except:
+            raise AirBackendError(
+                f"Kernel '{artifact.kernel}' not found in '{artifact.output_binary}'"
+            )
+        kernel = xrt.kernel(context, xkernel.get_name())
 
+        def load_insts(path):
             # load the instructions as a numpy array
-            with open(artifact.insts, "rb") as f:
+            with open(path, "rb") as f:
                 instr_data = f.read()
-                self.instr_v = np.frombuffer(instr_data, dtype=np.uint32)
+                instr_v = np.frombuffer(instr_data, dtype=np.uint32)
 
-            self.bo_instr = xrt.bo(
+            bo_instr = xrt.bo(
                 self.device,
-                len(self.instr_v) * 4,
+                len(instr_v) * 4,
                 xrt.bo.cacheable,
-                self.kernel.group_id(1),
+                kernel.group_id(1),
             )
-            self.bo_instr.write(self.instr_v, 0)
-
-            def invoker(*args):
-                # limit arg length to 5
-                if len(args) > 5:
-                    raise ValueError("Too many arguments")
-                sizes_in_bytes = [a.size * a.itemsize for a in args]
-                bos = [
-                    xrt.bo(
-                        self.device, s, xrt.bo.host_only, self.kernel.group_id(i + 3)
-                    )
-                    for i, s in enumerate(sizes_in_bytes)
-                ]
-
-                self.bo_instr.sync(xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE)
-                for i, a in enumerate(args):
-                    if a.dtype == bfloat16:
-                        # store bfloat16 in binary as int16
-                        a = a.view(np.int16)
-                    bos[i].write(a, 0)
-                    bos[i].sync(xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE)
-
-                h = self.kernel(3, self.bo_instr, len(self.instr_v), *bos)
-                h.wait()
-
-                for i, a in enumerate(args):
-                    bos[i].sync(xrt.xclBOSyncDirection.XCL_BO_SYNC_BO_FROM_DEVICE)
-                return tuple(
-                    [
-                        bos[i].read(s, 0).view(args[i].dtype)
-                        for i, s in enumerate(sizes_in_bytes)
-                    ]
-                )
-
-        self.currently_loaded = True
-        return invoker
+            bo_instr.write(instr_v, 0)
+            return bo_instr, instr_v
+
+        bo_instr, instr_v = load_insts(artifact.insts)
+        variants = {
+            sizes: load_insts(insts)
+            for sizes, insts in (artifact.variants or {}).items()
+        }
+        return XRTLoadedArtifact(
+            xrt,
+            self.device,
+            context,
+            kernel,
+            xclbin=xclbin,
+            bo_instr=bo_instr,
+            instr_v=instr_v,
+            variants=variants,
+        )
 
     def compile_and_load(self, module):
         """
@@ -603,7 +913,11 @@ class XRTBackend(AirBackend):
         return self.load(c)
 
     def unload(self):
-        """Unload any loaded module and shutdown the air runtime."""
+        """Unload any loaded module and shutdown the air runtime.
+
+        Artifacts in the load cache stay loaded on the device, call
+        xrt_load_cache.clear() to release them."""
+        self.loaded = None
         self.kernel = None
         self.context = None
         self.xclbin = None
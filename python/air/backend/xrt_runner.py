@@ -184,6 +184,9 @@ class XRTRunner:
             debug_ir=self.debug_ir,
             bf16_emulation=self.bf16_emulation,
             target_device=self.target_device,
+            device_lock=filelock.FileLock(
+                os.path.join(tempfile.gettempdir(), "npu.lock")
+            ),
         )
 
         # Use per-test trace file if provided, otherwise use instance default
@@ -257,10 +260,12 @@ class XRTRunner:
 
         expanded_inputs = inputs + output_placeholders
 
+        # Loaded artifacts are cached for the process, so a repeated test only
+        # pays for the hw context once. The npu lock is held by the backend
+        # while the kernel runs on the device.
         compiled_module = backend.compile(mlir_module)
-        with filelock.FileLock(os.path.join(tempfile.gettempdir(), "npu.lock")):
-            module_function = backend.load(compiled_module)
-            actual_outputs = module_function(*expanded_inputs)
+        module_function = backend.load(compiled_module)
+        actual_outputs = module_function(*expanded_inputs)
 
         backend.unload()
 
@@ -0,0 +1,170 @@
+# ./python/test/backend/Inputs/mock_pyxrt.py -*- Python -*-
+
+# Copyright (C) 2026, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: MIT
+
+# A stand-in for the pyxrt module, enough of it for the XRT backend. The
+# kernel adds one to its first argument, as int32, into its last argument.
+# Buffer syncs and kernel runs can be given a cost to model a device, runs
+# then execute in order on a device thread.
+
+import queue
+import sys
+import threading
+import time
+import types
+
+import numpy as np
+
+counts = {"register_xclbin": 0, "hw_context": 0, "bo": 0, "run": 0}
+
+# Seconds per buffer sync and per kernel run
+sync_seconds = 0.0
+run_seconds = 0.0
+
+# Runs submitted and not yet waited on by the host, and the most seen at once
+in_flight = 0
+max_in_flight = 0
+
+# Instruction words of the last kernel run
+last_instrs = None
+_in_flight_lock = threading.Lock()
+
+
+class _Device:
+    """Executes kernel runs one at a time, in submission order."""
+
+    def __init__(self):
+        self.runs = queue.Queue()
+        threading.Thread(target=self._worker, daemon=True).start()
+
+    def _worker(self):
+        while True:
+            bos, done = self.runs.get()
+            time.sleep(run_seconds)
+            counts["run"] += 1
+            bos[-1].data[:] = (bos[0].data.view(np.int32) + 1).view(np.uint8)
+            done.set()
+
+    def submit(self, bos):
+        global in_flight, max_in_flight
+        with _in_flight_lock:
+            in_flight += 1
+            max_in_flight = max(max_in_flight, in_flight)
+        done = threading.Event()
+        self.runs.put((list(bos), done))
+        return done
+
+
+def _wait(done):
+    global in_flight
+    done.wait()
+    with _in_flight_lock:
+        in_flight -= 1
+
+
+_device = _Device()
+
+
+class device:
+    def __init__(self, index):
+        pass
+
+    def register_xclbin(self, xclbin):
+        counts["register_xclbin"] += 1
+
+
+class kernel_info:
+    def __init__(self, name):
+        self.name = name
+
+    def get_name(self):
+        return self.name
+
+
+class xclbin:
+    def __init__(self, path):
+        self.path = path
+
+    def get_uuid(self):
+        return self.path
+
+    def get_kernels(self):
+        return [kernel_info("MLIR_AIE")]
+
+
+class elf:
+    def __init__(self, path):
+        self.path = path
+
+
+class hw_context:
+    def __init__(self, device, uuid):
+        counts["hw_context"] += 1
+
+
+class bo:
+    host_only = 0
+    cacheable = 1
+
+    def __init__(self, device, size, flags=0, group_id=0):
+        counts["bo"] += 1
+        self.data = np.zeros(size, dtype=np.uint8)
+
+    def write(self, a, offset):
+        raw = np.ascontiguousarray(a).view(np.uint8).reshape(-1)
+        self.data[offset : offset + raw.size] = raw
+
+    def read(self, size, offset):
+        return self.data[offset : offset + size].copy()
+
+    def sync(self, direction):
+        time.sleep(sync_seconds)
+
+
+class handle:
+    def __init__(self, done):
+        self.done = done
+
+    def wait(self):
+        _wait(self.done)
+
+
+class kernel:
+    def __init__(self, context, name):
+        pass
+
+    def group_id(self, i):
+        return i
+
+    def __call__(self, opcode, bo_instr, num_instrs, *bos):
+        global last_instrs
+        last_instrs = bo_instr.data.view(np.uint32)[:num_instrs].tolist()
+        return handle(_device.submit(bos))
+
+
+class run:
+    def __init__(self, kernel):
+        self.args = {}
+
+    def set_arg(self, i, arg):
+        self.args[i] = arg
+
+    def start(self):
+        self.done = _device.submit([self.args[i] for i in sorted(self.args)])
+
+    def wait2(self):
+        _wait(self.done)
+
+
+class xclBOSyncDirection:
+    XCL_BO_SYNC_BO_TO_DEVICE = 0
+    XCL_BO_SYNC_BO_FROM_DEVICE = 1
+
+
+def install():
+    """Register this module as pyxrt."""
+    module = sys.modules[__name__]
+    module.ext = types.SimpleNamespace(kernel=kernel, bo=lambda d, s: bo(d, s))
+    sys.modules["pyxrt"] = module
+    return module
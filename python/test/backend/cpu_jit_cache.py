@@ -0,0 +1,75 @@
+# ./python/test/backend/cpu_jit_cache.py -*- Python -*-
+
+# Copyright (C) 2026, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: MIT
+
+# REQUIRES: torch_mlir
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# The CPU backend caches the lowered module and its execution engine, and
+# passes numpy buffers to the kernel without copies. The output parameter
+# takes a strided memref, so a strided view is written in place.
+
+import numpy as np
+
+import air.ir
+from air.backend import cpu_backend
+
+MODULE = """
+module {
+  func.func @forward(%a: memref<4x4xf32>,
+                     %b: memref<4x4xf32, strided<[?, ?], offset: ?>>) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    %one = arith.constant 1.0 : f32
+    scf.for %i = %c0 to %c4 step %c1 {
+      scf.for %j = %c0 to %c4 step %c1 {
+        %v = memref.load %a[%i, %j] : memref<4x4xf32>
+        %r = arith.addf %v, %one : f32
+        memref.store %r, %b[%i, %j] : memref<4x4xf32, strided<[?, ?], offset: ?>>
+      }
+    }
+    return
+  }
+}
+"""
+
+
+def compile():
+    backend = cpu_backend.AirCpuBackend()
+    with air.ir.Context():
+        module = air.ir.Module.parse(MODULE)
+    return backend, backend.compile(module)
+
+
+backend, artifact = compile()
+forward = backend.load(artifact)
+
+# CHECK: cached: True 1
+_, again = compile()
+backend.load(again)
+print("cached:", again is artifact, len(cpu_backend._engine_cache))
+
+# A strided view of the output is written in place, the rest is untouched
+# CHECK: strided output: True True
+a = np.arange(16, dtype=np.float32).reshape(4, 4)
+out = np.zeros((8, 8), dtype=np.float32)
+forward(a, out[::2, 1::2])
+untouched = out.copy()
+untouched[::2, 1::2] = 0
+print(
+    "strided output:",
+    np.array_equal(out[::2, 1::2], a + 1),
+    not untouched.any(),
+)
+
+# The input parameter has the identity layout, a strided view is staged
+# CHECK: strided input: True
+big = np.arange(64, dtype=np.float32).reshape(8, 8)
+b = np.zeros((4, 4), dtype=np.float32)
+forward(big[::2, ::2], b)
+print("strided input:", np.array_equal(b, big[::2, ::2] + 1))
+
+cpu_backend.clear_jit_cache()
@@ -0,0 +1,135 @@
+# ./python/test/backend/xrt_load_cache.py -*- Python -*-
+
+# Copyright (C) 2026, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: MIT
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Exercise the XRT backend load cache against a mocked pyxrt module: repeated
+# loads of the same artifact reuse the hw context, and repeated invocations
+# with the same shapes reuse the argument buffers.
+
+import os
+import sys
+import tempfile
+
+import numpy as np
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "Inputs"))
+import mock_pyxrt
+
+mock_pyxrt.install()
+counts = mock_pyxrt.counts
+
+# Keep more than the default single artifact loaded
+os.environ["AIR_XRT_LOAD_CACHE_SIZE"] = "4"
+
+from air.backend.xrt import (
+    XRTBackend,
+    XRTCompileArtifact,
+    XRTLoadCache,
+    xrt_load_cache,
+)
+
+
+class counting_lock:
+    def __init__(self):
+        self.acquired = 0
+
+    def __enter__(self):
+        self.acquired += 1
+
+    def __exit__(self, *args):
+        pass
+
+
+workdir = tempfile.mkdtemp()
+
+
+def artifact(name, payload, output_format="xclbin"):
+    binary = os.path.join(workdir, f"{name}.{output_format}")
+    insts = os.path.join(workdir, f"{name}.insts.bin")
+    with open(binary, "wb") as f:
+        f.write(payload)
+    with open(insts, "wb") as f:
+        f.write(np.zeros(4, dtype=np.uint32).tobytes())
+    return XRTCompileArtifact(binary, "MLIR_AIE", insts)
+
+
+def invoke(a, shape, lock=None, use_load_cache=True):
+    backend = XRTBackend(device_lock=lock, use_load_cache=use_load_cache)
+    fn = backend.load(a)
+    x = np.arange(np.prod(shape), dtype=np.int32).reshape(shape)
+    y = np.zeros(shape, dtype=np.int32)
+    _, out = fn(x, y)
+    backend.unload()
+    return np.array_equal(out.reshape(shape), x + 1)
+
+
+def report(label):
+    print(
+        f"{label}: register {counts['register_xclbin']} context "
+        f"{counts['hw_context']} bo {counts['bo']} run {counts['run']}"
+    )
+
+
+a = artifact("a", b"design a")
+
+# CHECK: first: True
+# CHECK: first: register 1 context 1 bo 3 run 1
+print("first:", invoke(a, (4, 4)))
+report("first")
+
+# Same artifact and shapes, nothing is allocated again
+# CHECK: repeat: True
+# CHECK: repeat: register 1 context 1 bo 3 run 2
+print("repeat:", invoke(a, (4, 4)))
+report("repeat")
+
+# New shapes get new argument buffers on the cached context
+# CHECK: reshape: True
+# CHECK: reshape: register 1 context 1 bo 5 run 3
+print("reshape:", invoke(a, (8, 8)))
+report("reshape")
+
+# A different binary is a different artifact
+# CHECK: other: True
+# CHECK: other: register 2 context 2 bo 8 run 4
+print("other:", invoke(artifact("b", b"design b"), (4, 4)))
+report("other")
+
+# The device lock wraps the submission, and the load when it is not cached
+# CHECK: locked: True 1
+# CHECK: locked miss: True 2
+lock = counting_lock()
+print("locked:", invoke(a, (4, 4), lock), lock.acquired)
+lock = counting_lock()
+print("locked miss:", invoke(artifact("c", b"design c"), (4, 4), lock), lock.acquired)
+
+# Without the cache every load creates a new context
+# CHECK: uncached: True
+# CHECK: uncached: register 4 context 4
+print("uncached:", invoke(a, (4, 4), use_load_cache=False))
+report("uncached")
+
+# ELF artifacts are cached the same way
+# CHECK: elf: True True
+# CHECK: elf: register 4 context 5
+e = artifact("e", b"design e", "elf")
+print("elf:", invoke(e, (4, 4)), invoke(e, (4, 4)))
+report("elf")
+
+# CHECK: hits 4 misses 4
+print(f"hits {xrt_load_cache.hits} misses {xrt_load_cache.misses}")
+xrt_load_cache.clear()
+
+# By default only the last artifact keeps its hw context, and a capacity of 0
+# keeps none
+# CHECK: default capacity 1
+# CHECK: capacity 1: 1 capacity 0: 0
+print("default capacity", XRTLoadCache().capacity)
+one, none = XRTLoadCache(), XRTLoadCache(0)
+for key in ("a", "b"):
+    one.insert(key, object())
+    none.insert(key, object())
+print(f"capacity 1: {len(one.entries)} capacity 0: {len(none.entries)}")
@@ -0,0 +1,80 @@
+# ./python/test/backend/xrt_size_variants.py -*- Python -*-
+
+# Copyright (C) 2026, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: MIT
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Size variants of an XRT artifact against a mocked device runtime. aircc
+# lists the insts file of each variant in a manifest next to the default
+# one, and an invocation runs the sequence of the variant its sizes pick.
+
+import json
+import os
+import sys
+import tempfile
+
+import numpy as np
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "Inputs"))
+import mock_pyxrt
+
+mock_pyxrt.install()
+
+from air.backend.abc import AirBackendError
+from air.backend.xrt import (
+    XRTBackend,
+    XRTCompileArtifact,
+    load_size_variants,
+    size_variants_manifest,
+)
+
+workdir = tempfile.mkdtemp()
+binary = os.path.join(workdir, "dyn.xclbin")
+insts = os.path.join(workdir, "dyn.insts.bin")
+with open(binary, "wb") as f:
+    f.write(b"dyn design")
+
+# Each insts file holds a single word telling the variants apart. The first
+# variant is also the default sequence.
+entries = []
+for word, sizes in [(1, [1, 8]), (2, [2, 16])]:
+    name = "dyn_" + "_".join(str(s) for s in sizes)
+    path = os.path.join(workdir, f"dyn.{name}.insts.bin")
+    with open(path, "wb") as f:
+        f.write(np.array([word], dtype=np.uint32).tobytes())
+    entries.append({"function": "dyn", "sizes": sizes, "sequence": name, "insts": path})
+with open(insts, "wb") as f:
+    f.write(np.array([1], dtype=np.uint32).tobytes())
+
+# CHECK: manifest: dyn.variants.json [(1, 8), (2, 16)]
+manifest = size_variants_manifest(insts)
+with open(manifest, "w") as f:
+    json.dump(entries, f)
+variants = load_size_variants(manifest)
+print("manifest:", os.path.basename(manifest), list(variants))
+
+backend = XRTBackend()
+fn = backend.load(XRTCompileArtifact(binary, "MLIR_AIE", insts, variants))
+args = (np.zeros(16, dtype=np.int32), np.zeros(16, dtype=np.int32))
+
+# CHECK: default: [1]
+# CHECK: variants: [2] [1]
+fn(*args)
+print("default:", mock_pyxrt.last_instrs)
+fn(*args, sizes=(2, 16))
+second = mock_pyxrt.last_instrs
+fn(*args, sizes=[1, 8])
+print("variants:", second, mock_pyxrt.last_instrs)
+
+# CHECK: stream: [2] True
+outputs = list(fn.stream([args, args], sizes=(2, 16)))
+print("stream:", mock_pyxrt.last_instrs, len(outputs) == 2)
+
+# CHECK: unknown: No size variant for sizes [3, 24]
+try:
+    fn(*args, sizes=(3, 24))
+except AirBackendError as e:
+    print("unknown:", e)
+
+backend.unload()
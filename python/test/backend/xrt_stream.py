@@ -0,0 +1,138 @@
+# ./python/test/backend/xrt_stream.py -*- Python -*-
+
+# Copyright (C) 2026, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: MIT
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Streamed XRT backend invocations against a mocked device runtime. A stream
+# must keep up to one run per buffer set on the device while it stages the
+# next batch, where invoking the module once per batch keeps a single run.
+# Run directly with --batches, --sync-ms and --run-ms to benchmark the
+# throughput of both at other cost ratios.
+
+import argparse
+import os
+import sys
+import tempfile
+import time
+
+import numpy as np
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "Inputs"))
+import mock_pyxrt
+
+mock_pyxrt.install()
+
+from air.backend.xrt import XRTBackend, XRTCompileArtifact
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--batches", type=int, default=24)
+parser.add_argument("--sync-ms", type=float, default=2.0)
+parser.add_argument("--run-ms", type=float, default=8.0)
+parser.add_argument("--buffers", type=int, default=2)
+args = parser.parse_args()
+
+workdir = tempfile.mkdtemp()
+binary = os.path.join(workdir, "stream.xclbin")
+insts = os.path.join(workdir, "stream.insts.bin")
+with open(binary, "wb") as f:
+    f.write(b"stream design")
+with open(insts, "wb") as f:
+    f.write(np.zeros(4, dtype=np.uint32).tobytes())
+
+backend = XRTBackend()
+fn = backend.load(XRTCompileArtifact(binary, "MLIR_AIE", insts))
+
+shape = (64, 64)
+batches = [
+    (np.full(shape, i, dtype=np.int32), np.zeros(shape, dtype=np.int32))
+    for i in range(args.batches)
+]
+
+
+def check(outputs):
+    return len(outputs) == len(batches) and all(
+        np.array_equal(out[1].reshape(shape), batch[0] + 1)
+        for out, batch in zip(outputs, batches)
+    )
+
+
+# Without device costs the results must match the synchronous path. Runs are
+# counted in flight from their submission until the host waits on them.
+# CHECK: results: True True
+# CHECK: in flight: 1 2
+sync_outputs = [fn(*batch) for batch in batches]
+sync_in_flight = mock_pyxrt.max_in_flight
+mock_pyxrt.max_in_flight = 0
+stream_outputs = list(fn.stream(iter(batches), args.buffers))
+print("results:", check(sync_outputs), check(stream_outputs))
+print("in flight:", sync_in_flight, mock_pyxrt.max_in_flight)
+
+# An abandoned stream still drains its runs
+# CHECK: abandoned: 3 0 True
+mock_pyxrt.max_in_flight = 0
+for out in backend.stream(batches, 3):
+    break
+print(
+    "abandoned:",
+    mock_pyxrt.max_in_flight,
+    mock_pyxrt.in_flight,
+    check([fn(*batch) for batch in batches]),
+)
+
+
+# The device lock is taken for submissions and retirements, and released
+# while the consumer works on an output, also of a stream it abandoned
+class DeviceLock:
+    held = False
+    held_by_consumer = False
+    acquisitions = 0
+
+    def __enter__(self):
+        assert not self.held
+        self.held = True
+        self.acquisitions += 1
+
+    def __exit__(self, *exc):
+        self.held = False
+
+
+# CHECK: device lock: True False False
+device_lock = DeviceLock()
+locked_backend = XRTBackend(device_lock=device_lock)
+locked_fn = locked_backend.load(XRTCompileArtifact(binary, "MLIR_AIE", insts))
+for out in locked_fn.stream(iter(batches), args.buffers):
+    device_lock.held_by_consumer |= device_lock.held
+abandoned = locked_fn.stream(iter(batches), args.buffers)
+next(abandoned)
+print(
+    "device lock:",
+    device_lock.acquisitions > 0,
+    device_lock.held_by_consumer,
+    device_lock.held,
+)
+abandoned.close()
+locked_backend.unload()
+
+mock_pyxrt.sync_seconds = args.sync_ms / 1000
+mock_pyxrt.run_seconds = args.run_ms / 1000
+
+
+def throughput(run):
+    start = time.perf_counter()
+    outputs = run()
+    elapsed = time.perf_counter() - start
+    assert check(outputs)
+    return len(batches) / elapsed
+
+
+sync_rate = throughput(lambda: [fn(*batch) for batch in batches])
+stream_rate = throughput(lambda: list(fn.stream(batches, args.buffers)))
+print(f"synchronous: {sync_rate:.1f} batches/s")
+print(f"streamed ({args.buffers} buffer sets): {stream_rate:.1f} batches/s")
+
+# Each synchronous batch pays for its syncs and its run back to back, the
+# stream hides the syncs of the next batch behind the run.
+
+backend.unload()
@@ -62,7 +62,7 @@ config.substitutions.append(("%PYTHON", config.python_executable))
 # excludes: A list of directories to exclude from the testsuite. The 'Inputs'
 # subdirectories contain auxiliary inputs for various tests in their parent
 # directories.
-config.excludes = []
+config.excludes = ["Inputs"]
 
 run_on_npu1 = "echo"
 run_on_npu2 = "echo"
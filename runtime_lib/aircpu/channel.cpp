@@ -3,17 +3,41 @@
 
 #include "air_channel.h"
 #include "air_tensor.h"
+#include "nd_copy.h"
 
 #include <iostream>
+#include <mutex>
 #include <thread>
 
 #define VERBOSE 0
 
+// Channels are shared by the herd cores and the rank workers of the process,
+// and a channel is allocated by whichever put reaches it first. Allocation is
+// serialized and data[0] is published last, so a get that finds data[0] set
+// finds every channel of the array.
+static std::mutex channel_init_mtx;
+
+template <typename T>
+static void _air_channel_init(tensor_t<uint64_t, 2> *channel, size_t *size,
+                              size_t *ratio, size_t depth) {
+  if (__atomic_load_n(&channel->data[0], __ATOMIC_ACQUIRE))
+    return;
+  std::lock_guard<std::mutex> guard(channel_init_mtx);
+  if (channel->data[0])
+    return;
+  for (size_t i = channel->shape[0] * channel->shape[1]; i-- > 0;) {
+    channel_t<T> *new_channel = new channel_t<T>(size, ratio, depth);
+    __atomic_store_n(&channel->data[i], (uint64_t)new_channel,
+                     __ATOMIC_RELEASE);
+  }
+}
+
 template <typename T, int R>
 static void _air_channel_put(tensor_t<uint64_t, 2> *channel, size_t *chnl_size,
-                             size_t *chnl_bcast_size, size_t *chnl_idx,
-                             tensor_t<T, R> *src, size_t *_offset,
-                             size_t *_size, size_t *_stride) {
+                             size_t *chnl_bcast_size, size_t chnl_depth,
+                             size_t *chnl_idx, tensor_t<T, R> *src,
+                             size_t *_offset, size_t *_size,
+                             size_t *_stride) {
   size_t offset[4] = {0, 0, 0, 0};
   size_t size[4] = {1, 1, 1, 1};
   size_t stride[4] = {1, 1, 1, 1};
@@ -38,37 +62,41 @@ static void _air_channel_put(tensor_t<uint64_t, 2> *channel, size_t *chnl_size,
   // channel->data is an array of pointers to channel_t objects
   // if the channel is valid, channel->data[0] should be a valid memory address
   // otherwise, allocate a new channel
-  if (channel->data[0] == 0) {
-    for (size_t i = 0; i < channel->shape[0] * channel->shape[1]; i++) {
-      channel_t<T> *new_channel = new channel_t<T>(size, ratio);
-      channel->data[i] = (uint64_t)new_channel;
-    }
-  }
+  _air_channel_init<T>(channel, size, ratio, chnl_depth ? chnl_depth : 1);
 
-  size_t idx = chnl_idx[1] * chnl_size[1] + chnl_idx[0];
+  size_t idx = chnl_idx[1] * chnl_size[0] + chnl_idx[0];
   channel_t<T> *chan = (channel_t<T> *)channel->data[idx];
 
-  // wait until the channel is empty
+  // wait until the channel has a free slot
   std::unique_lock<std::mutex> lock(chan->mtx);
-  chan->cv.wait(lock, [&chan] { return chan->token.load() == 0; });
+  chan->cv.wait(lock, [&chan] { return chan->occupancy() < chan->depth; });
 
   if (VERBOSE)
-    std::cerr << "dst offset " << offset[1] << ", " << offset[0] << ", size "
+    std::cerr << "src offset " << offset[1] << ", " << offset[0] << ", size "
               << size[1] << ", " << size[0] << ", stride " << stride[1] << ", "
               << stride[0] << std::endl;
-  size_t src_offset = 0;
-  for (size_t l = 0; l < size[3]; l++)
-    for (size_t k = 0; k < size[2]; k++)
-      for (size_t j = 0; j < size[1]; j++)
-        for (size_t i = 0; i < size[0]; i++) {
-          size_t idx =
-              ((offset[3] + l) * stride[3]) + ((offset[2] + k) * stride[2]) +
-              ((offset[1] + j) * stride[1]) + ((offset[0] + i) * stride[0]);
-          chan->data[src_offset++] = src->data[idx];
-        }
-
-  // mark the channel as full
-  chan->token.store(ratio[0] * ratio[1]);
+  nd_pattern_t src_p(offset, size, stride);
+
+  // hand the transfer to the destinations already waiting for it, and buffer
+  // it for the others
+  bool buffered = false;
+  for (size_t g = 0; g < chan->waiting.size(); g++) {
+    channel_waiter_t<T> *waiter = chan->waiting[g];
+    if (waiter) {
+      nd_pattern_t dst_p(waiter->offset, waiter->size, waiter->stride);
+      nd_copy(waiter->data, dst_p, src->data, src_p);
+      waiter->done = true;
+      chan->waiting[g] = nullptr;
+      chan->read[g]++;
+    } else if (!buffered) {
+      T *slot = chan->data + (chan->written % chan->depth) * chan->slot_size;
+      nd_copy(slot, nd_pattern_t(chan->slot_size), src->data, src_p);
+      buffered = true;
+    }
+  }
+
+  // publish the transfer to every destination
+  chan->written++;
   chan->cv.notify_all();
 }
 
@@ -91,7 +119,7 @@ static void _air_channel_get(tensor_t<uint64_t, 2> *channel, size_t *chnl_idx,
 
   // if channel get called before channel put, wait until the channel becomes
   // available
-  while (channel->data[0] == 0) {
+  while (__atomic_load_n(&channel->data[0], __ATOMIC_ACQUIRE) == 0) {
     // yield the processor
     std::this_thread::yield();
   }
@@ -101,25 +129,33 @@ static void _air_channel_get(tensor_t<uint64_t, 2> *channel, size_t *chnl_idx,
   size_t ratio1 = chan0->bcast_ratio[1];
   size_t idx = chnl_idx[1] / ratio1 * channel->shape[1] + chnl_idx[0] / ratio0;
   channel_t<T> *chan = (channel_t<T> *)channel->data[idx];
+  // this destination among the ones the channel broadcasts to
+  size_t g = chnl_idx[1] % ratio1 * ratio0 + chnl_idx[0] % ratio0;
+  uint64_t &read = chan->read[g];
 
-  // wait until the channel is full
   std::unique_lock<std::mutex> lock(chan->mtx);
-  chan->cv.wait(lock, [&chan] { return chan->token.load() > 0; });
-
-  // copy data from buffer to dst
-  size_t dst_offset = 0;
-  for (size_t l = 0; l < size[3]; l++)
-    for (size_t k = 0; k < size[2]; k++)
-      for (size_t j = 0; j < size[1]; j++)
-        for (size_t i = 0; i < size[0]; i++) {
-          size_t idx =
-              ((offset[3] + l) * stride[3]) + ((offset[2] + k) * stride[2]) +
-              ((offset[1] + j) * stride[1]) + ((offset[0] + i) * stride[0]);
-          dst->data[idx] = chan->data[dst_offset++];
-        }
-
-  // each channel.get uses up one broadcast token
-  chan->token.fetch_sub(1);
+  if (chan->written == read) {
+    // wait for the put to copy the next transfer straight into dst
+    channel_waiter_t<T> waiter;
+    waiter.data = dst->data;
+    for (int d = 0; d < 4; d++) {
+      waiter.offset[d] = offset[d];
+      waiter.size[d] = size[d];
+      waiter.stride[d] = stride[d];
+    }
+    waiter.done = false;
+    chan->waiting[g] = &waiter;
+    chan->cv.wait(lock, [&waiter] { return waiter.done; });
+    return;
+  }
+
+  // copy the oldest transfer this destination has not read from its slot
+  T *slot = chan->data + (read % chan->depth) * chan->slot_size;
+  nd_copy(dst->data, nd_pattern_t(offset, size, stride), slot,
+          nd_pattern_t(chan->slot_size));
+
+  // the slot is free once every destination has read it
+  read++;
   chan->cv.notify_all();
 }
 
@@ -141,7 +177,7 @@ static void air_channel_get(void *c, uint64_t chnl_idx1, uint64_t chnl_idx0,
 
 template <typename T, int R>
 static void air_channel_put(void *c, uint64_t chnl_size1, uint64_t chnl_size0,
-                            uint64_t bsize1, uint64_t bsize0,
+                            uint64_t bsize1, uint64_t bsize0, uint64_t depth,
                             uint64_t chnl_idx1, uint64_t chnl_idx0, void *s,
                             uint64_t offset3, uint64_t offset2,
                             uint64_t offset1, uint64_t offset0, uint64_t size3,
@@ -156,8 +192,8 @@ static void air_channel_put(void *c, uint64_t chnl_size1, uint64_t chnl_size0,
   size_t offset[4] = {offset0, offset1, offset2, offset3};
   size_t size[4] = {size0, size1, size2, size3};
   size_t stride[4] = {stride0, stride1, stride2, stride3};
-  _air_channel_put<T, R>(channel, chnl_size, chnl_bcast_size, chnl_idx, src,
-                         offset, size, stride);
+  _air_channel_put<T, R>(channel, chnl_size, chnl_bcast_size, depth, chnl_idx,
+                         src, offset, size, stride);
 }
 
 // 4D
@@ -176,12 +212,12 @@ static void air_channel_put(void *c, uint64_t chnl_size1, uint64_t chnl_size0,
 #define mlir_air_channel_put_4d(mangle, type)                                  \
   void _mlir_ciface_air_channel_put_##mangle(                                  \
       void *c, uint64_t chnl_size1, uint64_t chnl_size0, uint64_t bsize1,      \
-      uint64_t bsize0, uint64_t chnl_idx1, uint64_t chnl_idx0, void *s,        \
-      uint64_t offset3, uint64_t offset2, uint64_t offset1, uint64_t offset0,  \
-      uint64_t size3, uint64_t size2, uint64_t size1, uint64_t size0,          \
-      uint64_t stride3, uint64_t stride2, uint64_t stride1,                    \
+      uint64_t bsize0, uint64_t depth, uint64_t chnl_idx1, uint64_t chnl_idx0, \
+      void *s, uint64_t offset3, uint64_t offset2, uint64_t offset1,           \
+      uint64_t offset0, uint64_t size3, uint64_t size2, uint64_t size1,        \
+      uint64_t size0, uint64_t stride3, uint64_t stride2, uint64_t stride1,    \
       uint64_t stride0) {                                                      \
-    air_channel_put<type, 4>(c, chnl_size1, chnl_size0, bsize1, bsize0,        \
+    air_channel_put<type, 4>(c, chnl_size1, chnl_size0, bsize1, bsize0, depth, \
                              chnl_idx1, chnl_idx0, s, offset3, offset2,        \
                              offset1, offset0, size3, size2, size1, size0,     \
                              stride3, stride2, stride1, stride0);              \
@@ -202,11 +238,11 @@ static void air_channel_put(void *c, uint64_t chnl_size1, uint64_t chnl_size0,
 #define mlir_air_channel_put_3d(mangle, type)                                  \
   void _mlir_ciface_air_channel_put_##mangle(                                  \
       void *c, uint64_t chnl_size1, uint64_t chnl_size0, uint64_t bsize1,      \
-      uint64_t bsize0, uint64_t chnl_idx1, uint64_t chnl_idx0, void *s,        \
-      uint64_t offset2, uint64_t offset1, uint64_t offset0, uint64_t size2,    \
-      uint64_t size1, uint64_t size0, uint64_t stride2, uint64_t stride1,      \
-      uint64_t stride0) {                                                      \
-    air_channel_put<type, 3>(c, chnl_size1, chnl_size0, bsize1, bsize0,        \
+      uint64_t bsize0, uint64_t depth, uint64_t chnl_idx1, uint64_t chnl_idx0, \
+      void *s, uint64_t offset2, uint64_t offset1, uint64_t offset0,           \
+      uint64_t size2, uint64_t size1, uint64_t size0, uint64_t stride2,        \
+      uint64_t stride1, uint64_t stride0) {                                    \
+    air_channel_put<type, 3>(c, chnl_size1, chnl_size0, bsize1, bsize0, depth, \
                              chnl_idx1, chnl_idx0, s, 0, offset2, offset1,     \
                              offset0, 1, size2, size1, size0, 1, stride2,      \
                              stride1, stride0);                                \
@@ -226,10 +262,10 @@ static void air_channel_put(void *c, uint64_t chnl_size1, uint64_t chnl_size0,
 #define mlir_air_channel_put_2d(mangle, type)                                  \
   void _mlir_ciface_air_channel_put_##mangle(                                  \
       void *c, uint64_t chnl_size1, uint64_t chnl_size0, uint64_t bsize1,      \
-      uint64_t bsize0, uint64_t chnl_idx1, uint64_t chnl_idx0, void *s,        \
-      uint64_t offset1, uint64_t offset0, uint64_t size1, uint64_t size0,      \
-      uint64_t stride1, uint64_t stride0) {                                    \
-    air_channel_put<type, 2>(c, chnl_size1, chnl_size0, bsize1, bsize0,        \
+      uint64_t bsize0, uint64_t depth, uint64_t chnl_idx1, uint64_t chnl_idx0, \
+      void *s, uint64_t offset1, uint64_t offset0, uint64_t size1,             \
+      uint64_t size0, uint64_t stride1, uint64_t stride0) {                    \
+    air_channel_put<type, 2>(c, chnl_size1, chnl_size0, bsize1, bsize0, depth, \
                              chnl_idx1, chnl_idx0, s, 0, 0, offset1, offset0,  \
                              1, 1, size1, size0, 1, 1, stride1, stride0);      \
   }
@@ -246,9 +282,9 @@ static void air_channel_put(void *c, uint64_t chnl_size1, uint64_t chnl_size0,
 #define mlir_air_channel_put_1d(mangle, type)                                  \
   void _mlir_ciface_air_channel_put_##mangle(                                  \
       void *c, uint64_t chnl_size1, uint64_t chnl_size0, uint64_t bsize1,      \
-      uint64_t bsize0, uint64_t chnl_idx1, uint64_t chnl_idx0, void *s,        \
-      uint64_t offset0, uint64_t size0, uint64_t stride0) {                    \
-    air_channel_put<type, 1>(c, chnl_size1, chnl_size0, bsize1, bsize0,        \
+      uint64_t bsize0, uint64_t depth, uint64_t chnl_idx1, uint64_t chnl_idx0, \
+      void *s, uint64_t offset0, uint64_t size0, uint64_t stride0) {           \
+    air_channel_put<type, 1>(c, chnl_size1, chnl_size0, bsize1, bsize0, depth, \
                              chnl_idx1, chnl_idx0, s, 0, 0, 0, offset0, 1, 1,  \
                              1, size0, 1, 1, 1, stride0);                      \
   }
@@ -259,41 +295,43 @@ mlir_air_channel_get_4d(
     M0D2I64_I64_I64_M0D4I32_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64,
     int32_t);
 mlir_air_channel_put_4d(
-    M0D2I64_I64_I64_I64_I64_I64_I64_M0D4I32_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64,
+    M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D4I32_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64,
     int32_t);
 mlir_air_channel_get_4d(
     M0D2I64_I64_I64_M0D4F32_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64,
     float);
 mlir_air_channel_put_4d(
-    M0D2I64_I64_I64_I64_I64_I64_I64_M0D4F32_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64,
+    M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D4F32_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64_I64,
     float);
 
 // 3D
 mlir_air_channel_get_3d(
     M0D2I64_I64_I64_M0D3I32_I64_I64_I64_I64_I64_I64_I64_I64_I64, int32_t);
 mlir_air_channel_put_3d(
-    M0D2I64_I64_I64_I64_I64_I64_I64_M0D3I32_I64_I64_I64_I64_I64_I64_I64_I64_I64,
+    M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D3I32_I64_I64_I64_I64_I64_I64_I64_I64_I64,
     int32_t);
 mlir_air_channel_get_3d(
     M0D2I64_I64_I64_M0D3F32_I64_I64_I64_I64_I64_I64_I64_I64_I64, float);
 mlir_air_channel_put_3d(
-    M0D2I64_I64_I64_I64_I64_I64_I64_M0D3F32_I64_I64_I64_I64_I64_I64_I64_I64_I64,
+    M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D3F32_I64_I64_I64_I64_I64_I64_I64_I64_I64,
     float);
 
 // 2D
 mlir_air_channel_get_2d(M0D2I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64,
                         int32_t);
 mlir_air_channel_put_2d(
-    M0D2I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64, int32_t);
+    M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64,
+    int32_t);
 mlir_air_channel_get_2d(M0D2I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64, float);
 mlir_air_channel_put_2d(
-    M0D2I64_I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64, float);
+    M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2F32_I64_I64_I64_I64_I64_I64,
+    float);
 
 // 1D
 mlir_air_channel_get_1d(M0D2I64_I64_I64_M0D1I32_I64_I64_I64, int32_t);
-mlir_air_channel_put_1d(M0D2I64_I64_I64_I64_I64_I64_I64_M0D1I32_I64_I64_I64,
+mlir_air_channel_put_1d(M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D1I32_I64_I64_I64,
                         int32_t);
 mlir_air_channel_get_1d(M0D2I64_I64_I64_M0D1F32_I64_I64_I64, float);
-mlir_air_channel_put_1d(M0D2I64_I64_I64_I64_I64_I64_I64_M0D1F32_I64_I64_I64,
+mlir_air_channel_put_1d(M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D1F32_I64_I64_I64,
                         float);
 }
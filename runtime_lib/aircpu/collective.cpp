@@ -0,0 +1,227 @@
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "air_collective.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Bounded queue of chunks, filled by the previous rank on the ring
+struct inbox_t {
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::vector<std::vector<char>> slots;
+  std::vector<size_t> bytes;
+  uint64_t head = 0;
+  uint64_t tail = 0;
+
+  inbox_t(uint32_t depth, uint64_t chunk_bytes)
+      : slots(depth, std::vector<char>(chunk_bytes)), bytes(depth) {}
+
+  void push(const void *data, size_t n) {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] { return tail - head < slots.size(); });
+    size_t slot = tail % slots.size();
+    lock.unlock();
+    // only the producer writes a free slot
+    memcpy(slots[slot].data(), data, n);
+    bytes[slot] = n;
+    lock.lock();
+    tail++;
+    cv.notify_all();
+  }
+
+  // hands the oldest chunk to f and frees its slot
+  template <typename F> void pop(F f) {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] { return tail > head; });
+    size_t slot = head % slots.size();
+    lock.unlock();
+    f(slots[slot].data(), bytes[slot]);
+    lock.lock();
+    head++;
+    cv.notify_all();
+  }
+};
+
+} // namespace
+
+struct air_collective_comm_t {
+  uint32_t world;
+  uint64_t chunk_bytes;
+  std::vector<inbox_t *> inbox;
+};
+
+namespace {
+
+template <typename T> static T reduce(air_collective_reduction_t op, T a, T b) {
+  switch (op) {
+  case AIR_COLLECTIVE_MUL:
+    return a * b;
+  case AIR_COLLECTIVE_MAX:
+    return std::max(a, b);
+  case AIR_COLLECTIVE_MIN:
+    return std::min(a, b);
+  default:
+    return a + b;
+  }
+}
+
+// Runs world - 1 ring steps over a buffer of world blocks. Step s sends
+// block (rank - s - shift) to the next rank and receives block
+// (rank - s - shift - 1) from the previous one, chunk by chunk. All blocks
+// are cut into the same number of chunks, so every rank pushes and pops in
+// lockstep with its neighbours and a full inbox cannot deadlock the ring.
+template <typename T, typename Recv>
+static void ring_steps(air_collective_comm_t *comm, uint32_t rank, T *buf,
+                       size_t count, uint32_t shift, Recv recv) {
+  uint64_t n = comm->world;
+  if (n == 1)
+    return;
+  auto block_begin = [&](uint64_t b) { return b * count / n; };
+  size_t chunk_elems = std::max<size_t>(1, comm->chunk_bytes / sizeof(T));
+  size_t max_block = (count + n - 1) / n;
+  size_t chunks = std::max<size_t>(1, (max_block + chunk_elems - 1) /
+                                          chunk_elems);
+
+  inbox_t *next = comm->inbox[(rank + 1) % n];
+  inbox_t *own = comm->inbox[rank];
+  for (uint64_t s = 0; s < n - 1; s++) {
+    uint64_t send = (rank + 2 * n - s - shift) % n;
+    uint64_t from = (rank + 2 * n - s - shift - 1) % n;
+    size_t send_begin = block_begin(send);
+    size_t send_len = block_begin(send + 1) - send_begin;
+    size_t from_begin = block_begin(from);
+    size_t from_len = block_begin(from + 1) - from_begin;
+    for (size_t k = 0; k < chunks; k++) {
+      size_t lo = send_begin + k * send_len / chunks;
+      size_t hi = send_begin + (k + 1) * send_len / chunks;
+      next->push(buf + lo, (hi - lo) * sizeof(T));
+      size_t dst = from_begin + k * from_len / chunks;
+      own->pop([&](const char *data, size_t bytes) {
+        recv(buf + dst, reinterpret_cast<const T *>(data), bytes / sizeof(T));
+      });
+    }
+  }
+}
+
+template <typename T>
+static void reduce_scatter_steps(air_collective_comm_t *comm, uint32_t rank,
+                                 T *buf, size_t count,
+                                 air_collective_reduction_t op) {
+  ring_steps(comm, rank, buf, count, 1, [op](T *dst, const T *in, size_t n) {
+    for (size_t i = 0; i < n; i++)
+      dst[i] = reduce(op, dst[i], in[i]);
+  });
+}
+
+template <typename T>
+static void all_gather_steps(air_collective_comm_t *comm, uint32_t rank,
+                             T *buf, size_t count) {
+  ring_steps(comm, rank, buf, count, 0, [](T *dst, const T *in, size_t n) {
+    memcpy(dst, in, n * sizeof(T));
+  });
+}
+
+template <typename T>
+static int all_reduce(air_collective_comm_t *comm, uint32_t rank, const T *src,
+                      T *dst, size_t count, air_collective_reduction_t op) {
+  if (!comm || rank >= comm->world)
+    return -1;
+  if (src != dst)
+    memcpy(dst, src, count * sizeof(T));
+  reduce_scatter_steps(comm, rank, dst, count, op);
+  all_gather_steps(comm, rank, dst, count);
+  return 0;
+}
+
+template <typename T>
+static int all_gather(air_collective_comm_t *comm, uint32_t rank, const T *src,
+                      T *dst, size_t count) {
+  if (!comm || rank >= comm->world)
+    return -1;
+  memcpy(dst + rank * count, src, count * sizeof(T));
+  all_gather_steps(comm, rank, dst, count * comm->world);
+  return 0;
+}
+
+template <typename T>
+static int reduce_scatter(air_collective_comm_t *comm, uint32_t rank,
+                          const T *src, T *dst, size_t count,
+                          air_collective_reduction_t op) {
+  if (!comm || rank >= comm->world)
+    return -1;
+  // src may be read by others while this rank reduces into its copy
+  std::vector<T> scratch(src, src + count * comm->world);
+  reduce_scatter_steps(comm, rank, scratch.data(), scratch.size(), op);
+  memcpy(dst, scratch.data() + rank * count, count * sizeof(T));
+  return 0;
+}
+
+} // namespace
+
+extern "C" {
+
+air_collective_comm_t *air_collective_comm_create(uint32_t world,
+                                                  uint64_t chunk_bytes,
+                                                  uint32_t depth) {
+  if (!world || !chunk_bytes || !depth)
+    return nullptr;
+  air_collective_comm_t *comm = new air_collective_comm_t;
+  comm->world = world;
+  comm->chunk_bytes = chunk_bytes;
+  for (uint32_t i = 0; i < world; i++)
+    comm->inbox.push_back(new inbox_t(depth, chunk_bytes));
+  return comm;
+}
+
+void air_collective_comm_destroy(air_collective_comm_t *comm) {
+  if (!comm)
+    return;
+  for (inbox_t *inbox : comm->inbox)
+    delete inbox;
+  delete comm;
+}
+
+int air_collective_all_reduce_f32(air_collective_comm_t *comm, uint32_t rank,
+                                  const float *src, float *dst, size_t count,
+                                  air_collective_reduction_t op) {
+  return all_reduce(comm, rank, src, dst, count, op);
+}
+
+int air_collective_all_reduce_i32(air_collective_comm_t *comm, uint32_t rank,
+                                  const int32_t *src, int32_t *dst,
+                                  size_t count, air_collective_reduction_t op) {
+  return all_reduce(comm, rank, src, dst, count, op);
+}
+
+int air_collective_all_gather_f32(air_collective_comm_t *comm, uint32_t rank,
+                                  const float *src, float *dst, size_t count) {
+  return all_gather(comm, rank, src, dst, count);
+}
+
+int air_collective_all_gather_i32(air_collective_comm_t *comm, uint32_t rank,
+                                  const int32_t *src, int32_t *dst,
+                                  size_t count) {
+  return all_gather(comm, rank, src, dst, count);
+}
+
+int air_collective_reduce_scatter_f32(air_collective_comm_t *comm,
+                                      uint32_t rank, const float *src,
+                                      float *dst, size_t count,
+                                      air_collective_reduction_t op) {
+  return reduce_scatter(comm, rank, src, dst, count, op);
+}
+
+int air_collective_reduce_scatter_i32(air_collective_comm_t *comm,
+                                      uint32_t rank, const int32_t *src,
+                                      int32_t *dst, size_t count,
+                                      air_collective_reduction_t op) {
+  return reduce_scatter(comm, rank, src, dst, count, op);
+}
+}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "air_tensor.h"
+#include "nd_copy.h"
 
 #include <cstdint>
 #include <cstdio>
@@ -22,16 +23,8 @@ static void air_memcpy_nd_dst(tensor_t<T, R> *dst, tensor_t<T, R> *src,
   if (VERBOSE)
     printf("dst offset %lu, %lu, size %lu, %lu, stride %lu, %lu\n", offset[1],
            offset[0], size[1], size[0], stride[1], stride[0]);
-  size_t src_offset = 0;
-  for (size_t l = 0; l < size[3]; l++)
-    for (size_t k = 0; k < size[2]; k++)
-      for (size_t j = 0; j < size[1]; j++)
-        for (size_t i = 0; i < size[0]; i++) {
-          size_t idx =
-              ((offset[3] + l) * stride[3]) + ((offset[2] + k) * stride[2]) +
-              ((offset[1] + j) * stride[1]) + ((offset[0] + i) * stride[0]);
-          dst->data[idx] = src->data[src_offset++];
-        }
+  nd_pattern_t dst_p(offset, size, stride);
+  nd_copy(dst->data, dst_p, src->data, nd_pattern_t(dst_p.count()));
 }
 
 template <typename T, int R>
@@ -48,16 +41,8 @@ static void air_memcpy_nd_src(tensor_t<T, R> *dst, tensor_t<T, R> *src,
   if (VERBOSE)
     printf("src offset %lu, %lu, size %lu, %lu, stride %lu, %lu\n", offset[1],
            offset[0], size[1], size[0], stride[1], stride[0]);
-  size_t dst_offset = 0;
-  for (size_t l = 0; l < size[3]; l++)
-    for (size_t k = 0; k < size[2]; k++)
-      for (size_t j = 0; j < size[1]; j++)
-        for (size_t i = 0; i < size[0]; i++) {
-          size_t idx =
-              ((offset[3] + l) * stride[3]) + ((offset[2] + k) * stride[2]) +
-              ((offset[1] + j) * stride[1]) + ((offset[0] + i) * stride[0]);
-          dst->data[dst_offset++] = src->data[idx];
-        }
+  nd_pattern_t src_p(offset, size, stride);
+  nd_copy(dst->data, nd_pattern_t(src_p.count()), src->data, src_p);
 }
 
 // 4D
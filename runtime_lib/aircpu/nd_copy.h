@@ -0,0 +1,97 @@
+//===- nd_copy.h ------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Strided copies of the aircpu data movement ops. An access pattern is the
+// offsets, sizes and strides of an air.dma_memcpy_nd or air.channel op padded
+// to 4 dimensions, dimension 0 innermost.
+
+#ifndef AIRCPU_ND_COPY_H
+#define AIRCPU_ND_COPY_H
+
+#include <algorithm>
+#include <cstring>
+#include <stdlib.h>
+
+struct nd_pattern_t {
+  size_t offset[4];
+  size_t size[4];
+  size_t stride[4];
+
+  nd_pattern_t(const size_t *o, const size_t *s, const size_t *st) {
+    for (int d = 0; d < 4; d++) {
+      offset[d] = o[d];
+      size[d] = s[d];
+      stride[d] = st[d];
+    }
+  }
+
+  // n contiguous elements, e.g. a channel buffer
+  explicit nd_pattern_t(size_t n) {
+    for (int d = 0; d < 4; d++) {
+      offset[d] = 0;
+      size[d] = d ? 1 : n;
+      stride[d] = 1;
+    }
+  }
+
+  size_t count() const { return size[0] * size[1] * size[2] * size[3]; }
+};
+
+// Walks a pattern in order, a row of dimension 0 at a time
+struct nd_cursor_t {
+  const nd_pattern_t &p;
+  size_t i[4] = {0, 0, 0, 0};
+
+  explicit nd_cursor_t(const nd_pattern_t &p) : p(p) {}
+
+  size_t index() const {
+    size_t idx = 0;
+    for (int d = 0; d < 4; d++)
+      idx += (p.offset[d] + i[d]) * p.stride[d];
+    return idx;
+  }
+
+  size_t row_left() const { return p.size[0] - i[0]; }
+
+  // n is at most row_left()
+  void advance(size_t n) {
+    i[0] += n;
+    if (i[0] < p.size[0])
+      return;
+    i[0] = 0;
+    for (int d = 1; d < 4; d++) {
+      if (++i[d] < p.size[d])
+        return;
+      i[d] = 0;
+    }
+  }
+};
+
+// Copies the elements of src_p in src to the elements of dst_p in dst, in
+// one pass and in order. Runs that are contiguous on both sides are copied
+// with memcpy.
+template <typename T>
+static void nd_copy(T *dst, const nd_pattern_t &dst_p, const T *src,
+                    const nd_pattern_t &src_p) {
+  size_t n = std::min(dst_p.count(), src_p.count());
+  bool contiguous = dst_p.stride[0] == 1 && src_p.stride[0] == 1;
+  nd_cursor_t d(dst_p), s(src_p);
+  while (n) {
+    size_t run = 1;
+    if (contiguous) {
+      run = std::min(d.row_left(), s.row_left());
+      memcpy(dst + d.index(), src + s.index(), run * sizeof(T));
+    } else {
+      dst[d.index()] = src[s.index()];
+    }
+    d.advance(run);
+    s.advance(run);
+    n -= run;
+  }
+}
+
+#endif // AIRCPU_ND_COPY_H
@@ -2,7 +2,6 @@
 // Copyright (c) 2026 Advanced Micro Devices, Inc. All rights reserved.
 
 #include "vmem_allocator.h"
-#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
@@ -50,6 +49,7 @@ VMemAllocator::VMemAllocator(size_t heap_size) {
   hipDeviceptr_t va = 0;
   HIP_CHECK(hipMemAddressReserve(&va, heap_size_, granularity_, 0, 0));
   va_base_ = reinterpret_cast<void *>(va);
+  heap_.reset(new air::FreeListAllocator(heap_size_, granularity_));
 
   // Build access descriptors for ALL GPUs (future-ready for symmetric heap)
   access_descs_.resize(num_devices_);
@@ -68,7 +68,8 @@ VMemAllocator::VMemAllocator(size_t heap_size) {
 
 VMemAllocator::~VMemAllocator() {
   // Unmap and release all tracked allocations
-  for (auto &rec : alloc_records_) {
+  for (auto &entry : alloc_records_) {
+    AllocRecord &rec = entry.second;
     hipError_t err;
     err = hipMemUnmap(reinterpret_cast<hipDeviceptr_t>(rec.va_ptr), rec.size);
     if (err != hipSuccess)
@@ -99,17 +100,19 @@ void *VMemAllocator::allocate(size_t size_bytes) {
     size_bytes = 1;
 
   size_t aligned_size = alignUp(size_bytes, granularity_);
-  size_t aligned_offset = alignUp(current_offset_, granularity_);
+  uint64_t offset = heap_->allocate(aligned_size);
 
-  if (aligned_offset + aligned_size > heap_size_) {
+  if (offset == air::FreeListAllocator::kInvalidOffset) {
+    air::FreeListAllocator::Stats stats = heap_->getStats();
     fprintf(stderr,
             "airgpu: VMem heap exhausted "
-            "(requested %zu, used %zu, total %zu)\n",
-            aligned_size, aligned_offset, heap_size_);
+            "(requested %zu, used %zu, total %zu, largest free %zu)\n",
+            aligned_size, static_cast<size_t>(stats.bytes_allocated),
+            heap_size_, static_cast<size_t>(stats.largest_free_block));
     abort();
   }
 
-  void *va_ptr = static_cast<char *>(va_base_) + aligned_offset;
+  void *va_ptr = static_cast<char *>(va_base_) + offset;
   hipDeviceptr_t dptr = reinterpret_cast<hipDeviceptr_t>(va_ptr);
 
   // Create physical memory on this device
@@ -128,9 +131,8 @@ void *VMemAllocator::allocate(size_t size_bytes) {
   HIP_CHECK(hipMemSetAccess(dptr, aligned_size, access_descs_.data(),
                             access_descs_.size()));
 
-  // Track for cleanup
-  alloc_records_.push_back({va_ptr, aligned_size, handle});
-  current_offset_ = aligned_offset + aligned_size;
+  // Track for free and cleanup
+  alloc_records_[va_ptr] = {va_ptr, aligned_size, handle};
 
   return va_ptr;
 }
@@ -138,15 +140,20 @@ void *VMemAllocator::allocate(size_t size_bytes) {
 void VMemAllocator::free(void *ptr) {
   std::lock_guard<std::mutex> lock(mutex_);
 
-  auto it =
-      std::find_if(alloc_records_.begin(), alloc_records_.end(),
-                   [ptr](const AllocRecord &r) { return r.va_ptr == ptr; });
+  auto it = alloc_records_.find(ptr);
   if (it == alloc_records_.end()) {
     fprintf(stderr, "airgpu: free of unknown pointer %p\n", ptr);
     return;
   }
 
-  hipMemUnmap(reinterpret_cast<hipDeviceptr_t>(it->va_ptr), it->size);
-  hipMemRelease(it->handle);
+  AllocRecord &rec = it->second;
+  hipMemUnmap(reinterpret_cast<hipDeviceptr_t>(rec.va_ptr), rec.size);
+  hipMemRelease(rec.handle);
+  heap_->free(static_cast<char *>(rec.va_ptr) - static_cast<char *>(va_base_));
   alloc_records_.erase(it);
 }
+
+air::FreeListAllocator::Stats VMemAllocator::getStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return heap_->getStats();
+}
@@ -8,10 +8,14 @@
 
 #pragma once
 
+#include "air_free_list_allocator.h"
+
 #include <cstddef>
 #include <cstdint>
 #include <hip/hip_runtime.h>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 struct AllocRecord {
@@ -30,9 +34,13 @@ public:
   // Returns device pointer accessible from all GPUs (access granted at alloc).
   void *allocate(size_t size_bytes);
 
-  // Free a previously allocated pointer.
+  // Free a previously allocated pointer. Its VA range is reused by later
+  // allocations.
   void free(void *ptr);
 
+  // Usage and fragmentation of the VA heap
+  air::FreeListAllocator::Stats getStats();
+
   // Accessors for future symmetric heap extension
   void *getVaBase() const { return va_base_; }
   size_t getHeapSize() const { return heap_size_; }
@@ -46,13 +54,13 @@ public:
 private:
   void *va_base_ = nullptr;
   size_t heap_size_;
-  size_t current_offset_ = 0;
   size_t granularity_;
   int device_id_ = 0;
   int num_devices_ = 1;
 
   std::vector<hipMemAccessDesc> access_descs_;
-  std::vector<AllocRecord> alloc_records_;
+  std::unique_ptr<air::FreeListAllocator> heap_;
+  std::unordered_map<void *, AllocRecord> alloc_records_;
   std::mutex mutex_;
 
   static size_t alignUp(size_t value, size_t alignment);
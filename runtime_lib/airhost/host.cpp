@@ -9,9 +9,11 @@
 #include "air.hpp"
 #include "air_host.h"
 #include "air_host_impl.h"
+#include "air_soft_agent.h"
 #include "runtime.h"
 #include "test_library.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <dirent.h>
 #include <dlfcn.h>
@@ -19,11 +21,16 @@
 #include <fstream> // ifstream
 #include <iomanip> // setbase()
 #include <iostream>
+#include <limits.h>
+#include <map>
+#include <mutex>
+#include <set>
 #include <stdio.h>
 #include <string>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <tuple>
 #include <unistd.h>
 #include <vector>
 
@@ -51,10 +58,94 @@ aie_libxaie_ctx_t *_air_host_active_libxaie = nullptr;
 uint32_t *_air_host_bram_ptr = nullptr;
 uint64_t _air_host_bram_paddr = 0;
 air_module_handle_t _air_host_active_module = (air_module_handle_t) nullptr;
+air_load_cache_stats_t _air_host_load_cache_stats = {};
 
 const char vck5000_driver_name[] = "/dev/amdair";
 }
 
+namespace {
+
+// A module kept mapped by the cache. The cache holds its own dlopen reference,
+// so descriptors of a cached module stay valid across unload and reload.
+struct air_module_cache_entry_t {
+  struct timespec mtime;
+  off_t size;
+  void *handle;
+};
+
+// Guards air_module_cache and air_herd_cache, like airbin_cache_mutex does
+// for the airbin cache.
+std::mutex air_module_cache_mutex;
+std::map<std::string, air_module_cache_entry_t> air_module_cache;
+
+// Herds located by air_herd_load, keyed by module, the segment that was
+// active and the herd name, with the segment the herd was found in.
+struct air_herd_cache_entry_t {
+  air_segment_desc_t *segment_desc;
+  air_herd_desc_t *herd_desc;
+};
+std::map<std::tuple<air_module_handle_t, air_segment_desc_t *, std::string>,
+         air_herd_cache_entry_t>
+    air_herd_cache;
+
+// The segment whose configuration the array currently holds, and the module
+// and queue it was configured from.
+struct air_configured_segment_t {
+  air_module_handle_t module;
+  air_segment_desc_t *segment_desc;
+  hsa_queue_t *q;
+};
+
+air_configured_segment_t air_configured_segment = {0, nullptr, nullptr};
+
+// The callers below hold air_module_cache_mutex.
+bool air_module_cache_holds(air_module_handle_t handle) {
+  for (auto &entry : air_module_cache)
+    if ((air_module_handle_t)entry.second.handle == handle)
+      return true;
+  return false;
+}
+
+void air_herd_cache_forget(air_module_handle_t handle) {
+  for (auto it = air_herd_cache.begin(); it != air_herd_cache.end();)
+    if (std::get<0>(it->first) == handle)
+      it = air_herd_cache.erase(it);
+    else
+      ++it;
+}
+
+void air_module_cache_evict(
+    std::map<std::string, air_module_cache_entry_t>::iterator it) {
+  air_module_handle_t handle = (air_module_handle_t)it->second.handle;
+  if (air_configured_segment.module == handle)
+    air_segment_cache_invalidate();
+  air_herd_cache_forget(handle);
+  dlclose(it->second.handle);
+  air_module_cache.erase(it);
+}
+
+} // namespace
+
+void air_segment_cache_invalidate() {
+  air_configured_segment = {0, nullptr, nullptr};
+}
+
+void air_load_cache_get_stats(air_load_cache_stats_t *stats) {
+  if (stats)
+    *stats = _air_host_load_cache_stats;
+}
+
+void air_load_cache_flush() {
+  air_segment_cache_invalidate();
+  {
+    std::lock_guard<std::mutex> lock(air_module_cache_mutex);
+    while (!air_module_cache.empty())
+      air_module_cache_evict(air_module_cache.begin());
+    air_herd_cache.clear();
+  }
+  air_airbin_cache_flush();
+}
+
 // Determining if an hsa agent is an AIE agent or not
 hsa_status_t find_aie(hsa_agent_t agent, void *data) {
   hsa_status_t status(HSA_STATUS_SUCCESS);
@@ -84,6 +175,14 @@ hsa_status_t find_aie(hsa_agent_t agent, void *data) {
 hsa_status_t air_init() {
   printf("%s\n", __func__);
 
+  // The soft agent replaces both the HSA runtime and libxaie
+  if (air_soft_agent_requested()) {
+    hsa_status_t soft_ret = air_soft_agent_init();
+    if (soft_ret != HSA_STATUS_SUCCESS)
+      std::cerr << "air_soft_agent_init failed" << std::endl;
+    return soft_ret;
+  }
+
   hsa_status_t hsa_ret = hsa_init();
   air::rocm::Runtime::Init();
 
@@ -102,11 +201,21 @@ hsa_status_t air_init() {
 }
 
 hsa_status_t air_shut_down() {
+  if (air_soft_agent_active()) {
+    if (_air_host_active_module)
+      air_module_unload(_air_host_active_module);
+    air_load_cache_flush();
+    air_signal_pool_destroy();
+    return air_soft_agent_shut_down();
+  }
+
   if (!_air_host_active_libxaie)
     return HSA_STATUS_ERROR_NOT_INITIALIZED;
 
   if (_air_host_active_module)
     air_module_unload(_air_host_active_module);
+  air_load_cache_flush();
+  air_signal_pool_destroy();
 
   if (_air_host_active_libxaie)
     air_deinit_libxaie((air_libxaie_ctx_t)_air_host_active_libxaie);
@@ -188,12 +297,41 @@ air_module_handle_t air_module_load_from_file(const char *filename,
   if (_air_host_active_module)
     air_module_unload(_air_host_active_module);
 
-  air_module_handle_t handle;
+  // Files found through the library search path are not cached
+  struct stat file_stat;
+  bool cacheable = !stat(filename, &file_stat);
+  std::string key(filename);
+  std::unique_lock<std::mutex> lock(air_module_cache_mutex);
+  if (cacheable) {
+    char resolved[PATH_MAX];
+    if (realpath(filename, resolved))
+      key = resolved;
+    auto it = air_module_cache.find(key);
+    if (it != air_module_cache.end() &&
+        (it->second.size != file_stat.st_size ||
+         it->second.mtime.tv_sec != file_stat.st_mtim.tv_sec ||
+         it->second.mtime.tv_nsec != file_stat.st_mtim.tv_nsec))
+      air_module_cache_evict(it);
+  }
+
   void *_handle = dlopen(filename, RTLD_NOW);
   if (!_handle) {
     printf("%s\n", dlerror());
     return 0;
   }
+
+  if (cacheable) {
+    auto it = air_module_cache.find(key);
+    if (it != air_module_cache.end()) {
+      _air_host_load_cache_stats.module_hits++;
+    } else {
+      // The extra reference keeps the module mapped once it is unloaded
+      _air_host_load_cache_stats.module_misses++;
+      air_module_cache[key] = {file_stat.st_mtim, file_stat.st_size,
+                               dlopen(filename, RTLD_NOW)};
+    }
+  }
+  lock.unlock();
   _air_host_active_module = (air_module_handle_t)_handle;
   _air_host_active_herd = {q, agent, nullptr};
   _air_host_active_segment = {q, agent, nullptr};
@@ -216,7 +354,7 @@ int32_t air_module_unload(air_module_handle_t handle) {
         auto herd_desc = module_desc->segment_descs[i]->herd_descs[j];
         if (herd_desc == _air_host_active_herd.herd_desc) {
           if (_air_host_active_segment.q) {
-            hsa_queue_destroy(_air_host_active_segment.q);
+            air_queue_destroy(_air_host_active_segment.q);
           }
           _air_host_active_herd = {nullptr, nullptr};
           _air_host_active_segment = {nullptr, nullptr, nullptr};
@@ -224,6 +362,16 @@ int32_t air_module_unload(air_module_handle_t handle) {
       }
     }
   }
+  // Without a cache reference the descriptors go away with the module
+  {
+    std::lock_guard<std::mutex> lock(air_module_cache_mutex);
+    if (!air_module_cache_holds(handle)) {
+      if (air_configured_segment.module == handle)
+        air_segment_cache_invalidate();
+      air_herd_cache_forget(handle);
+    }
+  }
+
   if (_air_host_active_module == handle) {
     _air_host_active_module = (air_module_handle_t) nullptr;
 
@@ -284,7 +432,9 @@ air_module_desc_t *air_module_get_desc(air_module_handle_t handle) {
 
 uint64_t air_segment_load(const char *name) {
 
-  assert(_air_host_active_libxaie);
+  // There is no array to configure behind the soft agent
+  bool soft_agent = air_soft_agent_active();
+  assert(soft_agent || _air_host_active_libxaie);
 
   auto segment_desc = air_segment_get_desc(_air_host_active_module, name);
   if (!segment_desc) {
@@ -292,37 +442,50 @@ uint64_t air_segment_load(const char *name) {
     assert(0);
   }
 
-  XAie_Finish(_air_host_active_libxaie->XAieDevInst);
-
-  // Setting the driver libxaie backend back up
-  // Currently only targetting device 0
-  _air_host_active_libxaie->XAieConfig->Backend = XAIE_IO_BACKEND_AMDAIR;
-  _air_host_active_libxaie->XAieDevInst->IOInst =
-      (void *)"/sys/class/amdair/amdair/00";
-
-  XAie_CfgInitialize(_air_host_active_libxaie->XAieDevInst,
-                     _air_host_active_libxaie->XAieConfig);
-  XAie_PmRequestTiles(_air_host_active_libxaie->XAieDevInst, NULL, 0);
-
-  //
-  // Set up a 1x3 herd starting 7,0
-  //
-  uint64_t wr_idx =
-      hsa_queue_add_write_index_relaxed(_air_host_active_segment.q, 1);
-  uint64_t packet_id = wr_idx % _air_host_active_segment.q->size;
-  hsa_agent_dispatch_packet_t shim_pkt;
-  air_packet_device_init(&shim_pkt, XAIE_NUM_COLS);
-  air_queue_dispatch_and_wait(_air_host_active_segment.agent,
-                              _air_host_active_segment.q, packet_id, wr_idx,
-                              &shim_pkt);
-
-  wr_idx = hsa_queue_add_write_index_relaxed(_air_host_active_segment.q, 1);
-  packet_id = wr_idx % _air_host_active_segment.q->size;
-  hsa_agent_dispatch_packet_t segment_pkt;
-  air_packet_segment_init(&segment_pkt, 0, 0, 50, 1, 8);
-  air_queue_dispatch_and_wait(_air_host_active_segment.agent,
-                              _air_host_active_segment.q, packet_id, wr_idx,
-                              &segment_pkt);
+  // The array still holds this segment from an earlier load on this queue.
+  // The stream switches and program memories are as we left them, but an
+  // earlier run used up the locks and buffer descriptors and stopped the
+  // cores, so those are set up again below.
+  hsa_queue_t *q = _air_host_active_segment.q;
+  bool resident = air_configured_segment.module == _air_host_active_module &&
+                  air_configured_segment.segment_desc == segment_desc &&
+                  air_configured_segment.q == q;
+  if (resident)
+    _air_host_load_cache_stats.segment_skips++;
+
+  if (!soft_agent) {
+    XAie_Finish(_air_host_active_libxaie->XAieDevInst);
+
+    // Setting the driver libxaie backend back up
+    // Currently only targetting device 0
+    _air_host_active_libxaie->XAieConfig->Backend = XAIE_IO_BACKEND_AMDAIR;
+    _air_host_active_libxaie->XAieDevInst->IOInst =
+        (void *)"/sys/class/amdair/amdair/00";
+
+    XAie_CfgInitialize(_air_host_active_libxaie->XAieDevInst,
+                       _air_host_active_libxaie->XAieConfig);
+    XAie_PmRequestTiles(_air_host_active_libxaie->XAieDevInst, NULL, 0);
+  }
+
+  if (!resident) {
+    //
+    // Set up a 1x3 herd starting 7,0
+    //
+    // Both packets go out with one doorbell. The queue executes them in
+    // order, so only the last one needs a completion signal.
+    hsa_agent_dispatch_packet_t init_pkts[2];
+    air_packet_device_init(&init_pkts[0], XAIE_NUM_COLS);
+    init_pkts[0].completion_signal.handle = 0;
+    air_packet_segment_init(&init_pkts[1], 0, 0, 50, 1, 8);
+    air_signal_pool_acquire(_air_host_active_segment.agent,
+                            &init_pkts[1].completion_signal);
+    air_queue_dispatch_batch(q, init_pkts, 2);
+    air_queue_wait(q, &init_pkts[1]);
+    air_signal_pool_release(init_pkts[1].completion_signal);
+
+    // The device init reset every column
+    air_segment_cache_invalidate();
+  }
 
   std::string segment_name(segment_desc->name, segment_desc->name_length);
 
@@ -330,7 +493,9 @@ uint64_t air_segment_load(const char *name) {
   air_rt_aie_functions_t *mlir = (air_rt_aie_functions_t *)dlsym(
       (void *)_air_host_active_module, func_name.c_str());
 
-  if (mlir) {
+  if (soft_agent) {
+    // Segment configuration is skipped, only the queue traffic is emulated
+  } else if (mlir) {
     // printf("configuring segment: '%s'\n", segment_name.c_str());
     assert(mlir->configure_cores);
     assert(mlir->configure_switchboxes);
@@ -338,7 +503,8 @@ uint64_t air_segment_load(const char *name) {
     assert(mlir->configure_dmas);
     assert(mlir->start_cores);
     mlir->configure_cores(_air_host_active_libxaie);
-    mlir->configure_switchboxes(_air_host_active_libxaie);
+    if (!resident)
+      mlir->configure_switchboxes(_air_host_active_libxaie);
     mlir->initialize_locks(_air_host_active_libxaie);
     mlir->configure_dmas(_air_host_active_libxaie);
     mlir->start_cores(_air_host_active_libxaie);
@@ -348,11 +514,33 @@ uint64_t air_segment_load(const char *name) {
     assert(0);
   }
   _air_host_active_segment.segment_desc = segment_desc;
+  air_configured_segment = {_air_host_active_module, segment_desc, q};
   return 0;
 }
 
 uint64_t air_herd_load(const char *name) {
 
+  // The herd was located before with the same segment active. Load the
+  // segment it was found in if that is not the active one and skip the walk
+  // over the descriptors.
+  {
+    std::unique_lock<std::mutex> lock(air_module_cache_mutex);
+    auto it = air_herd_cache.find(std::make_tuple(
+        _air_host_active_module, _air_host_active_segment.segment_desc,
+        std::string(name)));
+    if (it != air_herd_cache.end()) {
+      air_herd_cache_entry_t entry = it->second;
+      _air_host_load_cache_stats.herd_hits++;
+      lock.unlock();
+      if (_air_host_active_segment.segment_desc != entry.segment_desc)
+        air_segment_load(entry.segment_desc->name);
+      _air_host_active_herd.herd_desc = entry.herd_desc;
+      return 0;
+    }
+  }
+  air_segment_desc_t *active_segment_desc =
+      _air_host_active_segment.segment_desc;
+
   // If no segment is loaded, load the segment associated with this herd
   if (!_air_host_active_segment.segment_desc) {
     bool loaded = false;
@@ -384,6 +572,10 @@ uint64_t air_herd_load(const char *name) {
   }
   _air_host_active_herd.herd_desc = herd_desc;
 
+  std::lock_guard<std::mutex> lock(air_module_cache_mutex);
+  air_herd_cache[std::make_tuple(_air_host_active_module, active_segment_desc,
+                                 std::string(name))] = {
+      _air_host_active_segment.segment_desc, herd_desc};
   return 0;
 }
 
@@ -395,64 +587,66 @@ uint64_t air_wait_all(std::vector<uint64_t> &signals) {
     return 0;
   }
 
-  // Containing all of the barrier packets. This is needed because
-  // we might have to wait on more than 5 signals.
-  std::vector<hsa_barrier_and_packet_t> packets;
-
-  // iterate over the signals in chunks of 5
-  while (signals.size()) {
-    if (signals.size() < 5)
-      signals.resize(5, 0);
-
-    // Vector which contains the handles of the signals that we are going to
-    // wait on
-    std::vector<hsa_signal_t> signals_in_pkt;
-    bool non_zero = false;
-    for (auto s : signals) {
-      if (s) {
-        // Push back the proper signal
-        signals_in_pkt.push_back(*reinterpret_cast<hsa_signal_t *>(s));
-        non_zero = true;
-      } else {
-        // Create a dummy signal that will have a handle of 0
-        hsa_signal_t dummy_signal;
-        hsa_amd_signal_create_on_agent(
-            0, 0, nullptr, _air_host_active_segment.agent, 0, &dummy_signal);
-        dummy_signal.handle =
-            0; // The barrier and packet will ignore a signal with handle of 0
-        signals_in_pkt.push_back(dummy_signal);
+  // Collect the outstanding events. A null event, or one whose signal was
+  // already recycled by an earlier wait, has nothing left to wait for.
+  std::vector<hsa_signal_t *> events;
+  std::set<uint64_t> seen;
+  for (auto s : signals) {
+    auto event = reinterpret_cast<hsa_signal_t *>(s);
+    if (event && event->handle && seen.insert(event->handle).second)
+      events.push_back(event);
+  }
+
+  if (events.empty())
+    return 0;
+
+  // A single event needs no barrier, wait on its signal directly
+  if (events.size() == 1) {
+    air_signal_wait_complete(*events[0]);
+  } else {
+    // Build a tree of barrier AND packets. Each leaf covers 5 events and each
+    // inner barrier the completion signals of 5 barriers of the level below,
+    // so the host only waits on the root.
+    std::vector<hsa_barrier_and_packet_t> packets;
+    std::vector<hsa_signal_t> level;
+    for (auto event : events)
+      level.push_back(*event);
+    while (level.size() > 1 || packets.empty()) {
+      std::vector<hsa_signal_t> next;
+      for (size_t i = 0; i < level.size(); i += 5) {
+        hsa_signal_t deps[5] = {};
+        for (size_t j = 0; j < 5 && i + j < level.size(); j++)
+          deps[j] = level[i + j];
+        hsa_barrier_and_packet_t barrier_pkt;
+        air_packet_barrier_and(&barrier_pkt, deps[0], deps[1], deps[2],
+                               deps[3], deps[4]);
+        air_signal_pool_acquire(_air_host_active_segment.agent,
+                                &barrier_pkt.completion_signal);
+        packets.push_back(barrier_pkt);
+        next.push_back(barrier_pkt.completion_signal);
       }
+      level.swap(next);
     }
-    if (non_zero) {
-
-      // Submit a barrier packet for 5 signals that we are waiting on
-      uint64_t wr_idx =
-          hsa_queue_add_write_index_relaxed(_air_host_active_segment.q, 1);
-      uint64_t packet_id = wr_idx % _air_host_active_segment.q->size;
-      hsa_barrier_and_packet_t barrier_pkt;
-      air_packet_barrier_and(&barrier_pkt, signals_in_pkt[0], signals_in_pkt[1],
-                             signals_in_pkt[2], signals_in_pkt[3],
-                             signals_in_pkt[4]);
-      hsa_amd_signal_create_on_agent(1, 0, nullptr,
-                                     _air_host_active_segment.agent, 0,
-                                     &barrier_pkt.completion_signal);
-      air_queue_dispatch(_air_host_active_segment.q, packet_id, wr_idx,
-                         &barrier_pkt);
-
-      // Put it in a vector of barrier packets so we can wait on all of them
-      // after they are submitted
-      packets.push_back(barrier_pkt);
+
+    // Submit leaves first with one doorbell per queue-full of packets. The
+    // queue drains in order, so once the last packet of a chunk is done the
+    // whole chunk has left the queue.
+    for (size_t i = 0; i < packets.size(); i += q->size) {
+      uint32_t count = std::min<size_t>(q->size, packets.size() - i);
+      air_queue_dispatch_batch(q, &packets[i], count);
+      air_signal_wait_complete(packets[i + count - 1].completion_signal);
     }
 
-    // Remove the 5 signals from our vector and keep going if we have more
-    signals.resize(signals.size() - 5);
+    for (auto &pkt : packets)
+      air_signal_pool_release(pkt.completion_signal);
   }
 
-  // Submit each packet and delete the completion signal
-  for (auto p : packets) {
-    air_queue_wait(q, &p);
-    hsa_signal_destroy(p.completion_signal);
-  }
+  // Recycle the event signals the runtime took from the pool. Clearing those
+  // events makes any later wait on them return right away instead of looking
+  // at a recycled signal. Signals the caller created stay with the caller.
+  for (auto event : events)
+    if (air_signal_pool_release(*event) == HSA_STATUS_SUCCESS)
+      event->handle = 0;
 
   return 0;
 }
@@ -526,4 +720,14 @@ uint64_t _mlir_ciface___airrt_wait_all_1_3(uint64_t e0, uint64_t e1,
   return air_wait_all(events);
 }
 
+// Waits on more than 3 events pass them as an array, see AIRRtToLLVM
+void _mlir_ciface___airrt_wait_all_0_n(uint64_t *e, uint64_t count) {
+  std::vector<uint64_t> events(e, e + count);
+  air_wait_all(events);
+}
+uint64_t _mlir_ciface___airrt_wait_all_1_n(uint64_t *e, uint64_t count) {
+  std::vector<uint64_t> events(e, e + count);
+  return air_wait_all(events);
+}
+
 } // extern C
@@ -9,6 +9,7 @@
 #define AIR_HPP
 
 #include "air_host.h"
+#include "air_soft_agent.h"
 
 #include <stdint.h>
 #include <vector>
@@ -19,6 +20,10 @@ inline void air_write_pkt(hsa_queue_t *q, uint32_t packet_id, T *pkt) {
 }
 
 inline hsa_status_t air_get_agents(std::vector<hsa_agent_t> &agents) {
+  if (air_soft_agent_active()) {
+    agents.push_back(air_soft_agent_get_agent());
+    return HSA_STATUS_SUCCESS;
+  }
   return hsa_iterate_agents(find_aie, (void *)&agents);
 }
 
@@ -9,24 +9,55 @@
 #ifndef AIR_CHANNEL_H
 #define AIR_CHANNEL_H
 
-#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <stdint.h>
 #include <stdlib.h>
+#include <vector>
 
+// A get waiting for the next transfer, with the access pattern of its
+// destination. The put copies straight into it and marks it done.
+template <typename T> struct channel_waiter_t {
+  T *data;
+  size_t offset[4];
+  size_t size[4];
+  size_t stride[4];
+  bool done;
+};
+
+// A channel holds up to depth transfers in a ring of depth slots. A put fills
+// the next slot once every destination has read the transfer depth puts ago,
+// and every broadcast destination reads the slots in order at its own pace.
+// Destinations already waiting for the transfer are handed it directly, and
+// the slot is only filled for the others.
 template <typename T> struct channel_t {
   T *data;
+  size_t slot_size;
+  size_t depth;
   size_t bcast_ratio[2];
-  std::atomic<int> token;
+  // transfers put, and transfers got by each broadcast destination
+  uint64_t written;
+  std::vector<uint64_t> read;
+  // the get of each broadcast destination waiting for a transfer, if any
+  std::vector<channel_waiter_t<T> *> waiting;
   std::mutex mtx;
   std::condition_variable cv;
 
-  channel_t(size_t sizes[4], size_t ratio[2]) {
-    data = new T[sizes[0] * sizes[1] * sizes[2] * sizes[3]];
+  channel_t(size_t sizes[4], size_t ratio[2], size_t depth)
+      : slot_size(sizes[0] * sizes[1] * sizes[2] * sizes[3]), depth(depth),
+        written(0), read(ratio[0] * ratio[1], 0),
+        waiting(ratio[0] * ratio[1], nullptr) {
+    data = new T[slot_size * depth];
     bcast_ratio[0] = ratio[0];
     bcast_ratio[1] = ratio[1];
-    token.store(0);
-    cv.notify_all();
+  }
+
+  // transfers put but not yet read by every destination
+  uint64_t occupancy() {
+    uint64_t oldest = written;
+    for (uint64_t r : read)
+      oldest = r < oldest ? r : oldest;
+    return written - oldest;
   }
 };
 
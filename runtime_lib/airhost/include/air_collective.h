@@ -0,0 +1,71 @@
+//===- air_collective.h -----------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Reference implementation of the air.collective ops for rank instances that
+// run as threads of one process, as air-to-async lowers air.rank.
+//
+// A communicator connects world rank instances in a ring. Every instance
+// owns an inbox, a bounded queue of chunk slots in process memory that the
+// previous instance on the ring fills and the owner drains. The collectives
+// follow the schedule of air-collective-to-channel: the data is cut into one
+// block per instance and every block into chunks of at most chunk_bytes, so
+// an instance reduces a chunk while the next ones are already in its inbox.
+// Blocks need not be the same size for all-reduce.
+//
+// Every rank instance of the world calls the same collectives in the same
+// order, each from its own thread.
+
+#ifndef AIR_COLLECTIVE_H
+#define AIR_COLLECTIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+
+typedef enum {
+  AIR_COLLECTIVE_ADD,
+  AIR_COLLECTIVE_MUL,
+  AIR_COLLECTIVE_MAX,
+  AIR_COLLECTIVE_MIN,
+} air_collective_reduction_t;
+
+struct air_collective_comm_t;
+
+// depth is the number of chunks an inbox holds, at least 1
+air_collective_comm_t *air_collective_comm_create(uint32_t world,
+                                                  uint64_t chunk_bytes,
+                                                  uint32_t depth);
+void air_collective_comm_destroy(air_collective_comm_t *comm);
+
+// src and dst hold count elements and may be the same buffer
+int air_collective_all_reduce_f32(air_collective_comm_t *comm, uint32_t rank,
+                                  const float *src, float *dst, size_t count,
+                                  air_collective_reduction_t op);
+int air_collective_all_reduce_i32(air_collective_comm_t *comm, uint32_t rank,
+                                  const int32_t *src, int32_t *dst,
+                                  size_t count, air_collective_reduction_t op);
+
+// src holds count elements, dst world * count
+int air_collective_all_gather_f32(air_collective_comm_t *comm, uint32_t rank,
+                                  const float *src, float *dst, size_t count);
+int air_collective_all_gather_i32(air_collective_comm_t *comm, uint32_t rank,
+                                  const int32_t *src, int32_t *dst,
+                                  size_t count);
+
+// src holds world * count elements, dst count
+int air_collective_reduce_scatter_f32(air_collective_comm_t *comm,
+                                      uint32_t rank, const float *src,
+                                      float *dst, size_t count,
+                                      air_collective_reduction_t op);
+int air_collective_reduce_scatter_i32(air_collective_comm_t *comm,
+                                      uint32_t rank, const int32_t *src,
+                                      int32_t *dst, size_t count,
+                                      air_collective_reduction_t op);
+}
+
+#endif // AIR_COLLECTIVE_H
@@ -0,0 +1,174 @@
+//===- air_free_list_allocator.h --------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Offset allocator for device heaps that the host cannot or should not touch.
+//
+// All bookkeeping lives on the host: the allocator hands out offsets into a
+// heap of a fixed capacity and the caller maps them onto its memory (a BAR
+// mapping, a reserved VA range, ...). Free blocks sit in power-of-two size
+// class lists, neighbouring free blocks are coalesced on free, and live
+// allocations are found with one hash lookup.
+//
+// The allocator is not thread safe, callers serialize access.
+
+#ifndef AIR_FREE_LIST_ALLOCATOR_H
+#define AIR_FREE_LIST_ALLOCATOR_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace air {
+
+class FreeListAllocator {
+public:
+  static constexpr uint64_t kInvalidOffset = ~0ULL;
+
+  struct Stats {
+    uint64_t capacity;
+    uint64_t bytes_allocated;
+    uint64_t bytes_free;
+    uint64_t largest_free_block;
+    uint64_t num_allocations;
+    uint64_t num_free_blocks;
+
+    // 0 when all free memory is one block, approaching 1 as it splinters
+    double fragmentation() const {
+      if (!bytes_free)
+        return 0.0;
+      return 1.0 - static_cast<double>(largest_free_block) / bytes_free;
+    }
+  };
+
+  // alignment must be a power of two, capacity is rounded down to it
+  FreeListAllocator(uint64_t capacity, uint64_t alignment)
+      : alignment_(alignment ? alignment : 1),
+        capacity_(capacity & ~(alignment_ - 1)), free_lists_(kNumClasses) {
+    if (capacity_)
+      insertFree(0, capacity_);
+  }
+
+  // Returns the offset of a block of at least size bytes, or kInvalidOffset
+  uint64_t allocate(uint64_t size) {
+    if (!size)
+      size = 1;
+    size = (size + alignment_ - 1) & ~(alignment_ - 1);
+    if (size > capacity_)
+      return kInvalidOffset;
+
+    // Take the smallest block that fits. Blocks in the request's own class
+    // may be too small, every block in a higher class fits.
+    for (unsigned c = sizeClass(size); c < kNumClasses; c++) {
+      auto it = free_lists_[c].lower_bound({size, 0});
+      if (it == free_lists_[c].end())
+        continue;
+      uint64_t block_size = it->first;
+      uint64_t offset = it->second;
+      eraseFree(offset, block_size);
+      if (block_size > size)
+        insertFree(offset + size, block_size - size);
+      allocated_[offset] = size;
+      bytes_allocated_ += size;
+      return offset;
+    }
+    return kInvalidOffset;
+  }
+
+  // Returns false if offset is not a live allocation
+  bool free(uint64_t offset) {
+    auto it = allocated_.find(offset);
+    if (it == allocated_.end())
+      return false;
+    uint64_t size = it->second;
+    allocated_.erase(it);
+    bytes_allocated_ -= size;
+
+    // Merge with the free blocks right after and right before
+    auto next = free_blocks_.find(offset + size);
+    if (next != free_blocks_.end()) {
+      uint64_t next_size = next->second;
+      eraseFree(next->first, next_size);
+      size += next_size;
+    }
+    auto prev = free_blocks_.lower_bound(offset);
+    if (prev != free_blocks_.begin()) {
+      --prev;
+      if (prev->first + prev->second == offset) {
+        uint64_t prev_offset = prev->first;
+        uint64_t prev_size = prev->second;
+        eraseFree(prev_offset, prev_size);
+        offset = prev_offset;
+        size += prev_size;
+      }
+    }
+    insertFree(offset, size);
+    return true;
+  }
+
+  // Size of the live allocation at offset, 0 if there is none
+  uint64_t allocationSize(uint64_t offset) const {
+    auto it = allocated_.find(offset);
+    return it == allocated_.end() ? 0 : it->second;
+  }
+
+  Stats getStats() const {
+    Stats stats;
+    stats.capacity = capacity_;
+    stats.bytes_allocated = bytes_allocated_;
+    stats.bytes_free = capacity_ - bytes_allocated_;
+    stats.largest_free_block = 0;
+    for (unsigned c = kNumClasses; c-- > 0;) {
+      if (!free_lists_[c].empty()) {
+        stats.largest_free_block = free_lists_[c].rbegin()->first;
+        break;
+      }
+    }
+    stats.num_allocations = allocated_.size();
+    stats.num_free_blocks = free_blocks_.size();
+    return stats;
+  }
+
+  uint64_t getCapacity() const { return capacity_; }
+  uint64_t getAlignment() const { return alignment_; }
+
+private:
+  static constexpr unsigned kNumClasses = 64;
+
+  static unsigned sizeClass(uint64_t size) {
+    unsigned c = 0;
+    while (size >>= 1)
+      c++;
+    return c;
+  }
+
+  void insertFree(uint64_t offset, uint64_t size) {
+    free_blocks_[offset] = size;
+    free_lists_[sizeClass(size)].insert({size, offset});
+  }
+
+  void eraseFree(uint64_t offset, uint64_t size) {
+    free_blocks_.erase(offset);
+    free_lists_[sizeClass(size)].erase({size, offset});
+  }
+
+  uint64_t alignment_;
+  uint64_t capacity_;
+  uint64_t bytes_allocated_ = 0;
+
+  // Free blocks by address for coalescing, and by (size, address) per class
+  std::map<uint64_t, uint64_t> free_blocks_;
+  std::vector<std::set<std::pair<uint64_t, uint64_t>>> free_lists_;
+
+  // Live allocations, offset to size
+  std::unordered_map<uint64_t, uint64_t> allocated_;
+};
+
+} // namespace air
+
+#endif // AIR_FREE_LIST_ALLOCATOR_H
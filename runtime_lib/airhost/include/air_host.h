@@ -30,6 +30,12 @@ hsa_status_t air_shut_down();
 void *air_malloc(size_t size);
 void air_free(void *mem);
 
+// Make host memory directly addressable by the shim DMAs. Transfers on
+// registered memory, or memory from air_malloc, are handed to the DMA as one
+// 4-D descriptor instead of being staged through the BRAM bounce buffer.
+hsa_status_t air_mem_register(void *ptr, size_t size);
+hsa_status_t air_mem_unregister(void *ptr);
+
 // libxaie context operations
 //
 
@@ -52,6 +58,39 @@ void air_write32(uint64_t addr, uint32_t val);
 hsa_status_t air_get_agent_info(hsa_agent_t *agent, hsa_queue_t *queue,
                                 hsa_air_agent_info_t attribute, void *data);
 
+// queue and signal operations, routed to the soft agent when it is active
+// (see air_soft_agent.h) and to the HSA runtime otherwise
+//
+
+hsa_status_t air_queue_create(hsa_agent_t agent, uint32_t size,
+                              hsa_queue_t **queue);
+hsa_status_t air_queue_destroy(hsa_queue_t *queue);
+uint64_t air_queue_add_write_index(hsa_queue_t *queue, uint64_t value);
+
+hsa_status_t air_signal_create(hsa_signal_value_t initial_value,
+                               hsa_agent_t *agent, hsa_signal_t *signal);
+hsa_status_t air_signal_destroy(hsa_signal_t signal);
+void air_signal_store(hsa_signal_t signal, hsa_signal_value_t value);
+hsa_signal_value_t
+air_signal_wait(hsa_signal_t signal, hsa_signal_condition_t condition,
+                hsa_signal_value_t compare_value, uint64_t timeout_hint,
+                hsa_wait_state_t wait_state = HSA_WAIT_STATE_ACTIVE);
+
+// How the runtime waits for packet completion. Adaptive spins for spin_ns
+// and then blocks, which keeps short waits fast without burning a core on
+// long ones.
+typedef enum {
+  AIR_WAIT_POLICY_ACTIVE = 0,
+  AIR_WAIT_POLICY_BLOCKED = 1,
+  AIR_WAIT_POLICY_ADAPTIVE = 2
+} air_wait_policy_t;
+
+void air_set_wait_policy(air_wait_policy_t policy, uint64_t spin_ns = 20000);
+air_wait_policy_t air_get_wait_policy();
+
+// Wait until signal reaches 0 following the wait policy
+hsa_status_t air_signal_wait_complete(hsa_signal_t signal);
+
 // initialize pkt as a segment init packet with given parameters
 hsa_status_t air_packet_segment_init(hsa_agent_dispatch_packet_t *pkt,
                                      uint16_t herd_id, uint8_t start_col,
@@ -189,6 +228,36 @@ air_herd_desc_t *air_herd_get_desc(air_module_handle_t handle,
 uint64_t air_segment_load(const char *name);
 
 uint64_t air_herd_load(const char *name);
+
+// Load caches
+//
+// Modules stay mapped after air_module_unload, keyed by path and mtime, so
+// loading the same file again skips the dynamic loader. When the segment last
+// configured on the queue is the one requested, air_segment_load skips the
+// device init and the stream switch configuration. It still resets and
+// reloads the cores and sets up the locks and DMAs again, since the last run
+// changed them. air_herd_load remembers where it found each herd, and
+// air_load_airbin keeps each airbin staged in device memory and replays it
+// with a single packet. A file that changed on disk is reloaded in full.
+//
+// Call air_load_cache_flush after resetting or reconfiguring the array
+// outside of these entry points, so the next load configures it again.
+
+struct air_load_cache_stats_t {
+  uint64_t module_hits;
+  uint64_t module_misses;
+  // air_segment_load calls that found the segment already configured and
+  // skipped the device init and stream switch configuration
+  uint64_t segment_skips;
+  // air_herd_load calls that reused an earlier descriptor lookup
+  uint64_t herd_hits;
+  // airbins replayed from device memory without parsing the file
+  uint64_t airbin_hits;
+  uint64_t airbin_misses;
+};
+
+void air_load_cache_get_stats(air_load_cache_stats_t *stats);
+void air_load_cache_flush();
 }
 
 // queue operations
@@ -215,6 +284,34 @@ hsa_status_t air_queue_dispatch_and_wait(hsa_agent_t *agent, hsa_queue_t *queue,
                                          hsa_barrier_and_packet_t *pkt,
                                          bool destroy_signal = true);
 
+// Submit count packets with a single doorbell. The write indices are
+// reserved in one step and the first one is returned in first_wr_idx.
+hsa_status_t air_queue_dispatch_batch(hsa_queue_t *queue,
+                                      hsa_agent_dispatch_packet_t *pkts,
+                                      uint32_t count,
+                                      uint64_t *first_wr_idx = nullptr);
+hsa_status_t air_queue_dispatch_batch(hsa_queue_t *queue,
+                                      hsa_barrier_and_packet_t *pkts,
+                                      uint32_t count,
+                                      uint64_t *first_wr_idx = nullptr);
+
+// completion signal pool
+//
+
+// Take a signal with value 1 from the pool of agent, creating one when the
+// pool is empty.
+hsa_status_t air_signal_pool_acquire(hsa_agent_t *agent, hsa_signal_t *signal);
+// Return a signal that nothing waits on anymore to the pool it was acquired
+// from. Signals that did not come from the pool are left alone and
+// HSA_STATUS_ERROR_INVALID_SIGNAL is returned.
+hsa_status_t air_signal_pool_release(hsa_signal_t signal);
+// Return attached to the pool together with signal. For signals that only
+// complete after attached has, such as the completion signal of a packet
+// queued behind a barrier on attached.
+hsa_status_t air_signal_pool_attach(hsa_signal_t signal, hsa_signal_t attached);
+// Destroy the pooled signals of all agents, done by air_shut_down.
+void air_signal_pool_destroy();
+
 hsa_status_t find_aie(hsa_agent_t agent, void *data);
 hsa_status_t air_get_agents(std::vector<hsa_agent_t> &agents);
 
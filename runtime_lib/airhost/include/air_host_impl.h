@@ -8,6 +8,7 @@
 #ifndef AIR_HOST_IMPL_H
 #define AIR_HOST_IMPL_H
 
+#include "air_host.h"
 #include "test_library.h"
 
 // AIE config functions generated by AIE dialect lowering
@@ -27,4 +28,13 @@ struct air_rt_aie_functions_t {
 */
 const char *air_get_driver_name(void);
 
+// Load cache state shared between the module and airbin loaders
+extern "C" air_load_cache_stats_t _air_host_load_cache_stats;
+
+// Release the staged airbins
+void air_airbin_cache_flush();
+// Forget the configured segment, after the array was reprogrammed or its
+// queue destroyed
+void air_segment_cache_invalidate();
+
 #endif
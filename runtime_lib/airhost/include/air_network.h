@@ -51,4 +51,10 @@ void air_send(hsa_signal_t *s, tensor_t<uint32_t, 1> *t, uint32_t size,
 void air_barrier(tensor_t<uint32_t, 1> *dummy_tensor, hsa_agent_t *agent,
                  hsa_queue_t *q, uint8_t ernic_sel);
 
+// Number of RQEs or WQEs air_send and air_recv keep in flight on their queue,
+// 16 unless AIR_NETWORK_WINDOW says otherwise. This is a local send window,
+// the peer does not grant credits.
+void air_set_network_window(uint32_t window);
+uint32_t air_get_network_window();
+
 #endif
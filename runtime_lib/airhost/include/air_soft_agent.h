@@ -0,0 +1,80 @@
+//===- air_soft_agent.h -----------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// In-process software emulation of an AIE HSA agent.
+//
+// The soft agent owns its queues and signals in host memory and runs one
+// worker thread per queue that consumes agent dispatch and barrier packets in
+// order. ND_MEMCPY packets are executed with host memcpys: data sent on an
+// MM2S shim channel is staged and returned on the S2MM channel with the same
+// column and channel number. RDMA SENDs are looped back into the receives
+// posted on the same QP through another queue, so two queues can stand in for
+// two ERNIC nodes. Every packet completes after a configurable latency,
+// which makes dispatch overhead and transfer throughput of the runtime
+// measurable on machines without an AIE device.
+//
+// The soft agent is selected by setting AIR_SOFT_AGENT=1 before air_init().
+// AIR_SOFT_AGENT_LATENCY="<ns per packet>[,<bytes per us>]" sets the initial
+// latency model. A bandwidth of 0 models an infinitely fast data mover.
+
+#ifndef AIR_SOFT_AGENT_H
+#define AIR_SOFT_AGENT_H
+
+#include "hsa/hsa.h"
+
+#include <stdint.h>
+
+extern "C" {
+
+struct air_soft_agent_latency_model_t {
+  // fixed cost charged to every packet
+  uint64_t packet_ns;
+  // data mover bandwidth for memcpy packets, 0 for no transfer cost
+  uint64_t bytes_per_us;
+};
+
+// true if AIR_SOFT_AGENT is set to a non-zero value in the environment
+bool air_soft_agent_requested();
+
+// true between a successful air_soft_agent_init() and its shut down
+bool air_soft_agent_active();
+
+hsa_status_t air_soft_agent_init();
+hsa_status_t air_soft_agent_shut_down();
+
+hsa_status_t
+air_soft_agent_set_latency_model(const air_soft_agent_latency_model_t *model);
+hsa_status_t
+air_soft_agent_get_latency_model(air_soft_agent_latency_model_t *model);
+
+// the single agent exposed by the emulator
+hsa_agent_t air_soft_agent_get_agent();
+
+// Queue and signal operations of the emulator. These mirror the HSA entry
+// points used by the runtime and are reached through the air_queue_* and
+// air_signal_* wrappers in air_host.h.
+hsa_status_t air_soft_agent_queue_create(uint32_t size, hsa_queue_t **queue);
+hsa_status_t air_soft_agent_queue_destroy(hsa_queue_t *queue);
+uint64_t air_soft_agent_queue_add_write_index(hsa_queue_t *queue,
+                                              uint64_t value);
+
+hsa_status_t air_soft_agent_signal_create(hsa_signal_value_t initial_value,
+                                          hsa_signal_t *signal);
+hsa_status_t air_soft_agent_signal_destroy(hsa_signal_t signal);
+void air_soft_agent_signal_store(hsa_signal_t signal, hsa_signal_value_t value);
+hsa_signal_value_t air_soft_agent_signal_load(hsa_signal_t signal);
+hsa_signal_value_t air_soft_agent_signal_wait(hsa_signal_t signal,
+                                              hsa_signal_condition_t condition,
+                                              hsa_signal_value_t compare_value,
+                                              uint64_t timeout_hint,
+                                              hsa_wait_state_t wait_state);
+
+void *air_soft_agent_malloc(size_t size);
+void air_soft_agent_free(void *mem);
+}
+
+#endif // AIR_SOFT_AGENT_H
@@ -22,17 +22,17 @@
 #include <termios.h>
 #include <unistd.h>
 
+#include "air_free_list_allocator.h"
+
 // #include "pcie-bdf.h"
 
-// Defining our memory allocator. Right now going
-// to implement it as a stack, where we can just
-// make arbitrary allocations to it, and it grows
-// until it runs out of space. I guess that is the
-// easiest for now
+// Defining our memory allocator. Allocations are carved out of the device
+// memory after segment_offset by a free-list allocator, so buffers can be
+// freed and their memory reused.
 struct pcie_ernic_dev_mem_allocator {
   void *dev_mem;                    // Pointing to device BAR
   const char *dev_mem_bar_filename; // BAR which is backed by device memory
-  uint64_t dev_mem_ptr;             // Points to the top of the device memory
+  air::FreeListAllocator *heap;     // Tracks the memory after segment_offset
   uint64_t dev_mem_size; // The total size of the device memory so we can report
                          // errors when too much is requested
   uint64_t segment_offset; // Need an offset in case multiple processes are
@@ -47,5 +47,6 @@ struct pcie_ernic_dev_mem_allocator *init_dev_mem_allocator(
 void free_dev_mem_allocator(struct pcie_ernic_dev_mem_allocator *allocator);
 void *dev_mem_alloc(struct pcie_ernic_dev_mem_allocator *allocator,
                     uint32_t size, uint64_t *pa);
+void dev_mem_free(struct pcie_ernic_dev_mem_allocator *allocator, void *ptr);
 
 #endif
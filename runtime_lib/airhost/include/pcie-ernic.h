@@ -300,6 +300,7 @@ struct pcie_ernic_buff {
   uint64_t pa;
   uint64_t size;
   bool on_device;
+  struct pcie_ernic_dev_mem_allocator *allocator; // Set for device memory
 };
 
 /* This contains the address mappings of the MMIO
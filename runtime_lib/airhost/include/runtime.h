@@ -21,6 +21,10 @@ public:
   void *AllocateMemory(size_t size);
   void FreeMemory(void *ptr);
 
+  // Pin host memory for the AIE agents, returns the agent side address
+  void *LockMemory(void *ptr, size_t size);
+  void UnlockMemory(void *ptr);
+
   static Runtime *runtime_;
 
 private:
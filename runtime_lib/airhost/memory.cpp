@@ -9,9 +9,11 @@
 #include "air.hpp"
 #include "air_host.h"
 #include "air_host_impl.h"
+#include "air_soft_agent.h"
 #include "pcie-ernic.h"
 #include "runtime.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdio>
@@ -20,6 +22,8 @@
 #include <string.h>   /* for memset() */
 #include <sys/mman.h> /* for mlock() */
 #include <unistd.h>   /* for getpagesize() */
+#include <map>
+#include <mutex>
 #include <vector>
 
 extern "C" {
@@ -30,12 +34,91 @@ extern uint32_t *_air_host_bram_ptr;
 extern uint64_t _air_host_bram_paddr;
 }
 
+// Host memory the shim DMAs can address directly, keyed by its start address
+struct air_mem_region_t {
+  size_t size;
+  uint64_t agent_addr;
+  bool locked;
+};
+
+static std::mutex air_mem_regions_mutex;
+static std::map<uint64_t, air_mem_region_t> air_mem_regions;
+
+static void air_mem_region_add(void *ptr, size_t size, void *agent_ptr,
+                               bool locked) {
+  std::lock_guard<std::mutex> lock(air_mem_regions_mutex);
+  air_mem_regions[reinterpret_cast<uint64_t>(ptr)] = {
+      size, reinterpret_cast<uint64_t>(agent_ptr), locked};
+}
+
+// Translate [addr, addr + bytes) to an agent address if one region covers it
+static bool air_mem_region_lookup(uint64_t addr, uint64_t bytes,
+                                  uint64_t *agent_addr) {
+  std::lock_guard<std::mutex> lock(air_mem_regions_mutex);
+  auto it = air_mem_regions.upper_bound(addr);
+  if (it == air_mem_regions.begin())
+    return false;
+  --it;
+  if (addr + bytes > it->first + it->second.size)
+    return false;
+  *agent_addr = it->second.agent_addr + (addr - it->first);
+  return true;
+}
+
 void *air_malloc(size_t size) {
-  void *mem(air::rocm::Runtime::runtime_->AllocateMemory(size));
+  void *mem;
+  if (air_soft_agent_active())
+    mem = air_soft_agent_malloc(size);
+  else
+    mem = air::rocm::Runtime::runtime_->AllocateMemory(size);
+  if (mem)
+    air_mem_region_add(mem, size, mem, false);
   return mem;
 }
 
-void air_free(void *mem) { air::rocm::Runtime::runtime_->FreeMemory(mem); }
+void air_free(void *mem) {
+  {
+    std::lock_guard<std::mutex> lock(air_mem_regions_mutex);
+    air_mem_regions.erase(reinterpret_cast<uint64_t>(mem));
+  }
+  if (air_soft_agent_active()) {
+    air_soft_agent_free(mem);
+    return;
+  }
+  air::rocm::Runtime::runtime_->FreeMemory(mem);
+}
+
+hsa_status_t air_mem_register(void *ptr, size_t size) {
+  if (!ptr || !size)
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+
+  // The soft agent works on host addresses
+  if (air_soft_agent_active()) {
+    air_mem_region_add(ptr, size, ptr, false);
+    return HSA_STATUS_SUCCESS;
+  }
+
+  void *agent_ptr = air::rocm::Runtime::runtime_->LockMemory(ptr, size);
+  if (!agent_ptr)
+    return HSA_STATUS_ERROR_INVALID_ALLOCATION;
+  air_mem_region_add(ptr, size, agent_ptr, true);
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t air_mem_unregister(void *ptr) {
+  air_mem_region_t region;
+  {
+    std::lock_guard<std::mutex> lock(air_mem_regions_mutex);
+    auto it = air_mem_regions.find(reinterpret_cast<uint64_t>(ptr));
+    if (it == air_mem_regions.end())
+      return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+    region = it->second;
+    air_mem_regions.erase(it);
+  }
+  if (region.locked)
+    air::rocm::Runtime::runtime_->UnlockMemory(ptr);
+  return HSA_STATUS_SUCCESS;
+}
 
 // Data structure internal to the runtime to map air tensors
 // to the information to access a remote buffer
@@ -51,6 +134,26 @@ static int64_t shim_channel_data(air_herd_shim_desc_t *sd, int i, int j,
   return sd->channel_data[i * 8 * 8 + j * 8 + k];
 }
 
+// Post RDMA work requests with one doorbell per queue-full and wait once per
+// batch. The queue executes them in order, so only the last packet of a batch
+// carries a completion signal.
+static void
+air_mem_post_rdma_wqes(std::vector<hsa_agent_dispatch_packet_t> &pkts) {
+  hsa_queue_t *q = _air_host_active_herd.q;
+  for (size_t i = 0; i < pkts.size(); i += q->size) {
+    uint32_t count = std::min<size_t>(q->size, pkts.size() - i);
+    for (uint32_t j = 0; j < count; j++)
+      pkts[i + j].completion_signal.handle = 0;
+    hsa_agent_dispatch_packet_t &last = pkts[i + count - 1];
+    air_signal_pool_acquire(_air_host_active_herd.agent,
+                            &last.completion_signal);
+    air_queue_dispatch_batch(q, &pkts[i], count);
+    air_signal_wait_complete(last.completion_signal);
+    air_signal_pool_release(last.completion_signal);
+  }
+  pkts.clear();
+}
+
 template <typename T, int R>
 static void air_mem_shim_nd_memcpy_queue_impl(
     hsa_signal_t *s, uint32_t id, uint64_t x, uint64_t y, tensor_t<T, R> *t,
@@ -89,38 +192,51 @@ static void air_mem_shim_nd_memcpy_queue_impl(
   }
 
   bool isMM2S = shim_chan >= 2;
+  if (isMM2S)
+    shim_chan = shim_chan - 2;
+
+  size_t stride = 1;
+  size_t offset = 0;
+  std::vector<uint64_t> offsets{offset_0, offset_1, offset_2, offset_3};
+  for (int i = 0; i < R; i++) {
+    offset += offsets[i] * stride * sizeof(T);
+    stride *= t->shape[R - i - 1];
+  }
 
+  // Physically addressed tensors, and local tensors in memory the agent can
+  // reach, go to the shim DMA as one 4-D descriptor without a bounce copy.
   bool uses_pa = (space == 1); // t->uses_pa;
-  if (uses_pa) {
-    if (isMM2S)
-      shim_chan = shim_chan - 2;
-
-    size_t stride = 1;
-    size_t offset = 0;
-    std::vector<uint64_t> offsets{offset_0, offset_1, offset_2, offset_3};
-    for (int i = 0; i < R; i++) {
-      offset += offsets[i] * stride * sizeof(T);
-      stride *= t->shape[R - i - 1];
+  uint64_t agent_addr = (uint64_t)t->data + offset;
+  uint8_t memory_space = space;
+  if (!uses_pa && is_local) {
+    uint64_t extent = ((length_4d - 1) * stride_4d +
+                       (length_3d - 1) * stride_3d +
+                       (length_2d - 1) * stride_2d + length_1d) *
+                      sizeof(T);
+    if (air_mem_region_lookup((uint64_t)t->data + offset, extent,
+                              &agent_addr)) {
+      uses_pa = true;
+      memory_space = 2;
     }
+  }
 
-    uint64_t wr_idx =
-        hsa_queue_add_write_index_relaxed(_air_host_active_herd.q, 1);
+  if (uses_pa) {
+    uint64_t wr_idx = air_queue_add_write_index(_air_host_active_herd.q, 1);
     uint64_t packet_id = wr_idx % _air_host_active_herd.q->size;
 
     hsa_agent_dispatch_packet_t pkt;
 
     air_packet_nd_memcpy(
         &pkt, /*herd_id=*/0, shim_col, /*direction=*/isMM2S, shim_chan,
-        /*burst_len=*/4, /*memory_space=*/space, (uint64_t)t->data + offset,
-        length_1d * sizeof(T), length_2d, stride_2d * sizeof(T), length_3d,
-        stride_3d * sizeof(T), length_4d, stride_4d * sizeof(T));
+        /*burst_len=*/4, memory_space, agent_addr, length_1d * sizeof(T),
+        length_2d, stride_2d * sizeof(T), length_3d, stride_3d * sizeof(T),
+        length_4d, stride_4d * sizeof(T));
 
-    // TODO: Right now we don't have a way of knowing when we can destroy these
-    // signals
     if (s) {
-      // Fire off the packet
-      hsa_amd_signal_create_on_agent(1, 0, nullptr, _air_host_active_herd.agent,
-                                     0, &pkt.completion_signal);
+      // Fire off the packet. The signal goes back to the pool once the
+      // air_wait_all consuming the event has seen it complete.
+      air_signal_pool_acquire(_air_host_active_herd.agent,
+                              &pkt.completion_signal);
       air_queue_dispatch(_air_host_active_herd.q, packet_id, wr_idx, &pkt);
 
       // Set the signal that we were passed in equal to the completion signal
@@ -132,19 +248,12 @@ static void air_mem_shim_nd_memcpy_queue_impl(
     }
     return;
   } else {
+    // Fall back to staging the rows in BRAM
     uint32_t *bounce_buffer = _air_host_bram_ptr;
 
     // Only used for RDMA requests
     uint64_t bounce_buffer_pa = _air_host_bram_paddr;
 
-    size_t stride = 1;
-    size_t offset = 0;
-    std::vector<uint64_t> offsets{offset_0, offset_1, offset_2, offset_3};
-    for (int i = 0; i < R; i++) {
-      offset += offsets[i] * stride * sizeof(T);
-      stride *= t->shape[R - i - 1];
-    }
-
     uint64_t length = 0;
     for (uint32_t index_4d = 0; index_4d < length_4d; index_4d++)
       for (uint32_t index_3d = 0; index_3d < length_3d; index_3d++)
@@ -167,10 +276,11 @@ static void air_mem_shim_nd_memcpy_queue_impl(
     uint64_t paddr_1d = p;
 
     uint64_t wr_idx, packet_id;
-    hsa_agent_dispatch_packet_t rdma_read_pkt;
+
+    // One RDMA work request per row, posted together
+    std::vector<hsa_agent_dispatch_packet_t> rdma_pkts;
 
     if (isMM2S) {
-      shim_chan = shim_chan - 2;
       for (uint32_t index_4d = 0; index_4d < length_4d; index_4d++) {
         paddr_2d = paddr_3d;
         for (uint32_t index_3d = 0; index_3d < length_3d; index_3d++) {
@@ -180,20 +290,13 @@ static void air_mem_shim_nd_memcpy_queue_impl(
               memcpy((size_t *)bounce_buffer, (size_t *)paddr_1d,
                      length_1d * sizeof(T));
             } else {
-              wr_idx =
-                  hsa_queue_add_write_index_relaxed(_air_host_active_herd.q, 1);
-              packet_id = wr_idx % _air_host_active_herd.q->size;
+              hsa_agent_dispatch_packet_t rdma_read_pkt;
               air_packet_post_rdma_wqe(
                   &rdma_read_pkt, (uint64_t)paddr_1d,
                   (uint64_t)bounce_buffer_pa, (uint32_t)length_1d * sizeof(T),
                   (uint8_t)OP_READ, (uint8_t)rdma_entry->rkey,
                   (uint8_t)rdma_entry->qp, (uint8_t)0);
-
-              // air_write_pkt<hsa_agent_dispatch_packet_t>(_air_host_active_herd.q,
-              // packet_id, &rdma_read_pkt);
-              air_queue_dispatch_and_wait(_air_host_active_herd.agent,
-                                          _air_host_active_herd.q, packet_id,
-                                          wr_idx, &rdma_read_pkt);
+              rdma_pkts.push_back(rdma_read_pkt);
             }
 
             // Update physical address of the bounce buffer we are writing to
@@ -205,9 +308,10 @@ static void air_mem_shim_nd_memcpy_queue_impl(
         }
         paddr_3d += stride_4d * sizeof(T);
       }
+      air_mem_post_rdma_wqes(rdma_pkts);
     }
 
-    wr_idx = hsa_queue_add_write_index_relaxed(_air_host_active_herd.q, 1);
+    wr_idx = air_queue_add_write_index(_air_host_active_herd.q, 1);
     packet_id = wr_idx % _air_host_active_herd.q->size;
 
     hsa_agent_dispatch_packet_t memcpy_pkt;
@@ -217,22 +321,16 @@ static void air_mem_shim_nd_memcpy_queue_impl(
         /*_air_host_bram_paddr*/ reinterpret_cast<uint64_t>(_air_host_bram_ptr),
         length * sizeof(T), 1, 0, 1, 0, 1, 0);
 
-    // TODO: Right now we don't have a way of knowing when we can destroy these
-    // signals
-    if (s) {
-      // Fire off the packet
-      // TODO: Don't wait here
-      air_queue_dispatch_and_wait(_air_host_active_herd.agent,
-                                  _air_host_active_herd.q, packet_id, wr_idx,
-                                  &memcpy_pkt, false);
+    // The bounce buffer is shared by all transfers and S2MM data is copied
+    // out of it below, so this path completes before returning even when an
+    // event is requested.
+    air_queue_dispatch_and_wait(_air_host_active_herd.agent,
+                                _air_host_active_herd.q, packet_id, wr_idx,
+                                &memcpy_pkt);
 
-      // Having the signal that we were passed point to the same signal value
-      s->handle = memcpy_pkt.completion_signal.handle;
-    } else {
-      air_queue_dispatch_and_wait(_air_host_active_herd.agent,
-                                  _air_host_active_herd.q, packet_id, wr_idx,
-                                  &memcpy_pkt);
-    }
+    // The transfer is complete, a null signal tells air_wait_all so
+    if (s)
+      s->handle = 0;
 
     if (!isMM2S) {
       for (uint32_t index_4d = 0; index_4d < length_4d; index_4d++) {
@@ -244,22 +342,13 @@ static void air_mem_shim_nd_memcpy_queue_impl(
               memcpy((size_t *)paddr_1d, (size_t *)bounce_buffer,
                      length_1d * sizeof(T));
             } else {
-              wr_idx =
-                  hsa_queue_add_write_index_relaxed(_air_host_active_herd.q, 1);
-              packet_id = wr_idx % _air_host_active_herd.q->size;
               hsa_agent_dispatch_packet_t rdma_write_pkt;
-
               air_packet_post_rdma_wqe(
                   &rdma_write_pkt, (uint64_t)paddr_1d,
                   (uint64_t)bounce_buffer_pa, (uint32_t)length_1d * sizeof(T),
                   (uint8_t)OP_WRITE, (uint8_t)rdma_entry->rkey,
                   (uint8_t)rdma_entry->qp, (uint8_t)0);
-
-              // air_write_pkt<hsa_agent_dispatch_packet_t>(_air_host_active_herd.q,
-              // packet_id, &rdma_write_pkt);
-              air_queue_dispatch_and_wait(_air_host_active_herd.agent,
-                                          _air_host_active_herd.q, packet_id,
-                                          wr_idx, &rdma_write_pkt);
+              rdma_pkts.push_back(rdma_write_pkt);
             }
 
             bounce_buffer_pa += length_1d * sizeof(T);
@@ -270,6 +359,7 @@ static void air_mem_shim_nd_memcpy_queue_impl(
         }
         paddr_3d += stride_4d * sizeof(T);
       }
+      air_mem_post_rdma_wqes(rdma_pkts);
     }
   }
 }
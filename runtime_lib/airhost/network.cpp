@@ -5,11 +5,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
+#include <deque>
 #include <iostream>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #include "air.hpp"
 #include "air_host.h"
@@ -258,6 +261,71 @@ hsa_status_t air_ernic_free() {
   return HSA_STATUS_SUCCESS;
 }
 
+// Number of RQEs or WQEs air_send and air_recv keep in flight on their own
+// queue. This is a local send window, not a flow-control credit: the peer
+// grants nothing, and a SEND still relies on the peer having posted its RQEs.
+static uint32_t air_network_window = 0;
+
+void air_set_network_window(uint32_t window) { air_network_window = window; }
+
+uint32_t air_get_network_window() {
+  if (!air_network_window) {
+    air_network_window = 16;
+    if (const char *env = getenv("AIR_NETWORK_WINDOW"))
+      air_network_window = std::max(1, atoi(env));
+  }
+  return air_network_window;
+}
+
+/* Posts the packets of one transfer in order with at most a window of them
+in flight. Every posted packet occupies a slot of the send window until its
+completion signal fires, and the oldest packet is retired when the window is
+full. Once the remaining packets fit in the window they are posted together
+and share one completion signal counting them down. That signal is returned
+through s, or waited on if s is NULL */
+static void air_network_post(hsa_agent_t *agent, hsa_queue_t *q,
+                             std::vector<hsa_agent_dispatch_packet_t> &pkts,
+                             hsa_signal_t *s) {
+  size_t window = std::min<size_t>(air_get_network_window(), q->size);
+  std::deque<hsa_signal_t> in_flight;
+  size_t i = 0;
+
+  while (in_flight.size() + (pkts.size() - i) > window) {
+    if (in_flight.size() == window) {
+      air_signal_wait_complete(in_flight.front());
+      air_signal_pool_release(in_flight.front());
+      in_flight.pop_front();
+      continue;
+    }
+    air_signal_pool_acquire(agent, &pkts[i].completion_signal);
+    air_queue_dispatch_batch(q, &pkts[i], 1);
+    in_flight.push_back(pkts[i].completion_signal);
+    i++;
+  }
+
+  // With no packets left, e.g. for an empty air_recv, done is already
+  // complete and nothing is dispatched
+  hsa_signal_t done;
+  air_signal_pool_acquire(agent, &done);
+  air_signal_store(done, pkts.size() - i);
+  for (size_t j = i; j < pkts.size(); j++)
+    pkts[j].completion_signal = done;
+  if (i < pkts.size())
+    air_queue_dispatch_batch(q, &pkts[i], pkts.size() - i);
+
+  for (auto signal : in_flight) {
+    air_signal_wait_complete(signal);
+    air_signal_pool_release(signal);
+  }
+
+  if (s) {
+    s->handle = done.handle;
+  } else {
+    air_signal_wait_complete(done);
+    air_signal_pool_release(done);
+  }
+}
+
 /* Performs a message passing receive. We first poll on receiving an
 RDMA SEND which contains the data, which is then copied to the provided
 tensor t. We then send a synchronizing SEND back to remote agent. This
@@ -306,72 +374,73 @@ void air_recv(hsa_signal_t *s, tensor_t<uint32_t, 1> *t, uint32_t size,
     return;
   }
 
-  // If we are provided a signal we can implement a non-blocking SEND and
-  // some other packets can wait on that signal
-  if (s) {
-    printf("TODO: Implement non-blocking air_recv\n");
-  } else {
-
-    // Calculating the number of RQEs that will be received
-    uint32_t num_rqes = ceil((float)size / RQE_SIZE);
-    uint32_t amount_data_left = size;
-
-    uint64_t wr_idx, packet_id;
-    uint32_t rqe_offset = 0;
-    while (amount_data_left > 0) {
-
-      // Calculating how much data we will recieve this iteration
-      uint32_t amount_data_to_recv = 0;
-      if (amount_data_left > RQE_SIZE) {
-        amount_data_to_recv = RQE_SIZE;
-      } else {
-        amount_data_to_recv = amount_data_left;
-      }
-
-      wr_idx = hsa_queue_add_write_index_relaxed(q, 1);
-      packet_id = wr_idx % q->size;
-      hsa_agent_dispatch_packet_t recv_pkt;
-
-      air_packet_post_rdma_recv(&recv_pkt, // HSA Packet
-                                rdma_entry->local_buff->pa + rqe_offset +
-                                    offset,          // Local PADDR
-                                amount_data_to_recv, // Length
-                                (uint8_t)qpid,       // QPID
-                                ernic_sel);          // ERNIC select
-
-      // Need to do this because otherwise the runtime will complain the packet
-      // is timing out but it is supposed to be blocking
-      // air_write_pkt<hsa_agent_dispatch_packet_t>(q, packet_id, &recv_pkt);
-      air_queue_dispatch(q, packet_id, wr_idx, &recv_pkt);
-
-      while (hsa_signal_wait_scacquire(recv_pkt.completion_signal,
-                                       HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                       HSA_WAIT_STATE_ACTIVE) != 0)
-        ;
-
-      // Calculating how much data we have to receive now and the new offset
-      amount_data_left -= amount_data_to_recv;
-      rqe_offset += amount_data_to_recv;
+  // Post one RQE per chunk of the tensor followed by the synchronizing SEND
+  // so the corresponding air_send() can complete. If we are provided a signal
+  // it reports completion and other packets can wait on it.
+  std::vector<hsa_agent_dispatch_packet_t> pkts;
+  uint32_t amount_data_left = size;
+  uint32_t rqe_offset = 0;
+  while (amount_data_left > 0) {
+
+    // Calculating how much data we will recieve in this RQE
+    uint32_t amount_data_to_recv = 0;
+    if (amount_data_left > RQE_SIZE) {
+      amount_data_to_recv = RQE_SIZE;
+    } else {
+      amount_data_to_recv = amount_data_left;
     }
 
-    // Sending a synchronizing SEND so the corresponding air_send() can complete
-    wr_idx = hsa_queue_add_write_index_relaxed(q, 1);
-    packet_id = wr_idx % q->size;
-    hsa_agent_dispatch_packet_t sync_send_pkt;
-    air_packet_post_rdma_wqe(
-        &sync_send_pkt,             // HSA Packet
-        0,                          // Remote VADDR
-        rdma_entry->local_buff->pa, // Local PADDR -- Once 0 length SENDs are
-                                    // working we can just make this 0
-        0x00000100, // Length -- For some reason 0 length is not working so need
-                    // to do a single RQE SEND
-        (uint8_t)OP_SEND, // op
-        0,                // Key
-        (uint8_t)qpid,    // QPID
-        ernic_sel);       // ERNIC select
+    hsa_agent_dispatch_packet_t recv_pkt;
+    air_packet_post_rdma_recv(&recv_pkt, // HSA Packet
+                              rdma_entry->local_buff->pa + rqe_offset +
+                                  offset,          // Local PADDR
+                              amount_data_to_recv, // Length
+                              (uint8_t)qpid,       // QPID
+                              ernic_sel);          // ERNIC select
+    pkts.push_back(recv_pkt);
+
+    // Calculating how much data we have to receive now and the new offset
+    amount_data_left -= amount_data_to_recv;
+    rqe_offset += amount_data_to_recv;
+  }
+
+  hsa_agent_dispatch_packet_t sync_send_pkt;
+  air_packet_post_rdma_wqe(
+      &sync_send_pkt,             // HSA Packet
+      0,                          // Remote VADDR
+      rdma_entry->local_buff->pa, // Local PADDR -- Once 0 length SENDs are
+                                  // working we can just make this 0
+      0x00000100, // Length -- For some reason 0 length is not working so need
+                  // to do a single RQE SEND
+      (uint8_t)OP_SEND, // op
+      0,                // Key
+      (uint8_t)qpid,    // QPID
+      ernic_sel);       // ERNIC select
+
+  // A receive completes when its data lands, not when the queue moves past
+  // it, so queue order alone would let the SEND overtake the RQEs. A barrier
+  // on the completion of the RQEs holds the SEND back until all the data is
+  // in. The SEND completing then covers the whole receive.
+  hsa_signal_t rqes_done;
+  air_network_post(agent, q, pkts, &rqes_done);
+
+  hsa_signal_t none = {0};
+  hsa_barrier_and_packet_t barrier_pkt;
+  air_packet_barrier_and(&barrier_pkt, rqes_done, none, none, none, none);
+  barrier_pkt.completion_signal = none;
+  air_queue_dispatch_batch(q, &barrier_pkt, 1);
+
+  hsa_signal_t sent;
+  air_signal_pool_acquire(agent, &sent);
+  air_signal_pool_attach(sent, rqes_done);
+  sync_send_pkt.completion_signal = sent;
+  air_queue_dispatch_batch(q, &sync_send_pkt, 1);
 
-    // air_write_pkt<hsa_agent_dispatch_packet_t>(q, packet_id, &sync_send_pkt);
-    air_queue_dispatch_and_wait(agent, q, packet_id, wr_idx, &sync_send_pkt);
+  if (s) {
+    s->handle = sent.handle;
+  } else {
+    air_signal_wait_complete(sent);
+    air_signal_pool_release(sent);
   }
 }
 
@@ -424,56 +493,39 @@ void air_send(hsa_signal_t *s, tensor_t<uint32_t, 1> *t, uint32_t size,
     return;
   }
 
-  // If we are provided a signal we can implement a non-blocking SEND and
-  // some other packets can wait on that signal
-  if (s) {
-    printf("TODO: Implement non-blocking air_send\n");
-  } else {
+  // Post one SEND per RQE of the tensor followed by the synchronizing RECV
+  // that reports the data was received. If we are provided a signal it
+  // reports completion and other packets can wait on it.
+  uint32_t num_rqes = ceil((float)size / RQE_SIZE);
 
-    // Calculating the number of RQEs that will be received
-    uint32_t num_rqes = ceil((float)size / RQE_SIZE);
-
-    uint64_t wr_idx, packet_id;
-    uint32_t rqe_offset = 0;
-    for (int i = 0; i < num_rqes; i++) {
-      wr_idx = hsa_queue_add_write_index_relaxed(q, 1);
-      packet_id = wr_idx % q->size;
-      hsa_agent_dispatch_packet_t send_pkt;
-      air_packet_post_rdma_wqe(
-          &send_pkt,                                        // HSA Packet
-          0,                                                // Remote VADDR
-          rdma_entry->local_buff->pa + rqe_offset + offset, // Local PADDR
-          0x00000100, // Length -- Need to send RQE size elements, receive side
-                      // will only copy the valid data
-          (uint8_t)OP_SEND, // op
-          0,                // Key
-          (uint8_t)qpid,    // QPID
-          ernic_sel);       // ERNIC select
-
-      // air_write_pkt<hsa_agent_dispatch_packet_t>(q, packet_id, &send_pkt);
-      air_queue_dispatch_and_wait(agent, q, packet_id, wr_idx, &send_pkt);
-    }
+  std::vector<hsa_agent_dispatch_packet_t> pkts;
+  uint32_t rqe_offset = 0;
+  for (int i = 0; i < num_rqes; i++) {
+    hsa_agent_dispatch_packet_t send_pkt;
+    air_packet_post_rdma_wqe(
+        &send_pkt,                                        // HSA Packet
+        0,                                                // Remote VADDR
+        rdma_entry->local_buff->pa + rqe_offset + offset, // Local PADDR
+        0x00000100, // Length -- Need to send RQE size elements, receive side
+                    // will only copy the valid data
+        (uint8_t)OP_SEND, // op
+        0,                // Key
+        (uint8_t)qpid,    // QPID
+        ernic_sel);       // ERNIC select
+    pkts.push_back(send_pkt);
+    rqe_offset += RQE_SIZE;
+  }
 
-    wr_idx = hsa_queue_add_write_index_relaxed(q, 1);
-    packet_id = wr_idx % q->size;
-    hsa_agent_dispatch_packet_t recv_pkt;
+  hsa_agent_dispatch_packet_t recv_pkt;
+  air_packet_post_rdma_recv(
+      &recv_pkt,                  // HSA Packet
+      rdma_entry->local_buff->pa, // Local PADDR
+      0, // Length - Synchronizing so don't want to copy any of the data over
+      (uint8_t)qpid, // QPID
+      ernic_sel);    // Ernic select
+  pkts.push_back(recv_pkt);
 
-    air_packet_post_rdma_recv(
-        &recv_pkt,                  // HSA Packet
-        rdma_entry->local_buff->pa, // Local PADDR
-        0, // Length - Synchronizing so don't want to copy any of the data over
-        (uint8_t)qpid, // QPID
-        ernic_sel);    // Ernic select
-
-    // Need to do this because otherwise the runtime will complain the packet is
-    // timing out but it is supposed to be blocking
-    // air_write_pkt<hsa_agent_dispatch_packet_t>(q, packet_id, &recv_pkt);
-    air_queue_dispatch(q, packet_id, wr_idx, &recv_pkt);
-    while (hsa_signal_wait_scacquire(recv_pkt.completion_signal,
-                                     HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                     HSA_WAIT_STATE_ACTIVE) != 0)
-      ;
-  }
+  air_network_post(agent, q, pkts, s);
 }
 
 /* Provides a very simplistic barrier for remote AIR instances.
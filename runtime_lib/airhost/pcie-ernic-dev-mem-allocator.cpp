@@ -21,6 +21,9 @@
 
 #include "include/pcie-ernic-dev-mem-allocator.h"
 
+// Alignment of the blocks handed out by dev_mem_alloc
+#define DEV_MEM_ALLOC_ALIGNMENT 64
+
 struct pcie_ernic_dev_mem_allocator *init_dev_mem_allocator(
     const char *dev_mem_bar_filename, uint64_t dev_mem_bar_size,
     uint64_t dev_mem_global_offset, uint64_t dev_mem_segment_offset) {
@@ -32,18 +35,26 @@ struct pcie_ernic_dev_mem_allocator *init_dev_mem_allocator(
 
   // Initialize components of the allocator
   allocator->dev_mem_bar_filename = dev_mem_bar_filename;
-  allocator->dev_mem_ptr = 0;
   allocator->dev_mem_size = dev_mem_bar_size;
   allocator->segment_offset = dev_mem_segment_offset;
   allocator->global_offset = dev_mem_global_offset;
+  allocator->heap = NULL;
 
   // Map the
   int axib_fd;
   if ((axib_fd = open(dev_mem_bar_filename, O_RDWR | O_SYNC)) == -1) {
     printf("[ERROR] Failed to open device file: %s\n", dev_mem_bar_filename);
+    free(allocator);
     return NULL;
   }
 
+  // Everything after our segment offset is ours to hand out
+  uint64_t heap_size = dev_mem_bar_size > dev_mem_segment_offset
+                           ? dev_mem_bar_size - dev_mem_segment_offset
+                           : 0;
+  allocator->heap =
+      new air::FreeListAllocator(heap_size, DEV_MEM_ALLOC_ALIGNMENT);
+
   printf("Opening %s with size %lu\n", dev_mem_bar_filename, dev_mem_bar_size);
 
   allocator->dev_mem = mmap(NULL,                   // virtual address
@@ -64,8 +75,9 @@ struct pcie_ernic_dev_mem_allocator *init_dev_mem_allocator(
 
 void free_dev_mem_allocator(struct pcie_ernic_dev_mem_allocator *allocator) {
 
-  // Setting device memory pointer to zero
-  allocator->dev_mem_ptr = 0;
+  // Dropping all the allocations
+  delete allocator->heap;
+  allocator->heap = NULL;
 
   // Unmapping the device memory
   if (munmap(allocator->dev_mem, allocator->dev_mem_size) == -1) {
@@ -80,10 +92,9 @@ void free_dev_mem_allocator(struct pcie_ernic_dev_mem_allocator *allocator) {
 #endif
 }
 
-// Allocating memory on the device. Since we are treating the memory just like a
-// stack, this is pretty straightforward as we are just giving the user the
-// next portion of memory equal to the size that they want. Also, if user gives
-// a non NULL uint64_t pointer, we will provide the PA which is useful for some
+// Allocating memory on the device. The free-list allocator gives us the offset
+// of a block of at least the size the user wants. Also, if user gives a non
+// NULL uint64_t pointer, we will provide the PA which is useful for some
 // applications to know -- Note the PA is the physical address in the device
 // memory map, not the memory map of the CPU.
 void *dev_mem_alloc(struct pcie_ernic_dev_mem_allocator *allocator,
@@ -96,31 +107,43 @@ void *dev_mem_alloc(struct pcie_ernic_dev_mem_allocator *allocator,
   }
 
   // Making sure we have enough space on the device
-  if (size + allocator->dev_mem_ptr + allocator->segment_offset >
-      allocator->dev_mem_size) {
+  uint64_t offset = allocator->heap->allocate(size);
+  if (offset == air::FreeListAllocator::kInvalidOffset) {
+    air::FreeListAllocator::Stats stats = allocator->heap->getStats();
     printf("[ERROR] Device memory cannot accept this allocation due to lack of "
-           "space\n");
+           "space (%lu free, largest block %lu)\n",
+           stats.bytes_free, stats.largest_free_block);
     return NULL;
   }
 
   // If user provided valid pointer, give the physical address
   if (pa != NULL) {
-    *pa = allocator->dev_mem_ptr + allocator->segment_offset +
+    *pa = offset + allocator->segment_offset +
           allocator->global_offset /*DEV_MEM_OFFSET*/;
   }
 
-  // Setting the user pointer equal to the next portion
-  // of available memory
+  // Setting the user pointer equal to the allocated portion of memory
   void *user_ptr = (void *)((unsigned char *)allocator->dev_mem +
-                            allocator->segment_offset + allocator->dev_mem_ptr);
+                            allocator->segment_offset + offset);
 
 #ifdef VERBOSE_DEBUG
   printf("Giving user %dB starting at dev_mem[0x%lx]\n", size,
-         allocator->dev_mem_ptr + allocator->segment_offset);
+         offset + allocator->segment_offset);
 #endif
 
-  // Incrementing pointer by the size of memory allocated
-  allocator->dev_mem_ptr += size;
-
   return user_ptr;
 }
+
+// Returning memory from dev_mem_alloc so later allocations can reuse it
+void dev_mem_free(struct pcie_ernic_dev_mem_allocator *allocator, void *ptr) {
+
+  if (allocator == NULL || ptr == NULL)
+    return;
+
+  uint64_t offset = (uint64_t)((unsigned char *)ptr -
+                               (unsigned char *)allocator->dev_mem -
+                               allocator->segment_offset);
+  if (!allocator->heap->free(offset)) {
+    printf("[ERROR] dev_mem_free given unknown pointer %p\n", ptr);
+  }
+}
@@ -458,6 +458,7 @@ struct pcie_ernic_buff *pcie_ernic_malloc(struct pcie_ernic_dev *dev,
   // Bookeeping
   ret_struct->size = size;
   ret_struct->on_device = on_device;
+  ret_struct->allocator = NULL;
 
   if (on_device) {
 
@@ -472,6 +473,7 @@ struct pcie_ernic_buff *pcie_ernic_malloc(struct pcie_ernic_dev *dev,
     // that is the physical address in the device memory map, not the physical
     // address of the host.
     ret_struct->buff = dev_mem_alloc(dev->allocator, size, &ret_struct->pa);
+    ret_struct->allocator = dev->allocator;
 
   } else {
     printf("[ERROR] Don't currently support allocating host memory with PCIe "
@@ -489,10 +491,12 @@ void pcie_ernic_free_buff(struct pcie_ernic_buff *buff) {
     return;
   }
 
-  // Right now we don't have a way of freeing device memory,
-  // but on the host we need to unlock it and unmap the huge
+  // Device memory goes back to the device memory allocator,
+  // on the host we need to unlock it and unmap the huge
   // pages
-  if (!(buff->on_device)) {
+  if (buff->on_device) {
+    dev_mem_free(buff->allocator, buff->buff);
+  } else {
     // Freeing the associated memory
     if (munlock(buff->buff, 1 << HUGE_PAGE_SHIFT) == -1) {
       printf("[ERROR] Failed to munlock buffer\n");
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <limits.h>
 #include <string>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -17,12 +18,15 @@
 
 #include <cstdio>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <vector>
 
 #include "air.hpp"
 #include "air_host.h"
 #include "air_host_impl.h"
 #include "air_queue.h"
+#include "air_soft_agent.h"
 #include "airbin.h"
 #include "hsa/hsa.h"
 #include "hsa/hsa_ext_amd.h"
@@ -40,6 +44,236 @@
 
 #define ALIGN(_x, _size) (((_x) + ((_size)-1)) & ~((_size)-1))
 
+hsa_status_t air_queue_create(hsa_agent_t agent, uint32_t size,
+                              hsa_queue_t **queue) {
+  if (air_soft_agent_active())
+    return air_soft_agent_queue_create(size, queue);
+  return hsa_queue_create(agent, size, HSA_QUEUE_TYPE_SINGLE, nullptr, nullptr,
+                          0, 0, queue);
+}
+
+hsa_status_t air_queue_destroy(hsa_queue_t *queue) {
+  // A new queue may reuse the address, its segment is not configured yet
+  air_segment_cache_invalidate();
+  if (air_soft_agent_active())
+    return air_soft_agent_queue_destroy(queue);
+  return hsa_queue_destroy(queue);
+}
+
+uint64_t air_queue_add_write_index(hsa_queue_t *queue, uint64_t value) {
+  if (air_soft_agent_active())
+    return air_soft_agent_queue_add_write_index(queue, value);
+  return hsa_queue_add_write_index_relaxed(queue, value);
+}
+
+hsa_status_t air_signal_create(hsa_signal_value_t initial_value,
+                               hsa_agent_t *agent, hsa_signal_t *signal) {
+  if (air_soft_agent_active())
+    return air_soft_agent_signal_create(initial_value, signal);
+  return hsa_amd_signal_create_on_agent(initial_value, 0, nullptr, agent, 0,
+                                        signal);
+}
+
+hsa_status_t air_signal_destroy(hsa_signal_t signal) {
+  if (air_soft_agent_active())
+    return air_soft_agent_signal_destroy(signal);
+  return hsa_signal_destroy(signal);
+}
+
+void air_signal_store(hsa_signal_t signal, hsa_signal_value_t value) {
+  if (air_soft_agent_active()) {
+    air_soft_agent_signal_store(signal, value);
+    return;
+  }
+  hsa_signal_store_screlease(signal, value);
+}
+
+hsa_signal_value_t air_signal_wait(hsa_signal_t signal,
+                                   hsa_signal_condition_t condition,
+                                   hsa_signal_value_t compare_value,
+                                   uint64_t timeout_hint,
+                                   hsa_wait_state_t wait_state) {
+  if (air_soft_agent_active())
+    return air_soft_agent_signal_wait(signal, condition, compare_value,
+                                      timeout_hint, wait_state);
+  return hsa_signal_wait_scacquire(signal, condition, compare_value,
+                                   timeout_hint, wait_state);
+}
+
+static std::once_flag air_wait_policy_once;
+static air_wait_policy_t air_wait_policy = AIR_WAIT_POLICY_ADAPTIVE;
+static uint64_t air_wait_spin_ns = 20000;
+
+// AIR_WAIT_POLICY=active|blocked|adaptive and AIR_WAIT_SPIN_NS override the
+// defaults, air_set_wait_policy() overrides both.
+static void air_wait_policy_init() {
+  std::call_once(air_wait_policy_once, [] {
+    if (const char *env = getenv("AIR_WAIT_POLICY")) {
+      if (!strcmp(env, "active"))
+        air_wait_policy = AIR_WAIT_POLICY_ACTIVE;
+      else if (!strcmp(env, "blocked"))
+        air_wait_policy = AIR_WAIT_POLICY_BLOCKED;
+      else if (!strcmp(env, "adaptive"))
+        air_wait_policy = AIR_WAIT_POLICY_ADAPTIVE;
+      else
+        printf("[WARNING] ignoring unknown AIR_WAIT_POLICY '%s'\n", env);
+    }
+    if (const char *env = getenv("AIR_WAIT_SPIN_NS"))
+      air_wait_spin_ns = strtoull(env, nullptr, 0);
+  });
+}
+
+void air_set_wait_policy(air_wait_policy_t policy, uint64_t spin_ns) {
+  air_wait_policy_init();
+  air_wait_policy = policy;
+  air_wait_spin_ns = spin_ns;
+}
+
+air_wait_policy_t air_get_wait_policy() {
+  air_wait_policy_init();
+  return air_wait_policy;
+}
+
+// HSA timeouts are in system timestamp ticks, the soft agent uses ns
+static uint64_t air_ns_to_timeout_hint(uint64_t ns) {
+  if (air_soft_agent_active())
+    return ns;
+  static uint64_t frequency = [] {
+    uint64_t f = 0;
+    hsa_system_get_info(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &f);
+    return f ? f : 1000000000;
+  }();
+  return ns * frequency / 1000000000;
+}
+
+hsa_status_t air_signal_wait_complete(hsa_signal_t signal) {
+  air_wait_policy_init();
+
+  // Spin for a short while first, most packets finish quickly
+  if (air_wait_policy == AIR_WAIT_POLICY_ADAPTIVE &&
+      air_signal_wait(signal, HSA_SIGNAL_CONDITION_EQ, 0,
+                      air_ns_to_timeout_hint(air_wait_spin_ns),
+                      HSA_WAIT_STATE_ACTIVE) == 0)
+    return HSA_STATUS_SUCCESS;
+
+  hsa_wait_state_t wait_state = air_wait_policy == AIR_WAIT_POLICY_ACTIVE
+                                    ? HSA_WAIT_STATE_ACTIVE
+                                    : HSA_WAIT_STATE_BLOCKED;
+  while (air_signal_wait(signal, HSA_SIGNAL_CONDITION_EQ, 0, UINT64_MAX,
+                         wait_state) != 0)
+    ;
+  return HSA_STATUS_SUCCESS;
+}
+
+// Free completion signals of each agent. Signals do not belong to a queue in
+// HSA, so the pools are keyed by the agent the signals were created for, which
+// lives as long as the runtime. Signals handed out by the pool are tracked
+// until they come back, release only takes back signals the pool owns.
+static std::mutex air_signal_pool_mutex;
+static std::map<uint64_t, std::vector<hsa_signal_t>> air_signal_pools;
+static std::map<uint64_t, uint64_t> air_signal_pool_acquired;
+static std::map<uint64_t, std::vector<hsa_signal_t>> air_signal_pool_attached;
+
+hsa_status_t air_signal_pool_acquire(hsa_agent_t *agent, hsa_signal_t *signal) {
+  if (!agent || !signal)
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  {
+    std::lock_guard<std::mutex> lock(air_signal_pool_mutex);
+    auto &pool = air_signal_pools[agent->handle];
+    if (!pool.empty()) {
+      *signal = pool.back();
+      pool.pop_back();
+      air_signal_store(*signal, 1);
+      air_signal_pool_acquired[signal->handle] = agent->handle;
+      return HSA_STATUS_SUCCESS;
+    }
+  }
+  hsa_status_t ret = air_signal_create(1, agent, signal);
+  if (ret != HSA_STATUS_SUCCESS)
+    return ret;
+  std::lock_guard<std::mutex> lock(air_signal_pool_mutex);
+  air_signal_pool_acquired[signal->handle] = agent->handle;
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t air_signal_pool_release(hsa_signal_t signal) {
+  std::lock_guard<std::mutex> lock(air_signal_pool_mutex);
+  if (!air_signal_pool_acquired.count(signal.handle))
+    return HSA_STATUS_ERROR_INVALID_SIGNAL;
+  std::vector<hsa_signal_t> released = {signal};
+  while (!released.empty()) {
+    hsa_signal_t next = released.back();
+    released.pop_back();
+    auto it = air_signal_pool_acquired.find(next.handle);
+    if (it == air_signal_pool_acquired.end())
+      continue;
+    air_signal_pools[it->second].push_back(next);
+    air_signal_pool_acquired.erase(it);
+    auto attached = air_signal_pool_attached.find(next.handle);
+    if (attached != air_signal_pool_attached.end()) {
+      released.insert(released.end(), attached->second.begin(),
+                      attached->second.end());
+      air_signal_pool_attached.erase(attached);
+    }
+  }
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t air_signal_pool_attach(hsa_signal_t signal,
+                                    hsa_signal_t attached) {
+  std::lock_guard<std::mutex> lock(air_signal_pool_mutex);
+  if (!air_signal_pool_acquired.count(signal.handle) ||
+      !air_signal_pool_acquired.count(attached.handle))
+    return HSA_STATUS_ERROR_INVALID_SIGNAL;
+  air_signal_pool_attached[signal.handle].push_back(attached);
+  return HSA_STATUS_SUCCESS;
+}
+
+void air_signal_pool_destroy() {
+  std::map<uint64_t, std::vector<hsa_signal_t>> pools;
+  {
+    std::lock_guard<std::mutex> lock(air_signal_pool_mutex);
+    pools.swap(air_signal_pools);
+    air_signal_pool_acquired.clear();
+    air_signal_pool_attached.clear();
+  }
+  for (auto &pool : pools)
+    for (auto signal : pool.second)
+      air_signal_destroy(signal);
+}
+
+template <typename T>
+static hsa_status_t air_queue_dispatch_batch_impl(hsa_queue_t *q, T *pkts,
+                                                  uint32_t count,
+                                                  uint64_t *first_wr_idx) {
+  if (!count)
+    return HSA_STATUS_SUCCESS;
+  if (count > q->size)
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+
+  // Reserve all slots at once, fill them and ring the doorbell for the last
+  uint64_t wr_idx = air_queue_add_write_index(q, count);
+  for (uint32_t i = 0; i < count; i++)
+    air_write_pkt<T>(q, (wr_idx + i) % q->size, &pkts[i]);
+  air_signal_store(q->doorbell_signal, wr_idx + count - 1);
+
+  if (first_wr_idx)
+    *first_wr_idx = wr_idx;
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t air_queue_dispatch_batch(hsa_queue_t *q,
+                                      hsa_agent_dispatch_packet_t *pkts,
+                                      uint32_t count, uint64_t *first_wr_idx) {
+  return air_queue_dispatch_batch_impl(q, pkts, count, first_wr_idx);
+}
+
+hsa_status_t air_queue_dispatch_batch(hsa_queue_t *q,
+                                      hsa_barrier_and_packet_t *pkts,
+                                      uint32_t count, uint64_t *first_wr_idx) {
+  return air_queue_dispatch_batch_impl(q, pkts, count, first_wr_idx);
+}
+
 hsa_status_t air_get_agent_info(hsa_agent_t *agent, hsa_queue_t *queue,
                                 hsa_air_agent_info_t attribute, void *data) {
   if ((data == nullptr) || (queue == nullptr)) {
@@ -47,7 +281,7 @@ hsa_status_t air_get_agent_info(hsa_agent_t *agent, hsa_queue_t *queue,
   }
 
   // Getting our slot in the queue
-  uint64_t wr_idx = hsa_queue_add_write_index_relaxed(queue, 1);
+  uint64_t wr_idx = air_queue_add_write_index(queue, 1);
   uint64_t packet_id = wr_idx % queue->size;
 
   // Getting a pointer to where the packet is in the queue
@@ -81,7 +315,7 @@ hsa_status_t air_queue_dispatch(hsa_queue_t *q, uint64_t packet_id,
   air_write_pkt<hsa_agent_dispatch_packet_t>(q, packet_id, pkt);
 
   // Ringing the doorbell
-  hsa_signal_store_screlease(q->doorbell_signal, doorbell);
+  air_signal_store(q->doorbell_signal, doorbell);
 
   return HSA_STATUS_SUCCESS;
 }
@@ -94,34 +328,21 @@ hsa_status_t air_queue_dispatch(hsa_queue_t *q, uint64_t packet_id,
   air_write_pkt<hsa_barrier_and_packet_t>(q, packet_id, pkt);
 
   // Ringing the doorbell
-  hsa_signal_store_screlease(q->doorbell_signal, doorbell);
+  air_signal_store(q->doorbell_signal, doorbell);
 
   return HSA_STATUS_SUCCESS;
 }
 
 hsa_status_t air_queue_wait(hsa_queue_t *q, hsa_agent_dispatch_packet_t *pkt) {
   // wait for packet completion
-  while (hsa_signal_wait_scacquire(pkt->completion_signal,
-                                   HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                   HSA_WAIT_STATE_ACTIVE) != 0) {
-    printf("packet completion signal timeout!\n");
-    printf("%x\n", pkt->header);
-    printf("%x\n", pkt->type);
-    printf("%lx\n", pkt->completion_signal.handle);
-  }
+  air_signal_wait_complete(pkt->completion_signal);
 
   return HSA_STATUS_SUCCESS;
 }
 
 hsa_status_t air_queue_wait(hsa_queue_t *q, hsa_barrier_and_packet_t *pkt) {
   // wait for packet completion
-  while (hsa_signal_wait_scacquire(pkt->completion_signal,
-                                   HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                   HSA_WAIT_STATE_ACTIVE) != 0) {
-    printf("packet completion signal timeout!\n");
-    printf("%x\n", pkt->header);
-    printf("%lx\n", pkt->completion_signal.handle);
-  }
+  air_signal_wait_complete(pkt->completion_signal);
 
   return HSA_STATUS_SUCCESS;
 }
@@ -131,26 +352,22 @@ hsa_status_t air_queue_dispatch_and_wait(hsa_agent_t *agent, hsa_queue_t *q,
                                          hsa_agent_dispatch_packet_t *pkt,
                                          bool destroy_signal) {
 
-  // dispatch and wait has blocking semantics so we can internally create the
-  // signal
-  hsa_amd_signal_create_on_agent(1, 0, nullptr, agent, 0,
-                                 &(pkt->completion_signal));
+  // dispatch and wait has blocking semantics so we can internally take a
+  // signal from the pool
+  air_signal_pool_acquire(agent, &(pkt->completion_signal));
 
   // Write the packet to the queue
   air_write_pkt<hsa_agent_dispatch_packet_t>(q, packet_id, pkt);
 
   // Ringing the doorbell
-  hsa_signal_store_screlease(q->doorbell_signal, doorbell);
+  air_signal_store(q->doorbell_signal, doorbell);
 
   // wait for packet completion
-  while (hsa_signal_wait_scacquire(pkt->completion_signal,
-                                   HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                   HSA_WAIT_STATE_ACTIVE) != 0)
-    ;
+  air_signal_wait_complete(pkt->completion_signal);
 
-  // Optionally destroying the signal
+  // Optionally handing the signal back to the pool
   if (destroy_signal) {
-    hsa_signal_destroy(pkt->completion_signal);
+    air_signal_pool_release(pkt->completion_signal);
   }
 
   return HSA_STATUS_SUCCESS;
@@ -161,26 +378,22 @@ hsa_status_t air_queue_dispatch_and_wait(hsa_agent_t *agent, hsa_queue_t *q,
                                          hsa_barrier_and_packet_t *pkt,
                                          bool destroy_signal) {
 
-  // dispatch and wait has blocking semantics so we can internally create the
-  // signal
-  hsa_amd_signal_create_on_agent(1, 0, nullptr, agent, 0,
-                                 &(pkt->completion_signal));
+  // dispatch and wait has blocking semantics so we can internally take a
+  // signal from the pool
+  air_signal_pool_acquire(agent, &(pkt->completion_signal));
 
   // Write the packet to the queue
   air_write_pkt<hsa_barrier_and_packet_t>(q, packet_id, pkt);
 
   // Ringing the doorbell
-  hsa_signal_store_screlease(q->doorbell_signal, doorbell);
+  air_signal_store(q->doorbell_signal, doorbell);
 
   // wait for packet completion
-  while (hsa_signal_wait_scacquire(pkt->completion_signal,
-                                   HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                   HSA_WAIT_STATE_ACTIVE) != 0)
-    ;
+  air_signal_wait_complete(pkt->completion_signal);
 
-  // Optionally destroying the signal
+  // Optionally handing the signal back to the pool
   if (destroy_signal) {
-    hsa_signal_destroy(pkt->completion_signal);
+    air_signal_pool_release(pkt->completion_signal);
   }
 
   return HSA_STATUS_SUCCESS;
@@ -478,53 +691,58 @@ hsa_status_t air_packet_load_airbin(hsa_agent_dispatch_packet_t *pkt,
   return HSA_STATUS_SUCCESS;
 }
 
+namespace {
+
+// An airbin staged in device memory. The table and the section data stay
+// resident, so loading the same file again is a single AIRBIN packet.
+struct air_airbin_image_t {
+  struct timespec mtime;
+  off_t size;
+  uint8_t *dram_ptr;
+};
+
+std::mutex airbin_cache_mutex;
+std::map<std::string, air_airbin_image_t> airbin_cache;
+
+void air_airbin_cache_evict(
+    std::map<std::string, air_airbin_image_t>::iterator it) {
+  air_free(it->second.dram_ptr);
+  airbin_cache.erase(it);
+}
+
+} // namespace
+
+void air_airbin_cache_flush() {
+  std::lock_guard<std::mutex> lock(airbin_cache_mutex);
+  for (auto &image : airbin_cache)
+    air_free(image.second.dram_ptr);
+  airbin_cache.clear();
+}
+
 /*
-  Load an airbin from a file into a device
+  Stage the loadable sections of an airbin in device memory, behind a table
+  the device firmware walks to load them
 */
-hsa_status_t air_load_airbin(hsa_agent_t *agent, hsa_queue_t *q,
-                             const char *filename, uint8_t column,
-                             uint32_t device_id) {
+static hsa_status_t air_airbin_stage(int elf_fd, uint8_t **staged) {
   hsa_status_t ret = HSA_STATUS_SUCCESS;
-  int drv_fd = 0, elf_fd = 0;
   uint32_t dram_size;
   uint8_t *dram_ptr = NULL;
   uint8_t *data_ptr = NULL;
-  struct timespec ts_start;
-  struct timespec ts_end;
   Elf *inelf = NULL;
   GElf_Ehdr *ehdr = NULL;
   GElf_Ehdr ehdr_mem;
-  uint64_t wr_idx = 0;
-  hsa_agent_dispatch_packet_t pkt;
   size_t shnum;
   uint32_t table_idx = 0;
   airbin_table_entry *airbin_table;
   uint32_t data_offset = 0;
   uint32_t table_size = 0;
-  struct stat elf_stat;
-
-  auto time_spec_diff = [](struct timespec &start, struct timespec &end) {
-    return (end.tv_sec - start.tv_sec) + 1e-9 * (end.tv_nsec - start.tv_nsec);
-  };
-
-  DBG_PRINT("%s fname=%s col=%u\r\n", __func__, filename, column);
-
-  // open the AIRBIN file
-  elf_fd = open(filename, O_RDONLY);
-  if (elf_fd < 0) {
-    printf("Can't open %s\n", filename);
-    ret = HSA_STATUS_ERROR_INVALID_FILE;
-    goto err_elf_open;
-  }
 
   // calculate the size needed to load
-  fstat(elf_fd, &elf_stat);
   // dram_size = elf_stat.st_size;
   dram_size = 6 * 1024 * 1024;
   if (table_size > dram_size) {
     printf("[ERROR] table size is larger than allocated DRAM. Exiting\n");
-    ret = HSA_STATUS_ERROR_OUT_OF_RESOURCES;
-    goto err_elf_open;
+    return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
   }
 
   // get some DRAM from the device
@@ -532,8 +750,7 @@ hsa_status_t air_load_airbin(hsa_agent_t *agent, hsa_queue_t *q,
 
   if (dram_ptr == MAP_FAILED) {
     printf("Error allocating %u DRAM\n", dram_size);
-    ret = HSA_STATUS_ERROR_OUT_OF_RESOURCES;
-    goto err_dev_mem_alloc;
+    return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
   }
 
   DBG_PRINT("Allocated %u device memory HVA=0x%lx\r\n", dram_size,
@@ -626,24 +843,82 @@ hsa_status_t air_load_airbin(hsa_agent_t *agent, hsa_queue_t *q,
   airbin_table[table_idx].size = 0;
   airbin_table[table_idx].addr = 0;
 
-  // Send configuration packet
-  DBG_PRINT("Notifying device\n");
-  wr_idx = hsa_queue_add_write_index_relaxed(q, 1);
-  air_packet_load_airbin(&pkt, (uint64_t)airbin_table, (uint16_t)column);
-
-  // clock_gettime(CLOCK_BOOTTIME, &ts_start);
-  air_queue_dispatch_and_wait(agent, q, wr_idx % q->size, wr_idx, &pkt);
-  hsa_signal_destroy(pkt.completion_signal);
-  // clock_gettime(CLOCK_BOOTTIME, &ts_end);
-
-  // printf("airbin loading time: %0.8f sec\n", time_spec_diff(ts_start,
-  // ts_end));
+  elf_end(inelf);
+  *staged = dram_ptr;
+  return HSA_STATUS_SUCCESS;
 
 err_elf_read:
   elf_end(inelf);
-  close(elf_fd);
-
-err_elf_open:
-err_dev_mem_alloc:
+  air_free(dram_ptr);
   return ret;
 }
+
+/*
+  Load an airbin from a file into a device
+
+  Staged airbins are cached by path and mtime. Loading a cached airbin skips
+  the file and replays the staged table. The AIRBIN packet is sent on every
+  load, even of the airbin a column already holds, so that each run starts
+  from freshly initialized locks, BDs and cores.
+*/
+hsa_status_t air_load_airbin(hsa_agent_t *agent, hsa_queue_t *q,
+                             const char *filename, uint8_t column,
+                             uint32_t device_id) {
+  uint64_t wr_idx = 0;
+  hsa_agent_dispatch_packet_t pkt;
+  struct stat elf_stat;
+  uint8_t *dram_ptr = NULL;
+
+  DBG_PRINT("%s fname=%s col=%u\r\n", __func__, filename, column);
+
+  // open the AIRBIN file
+  int elf_fd = open(filename, O_RDONLY);
+  if (elf_fd < 0) {
+    printf("Can't open %s\n", filename);
+    return HSA_STATUS_ERROR_INVALID_FILE;
+  }
+  fstat(elf_fd, &elf_stat);
+
+  std::string key(filename);
+  char resolved[PATH_MAX];
+  if (realpath(filename, resolved))
+    key = resolved;
+
+  {
+    std::lock_guard<std::mutex> lock(airbin_cache_mutex);
+    auto it = airbin_cache.find(key);
+    if (it != airbin_cache.end() &&
+        (it->second.size != elf_stat.st_size ||
+         it->second.mtime.tv_sec != elf_stat.st_mtim.tv_sec ||
+         it->second.mtime.tv_nsec != elf_stat.st_mtim.tv_nsec)) {
+      air_airbin_cache_evict(it);
+      it = airbin_cache.end();
+    }
+
+    if (it != airbin_cache.end()) {
+      close(elf_fd);
+      _air_host_load_cache_stats.airbin_hits++;
+      dram_ptr = it->second.dram_ptr;
+    } else {
+      hsa_status_t ret = air_airbin_stage(elf_fd, &dram_ptr);
+      close(elf_fd);
+      if (ret != HSA_STATUS_SUCCESS)
+        return ret;
+      _air_host_load_cache_stats.airbin_misses++;
+      airbin_cache[key] = {elf_stat.st_mtim, elf_stat.st_size, dram_ptr};
+    }
+  }
+
+  // Send configuration packet
+  DBG_PRINT("Notifying device\n");
+  wr_idx = air_queue_add_write_index(q, 1);
+  air_packet_load_airbin(&pkt, (uint64_t)dram_ptr, (uint16_t)column);
+  hsa_status_t ret =
+      air_queue_dispatch_and_wait(agent, q, wr_idx % q->size, wr_idx, &pkt);
+  if (ret != HSA_STATUS_SUCCESS)
+    return ret;
+
+  // The airbin replaced whatever segment configuration the array held
+  air_segment_cache_invalidate();
+  return HSA_STATUS_SUCCESS;
+}
@@ -31,6 +31,17 @@ void *Runtime::AllocateMemory(size_t size) {
 
 void Runtime::FreeMemory(void *ptr) { hsa_amd_memory_pool_free(ptr); }
 
+void *Runtime::LockMemory(void *ptr, size_t size) {
+  void *agent_ptr(nullptr);
+
+  hsa_amd_memory_lock(ptr, size, aie_agents_.data(), aie_agents_.size(),
+                      &agent_ptr);
+
+  return agent_ptr;
+}
+
+void Runtime::UnlockMemory(void *ptr) { hsa_amd_memory_unlock(ptr); }
+
 hsa_status_t Runtime::IterateAgents(hsa_agent_t agent, void *data) {
   hsa_status_t status(HSA_STATUS_SUCCESS);
   hsa_device_type_t device_type;
@@ -0,0 +1,670 @@
+//===- soft_agent.cpp -------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include "air_soft_agent.h"
+#include "debug.h"
+#include "hsa_ext_air.h"
+#include "pcie-ernic-defines.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kSoftAgentAlignment = 4096;
+
+struct SoftQueue;
+
+struct SoftSignal {
+  std::atomic<hsa_signal_value_t> value;
+  // Set for doorbell signals so that a store wakes up the queue worker
+  SoftQueue *doorbell_of = nullptr;
+};
+
+struct SoftQueue {
+  // Must stay the first member, the hsa_queue_t handed out to the runtime is
+  // cast back to its SoftQueue.
+  hsa_queue_t queue;
+  std::atomic<uint64_t> write_index{0};
+  uint64_t read_index = 0;
+  std::atomic<bool> stop{false};
+  std::mutex mutex;
+  std::condition_variable doorbell_rung;
+  std::thread worker;
+};
+
+SoftSignal *toSoftSignal(hsa_signal_t signal) {
+  return reinterpret_cast<SoftSignal *>(signal.handle);
+}
+
+SoftQueue *toSoftQueue(hsa_queue_t *queue) {
+  return reinterpret_cast<SoftQueue *>(queue);
+}
+
+uint32_t packetType(uint16_t header) {
+  return (header >> HSA_PACKET_HEADER_TYPE) &
+         ((1 << HSA_PACKET_HEADER_WIDTH_TYPE) - 1);
+}
+
+bool signalConditionHolds(hsa_signal_value_t value,
+                          hsa_signal_condition_t condition,
+                          hsa_signal_value_t compare_value) {
+  switch (condition) {
+  case HSA_SIGNAL_CONDITION_EQ:
+    return value == compare_value;
+  case HSA_SIGNAL_CONDITION_NE:
+    return value != compare_value;
+  case HSA_SIGNAL_CONDITION_LT:
+    return value < compare_value;
+  case HSA_SIGNAL_CONDITION_GTE:
+    return value >= compare_value;
+  }
+  return false;
+}
+
+// Threads in a blocked signal wait sleep on one condition variable that is
+// notified on every completion or store, much like an interrupt.
+std::mutex signal_wait_mutex;
+std::condition_variable signal_wait_cv;
+
+template <typename Update> void signalUpdate(SoftSignal *s, Update update) {
+  {
+    std::lock_guard<std::mutex> lock(signal_wait_mutex);
+    update(s);
+  }
+  signal_wait_cv.notify_all();
+}
+
+class SoftAgent {
+public:
+  // The model is written by the API thread and read by every queue worker.
+  air_soft_agent_latency_model_t getLatencyModel() {
+    std::lock_guard<std::mutex> lock(latency_mutex);
+    return latency_model;
+  }
+  void setLatencyModel(const air_soft_agent_latency_model_t &model) {
+    std::lock_guard<std::mutex> lock(latency_mutex);
+    latency_model = model;
+  }
+
+  hsa_queue_t *createQueue(uint32_t size);
+  void destroyQueue(SoftQueue *q);
+  void destroyAllQueues();
+
+private:
+  void releaseQueue(SoftQueue *q);
+  void run(SoftQueue *q);
+  uint64_t process(SoftQueue *q, hsa_agent_dispatch_packet_t *pkt,
+                   Clock::time_point start, bool &deferred);
+  void processBarrier(hsa_barrier_and_packet_t *pkt, bool is_or);
+  uint64_t ndMemcpy(hsa_agent_dispatch_packet_t *pkt);
+  uint64_t postRdmaWqe(SoftQueue *q, hsa_agent_dispatch_packet_t *pkt);
+  void postRdmaRecv(SoftQueue *q, hsa_agent_dispatch_packet_t *pkt,
+                    Clock::time_point start);
+  void getInfo(hsa_agent_dispatch_packet_t *pkt);
+  void complete(hsa_signal_t signal, Clock::time_point start, uint64_t bytes);
+
+  std::mutex latency_mutex;
+  air_soft_agent_latency_model_t latency_model = {0, 0};
+
+  std::mutex queues_mutex;
+  std::vector<SoftQueue *> queues;
+  uint64_t next_queue_id = 0;
+
+  // Data sent on an MM2S shim channel, keyed by (column, channel), waiting to
+  // be received by the S2MM channel with the same key.
+  std::mutex staging_mutex;
+  std::map<std::pair<uint8_t, uint8_t>, std::deque<uint8_t>> staging;
+
+  // Loopback ERNIC. Each queue plays one node: a SEND on a QP fills the
+  // oldest receive posted on the same QP through another queue, and
+  // completes that receive's packet.
+  struct SoftRqe {
+    SoftQueue *owner;
+    uint64_t addr;
+    uint32_t length;
+    hsa_signal_t signal;
+    Clock::time_point start;
+  };
+  std::mutex rdma_mutex;
+  std::condition_variable rqe_posted;
+  std::map<uint8_t, std::deque<SoftRqe>> receive_queues;
+};
+
+SoftAgent *soft_agent = nullptr;
+
+hsa_queue_t *SoftAgent::createQueue(uint32_t size) {
+  SoftQueue *q = new SoftQueue();
+  void *ring =
+      air_soft_agent_malloc(size * sizeof(hsa_agent_dispatch_packet_t));
+  if (!ring) {
+    delete q;
+    return nullptr;
+  }
+  auto *packets = static_cast<hsa_agent_dispatch_packet_t *>(ring);
+  for (uint32_t i = 0; i < size; i++)
+    packets[i].header = HSA_PACKET_TYPE_INVALID << HSA_PACKET_HEADER_TYPE;
+
+  hsa_signal_t doorbell;
+  air_soft_agent_signal_create(-1, &doorbell);
+  toSoftSignal(doorbell)->doorbell_of = q;
+
+  q->queue.type = HSA_QUEUE_TYPE_SINGLE;
+  q->queue.features = HSA_QUEUE_FEATURE_AGENT_DISPATCH;
+  q->queue.base_address = ring;
+  q->queue.doorbell_signal = doorbell;
+  q->queue.size = size;
+  q->queue.reserved1 = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(queues_mutex);
+    q->queue.id = next_queue_id++;
+    queues.push_back(q);
+  }
+  q->worker = std::thread(&SoftAgent::run, this, q);
+  return &q->queue;
+}
+
+void SoftAgent::destroyQueue(SoftQueue *q) {
+  {
+    std::lock_guard<std::mutex> lock(queues_mutex);
+    queues.erase(std::remove(queues.begin(), queues.end(), q), queues.end());
+  }
+  releaseQueue(q);
+}
+
+void SoftAgent::releaseQueue(SoftQueue *q) {
+  {
+    std::lock_guard<std::mutex> lock(q->mutex);
+    q->stop = true;
+  }
+  q->doorbell_rung.notify_all();
+  {
+    // Wake up a SEND waiting for a receive, and drop our pending receives
+    std::lock_guard<std::mutex> lock(rdma_mutex);
+    for (auto &rq : receive_queues)
+      rq.second.erase(std::remove_if(rq.second.begin(), rq.second.end(),
+                                     [q](const SoftRqe &rqe) {
+                                       return rqe.owner == q;
+                                     }),
+                      rq.second.end());
+  }
+  rqe_posted.notify_all();
+  if (q->worker.joinable())
+    q->worker.join();
+  air_soft_agent_signal_destroy(q->queue.doorbell_signal);
+  air_soft_agent_free(q->queue.base_address);
+  delete q;
+}
+
+void SoftAgent::destroyAllQueues() {
+  std::vector<SoftQueue *> live;
+  {
+    std::lock_guard<std::mutex> lock(queues_mutex);
+    live.swap(queues);
+  }
+  for (auto q : live)
+    releaseQueue(q);
+}
+
+// Consume packets in order, the same way the AIE controller firmware walks
+// its queue: wait for the doorbell to cover the next packet, wait for the
+// packet to become valid, execute it and hand the slot back.
+void SoftAgent::run(SoftQueue *q) {
+  SoftSignal *doorbell = toSoftSignal(q->queue.doorbell_signal);
+  auto *ring =
+      static_cast<hsa_agent_dispatch_packet_t *>(q->queue.base_address);
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(q->mutex);
+      q->doorbell_rung.wait(lock, [&] {
+        return q->stop ||
+               doorbell->value.load(std::memory_order_acquire) >=
+                   static_cast<hsa_signal_value_t>(q->read_index);
+      });
+      if (q->stop)
+        return;
+    }
+
+    auto *pkt = &ring[q->read_index % q->queue.size];
+    while (packetType(__atomic_load_n(&pkt->header, __ATOMIC_ACQUIRE)) ==
+           HSA_PACKET_TYPE_INVALID) {
+      if (q->stop)
+        return;
+      std::this_thread::yield();
+    }
+
+    // Dispatch and barrier packets keep their completion signal at the same
+    // offset. Release the slot before signaling, the host may refill the
+    // ring as soon as it sees the completion.
+    auto start = Clock::now();
+    hsa_signal_t completion_signal = pkt->completion_signal;
+    bool deferred = false;
+    uint64_t bytes = process(q, pkt, start, deferred);
+
+    __atomic_store_n(
+        &pkt->header,
+        (uint16_t)(HSA_PACKET_TYPE_INVALID << HSA_PACKET_HEADER_TYPE),
+        __ATOMIC_RELEASE);
+    q->read_index++;
+
+    if (!deferred)
+      complete(completion_signal, start, bytes);
+  }
+}
+
+// Execute a packet and return the number of bytes it moved. A packet that
+// completes later, from another queue's worker, sets deferred.
+uint64_t SoftAgent::process(SoftQueue *q, hsa_agent_dispatch_packet_t *pkt,
+                            Clock::time_point start, bool &deferred) {
+  uint32_t type = packetType(pkt->header);
+
+  if (type == HSA_PACKET_TYPE_BARRIER_AND ||
+      type == HSA_PACKET_TYPE_BARRIER_OR) {
+    auto *barrier = reinterpret_cast<hsa_barrier_and_packet_t *>(pkt);
+    processBarrier(barrier, type == HSA_PACKET_TYPE_BARRIER_OR);
+    return 0;
+  }
+
+  if (type != HSA_PACKET_TYPE_AGENT_DISPATCH) {
+    debug_print("soft agent: ignoring packet with header type ", type);
+    return 0;
+  }
+
+  uint64_t bytes = 0;
+  switch (pkt->type) {
+  case AIR_PKT_TYPE_ND_MEMCPY:
+    bytes = ndMemcpy(pkt);
+    break;
+  case AIR_PKT_TYPE_CDMA:
+    bytes = static_cast<uint32_t>(pkt->arg[2]);
+    std::memcpy(reinterpret_cast<void *>(pkt->arg[0]),
+                reinterpret_cast<void *>(pkt->arg[1]), bytes);
+    break;
+  case AIR_PKT_TYPE_GET_INFO:
+    getInfo(pkt);
+    break;
+  case AIR_PKT_TYPE_POST_RDMA_WQE:
+    bytes = postRdmaWqe(q, pkt);
+    break;
+  case AIR_PKT_TYPE_POST_RDMA_RECV:
+    postRdmaRecv(q, pkt, start);
+    deferred = true;
+    break;
+  default:
+    // Configuration, lock and status packets have no host visible effect
+    // beyond their completion.
+    break;
+  }
+  return bytes;
+}
+
+void SoftAgent::processBarrier(hsa_barrier_and_packet_t *pkt, bool is_or) {
+  while (true) {
+    bool any_done = false;
+    bool all_done = true;
+    bool any_dep = false;
+    for (auto dep : pkt->dep_signal) {
+      if (!dep.handle)
+        continue;
+      any_dep = true;
+      bool done = toSoftSignal(dep)->value.load(std::memory_order_acquire) == 0;
+      any_done |= done;
+      all_done &= done;
+    }
+    if (!any_dep || (is_or ? any_done : all_done))
+      return;
+    std::this_thread::yield();
+  }
+}
+
+// Walk the up to 4-D access pattern of an ND_MEMCPY packet. Lengths above the
+// first dimension count iterations and strides are in bytes, mirroring
+// air_packet_nd_memcpy.
+uint64_t SoftAgent::ndMemcpy(hsa_agent_dispatch_packet_t *pkt) {
+  uint8_t channel = (pkt->arg[0] >> 24) & 0xff;
+  uint8_t col = (pkt->arg[0] >> 32) & 0xff;
+  bool is_mm2s = (pkt->arg[0] >> 60) & 0xf;
+  auto *base = reinterpret_cast<uint8_t *>(pkt->arg[1]);
+
+  uint64_t length_1d = pkt->arg[2] & 0xffffffff;
+  uint64_t length_2d = std::max<uint64_t>((pkt->arg[2] >> 32) & 0xffff, 1);
+  uint64_t stride_2d = (pkt->arg[2] >> 48) & 0xffff;
+  uint64_t length_3d = std::max<uint64_t>(pkt->arg[3] & 0xffff, 1);
+  uint64_t stride_3d = (pkt->arg[3] >> 16) & 0xffff;
+  uint64_t length_4d = std::max<uint64_t>((pkt->arg[3] >> 32) & 0xffff, 1);
+  uint64_t stride_4d = (pkt->arg[3] >> 48) & 0xffff;
+
+  std::lock_guard<std::mutex> lock(staging_mutex);
+  auto &fifo = staging[{col, channel}];
+  uint64_t bytes = 0;
+  for (uint64_t i = 0; i < length_4d; i++) {
+    for (uint64_t j = 0; j < length_3d; j++) {
+      for (uint64_t k = 0; k < length_2d; k++) {
+        uint8_t *p = base + i * stride_4d + j * stride_3d + k * stride_2d;
+        if (is_mm2s) {
+          fifo.insert(fifo.end(), p, p + length_1d);
+        } else {
+          // Receive whatever the matching MM2S channel sent, zero filling
+          // when it sent less.
+          uint64_t n = std::min<uint64_t>(length_1d, fifo.size());
+          std::copy(fifo.begin(), fifo.begin() + n, p);
+          fifo.erase(fifo.begin(), fifo.begin() + n);
+          std::memset(p + n, 0, length_1d - n);
+        }
+        bytes += length_1d;
+      }
+    }
+  }
+  return bytes;
+}
+
+void SoftAgent::getInfo(hsa_agent_dispatch_packet_t *pkt) {
+  uint64_t value = 0;
+  switch (pkt->arg[0]) {
+  case AIR_AGENT_INFO_NAME:
+    std::strncpy(reinterpret_cast<char *>(&value), "SoftAIE", 8);
+    break;
+  case AIR_AGENT_INFO_VENDOR_NAME:
+    std::strncpy(reinterpret_cast<char *>(&value), "AMD", 8);
+    break;
+  case AIR_AGENT_INFO_NUM_REGIONS:
+    value = 1;
+    break;
+  case AIR_AGENT_INFO_HERD_ROWS:
+    value = 8;
+    break;
+  case AIR_AGENT_INFO_HERD_COLS:
+    value = 50;
+    break;
+  case AIR_AGENT_INFO_HERD_SIZE:
+    value = 8 * 50;
+    break;
+  case AIR_AGENT_INFO_TILE_DATA_MEM_SIZE:
+    value = 32 * 1024;
+    break;
+  case AIR_AGENT_INFO_TILE_PROG_MEM_SIZE:
+    value = 16 * 1024;
+    break;
+  default:
+    break;
+  }
+  // The response travels back in the packet, see air_get_agent_info.
+  std::memcpy(&pkt->return_address, &value, sizeof(value));
+}
+
+// Work requests carry the remote address in arg[0], the local one in arg[1]
+// and the QP, opcode and length in arg[2], see air_packet_post_rdma_wqe.
+// READ and WRITE treat the remote address as local memory.
+uint64_t SoftAgent::postRdmaWqe(SoftQueue *q,
+                                hsa_agent_dispatch_packet_t *pkt) {
+  auto *remote = reinterpret_cast<uint8_t *>(pkt->arg[0]);
+  auto *local = reinterpret_cast<uint8_t *>(pkt->arg[1]);
+  uint8_t qpid = (pkt->arg[2] >> 48) & 0xff;
+  uint8_t op = (pkt->arg[2] >> 32) & 0xff;
+  uint32_t length = pkt->arg[2] & 0xffffffff;
+
+  switch (op) {
+  case OP_READ:
+    std::memcpy(local, remote, length);
+    return length;
+  case OP_WRITE:
+    std::memcpy(remote, local, length);
+    return length;
+  case OP_SEND:
+    break;
+  default:
+    debug_print("soft agent: ignoring RDMA opcode ", (int)op);
+    return 0;
+  }
+
+  // Like an ERNIC retrying on receiver not ready, wait for a receive
+  SoftRqe rqe;
+  {
+    std::unique_lock<std::mutex> lock(rdma_mutex);
+    auto &rq = receive_queues[qpid];
+    auto peer = rq.end();
+    rqe_posted.wait(lock, [&] {
+      peer = std::find_if(rq.begin(), rq.end(), [q](const SoftRqe &r) {
+        return r.owner != q;
+      });
+      return q->stop || peer != rq.end();
+    });
+    if (peer == rq.end())
+      return 0;
+    rqe = *peer;
+    rq.erase(peer);
+  }
+
+  uint32_t copied = std::min(length, rqe.length);
+  std::memcpy(reinterpret_cast<void *>(rqe.addr), local, copied);
+  complete(rqe.signal, rqe.start, copied);
+  return length;
+}
+
+// Receives carry the buffer in arg[0] and the length and QP in arg[1], see
+// air_packet_post_rdma_recv. The packet completes once a SEND filled it.
+void SoftAgent::postRdmaRecv(SoftQueue *q, hsa_agent_dispatch_packet_t *pkt,
+                             Clock::time_point start) {
+  uint8_t qpid = pkt->arg[1] & 0xff;
+  uint32_t length = (pkt->arg[1] >> 16) & 0xffffffff;
+  {
+    std::lock_guard<std::mutex> lock(rdma_mutex);
+    receive_queues[qpid].push_back(
+        {q, pkt->arg[0], length, pkt->completion_signal, start});
+  }
+  rqe_posted.notify_all();
+}
+
+// Hold the completion until the latency model says the packet is done, then
+// decrement the completion signal as an HSA packet processor would.
+void SoftAgent::complete(hsa_signal_t signal, Clock::time_point start,
+                         uint64_t bytes) {
+  air_soft_agent_latency_model_t model = getLatencyModel();
+  uint64_t ns = model.packet_ns;
+  if (model.bytes_per_us)
+    ns += bytes * 1000 / model.bytes_per_us;
+  auto deadline = start + std::chrono::nanoseconds(ns);
+
+  // Sleep through long latencies and spin the last stretch so that short
+  // ones stay accurate.
+  auto spin = std::chrono::microseconds(50);
+  if (deadline - Clock::now() > spin)
+    std::this_thread::sleep_until(deadline - spin);
+  while (Clock::now() < deadline)
+    std::this_thread::yield();
+
+  if (signal.handle)
+    signalUpdate(toSoftSignal(signal), [](SoftSignal *sig) {
+      sig->value.fetch_sub(1, std::memory_order_acq_rel);
+    });
+}
+
+} // namespace
+
+extern "C" {
+
+bool air_soft_agent_requested() {
+  const char *env = getenv("AIR_SOFT_AGENT");
+  return env && *env && strcmp(env, "0") != 0;
+}
+
+bool air_soft_agent_active() { return soft_agent != nullptr; }
+
+hsa_status_t air_soft_agent_init() {
+  if (soft_agent)
+    return HSA_STATUS_SUCCESS;
+
+  soft_agent = new SoftAgent();
+
+  if (const char *env = getenv("AIR_SOFT_AGENT_LATENCY")) {
+    unsigned long long packet_ns = 0, bytes_per_us = 0;
+    if (sscanf(env, "%llu,%llu", &packet_ns, &bytes_per_us) < 1) {
+      printf("[ERROR] invalid AIR_SOFT_AGENT_LATENCY '%s'\n", env);
+      delete soft_agent;
+      soft_agent = nullptr;
+      return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+    soft_agent->setLatencyModel({packet_ns, bytes_per_us});
+  }
+
+  air_soft_agent_latency_model_t model = soft_agent->getLatencyModel();
+  debug_print("soft agent: ", model.packet_ns, " ns per packet, ",
+              model.bytes_per_us, " bytes per us");
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t air_soft_agent_shut_down() {
+  if (!soft_agent)
+    return HSA_STATUS_ERROR_NOT_INITIALIZED;
+  soft_agent->destroyAllQueues();
+  delete soft_agent;
+  soft_agent = nullptr;
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+air_soft_agent_set_latency_model(const air_soft_agent_latency_model_t *model) {
+  if (!soft_agent)
+    return HSA_STATUS_ERROR_NOT_INITIALIZED;
+  if (!model)
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  soft_agent->setLatencyModel(*model);
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+air_soft_agent_get_latency_model(air_soft_agent_latency_model_t *model) {
+  if (!soft_agent)
+    return HSA_STATUS_ERROR_NOT_INITIALIZED;
+  if (!model)
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  *model = soft_agent->getLatencyModel();
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_agent_t air_soft_agent_get_agent() {
+  return {reinterpret_cast<uint64_t>(soft_agent)};
+}
+
+hsa_status_t air_soft_agent_queue_create(uint32_t size, hsa_queue_t **queue) {
+  if (!soft_agent)
+    return HSA_STATUS_ERROR_NOT_INITIALIZED;
+  if (!queue || !size || (size & (size - 1)))
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  *queue = soft_agent->createQueue(size);
+  return *queue ? HSA_STATUS_SUCCESS : HSA_STATUS_ERROR_OUT_OF_RESOURCES;
+}
+
+hsa_status_t air_soft_agent_queue_destroy(hsa_queue_t *queue) {
+  if (!soft_agent)
+    return HSA_STATUS_ERROR_NOT_INITIALIZED;
+  if (!queue)
+    return HSA_STATUS_ERROR_INVALID_QUEUE;
+  soft_agent->destroyQueue(toSoftQueue(queue));
+  return HSA_STATUS_SUCCESS;
+}
+
+uint64_t air_soft_agent_queue_add_write_index(hsa_queue_t *queue,
+                                              uint64_t value) {
+  return toSoftQueue(queue)->write_index.fetch_add(value,
+                                                   std::memory_order_relaxed);
+}
+
+hsa_status_t air_soft_agent_signal_create(hsa_signal_value_t initial_value,
+                                          hsa_signal_t *signal) {
+  if (!signal)
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  SoftSignal *s = new SoftSignal();
+  s->value.store(initial_value);
+  signal->handle = reinterpret_cast<uint64_t>(s);
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t air_soft_agent_signal_destroy(hsa_signal_t signal) {
+  if (!signal.handle)
+    return HSA_STATUS_ERROR_INVALID_SIGNAL;
+  delete toSoftSignal(signal);
+  return HSA_STATUS_SUCCESS;
+}
+
+void air_soft_agent_signal_store(hsa_signal_t signal,
+                                 hsa_signal_value_t value) {
+  SoftSignal *s = toSoftSignal(signal);
+  if (SoftQueue *q = s->doorbell_of) {
+    {
+      std::lock_guard<std::mutex> lock(q->mutex);
+      s->value.store(value, std::memory_order_release);
+    }
+    q->doorbell_rung.notify_one();
+    return;
+  }
+  signalUpdate(s, [value](SoftSignal *sig) {
+    sig->value.store(value, std::memory_order_release);
+  });
+}
+
+hsa_signal_value_t air_soft_agent_signal_load(hsa_signal_t signal) {
+  return toSoftSignal(signal)->value.load(std::memory_order_acquire);
+}
+
+// timeout_hint is interpreted in nanoseconds. Like hsa_signal_wait_scacquire
+// the wait may return early, callers must check the returned value.
+hsa_signal_value_t air_soft_agent_signal_wait(hsa_signal_t signal,
+                                              hsa_signal_condition_t condition,
+                                              hsa_signal_value_t compare_value,
+                                              uint64_t timeout_hint,
+                                              hsa_wait_state_t wait_state) {
+  SoftSignal *s = toSoftSignal(signal);
+  auto start = Clock::now();
+  auto expired = [&] {
+    return timeout_hint != UINT64_MAX &&
+           Clock::now() - start >= std::chrono::nanoseconds(timeout_hint);
+  };
+
+  if (wait_state == HSA_WAIT_STATE_BLOCKED) {
+    std::unique_lock<std::mutex> lock(signal_wait_mutex);
+    while (true) {
+      hsa_signal_value_t value = s->value.load(std::memory_order_acquire);
+      if (signalConditionHolds(value, condition, compare_value) || expired())
+        return value;
+      // Sleep in slices so that a finite timeout is honored without a
+      // separate timer.
+      signal_wait_cv.wait_for(lock, std::chrono::milliseconds(1));
+    }
+  }
+
+  while (true) {
+    hsa_signal_value_t value = s->value.load(std::memory_order_acquire);
+    if (signalConditionHolds(value, condition, compare_value) || expired())
+      return value;
+    std::this_thread::yield();
+  }
+}
+
+void *air_soft_agent_malloc(size_t size) {
+  size_t bytes = (size + kSoftAgentAlignment - 1) & ~(kSoftAgentAlignment - 1);
+  return aligned_alloc(kSoftAgentAlignment, bytes ? bytes : kSoftAgentAlignment);
+}
+
+void air_soft_agent_free(void *mem) { free(mem); }
+
+} // extern "C"
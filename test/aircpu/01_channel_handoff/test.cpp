@@ -0,0 +1,245 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Drive the aircpu channel entry points the way air-to-async lowered code
+// calls them, and check that a put hands its transfer straight to the gets
+// already waiting for it:
+// - a single destination waiting for the second transfer of a channel;
+// - a broadcast to two destinations, one waiting and one not, where only the
+//   one not waiting reads the transfer from the channel slot.
+// Then report the throughput of 1 MiB transfers handed to a waiting get and
+// of transfers buffered in the channel slot.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "air_channel.h"
+#include "air_tensor.h"
+
+extern "C" {
+void _mlir_ciface_air_channel_get_M0D2I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(
+    void *c, uint64_t chnl_idx1, uint64_t chnl_idx0, void *d,
+    uint64_t offset1, uint64_t offset0, uint64_t size1, uint64_t size0,
+    uint64_t stride1, uint64_t stride0);
+void _mlir_ciface_air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(
+    void *c, uint64_t chnl_size1, uint64_t chnl_size0, uint64_t bsize1,
+    uint64_t bsize0, uint64_t depth, uint64_t chnl_idx1, uint64_t chnl_idx0,
+    void *s, uint64_t offset1, uint64_t offset0, uint64_t size1,
+    uint64_t size0, uint64_t stride1, uint64_t stride0);
+}
+
+#define M_SIZE 16
+#define TILE 8
+
+// A [1, 1] channel broadcasting to dests destinations, with a single slot
+struct channel {
+  uint64_t ptr = 0;
+  tensor_t<uint64_t, 2> t;
+  uint64_t dests;
+
+  explicit channel(uint64_t dests) : dests(dests) {
+    t.alloc = t.data = &ptr;
+    t.shape[0] = t.shape[1] = 1;
+  }
+
+  channel_t<int32_t> *get() { return (channel_t<int32_t> *)ptr; }
+
+  // put the TILE x TILE tile of src at (row, col)
+  void put(tensor_t<int32_t, 2> *src, uint64_t row, uint64_t col) {
+    _mlir_ciface_air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(
+        &t, 1, 1, 1, dests, 1, 0, 0, src, row, col, TILE, TILE,
+        src->shape[1], 1);
+  }
+
+  // get the next transfer of destination g into the tile of dst at (row, col)
+  void get(uint64_t g, tensor_t<int32_t, 2> *dst, uint64_t row, uint64_t col) {
+    _mlir_ciface_air_channel_get_M0D2I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(
+        &t, 0, g, dst, row, col, TILE, TILE, dst->shape[1], 1);
+  }
+
+  // block until destination g is waiting for a transfer
+  void wait_for_get(uint64_t g) {
+    while (true) {
+      std::lock_guard<std::mutex> guard(get()->mtx);
+      if (get()->waiting[g])
+        return;
+    }
+  }
+
+  bool waiting(uint64_t g) {
+    std::lock_guard<std::mutex> guard(get()->mtx);
+    return get()->waiting[g] != nullptr;
+  }
+};
+
+struct matrix {
+  std::vector<int32_t> v;
+  tensor_t<int32_t, 2> t;
+
+  matrix(size_t rows, size_t cols, int32_t base) : v(rows * cols) {
+    for (size_t i = 0; i < v.size(); i++)
+      v[i] = base ? base + (int32_t)i : 0;
+    t.alloc = t.data = v.data();
+    t.shape[0] = rows;
+    t.shape[1] = cols;
+  }
+};
+
+int errors = 0;
+
+// compare the tile of a at (ar, ac) against the tile of b at (br, bc)
+void check_tile(const char *what, const int32_t *a, size_t ar, size_t ac,
+                const int32_t *b, size_t br, size_t bc, size_t b_cols) {
+  for (size_t i = 0; i < TILE; i++) {
+    for (size_t j = 0; j < TILE; j++) {
+      int32_t d = a[(ar + i) * M_SIZE + ac + j];
+      int32_t ref = b[(br + i) * b_cols + bc + j];
+      if (d != ref) {
+        if (errors < 10)
+          printf("%s: %zu,%zu: mismatch %d != %d\n", what, i, j, d, ref);
+        errors++;
+      }
+    }
+  }
+}
+
+void test_handoff() {
+  matrix src(M_SIZE, M_SIZE, 1);
+  matrix dst(M_SIZE, M_SIZE, 0);
+  channel chan(1);
+
+  // the first transfer allocates the channel and is buffered in its slot
+  chan.put(&src.t, 0, 0);
+  std::thread getter([&] {
+    chan.get(0, &dst.t, 0, TILE);
+    chan.get(0, &dst.t, TILE, 0);
+  });
+  // the second is copied straight into the waiting destination
+  chan.wait_for_get(0);
+  chan.put(&src.t, TILE, TILE);
+  getter.join();
+
+  check_tile("handoff first", dst.v.data(), 0, TILE, src.v.data(), 0, 0,
+             M_SIZE);
+  check_tile("handoff second", dst.v.data(), TILE, 0, src.v.data(), TILE,
+             TILE, M_SIZE);
+  // the slot still holds the first transfer
+  check_tile("handoff slot", src.v.data(), 0, 0, chan.get()->data, 0, 0,
+             TILE);
+  if (chan.get()->written != 2 || chan.get()->read[0] != 2) {
+    printf("handoff: written %lu read %lu\n",
+           (unsigned long)chan.get()->written,
+           (unsigned long)chan.get()->read[0]);
+    errors++;
+  }
+}
+
+void test_broadcast_handoff() {
+  matrix src(M_SIZE, M_SIZE, 1);
+  matrix dst0(M_SIZE, M_SIZE, 0);
+  matrix dst1(M_SIZE, M_SIZE, 0);
+  channel chan(2);
+
+  chan.put(&src.t, 0, 0);
+  chan.get(1, &dst1.t, 0, 0);
+  std::thread getter([&] {
+    chan.get(0, &dst0.t, 0, 0);
+    chan.get(0, &dst0.t, TILE, TILE);
+  });
+  // destination 0 waits for the second transfer, destination 1 does not
+  chan.wait_for_get(0);
+  if (chan.waiting(1)) {
+    printf("broadcast: destination 1 is waiting\n");
+    errors++;
+  }
+  chan.put(&src.t, 0, TILE);
+  getter.join();
+  // only destination 1 reads the second transfer from the slot
+  check_tile("broadcast slot", src.v.data(), 0, TILE, chan.get()->data, 0, 0,
+             TILE);
+  chan.get(1, &dst1.t, TILE, TILE);
+
+  check_tile("broadcast 0 first", dst0.v.data(), 0, 0, src.v.data(), 0, 0,
+             M_SIZE);
+  check_tile("broadcast 0 second", dst0.v.data(), TILE, TILE, src.v.data(), 0,
+             TILE, M_SIZE);
+  check_tile("broadcast 1 first", dst1.v.data(), 0, 0, src.v.data(), 0, 0,
+             M_SIZE);
+  check_tile("broadcast 1 second", dst1.v.data(), TILE, TILE, src.v.data(), 0,
+             TILE, M_SIZE);
+  if (chan.get()->read[0] != 2 || chan.get()->read[1] != 2) {
+    printf("broadcast: read %lu %lu\n", (unsigned long)chan.get()->read[0],
+           (unsigned long)chan.get()->read[1]);
+    errors++;
+  }
+}
+
+// GB/s of iters 512 x 512 int32 transfers
+double bandwidth(int iters, std::chrono::steady_clock::duration elapsed) {
+  double bytes = (double)iters * 512 * 512 * sizeof(int32_t);
+  return bytes / std::chrono::duration<double>(elapsed).count() / 1e9;
+}
+
+void benchmark() {
+  const int iters = 64;
+  const uint64_t n = 512;
+  matrix src(n, n, 1);
+  matrix dst(n, n, 0);
+
+  auto put = [&](channel &chan) {
+    _mlir_ciface_air_channel_put_M0D2I64_I64_I64_I64_I64_I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(
+        &chan.t, 1, 1, 1, 1, 1, 0, 0, &src.t, 0, 0, n, n, n, 1);
+  };
+  auto get = [&](channel &chan) {
+    _mlir_ciface_air_channel_get_M0D2I64_I64_I64_M0D2I32_I64_I64_I64_I64_I64_I64(
+        &chan.t, 0, 0, &dst.t, 0, 0, n, n, n, 1);
+  };
+
+  // the getter waits before every put but the first
+  channel handoff(1);
+  put(handoff);
+  auto start = std::chrono::steady_clock::now();
+  std::thread getter([&] {
+    for (int i = 0; i < iters + 1; i++)
+      get(handoff);
+  });
+  for (int i = 0; i < iters; i++) {
+    handoff.wait_for_get(0);
+    put(handoff);
+  }
+  getter.join();
+  double handoff_bw = bandwidth(iters, std::chrono::steady_clock::now() - start);
+
+  // every transfer is buffered in the slot and read back from it
+  channel buffered(1);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iters; i++) {
+    put(buffered);
+    get(buffered);
+  }
+  double buffered_bw =
+      bandwidth(iters, std::chrono::steady_clock::now() - start);
+
+  printf("1 MiB transfers: handoff %.2f GB/s, buffered %.2f GB/s\n",
+         handoff_bw, buffered_bw);
+}
+
+int main(int argc, char *argv[]) {
+  test_handoff();
+  test_broadcast_handoff();
+  benchmark();
+
+  if (!errors) {
+    printf("PASS!\n");
+    return 0;
+  }
+  printf("fail %d.\n", errors);
+  return 1;
+}
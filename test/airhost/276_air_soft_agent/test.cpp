@@ -0,0 +1,132 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Exercise the soft agent without any AIE device: agent info, a strided
+// ND_MEMCPY loopback through a shim channel, a barrier AND packet and the
+// fixed latency model.
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "air.hpp"
+
+int main(int argc, char *argv[]) {
+
+  setenv("AIR_SOFT_AGENT", "1", 1);
+
+  hsa_status_t init_status = air_init();
+  if (init_status != HSA_STATUS_SUCCESS) {
+    std::cout << "air_init() failed. Exiting" << std::endl;
+    return -1;
+  }
+  assert(air_soft_agent_active() && "soft agent was not selected");
+
+  std::vector<hsa_agent_t> agents;
+  auto get_agents_ret = air_get_agents(agents);
+  assert(get_agents_ret == HSA_STATUS_SUCCESS && agents.size() == 1);
+
+  hsa_queue_t *q = nullptr;
+  auto queue_create_status = air_queue_create(agents[0], MB_QUEUE_SIZE, &q);
+  assert(queue_create_status == HSA_STATUS_SUCCESS && q);
+
+  char vend[8];
+  air_get_agent_info(&agents[0], q, AIR_AGENT_INFO_VENDOR_NAME, vend);
+  std::cout << "Vendor is: " << vend << std::endl;
+  int errors = strncmp(vend, "AMD", 8) != 0;
+
+  // Send 4 rows of 16 bytes out of a 32 byte pitch source on MM2S channel 0
+  // of column 2 and receive them contiguously on S2MM channel 0.
+  uint8_t *src = (uint8_t *)air_malloc(128);
+  uint8_t *dst = (uint8_t *)air_malloc(64);
+  for (int i = 0; i < 128; i++)
+    src[i] = i;
+  memset(dst, 0xff, 64);
+
+  uint64_t wr_idx = air_queue_add_write_index(q, 1);
+  hsa_agent_dispatch_packet_t mm2s_pkt;
+  air_packet_nd_memcpy(&mm2s_pkt, 0, 2, /*direction=*/1, 0, 4, 1,
+                       (uint64_t)src, 16, 4, 32, 1, 0, 1, 0);
+  air_queue_dispatch_and_wait(&agents[0], q, wr_idx % q->size, wr_idx,
+                              &mm2s_pkt);
+
+  wr_idx = air_queue_add_write_index(q, 1);
+  hsa_agent_dispatch_packet_t s2mm_pkt;
+  air_packet_nd_memcpy(&s2mm_pkt, 0, 2, /*direction=*/0, 0, 4, 1,
+                       (uint64_t)dst, 64, 1, 0, 1, 0, 1, 0);
+  air_queue_dispatch_and_wait(&agents[0], q, wr_idx % q->size, wr_idx,
+                              &s2mm_pkt);
+
+  for (int i = 0; i < 64; i++) {
+    uint8_t ref = (i / 16) * 32 + i % 16;
+    if (dst[i] != ref) {
+      printf("dst[%d] = %d, expected %d\n", i, dst[i], ref);
+      errors++;
+    }
+  }
+
+  // A barrier AND packet completes once all of its dependencies did
+  std::vector<hsa_agent_dispatch_packet_t> hello_pkts(3);
+  std::vector<hsa_signal_t> deps(5, hsa_signal_t{0});
+  for (int i = 0; i < 3; i++) {
+    wr_idx = air_queue_add_write_index(q, 1);
+    air_packet_hello(&hello_pkts[i], 0xacdc0000LL + i);
+    air_signal_create(1, &agents[0], &hello_pkts[i].completion_signal);
+    deps[i] = hello_pkts[i].completion_signal;
+    air_queue_dispatch(q, wr_idx % q->size, wr_idx, &hello_pkts[i]);
+  }
+  wr_idx = air_queue_add_write_index(q, 1);
+  hsa_barrier_and_packet_t barrier_pkt;
+  air_packet_barrier_and(&barrier_pkt, deps[0], deps[1], deps[2], deps[3],
+                         deps[4]);
+  air_queue_dispatch_and_wait(&agents[0], q, wr_idx % q->size, wr_idx,
+                              &barrier_pkt);
+  for (auto &pkt : hello_pkts) {
+    if (air_signal_wait(pkt.completion_signal, HSA_SIGNAL_CONDITION_EQ, 0,
+                        0) != 0) {
+      printf("hello packet completed after the barrier\n");
+      errors++;
+    }
+    air_signal_destroy(pkt.completion_signal);
+  }
+
+  // Every packet takes at least the configured latency
+  air_soft_agent_latency_model_t model = {200000, 0};
+  air_soft_agent_set_latency_model(&model);
+  auto start = std::chrono::steady_clock::now();
+  wr_idx = air_queue_add_write_index(q, 1);
+  hsa_agent_dispatch_packet_t slow_pkt;
+  air_packet_hello(&slow_pkt, 0xfeed);
+  air_queue_dispatch_and_wait(&agents[0], q, wr_idx % q->size, wr_idx,
+                              &slow_pkt);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (elapsed < std::chrono::nanoseconds(model.packet_ns)) {
+    printf("packet completed before the modeled latency\n");
+    errors++;
+  }
+
+  air_free(src);
+  air_free(dst);
+  air_queue_destroy(q);
+
+  hsa_status_t shut_down_ret = air_shut_down();
+  if (shut_down_ret != HSA_STATUS_SUCCESS) {
+    std::cerr << "[ERROR] air_shut_down() failed" << std::endl;
+    return -1;
+  }
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
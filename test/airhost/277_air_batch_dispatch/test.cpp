@@ -0,0 +1,112 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Batched submission and completion signal recycling, run on the soft agent.
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "air.hpp"
+
+#define NUM_PKTS 16
+
+int main(int argc, char *argv[]) {
+
+  setenv("AIR_SOFT_AGENT", "1", 1);
+
+  hsa_status_t init_status = air_init();
+  if (init_status != HSA_STATUS_SUCCESS) {
+    std::cout << "air_init() failed. Exiting" << std::endl;
+    return -1;
+  }
+
+  std::vector<hsa_agent_t> agents;
+  auto get_agents_ret = air_get_agents(agents);
+  assert(get_agents_ret == HSA_STATUS_SUCCESS && !agents.empty());
+
+  hsa_queue_t *q = nullptr;
+  auto queue_create_status = air_queue_create(agents[0], MB_QUEUE_SIZE, &q);
+  assert(queue_create_status == HSA_STATUS_SUCCESS && q);
+
+  int errors = 0;
+
+  // A released signal is handed out again, reset to 1
+  hsa_signal_t s0, s1;
+  air_signal_pool_acquire(&agents[0], &s0);
+  air_signal_store(s0, 0);
+  air_signal_pool_release(s0);
+  air_signal_pool_acquire(&agents[0], &s1);
+  if (s1.handle != s0.handle) {
+    printf("signal was not recycled\n");
+    errors++;
+  }
+  if (air_signal_wait(s1, HSA_SIGNAL_CONDITION_EQ, 1, 0) != 1) {
+    printf("recycled signal was not reset\n");
+    errors++;
+  }
+
+  // Submit a batch twice: the packets are in order so only the last one
+  // carries a signal, taken from the pool each time.
+  for (int iter = 0; iter < 2; iter++) {
+    std::vector<hsa_agent_dispatch_packet_t> pkts(NUM_PKTS);
+    for (int i = 0; i < NUM_PKTS; i++) {
+      air_packet_hello(&pkts[i], 0xacdc0000LL + i);
+      pkts[i].completion_signal.handle = 0;
+    }
+    pkts.back().completion_signal = s1;
+
+    uint64_t first_wr_idx = 0;
+    air_queue_dispatch_batch(q, pkts.data(), NUM_PKTS, &first_wr_idx);
+    if (first_wr_idx != (uint64_t)iter * NUM_PKTS) {
+      printf("batch %d starts at %lu\n", iter, first_wr_idx);
+      errors++;
+    }
+    air_queue_wait(q, &pkts.back());
+    air_signal_pool_release(s1);
+    air_signal_pool_acquire(&agents[0], &s1);
+  }
+  air_signal_pool_release(s1);
+
+  // Only signals handed out by the pool go back to it: a second release and
+  // the release of a caller-owned signal are refused.
+  if (air_signal_pool_release(s1) != HSA_STATUS_ERROR_INVALID_SIGNAL) {
+    printf("signal was released twice\n");
+    errors++;
+  }
+  hsa_signal_t own;
+  air_signal_create(1, &agents[0], &own);
+  if (air_signal_pool_release(own) != HSA_STATUS_ERROR_INVALID_SIGNAL) {
+    printf("caller-owned signal was taken by the pool\n");
+    errors++;
+  }
+  air_signal_pool_acquire(&agents[0], &s0);
+  if (s0.handle == own.handle) {
+    printf("caller-owned signal was handed out by the pool\n");
+    errors++;
+  }
+  air_signal_pool_release(s0);
+  air_signal_destroy(own);
+
+  // The pool outlives the queue and is destroyed by air_shut_down
+  air_queue_destroy(q);
+
+  hsa_status_t shut_down_ret = air_shut_down();
+  if (shut_down_ret != HSA_STATUS_SUCCESS) {
+    std::cerr << "[ERROR] air_shut_down() failed" << std::endl;
+    return -1;
+  }
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
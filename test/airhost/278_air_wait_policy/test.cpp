@@ -0,0 +1,91 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Packet completion under each wait policy, run on the soft agent.
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "air.hpp"
+
+int main(int argc, char *argv[]) {
+
+  setenv("AIR_SOFT_AGENT", "1", 1);
+
+  hsa_status_t init_status = air_init();
+  if (init_status != HSA_STATUS_SUCCESS) {
+    std::cout << "air_init() failed. Exiting" << std::endl;
+    return -1;
+  }
+
+  std::vector<hsa_agent_t> agents;
+  auto get_agents_ret = air_get_agents(agents);
+  assert(get_agents_ret == HSA_STATUS_SUCCESS && !agents.empty());
+
+  hsa_queue_t *q = nullptr;
+  auto queue_create_status = air_queue_create(agents[0], MB_QUEUE_SIZE, &q);
+  assert(queue_create_status == HSA_STATUS_SUCCESS && q);
+
+  int errors = 0;
+
+  // run.lit selects the blocked policy through the environment
+  if (air_get_wait_policy() != AIR_WAIT_POLICY_BLOCKED) {
+    printf("AIR_WAIT_POLICY was not applied\n");
+    errors++;
+  }
+
+  // Packets take 2ms, longer than the adaptive spin, so the adaptive policy
+  // goes through both of its phases.
+  air_soft_agent_latency_model_t model = {2000000, 0};
+  air_soft_agent_set_latency_model(&model);
+
+  air_wait_policy_t policies[] = {AIR_WAIT_POLICY_ACTIVE,
+                                  AIR_WAIT_POLICY_BLOCKED,
+                                  AIR_WAIT_POLICY_ADAPTIVE};
+  for (auto policy : policies) {
+    air_set_wait_policy(policy, 20000);
+    hsa_agent_dispatch_packet_t pkt;
+    air_packet_hello(&pkt, 0xacdc0000LL + policy);
+    air_signal_pool_acquire(&agents[0], &pkt.completion_signal);
+    air_queue_dispatch_batch(q, &pkt, 1);
+    air_signal_wait_complete(pkt.completion_signal);
+    if (air_signal_wait(pkt.completion_signal, HSA_SIGNAL_CONDITION_EQ, 0, 0) !=
+        0) {
+      printf("policy %d returned before completion\n", policy);
+      errors++;
+    }
+    air_signal_pool_release(pkt.completion_signal);
+  }
+
+  // A blocked wait with a finite timeout still returns
+  hsa_signal_t s;
+  air_signal_pool_acquire(&agents[0], &s);
+  if (air_signal_wait(s, HSA_SIGNAL_CONDITION_EQ, 0, 1000000,
+                      HSA_WAIT_STATE_BLOCKED) != 1) {
+    printf("blocked wait on a pending signal did not time out\n");
+    errors++;
+  }
+  air_signal_pool_release(s);
+
+  air_queue_destroy(q);
+
+  hsa_status_t shut_down_ret = air_shut_down();
+  if (shut_down_ret != HSA_STATUS_SUCCESS) {
+    std::cerr << "[ERROR] air_shut_down() failed" << std::endl;
+    return -1;
+  }
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
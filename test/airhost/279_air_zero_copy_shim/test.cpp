@@ -0,0 +1,116 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Strided shim transfers on registered memory go out as one 4-D descriptor,
+// run on the soft agent. A tile of the source is sent on MM2S and received
+// into the same tile of the destination on the matching S2MM channel.
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "air.hpp"
+
+#define IMAGE_SIZE 16
+#define TILE_SIZE 8
+#define TILE_OFFSET 4
+
+extern "C" {
+extern air_rt_herd_desc_t _air_host_active_herd;
+
+void _mlir_ciface___airrt_dma_nd_memcpy_2d0i32(
+    hsa_signal_t *s, uint32_t id, uint64_t x, uint64_t y, void *t,
+    uint64_t offset_3, uint64_t offset_2, uint64_t offset_1, uint64_t offset_0,
+    uint64_t length_3, uint64_t length_2, uint64_t length_1, uint64_t length_0,
+    uint64_t stride_2, uint64_t stride_1, uint64_t stride_0);
+}
+
+static void shim_memcpy(uint32_t id, tensor_t<uint32_t, 2> *t) {
+  _mlir_ciface___airrt_dma_nd_memcpy_2d0i32(
+      nullptr, id, 0, 0, t, 0, 0, TILE_OFFSET, TILE_OFFSET, 1, 1, TILE_SIZE,
+      TILE_SIZE, 0, 0, IMAGE_SIZE);
+}
+
+int main(int argc, char *argv[]) {
+
+  setenv("AIR_SOFT_AGENT", "1", 1);
+
+  hsa_status_t init_status = air_init();
+  if (init_status != HSA_STATUS_SUCCESS) {
+    std::cout << "air_init() failed. Exiting" << std::endl;
+    return -1;
+  }
+
+  std::vector<hsa_agent_t> agents;
+  auto get_agents_ret = air_get_agents(agents);
+  assert(get_agents_ret == HSA_STATUS_SUCCESS && !agents.empty());
+
+  hsa_queue_t *q = nullptr;
+  auto queue_create_status = air_queue_create(agents[0], MB_QUEUE_SIZE, &q);
+  assert(queue_create_status == HSA_STATUS_SUCCESS && q);
+
+  // Transfer 1 uses MM2S channel 0 of column 2, transfer 2 its S2MM channel
+  std::vector<int64_t> location_data(2 * 8 * 8, 2);
+  std::vector<int64_t> channel_data(2 * 8 * 8, 0);
+  channel_data[0] = 2;
+  air_herd_shim_desc_t shim_desc = {location_data.data(), channel_data.data()};
+  air_herd_desc_t herd_desc = {0, nullptr, &shim_desc};
+  _air_host_active_herd = {q, &agents[0], &herd_desc};
+
+  // The source comes from air_malloc, the destination is registered
+  auto src_mem = (uint32_t *)air_malloc(IMAGE_SIZE * IMAGE_SIZE * 4);
+  std::vector<uint32_t> dst_mem(IMAGE_SIZE * IMAGE_SIZE, 0);
+  auto register_status =
+      air_mem_register(dst_mem.data(), dst_mem.size() * sizeof(uint32_t));
+  assert(register_status == HSA_STATUS_SUCCESS);
+
+  for (int i = 0; i < IMAGE_SIZE * IMAGE_SIZE; i++)
+    src_mem[i] = i + 1;
+
+  tensor_t<uint32_t, 2> src, dst;
+  src.alloc = src.data = src_mem;
+  dst.alloc = dst.data = dst_mem.data();
+  src.shape[0] = dst.shape[0] = IMAGE_SIZE;
+  src.shape[1] = dst.shape[1] = IMAGE_SIZE;
+
+  shim_memcpy(1, &src);
+  shim_memcpy(2, &dst);
+
+  int errors = 0;
+  for (int r = 0; r < IMAGE_SIZE; r++) {
+    for (int c = 0; c < IMAGE_SIZE; c++) {
+      bool in_tile = r >= TILE_OFFSET && r < TILE_OFFSET + TILE_SIZE &&
+                     c >= TILE_OFFSET && c < TILE_OFFSET + TILE_SIZE;
+      uint32_t ref = in_tile ? src_mem[r * IMAGE_SIZE + c] : 0;
+      uint32_t d = dst_mem[r * IMAGE_SIZE + c];
+      if (d != ref) {
+        if (errors < 10)
+          printf("dst[%d][%d] = %u != %u\n", r, c, d, ref);
+        errors++;
+      }
+    }
+  }
+
+  air_mem_unregister(dst_mem.data());
+  air_free(src_mem);
+  air_queue_destroy(q);
+
+  hsa_status_t shut_down_ret = air_shut_down();
+  if (shut_down_ret != HSA_STATUS_SUCCESS) {
+    std::cerr << "[ERROR] air_shut_down() failed" << std::endl;
+    return -1;
+  }
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
@@ -0,0 +1,125 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Free-list allocator backed by host memory. Every live block is filled with
+// its own pattern, overlapping blocks would overwrite each other's pattern.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "air_free_list_allocator.h"
+
+#define HEAP_SIZE (64 * 1024)
+#define ALIGNMENT 64
+#define NUM_STEPS 20000
+
+int main(int argc, char *argv[]) {
+
+  std::vector<uint8_t> heap_mem(HEAP_SIZE, 0);
+  air::FreeListAllocator heap(HEAP_SIZE, ALIGNMENT);
+
+  int errors = 0;
+
+  // offset -> (size, pattern)
+  std::map<uint64_t, std::pair<uint64_t, uint8_t>> live;
+
+  auto check = [&](uint64_t offset) {
+    auto &block = live[offset];
+    for (uint64_t i = 0; i < block.first; i++) {
+      if (heap_mem[offset + i] != block.second) {
+        printf("block at %lu was overwritten\n", offset);
+        return false;
+      }
+    }
+    return true;
+  };
+
+  srand(1);
+  for (int step = 0; step < NUM_STEPS && errors < 10; step++) {
+    if (live.empty() || rand() % 3) {
+      uint64_t size = 1 + rand() % 4096;
+      uint64_t offset = heap.allocate(size);
+      if (offset == air::FreeListAllocator::kInvalidOffset)
+        continue;
+      if (offset % ALIGNMENT || offset + size > HEAP_SIZE ||
+          heap.allocationSize(offset) < size) {
+        printf("bad block at %lu for %lu bytes\n", offset, size);
+        errors++;
+        continue;
+      }
+      uint8_t pattern = 1 + step % 255;
+      memset(&heap_mem[offset], pattern, size);
+      live[offset] = {size, pattern};
+    } else {
+      auto it = live.begin();
+      std::advance(it, rand() % live.size());
+      if (!check(it->first))
+        errors++;
+      if (!heap.free(it->first)) {
+        printf("free of live block at %lu failed\n", it->first);
+        errors++;
+      }
+      live.erase(it);
+    }
+  }
+
+  for (auto &block : live) {
+    if (!check(block.first))
+      errors++;
+    heap.free(block.first);
+  }
+
+  // Freeing everything coalesces the heap back into one block
+  auto stats = heap.getStats();
+  if (stats.num_allocations || stats.bytes_allocated ||
+      stats.num_free_blocks != 1 || stats.largest_free_block != HEAP_SIZE ||
+      stats.fragmentation() != 0.0) {
+    printf("heap did not coalesce: %lu free blocks, largest %lu\n",
+           stats.num_free_blocks, stats.largest_free_block);
+    errors++;
+  }
+
+  // Freed memory is reused: the whole heap can be allocated again
+  uint64_t all = heap.allocate(HEAP_SIZE);
+  if (all != 0) {
+    printf("could not allocate the whole heap after freeing\n");
+    errors++;
+  }
+  if (heap.allocate(1) != air::FreeListAllocator::kInvalidOffset) {
+    printf("allocation from a full heap succeeded\n");
+    errors++;
+  }
+  if (heap.free(all + ALIGNMENT)) {
+    printf("free of an unknown offset succeeded\n");
+    errors++;
+  }
+  heap.free(all);
+
+  // A hole between two live blocks shows up as fragmentation
+  uint64_t a = heap.allocate(HEAP_SIZE / 4);
+  uint64_t b = heap.allocate(HEAP_SIZE / 4);
+  heap.allocate(HEAP_SIZE / 4);
+  heap.free(b);
+  stats = heap.getStats();
+  if (stats.num_free_blocks != 2 || stats.fragmentation() != 0.5) {
+    printf("unexpected fragmentation %f\n", stats.fragmentation());
+    errors++;
+  }
+  heap.free(a);
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
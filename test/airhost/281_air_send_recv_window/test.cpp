@@ -0,0 +1,135 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// air_send and air_recv between two queues of the soft agent, which loops
+// SENDs back to the receives posted on the same QP. Small transfers go out
+// non-blocking, a large one goes through a window of in-flight RQEs/WQEs.
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "air.hpp"
+#include "air_network.h"
+#include "pcie-ernic.h"
+
+#define SMALL_SIZE (8 * RQE_SIZE)
+#define LARGE_SIZE (64 * RQE_SIZE)
+
+extern std::map<void *, tensor_to_qp_map_entry *> tensor_to_qp_map;
+extern std::map<std::string, world_view_entry *> world_view;
+
+struct local_tensor {
+  std::vector<uint32_t> mem;
+  pcie_ernic_buff buff;
+  tensor_to_qp_map_entry entry;
+  tensor_t<uint32_t, 1> t;
+
+  local_tensor(size_t bytes) : mem(bytes / sizeof(uint32_t) + RQE_SIZE, 0) {
+    buff.buff = mem.data();
+    buff.pa = reinterpret_cast<uint64_t>(mem.data());
+    buff.size = bytes;
+    buff.on_device = false;
+    entry = {0, 0, 0, &buff};
+    t.alloc = t.data = mem.data();
+    t.shape[0] = bytes / sizeof(uint32_t);
+    tensor_to_qp_map[t.alloc] = &entry;
+  }
+};
+
+static int check(local_tensor &src, local_tensor &dst, uint32_t size) {
+  int errors = 0;
+  for (uint32_t i = 0; i < size / sizeof(uint32_t); i++) {
+    if (dst.mem[i] != src.mem[i]) {
+      if (errors < 10)
+        printf("dst[%u] = %u != %u\n", i, dst.mem[i], src.mem[i]);
+      errors++;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char *argv[]) {
+
+  setenv("AIR_SOFT_AGENT", "1", 1);
+
+  hsa_status_t init_status = air_init();
+  if (init_status != HSA_STATUS_SUCCESS) {
+    std::cout << "air_init() failed. Exiting" << std::endl;
+    return -1;
+  }
+
+  std::vector<hsa_agent_t> agents;
+  auto get_agents_ret = air_get_agents(agents);
+  assert(get_agents_ret == HSA_STATUS_SUCCESS && !agents.empty());
+
+  // One queue per rank, both ranks talk over QP 2
+  hsa_queue_t *send_q = nullptr, *recv_q = nullptr;
+  air_queue_create(agents[0], MB_QUEUE_SIZE, &send_q);
+  air_queue_create(agents[0], MB_QUEUE_SIZE, &recv_q);
+  assert(send_q && recv_q);
+
+  char hostname[100] = "loopback";
+  air_set_hostname(hostname);
+  world_view_entry self = {};
+  self.qps[0] = self.qps[1] = 2;
+  world_view[hostname] = &self;
+
+  int errors = 0;
+
+  // Both sides return right away and report completion through a signal
+  {
+    local_tensor src(SMALL_SIZE), dst(SMALL_SIZE);
+    for (uint32_t i = 0; i < SMALL_SIZE / sizeof(uint32_t); i++)
+      src.mem[i] = i + 1;
+
+    hsa_signal_t recv_done, send_done;
+    air_recv(&recv_done, &dst.t, SMALL_SIZE, 0, 1, &agents[0], recv_q, 0);
+    air_send(&send_done, &src.t, SMALL_SIZE, 0, 1, &agents[0], send_q, 0);
+    // The receiver only sends the synchronizing SEND once all of its RQEs
+    // have completed, so the data is in place as soon as the sender is done.
+    air_signal_wait_complete(send_done);
+    errors += check(src, dst, SMALL_SIZE);
+    air_signal_wait_complete(recv_done);
+    air_signal_pool_release(recv_done);
+    air_signal_pool_release(send_done);
+  }
+
+  // A transfer larger than the window keeps 4 packets in flight per side
+  {
+    air_set_network_window(4);
+    local_tensor src(LARGE_SIZE), dst(LARGE_SIZE);
+    for (uint32_t i = 0; i < LARGE_SIZE / sizeof(uint32_t); i++)
+      src.mem[i] = 3 * i;
+
+    std::thread receiver([&] {
+      air_recv(nullptr, &dst.t, LARGE_SIZE, 0, 1, &agents[0], recv_q, 0);
+    });
+    air_send(nullptr, &src.t, LARGE_SIZE, 0, 1, &agents[0], send_q, 0);
+    receiver.join();
+    errors += check(src, dst, LARGE_SIZE);
+  }
+
+  air_queue_destroy(send_q);
+  air_queue_destroy(recv_q);
+
+  hsa_status_t shut_down_ret = air_shut_down();
+  if (shut_down_ret != HSA_STATUS_SUCCESS) {
+    std::cerr << "[ERROR] air_shut_down() failed" << std::endl;
+    return -1;
+  }
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
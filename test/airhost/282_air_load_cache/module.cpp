@@ -0,0 +1,66 @@
+//===- module.cpp -----------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// A module with one segment holding one herd, standing in for the shared
+// library aircc generates. Its configuration functions only count calls.
+
+#include <cstdint>
+
+namespace {
+
+struct herd_desc_t {
+  int64_t name_length;
+  const char *name;
+  void *shim_desc;
+};
+
+struct segment_desc_t {
+  int64_t name_length;
+  const char *name;
+  uint64_t herd_length;
+  herd_desc_t **herd_descs;
+};
+
+struct module_desc_t {
+  uint64_t segment_length;
+  segment_desc_t **segment_descs;
+};
+
+herd_desc_t herd = {6, "herd_0", nullptr};
+herd_desc_t *herds[] = {&herd};
+segment_desc_t segment = {9, "segment_0", 1, herds};
+segment_desc_t *segments[] = {&segment};
+
+} // namespace
+
+extern "C" {
+module_desc_t __airrt_module_descriptor = {1, segments};
+
+// Calls of configure_cores, configure_switchboxes, initialize_locks,
+// configure_dmas and start_cores
+int air_test_config_calls[5];
+}
+
+namespace {
+
+template <int I> int count_call(void *) { return ++air_test_config_calls[I]; }
+
+struct aie_functions_t {
+  int (*configure_cores)(void *);
+  int (*configure_switchboxes)(void *);
+  int (*initialize_locks)(void *);
+  int (*configure_dmas)(void *);
+  int (*start_cores)(void *);
+};
+
+} // namespace
+
+extern "C" {
+aie_functions_t __airrt_segment_0_aie_functions = {
+    count_call<0>, count_call<1>, count_call<2>, count_call<3>,
+    count_call<4>};
+}
@@ -0,0 +1,166 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Loading a module and its segment again hits the load caches. A module that
+// changed on disk is loaded and configured again. On a board, reloading a
+// resident segment must still set up the cores, locks and DMAs again, and so
+// must reloading an airbin, which is checked with the soft agent.
+
+#include <cassert>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <vector>
+
+#include "air.hpp"
+
+static air_load_cache_stats_t stats() {
+  air_load_cache_stats_t s;
+  air_load_cache_get_stats(&s);
+  return s;
+}
+
+static void print_stats(const char *step, const air_load_cache_stats_t &s) {
+  std::cout << step << ": module misses " << s.module_misses << " hits "
+            << s.module_hits << ", segment skips " << s.segment_skips
+            << ", herd hits " << s.herd_hits << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0] << " <module.so>" << std::endl;
+    return -1;
+  }
+  const char *module_path = argv[1];
+
+  hsa_status_t init_status = air_init();
+  if (init_status != HSA_STATUS_SUCCESS) {
+    std::cout << "air_init() failed. Exiting" << std::endl;
+    return -1;
+  }
+
+  std::vector<hsa_agent_t> agents;
+  auto get_agents_ret = air_get_agents(agents);
+  assert(get_agents_ret == HSA_STATUS_SUCCESS && !agents.empty());
+
+  hsa_queue_t *q = nullptr;
+  auto queue_create_status = air_queue_create(agents[0], MB_QUEUE_SIZE, &q);
+  assert(queue_create_status == HSA_STATUS_SUCCESS && q);
+
+  int errors = 0;
+
+  // First load misses, the segment is configured once
+  auto handle = air_module_load_from_file(module_path, &agents[0], q);
+  if (!handle) {
+    std::cout << "failed to load " << module_path << std::endl;
+    return -1;
+  }
+  air_segment_load("segment_0");
+  air_segment_load("segment_0");
+  auto s = stats();
+  if (s.module_misses != 1 || s.module_hits != 0 || s.segment_skips != 1) {
+    print_stats("first load", s);
+    errors++;
+  }
+
+  // Only the stream switches are left alone on the second load. The soft
+  // agent configures nothing.
+  auto calls = (int *)dlsym((void *)handle, "air_test_config_calls");
+  assert(calls);
+  int expected[5] = {2, 1, 2, 2, 2};
+  for (int i = 0; i < 5; i++) {
+    int want = air_soft_agent_active() ? 0 : expected[i];
+    if (calls[i] != want) {
+      std::cout << "configuration function " << i << " called " << calls[i]
+                << " times, expected " << want << std::endl;
+      errors++;
+    }
+  }
+
+  // The second lookup of the herd is served from the cache
+  air_herd_load("herd_0");
+  air_herd_load("herd_0");
+  s = stats();
+  if (s.herd_hits != 1) {
+    print_stats("herd load", s);
+    errors++;
+  }
+
+  // Reloading the same file keeps the module and its configuration
+  air_module_unload(handle);
+  handle = air_module_load_from_file(module_path, &agents[0], q);
+  assert(handle);
+  air_segment_load("segment_0");
+  s = stats();
+  if (s.module_misses != 1 || s.module_hits != 1 || s.segment_skips != 2) {
+    print_stats("reload", s);
+    errors++;
+  }
+
+  // A newer file on disk is loaded and configured from scratch
+  air_module_unload(handle);
+  struct stat module_stat;
+  stat(module_path, &module_stat);
+  struct timespec times[2] = {{0, UTIME_OMIT}, module_stat.st_mtim};
+  times[1].tv_sec -= 1;
+  utimensat(AT_FDCWD, module_path, times, 0);
+  handle = air_module_load_from_file(module_path, &agents[0], q);
+  assert(handle);
+  air_segment_load("segment_0");
+  s = stats();
+  if (s.module_misses != 2 || s.module_hits != 1 || s.segment_skips != 2) {
+    print_stats("changed file", s);
+    errors++;
+  }
+
+  // After a flush everything is loaded again
+  air_module_unload(handle);
+  air_load_cache_flush();
+  handle = air_module_load_from_file(module_path, &agents[0], q);
+  assert(handle);
+  air_segment_load("segment_0");
+  s = stats();
+  if (s.module_misses != 3 || s.segment_skips != 2) {
+    print_stats("flush", s);
+    errors++;
+  }
+
+  // Loading the same airbin twice sends its AIRBIN packet both times, the
+  // second from the staged copy. Any 64-bit ELF stands in for an airbin, so
+  // only do this where the packet configures nothing.
+  if (air_soft_agent_active()) {
+    uint64_t first_packet = air_queue_add_write_index(q, 0);
+    for (int i = 0; i < 2; i++) {
+      if (air_load_airbin(&agents[0], q, argv[0], 7, 0) !=
+          HSA_STATUS_SUCCESS) {
+        std::cout << "airbin load " << i << " failed" << std::endl;
+        errors++;
+      }
+    }
+    uint64_t packets = air_queue_add_write_index(q, 0) - first_packet;
+    s = stats();
+    if (packets != 2 || s.airbin_misses != 1 || s.airbin_hits != 1) {
+      std::cout << "airbin: " << packets << " packets, misses "
+                << s.airbin_misses << " hits " << s.airbin_hits << std::endl;
+      errors++;
+    }
+  }
+
+  air_module_unload(handle);
+  air_queue_destroy(q);
+  air_shut_down();
+
+  if (!errors) {
+    std::cout << std::endl << "PASS!" << std::endl;
+    return 0;
+  } else {
+    std::cout << std::endl << "fail." << std::endl;
+    return -1;
+  }
+}
@@ -106,6 +106,38 @@ else:
     print("ROCm not found")
     config.excludes.append("airhost")
 
+# The soft agent and its tests build against the stub HSA header, with or
+# without ROCm.
+config.substitutions.append(
+    (
+        "%soft_agent_libs%",
+        " -I"
+        + os.path.join(config.air_src_root, "runtime_lib", "airhost", "hsa_stub")
+        + "/include"
+        + " -I"
+        + air_runtime_lib
+        + "/airhost/include"
+        + " -L"
+        + air_runtime_lib
+        + "/airhost -lair_soft_agent -lpthread -lstdc++",
+    )
+)
+
+# The CPU runtime of air-to-async, driven directly through its entry points.
+config.substitutions.append(
+    (
+        "%aircpu_libs%",
+        " -I"
+        + air_runtime_lib
+        + "/airhost/include"
+        + " -L"
+        + air_runtime_lib
+        + "/aircpu -laircpu -Wl,-rpath,"
+        + air_runtime_lib
+        + "/aircpu -lpthread -lstdc++",
+    )
+)
+
 
 run_on_npu1 = "echo"
 run_on_npu2 = "echo"
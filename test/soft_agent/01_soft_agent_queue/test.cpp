@@ -0,0 +1,143 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2026, Advanced Micro Devices, Inc.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+// Drive the soft agent directly through its queue and signal API, without
+// libairhost, ROCm or libxaiengine: a strided ND_MEMCPY loopback through a
+// shim channel, a CDMA copy and a barrier AND packet. The latency model is
+// updated from this thread while the queue worker is completing packets.
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "air_soft_agent.h"
+#include "hsa_ext_air.h"
+
+// Write a packet into its slot, publish the header last and ring the doorbell.
+template <typename T> void dispatch(hsa_queue_t *q, T *pkt) {
+  uint64_t wr_idx = air_soft_agent_queue_add_write_index(q, 1);
+  auto *slot = (T *)q->base_address + wr_idx % q->size;
+  uint16_t header = pkt->header;
+  pkt->header = HSA_PACKET_TYPE_INVALID << HSA_PACKET_HEADER_TYPE;
+  memcpy(slot, pkt, sizeof(T));
+  __atomic_store_n(&slot->header, header, __ATOMIC_RELEASE);
+  air_soft_agent_signal_store(q->doorbell_signal, wr_idx);
+}
+
+void nd_memcpy(hsa_agent_dispatch_packet_t *pkt, uint8_t col,
+               uint8_t direction, uint8_t channel, void *addr,
+               uint32_t length1d, uint32_t length2d, uint32_t stride2d,
+               hsa_signal_t signal) {
+  memset(pkt, 0, sizeof(*pkt));
+  pkt->arg[0] = ((uint64_t)channel) << 24;
+  pkt->arg[0] |= ((uint64_t)col) << 32;
+  pkt->arg[0] |= ((uint64_t)direction) << 60;
+  pkt->arg[1] = (uint64_t)addr;
+  pkt->arg[2] = length1d;
+  pkt->arg[2] |= ((uint64_t)length2d) << 32;
+  pkt->arg[2] |= ((uint64_t)stride2d) << 48;
+  pkt->arg[3] = 1;
+  pkt->arg[3] |= ((uint64_t)1) << 32;
+  pkt->type = AIR_PKT_TYPE_ND_MEMCPY;
+  pkt->header = HSA_PACKET_TYPE_AGENT_DISPATCH << HSA_PACKET_HEADER_TYPE;
+  pkt->completion_signal = signal;
+}
+
+int main(int argc, char *argv[]) {
+
+  auto init_status = air_soft_agent_init();
+  assert(init_status == HSA_STATUS_SUCCESS && air_soft_agent_active());
+
+  hsa_queue_t *q = nullptr;
+  auto queue_create_status = air_soft_agent_queue_create(64, &q);
+  assert(queue_create_status == HSA_STATUS_SUCCESS && q);
+
+  hsa_signal_t done;
+  air_soft_agent_signal_create(2, &done);
+
+  // Send 4 rows of 16 bytes out of a 32 byte pitch source on MM2S channel 0
+  // of column 2 and receive them contiguously on S2MM channel 0.
+  uint8_t *src = (uint8_t *)air_soft_agent_malloc(128);
+  uint8_t *dst = (uint8_t *)air_soft_agent_malloc(64);
+  uint8_t *copy = (uint8_t *)air_soft_agent_malloc(64);
+  for (int i = 0; i < 128; i++)
+    src[i] = i;
+  memset(dst, 0xff, 64);
+  memset(copy, 0xff, 64);
+
+  hsa_agent_dispatch_packet_t pkt;
+  nd_memcpy(&pkt, 2, /*direction=*/1, 0, src, 16, 4, 32, done);
+  dispatch(q, &pkt);
+  nd_memcpy(&pkt, 2, /*direction=*/0, 0, dst, 64, 1, 0, done);
+  dispatch(q, &pkt);
+
+  // Change the latency model while the worker is busy with the packets above.
+  air_soft_agent_latency_model_t model = {1000, 0};
+  air_soft_agent_set_latency_model(&model);
+
+  // The CDMA copy only starts once both ND_MEMCPY packets have completed.
+  hsa_barrier_and_packet_t barrier;
+  memset(&barrier, 0, sizeof(barrier));
+  barrier.dep_signal[0] = done;
+  barrier.header = HSA_PACKET_TYPE_BARRIER_AND << HSA_PACKET_HEADER_TYPE;
+  hsa_signal_t barrier_done;
+  air_soft_agent_signal_create(1, &barrier_done);
+  barrier.completion_signal = barrier_done;
+
+  // The barrier waits for done to reach 0, so the CDMA packet must not share
+  // it.
+  hsa_signal_t cdma_done;
+  air_soft_agent_signal_create(1, &cdma_done);
+  memset(&pkt, 0, sizeof(pkt));
+  pkt.arg[0] = (uint64_t)copy;
+  pkt.arg[1] = (uint64_t)dst;
+  pkt.arg[2] = 64;
+  pkt.type = AIR_PKT_TYPE_CDMA;
+  pkt.header = HSA_PACKET_TYPE_AGENT_DISPATCH << HSA_PACKET_HEADER_TYPE;
+  pkt.completion_signal = cdma_done;
+
+  dispatch(q, &barrier);
+  dispatch(q, &pkt);
+
+  air_soft_agent_signal_wait(cdma_done, HSA_SIGNAL_CONDITION_EQ, 0, UINT64_MAX,
+                             HSA_WAIT_STATE_BLOCKED);
+  assert(air_soft_agent_signal_load(done) == 0);
+  assert(air_soft_agent_signal_load(barrier_done) == 0);
+
+  int errors = 0;
+  for (int i = 0; i < 64; i++) {
+    uint8_t ref = (i / 16) * 32 + i % 16;
+    if (dst[i] != ref || copy[i] != ref) {
+      if (errors < 10)
+        printf("mismatch %d: dst %d copy %d expected %d\n", i, dst[i], copy[i],
+               ref);
+      errors++;
+    }
+  }
+
+  air_soft_agent_latency_model_t readback;
+  air_soft_agent_get_latency_model(&readback);
+  errors += readback.packet_ns != 1000 || readback.bytes_per_us != 0;
+
+  air_soft_agent_signal_destroy(done);
+  air_soft_agent_signal_destroy(barrier_done);
+  air_soft_agent_signal_destroy(cdma_done);
+  air_soft_agent_free(src);
+  air_soft_agent_free(dst);
+  air_soft_agent_free(copy);
+  air_soft_agent_queue_destroy(q);
+  air_soft_agent_shut_down();
+
+  if (!errors) {
+    printf("PASS!\n");
+    return 0;
+  } else {
+    printf("fail %d/%d.\n", errors, 65);
+    return -1;
+  }
+}
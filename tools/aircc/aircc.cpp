@@ -25,12 +25,14 @@
 #include "air/Dialect/AIR/AIRDialect.h"
 #include "air/Dialect/AIRRt/AIRRtDialect.h"
 #include "air/InitAll.h"
+#include "air/Util/Util.h"
 
 #if AIR_ENABLE_AIE
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 #endif
 
+#include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
@@ -46,6 +48,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -185,6 +188,13 @@ static cl::opt<bool>
                                "logic"),
                       cl::init(false), cl::cat(airCompilerOptions));
 
+static cl::opt<bool>
+    persistentCores("persistent-cores",
+                    cl::desc("Keep cores resident across air.launch "
+                             "iterations; the host only writes runtime "
+                             "parameters and DMA BDs per launch"),
+                    cl::init(false), cl::cat(airCompilerOptions));
+
 // Use ValueOptional so --omit-ping-pong-transform (no value) defaults to "all"
 // matching Python argparse nargs="?" const="all" behavior.
 static cl::opt<std::string> omitPingpong(
@@ -228,6 +238,12 @@ static cl::opt<bool> useLockRaceConditionFix(
     cl::desc("Enable fix for lock race condition (inserts extra dummy BDs)"),
     cl::init(false), cl::cat(airCompilerOptions));
 
+static cl::opt<std::string> shimDmaAllocPolicy(
+    "shim-dma-alloc-policy",
+    cl::desc("Shim DMA column allocation policy (values: first-fit, "
+             "balanced)"),
+    cl::init("first-fit"), cl::cat(airCompilerOptions));
+
 enum OutputFormatKind { OF_xclbin, OF_txn, OF_elf, OF_none };
 
 static cl::opt<OutputFormatKind> outputFormat(
@@ -267,6 +283,12 @@ static cl::opt<bool>
             cl::desc("Emit IR after each pass to <tmpdir>/debug_ir/"),
             cl::init(false), cl::cat(airCompilerOptions));
 
+static cl::opt<bool> memoryFootprint(
+    "memory-footprint",
+    cl::desc("Write the peak L1 and L2 usage of each herd and segment to "
+             "<tmpdir>/memory_footprint.json before AIR to AIE conversion"),
+    cl::init(false), cl::cat(airCompilerOptions));
+
 static cl::opt<bool>
     bf16Emulation("bf16-emulation",
                   cl::desc("Emulate f32 vector arithmetic using bf16"),
@@ -1024,6 +1046,23 @@ static LogicalResult runAieCompilation() {
                              placedModule.get())))
     return failure();
 
+  if (memoryFootprint) {
+    SmallString<256> reportFile(tmpDir);
+    sys::path::append(reportFile, "memory_footprint.json");
+    std::string footprintPipeline;
+    {
+      raw_string_ostream os(footprintPipeline);
+      os << "builtin.module(air-memory-footprint{";
+      os << "device=" << deviceName.getValue();
+      os << " outputfile=" << reportFile;
+      os << "})";
+    }
+    if (failed(runPassPipeline(footprintPipeline, placedModule.get())))
+      return failure();
+    if (verbose)
+      llvm::outs() << "Memory footprint written to " << reportFile << "\n";
+  }
+
   // --- AIR to AIE conversion ---
   std::string airToAiePipeline;
   {
@@ -1031,6 +1070,8 @@ static LogicalResult runAieCompilation() {
     os << "builtin.module(";
     os << "air-to-aie{";
     os << "emit-while-loop=" << (omitWhileTrueLoop ? "false" : "true");
+    if (persistentCores)
+      os << " emit-persistent=true";
     os << " row-offset=" << resolvedRowOffset;
     os << " col-offset=" << resolvedColOffset;
     os << " device=" << deviceName.getValue();
@@ -1038,6 +1079,7 @@ static LogicalResult runAieCompilation() {
       os << " insert-trace-packet-flow=true";
     os << " use-lock-race-condition-fix="
        << (useLockRaceConditionFix ? "true" : "false");
+    os << " shim-dma-alloc-policy=" << shimDmaAllocPolicy.getValue();
     os << "}";
     os << ",air-merge-unrolled-devices";
     os << ")";
@@ -1120,6 +1162,26 @@ static LogicalResult runAieCompilation() {
       return failure();
     }
 
+    // Control functions with 'air.size_variants' get one runtime sequence
+    // per variant from airrt-to-npu, each built into its own insts file
+    struct SizeVariant {
+      std::string func;
+      SmallVector<int64_t> sizes;
+      std::string name;
+    };
+    SmallVector<SizeVariant> sizeVariants;
+    npuModule->walk([&](func::FuncOp f) {
+      auto variants = f->getAttrOfType<ArrayAttr>("air.size_variants");
+      if (!variants)
+        return;
+      for (Attribute attr : variants)
+        if (auto sizes = dyn_cast<DenseI64ArrayAttr>(attr))
+          sizeVariants.push_back(
+              {f.getName().str(), SmallVector<int64_t>(sizes.asArrayRef()),
+               xilinx::air::getSizeVariantName(f.getName(),
+                                               sizes.asArrayRef())});
+    });
+
     SmallString<256> npuFile(tmpDir);
     sys::path::append(npuFile, "npu." + airMlirFilename);
     if (failed(runPassPipeline(npuPipeline, npuModule.get())))
@@ -1153,6 +1215,43 @@ static LogicalResult runAieCompilation() {
         instsFile = ref.drop_back(7).str() + ".insts.bin";
     }
 
+    // Each size variant is built from a copy of the module holding only its
+    // runtime sequence, as an insts file holds a single sequence. The first
+    // variant goes through the full build, the others only generate their
+    // insts against the same device.
+    std::string instsBase = instsFile;
+    if (StringRef(instsFile).ends_with(".insts.bin"))
+      instsBase = StringRef(instsFile).drop_back(10).str();
+    std::vector<std::string> variantFiles;
+    for (const SizeVariant &variant : sizeVariants) {
+      auto variantModule = cloneModule(npuModule.get());
+      if (!variantModule) {
+        llvm::errs() << "Error: failed to clone module for size variant "
+                     << variant.name << "\n";
+        return failure();
+      }
+      SmallVector<Operation *> others;
+      variantModule->walk([&](Operation *op) {
+        auto name =
+            op->getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName());
+        if (op->getName().getStringRef() != "aie.runtime_sequence" || !name ||
+            name.getValue() == variant.name)
+          return;
+        if (llvm::any_of(sizeVariants, [&](const SizeVariant &v) {
+              return v.name == name.getValue();
+            }))
+          others.push_back(op);
+      });
+      for (Operation *op : others)
+        op->erase();
+      SmallString<256> variantFile(tmpDir);
+      sys::path::append(variantFile, Twine("npu.") + variant.name + "." +
+                                         airMlirFilename);
+      if (failed(saveModule(variantModule.get(), variantFile)))
+        return failure();
+      variantFiles.push_back(variantFile.str().str());
+    }
+
     // Build aiecc command
     std::vector<std::string> aieccCmd;
     aieccCmd.push_back(*aiecc);
@@ -1211,7 +1310,8 @@ static LogicalResult runAieCompilation() {
       aieccCmd.push_back("--bf16-emulation");
 
     // Input file
-    aieccCmd.push_back(npuFile.str().str());
+    aieccCmd.push_back(variantFiles.empty() ? npuFile.str().str()
+                                            : variantFiles.front());
 
     if (verbose) {
       llvm::outs() << "Running aiecc with options: ";
@@ -1224,6 +1324,51 @@ static LogicalResult runAieCompilation() {
     if (failed(runCommand(aieccCmd)))
       return failure();
 
+    // Insts of the other size variants, and a manifest mapping the sizes of
+    // each variant to its insts file for the host
+    if (!sizeVariants.empty()) {
+      json::Array manifest;
+      for (auto [i, variant] : llvm::enumerate(sizeVariants)) {
+        std::string variantInsts =
+            instsBase + "." + variant.name + ".insts.bin";
+        if (i == 0) {
+          if (failed(copyFile(instsFile, variantInsts)))
+            return failure();
+        } else {
+          std::vector<std::string> instsCmd;
+          instsCmd.push_back(*aiecc);
+          if (verbose)
+            instsCmd.push_back("-v");
+          instsCmd.push_back("--no-aiesim");
+          instsCmd.push_back(xchesscc ? "--xchesscc" : "--no-xchesscc");
+          instsCmd.push_back(xbridge ? "--xbridge" : "--no-xbridge");
+          instsCmd.push_back("--no-compile-host");
+          instsCmd.push_back("--no-compile");
+          instsCmd.push_back("--no-link");
+          instsCmd.push_back("--tmpdir=" + tmpDir.getValue());
+          instsCmd.push_back("--aie-generate-npu-insts");
+          instsCmd.push_back("--npu-insts-name=" + variantInsts);
+          if (!peanoInstallDir.empty())
+            instsCmd.push_back("--peano=" + peanoInstallDir.getValue());
+          instsCmd.push_back(variantFiles[i]);
+          if (failed(runCommand(instsCmd)))
+            return failure();
+        }
+        manifest.push_back(json::Object{{"function", variant.func},
+                                        {"sizes", json::Array(variant.sizes)},
+                                        {"sequence", variant.name},
+                                        {"insts", variantInsts}});
+      }
+      std::string manifestStr =
+          llvm::formatv("{0:2}", json::Value(std::move(manifest))).str();
+      if (failed(writeFile(instsBase + ".variants.json", manifestStr + "\n")))
+        return failure();
+      if (verbose)
+        llvm::outs() << "Wrote " << sizeVariants.size()
+                     << " size variants to " << instsBase
+                     << ".variants.json\n";
+    }
+
   } else {
     // --- Non-NPU path (Versal/legacy) ---
     // This path generates host-side libraries using aiecc + clang